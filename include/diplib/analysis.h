@@ -235,6 +235,62 @@ DIP_EXPORT FloatArray FindShift(
       UnsignedArray maxShift = {}
 );
 
+/// \brief Estimates the (sub-pixel) global shift between a reference image and many other images.
+///
+/// The constructor takes the reference image and the parameters to `dip::FindShift`, and computes the
+/// Fourier transform of the reference image (normalized as needed for the `"NCC"` method) once.
+/// `dip::ShiftEstimator::Estimate` then computes the same result as `dip::FindShift( reference, in, method,
+/// parameter, maxShift )`, but only needs to compute the Fourier transform of `in`. Given an array of images,
+/// these are processed in parallel.
+///
+/// For the methods that first compute the integer shift and then refine it on the common part of both images
+/// (`"CPF"`, `"MTS"`, `"ITER"` and `"PROJ"`), only the integer shift benefits from the cached transform.
+///
+/// `dip::ShiftEstimator::EstimateChained` is useful for registering a time series where the images drift
+/// away from the reference: each image is compared to the previous one, and the frame-to-frame shifts are
+/// accumulated. The Fourier transform of each image is computed only once.
+///
+/// ```cpp
+///     dip::ShiftEstimator estimator( frames[ 0 ], "CC" );
+///     dip::FloatCoordinateArray shifts = estimator.Estimate( dip::CreateImageConstRefArray( frames ));
+/// ```
+///
+/// The reference image must be scalar and real-valued; the images passed to `%Estimate` must in addition have
+/// the same sizes as the reference image. The object keeps a reference to the reference image's data.
+class DIP_NO_EXPORT ShiftEstimator {
+   public:
+      /// \brief Prepares for the estimation of shifts with respect to `reference`. See `dip::FindShift` for
+      /// the meaning of the other parameters.
+      DIP_EXPORT ShiftEstimator(
+            Image const& reference,
+            String const& method = "MTS",
+            dfloat parameter = 0,
+            UnsignedArray maxShift = {}
+      );
+
+      /// \brief Estimates the shift of `in` with respect to the reference image.
+      DIP_EXPORT FloatArray Estimate( Image const& in ) const;
+
+      /// \brief Estimates the shift of each image in `in` with respect to the reference image, in parallel.
+      DIP_EXPORT FloatCoordinateArray Estimate( ImageConstRefArray const& in ) const;
+
+      /// \brief Estimates the shift of each image in `in` with respect to the reference image, by accumulating
+      /// the shifts between consecutive images. The first image is compared to the reference image.
+      ///
+      /// The sequence is divided into as many contiguous blocks as threads, which are processed in parallel.
+      DIP_EXPORT FloatCoordinateArray EstimateChained( ImageConstRefArray const& in ) const;
+
+      /// \brief Returns the reference image.
+      Image const& Reference() const { return reference_; }
+
+   private:
+      Image reference_;
+      Image referenceFT_; // Fourier transform of `reference_`, divided by its square modulus for "NCC"
+      String method_;
+      dfloat parameter_;
+      UnsignedArray maxShift_;
+};
+
 
 /// \brief Computes the structure tensor.
 ///
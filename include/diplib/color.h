@@ -23,6 +23,7 @@
 #define DIP_COLOR_H
 
 #include <map>
+#include <memory>
 
 #include "diplib.h"
 #include "diplib/iterators.h"
@@ -64,6 +65,22 @@ class DIP_CLASS_EXPORT ColorSpaceConverter {
       /// spaces, as determined by the `InputColorSpace` and `OutputColorSpace` method.
       virtual void Convert( ConstLineIterator< dfloat >& input, LineIterator< dfloat >& output ) const = 0;
 
+      /// \brief Returns true if the converter implements `ConvertSinglePrecision`. The default implementation
+      /// returns false.
+      virtual bool HasSinglePrecision() const { return false; }
+
+      /// \brief Single-precision version of `Convert`, for `nPixels` pixels.
+      ///
+      /// `input[ ii ]` points to the `nPixels` values of input channel `ii`, and `output[ ii ]` to those of
+      /// output channel `ii`; each channel is stored contiguously. The input and output buffers do not overlap.
+      /// The buffers are short, such that all steps of a conversion work on data in the cache, and a simple
+      /// loop over the pixels can be vectorized by the compiler.
+      ///
+      /// `dip::ColorSpaceManager` calls this method only if `HasSinglePrecision` returns true.
+      virtual void ConvertSinglePrecision( sfloat const* const* /*input*/, sfloat* const* /*output*/, dip::uint /*nPixels*/ ) const {
+         DIP_THROW( E::NOT_IMPLEMENTED );
+      }
+
       virtual ~ColorSpaceConverter() = default;
 };
 
@@ -120,10 +137,19 @@ class DIP_NO_EXPORT ColorSpaceManager {
       /// \brief Constructor, registers the default color spaces.
       DIP_EXPORT ColorSpaceManager();
 
+      /// \brief Copy constructor. The copy does not share the look-up table cache with `other`.
+      DIP_EXPORT ColorSpaceManager( ColorSpaceManager const& other );
+
+      /// \brief Copy assignment. The copy does not share the look-up table cache with `other`.
+      DIP_EXPORT ColorSpaceManager& operator=( ColorSpaceManager const& other );
+
       /// \brief Defines a new color space, that requires `nChannels` channels.
-      void Define( String const& colorSpaceName, dip::uint nChannels ) {
+      ///
+      /// Set `hasHue` if one of the channels is an angle (such as the hue in HSV). Conversions to such a
+      /// color space never use the look-up table, see `EnableLookupTable`.
+      void Define( String const& colorSpaceName, dip::uint nChannels, bool hasHue = false ) {
          DIP_THROW_IF( IsDefined( colorSpaceName ), "Color space name already defined" );
-         colorSpaces_.emplace_back( colorSpaceName, nChannels );
+         colorSpaces_.emplace_back( colorSpaceName, nChannels, hasHue );
          names_[ colorSpaceName ] = colorSpaces_.size() - 1;
       }
 
@@ -136,6 +162,7 @@ class DIP_NO_EXPORT ColorSpaceManager {
       /// \brief Registers a function object to translate from one color space to another. The
       /// `%dip::ColorSpaceManager` object takes ownership of the converter.
       void Register( ColorSpaceConverter* converter ) {
+         ++converterVersion_;
          auto smartpointer = ColorSpaceConverterPointer( converter );
          dip::uint source = Index( converter->InputColorSpace() );
          dip::uint destination = Index( converter->OutputColorSpace() );
@@ -161,6 +188,7 @@ class DIP_NO_EXPORT ColorSpaceManager {
             String const& inputColorSpaceName,
             String const& outputColorSpaceName
       ) const {
+         ++converterVersion_; // the caller might modify the converter, cached look-up tables are no longer valid
          dip::uint source = Index( inputColorSpaceName );
          dip::uint destination = Index( outputColorSpaceName );
          auto& edges = colorSpaces_[ source ].edges;
@@ -208,10 +236,19 @@ class DIP_NO_EXPORT ColorSpaceManager {
       ///     dip::ColorSpaceManager csm;
       ///     cms.Convert( in, out, "HSV" );
       /// ```
-      /// In this case, all computations are still performed as double-precision floating-point computations,
-      /// but the result is cast to 8-bit unsigned integers when written to the output image. Some color spaces,
-      /// such as RGB and CMYK are defined to use the [0,255] range of 8-bit unsigned integers. Other color spaces
-      /// such as Lab and XYZ are not. For those color spaces, casting to an integer will destroy the data.
+      /// In this case, the computations are performed in floating-point, and the result is cast to 8-bit unsigned
+      /// integers when written to the output image. Some color spaces, such as RGB and CMYK are defined to use the
+      /// [0,255] range of 8-bit unsigned integers. Other color spaces such as Lab and XYZ are not. For those color
+      /// spaces, casting to an integer will destroy the data.
+      ///
+      /// If the input image is not double precision, and all converters along the path implement
+      /// `dip::ColorSpaceConverter::ConvertSinglePrecision`, the computations are performed in single precision,
+      /// with all conversion steps applied to a small block of pixels before moving on to the next block.
+      /// Otherwise the computations are performed in double precision. All converters between grey, RGB, sRGB,
+      /// XYZ and Lab implement the single-precision conversion.
+      ///
+      /// If `EnableLookupTable` was called, and the input image is an 8-bit unsigned integer image with three
+      /// channels, the conversion uses a 3D look-up table instead.
       DIP_EXPORT void Convert( Image const& in, Image& out, String const& colorSpaceName = "" ) const;
       Image Convert( Image const& in, String const& colorSpaceName = "" ) const {
          Image out;
@@ -259,19 +296,46 @@ class DIP_NO_EXPORT ColorSpaceManager {
          SetWhitePoint( triplet );
       }
 
+      /// \brief Enables or disables the use of 3D look-up tables for 8-bit unsigned integer images.
+      ///
+      /// When enabled, `Convert` converts three-channel `dip::DT_UINT8` images using a look-up table that samples
+      /// the complete conversion at a regular grid of 33x33x33 input values (in steps of 8), and uses trilinear
+      /// interpolation in between. The table for a pair of color spaces is computed the first time it is needed,
+      /// and kept until converters are changed through `Register`, `SetWhitePoint` or `GetColorSpaceConverter`.
+      /// This is much faster than computing the conversion for each pixel, but is an approximation: the error
+      /// depends on the curvature of the conversion, for sRGB to Lab it is at most about 0.5 units of L, a and b.
+      ///
+      /// The look-up table is not used when the target color space has a hue channel (HSI, HCV, HSV, LCH, or
+      /// any color space defined with `hasHue` set). The hue wraps around at 360 degrees, and interpolating
+      /// across that discontinuity would produce wrong values for colors near red.
+      ///
+      /// Disabled by default.
+      void EnableLookupTable( bool enable = true ) {
+         useLookupTable_ = enable;
+      }
+
    private:
 
       struct ColorSpace {
          String name;
          dip::uint nChannels;
+         bool hasHue;  // One of the channels is an angle, the look-up table cannot interpolate it
          std::map< dip::uint, ColorSpaceConverterPointer > edges;  // The key is the target color space index
-         ColorSpace( String const& name, dip::uint chans ) :
-               name( name ), nChannels( chans ) {}
+         ColorSpace( String const& name, dip::uint chans, bool hasHue = false ) :
+               name( name ), nChannels( chans ), hasHue( hasHue ) {}
       };
 
       std::map< String, dip::uint > names_;
       std::vector< ColorSpace > colorSpaces_;
 
+      // Cached look-up tables, see `EnableLookupTable`. A table is valid if it was computed with the current
+      // `converterVersion_`, which is incremented every time a converter might have changed. Each manager
+      // has its own cache, copies get a new, empty one.
+      struct LookupTableCache;
+      bool useLookupTable_ = false;
+      mutable dip::uint converterVersion_ = 0;
+      std::shared_ptr< LookupTableCache > lookupTables_;
+
       dip::uint Index( String const& name ) const {
          auto it = names_.find( name );
          DIP_THROW_IF( it == names_.end(), "Color space name not defined" );
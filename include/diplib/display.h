@@ -21,6 +21,9 @@
 #ifndef DIP_DISPLAY_H
 #define DIP_DISPLAY_H
 
+#include <map>
+#include <tuple>
+
 #include "diplib.h"
 #include "diplib/color.h"
 
@@ -544,6 +547,19 @@ class DIP_NO_EXPORT ImageDisplay {
       std::array< LimitsLists, 4 > sliceLimits_;  // Limits to use when !globalStretch_
       std::array< LimitsLists, 4 > globalLimits_; // Limits to use when globalStretch_
 
+      // Projections computed so far, so that going back to a previous projection doesn't recompute it. The image
+      // cannot be replaced, so these never need to be invalidated. `limits` are the `sliceLimits_` for the
+      // projection, computed for the tensor elements `red`, `green` and `blue`.
+      struct CachedProjection {
+         Image slice; // the projection, with dimensions already permuted like `slice_`
+         std::array< LimitsLists, 4 > limits;
+         dip::sint red = -1;
+         dip::sint green = -1;
+         dip::sint blue = -1;
+      };
+      using ProjectionKey = std::tuple< ProjectionMode, dip::uint, dip::uint >; // projectionMode_, dim1_, dim2_
+      std::map< ProjectionKey, CachedProjection > projectionCache_;
+
       bool IsComplex() { return image_.DataType().IsComplex(); }
       bool IsBinary() { return image_.DataType().IsBinary(); }
       bool IsInteger() { return image_.DataType().IsInteger(); }
@@ -554,6 +570,9 @@ class DIP_NO_EXPORT ImageDisplay {
 
       DIP_NO_EXPORT void InvalidateSliceLimits();
 
+      // Returns the cache entry for the current projection, or `nullptr` if the current slice is not a cached projection.
+      DIP_NO_EXPORT CachedProjection* CurrentProjection();
+
       DIP_EXPORT void UpdateSlice();
       DIP_NO_EXPORT void UpdateRgbSlice();
       DIP_EXPORT void UpdateOutput();
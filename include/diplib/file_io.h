@@ -21,6 +21,8 @@
 #ifndef DIP_FILE_IO_H
 #define DIP_FILE_IO_H
 
+#include <functional>
+
 #include "diplib.h"
 
 
@@ -185,6 +187,9 @@ DIP_EXPORT void ImageWriteICS(
 ///
 /// The pixels per inch value in the TIFF file will be used to set the pixel size of `out`.
 ///
+/// When reading multiple pages, these are read and decoded concurrently, using the number of threads set
+/// with `dip::SetNumberOfThreads`. Each thread opens the file separately.
+///
 /// TIFF is a very flexible file format. We have to limit the types of images that can be read to the
 /// more common ones. These are the most obvious limitations:
 ///  - Tiled images are not supported.
@@ -251,18 +256,48 @@ inline Image ImageReadTIFF(
 ///
 /// `filenames` contains the paths to the TIFF files, which are read in the order given, and concatenated along the 3rd
 /// dimension. Only the first page of each TIFF file is read.
+///
+/// The files are read and decoded concurrently by `nThreads` threads, directly into the output image. If `nThreads`
+/// is 0, the number of threads set with `dip::SetNumberOfThreads` is used. With many files on fast storage, using
+/// more threads than there are processor cores can help keep the storage busy.
 DIP_EXPORT void ImageReadTIFFSeries(
       Image& out,
-      StringArray const& filenames
+      StringArray const& filenames,
+      dip::uint nThreads = 0
 );
 inline Image ImageReadTIFFSeries(
-      StringArray const& filenames
+      StringArray const& filenames,
+      dip::uint nThreads = 0
 ) {
    Image out;
-   ImageReadTIFFSeries( out, filenames );
+   ImageReadTIFFSeries( out, filenames, nThreads );
    return out;
 }
 
+/// \brief The function called by `dip::ImageReadTIFFSeries` for each image read.
+///
+/// `index` is the index into `filenames` of the image. The function can take ownership of `image` (e.g. by
+/// moving it into another `dip::Image` object), otherwise its data segment will be reused for a later image.
+/// The data segment is not reused if `image` is protected when `callback` returns.
+using TIFFSeriesCallback = std::function< void( dip::uint index, Image& image ) >;
+
+/// \brief Reads a set of 2D TIFF images, and passes each of them to `callback`.
+///
+/// This is an alternative to the function above for when the images should not, or cannot, all be kept in memory.
+/// Upcoming files are read and decoded concurrently by `nThreads` threads, while `callback` processes the current
+/// one. At most `2 * nThreads` images are read ahead. If `nThreads` is 0, the number of threads set with
+/// `dip::SetNumberOfThreads` is used.
+///
+/// `callback` is called in the calling thread, once for each file, in the order given in `filenames`.
+/// Only the first page of each TIFF file is read. The images do not need to have the same sizes.
+/// If reading a file fails, or `callback` throws an exception, no more files are read and the exception is
+/// rethrown.
+DIP_EXPORT void ImageReadTIFFSeries(
+      StringArray const& filenames,
+      TIFFSeriesCallback const& callback,
+      dip::uint nThreads = 0
+);
+
 /// \brief Reads image information and metadata from the TIFF file `filename`, without reading the actual
 /// pixel data.
 DIP_EXPORT FileInformation ImageReadTIFFInfo( String const& filename, dip::uint imageNumber = 0 );
@@ -273,7 +308,8 @@ DIP_EXPORT bool ImageIsTIFF( String const& filename );
 /// \brief Writes `image` as a TIFF file.
 ///
 /// The TIFF image file format is very flexible in how data can be written, but is limited to multiple pages
-/// of 2D images. A 3D image will be written as a multi-page TIFF file (not yet implemented).
+/// of 2D images. A 3D image will be written as a multi-page TIFF file, with one page for each plane along
+/// the 3rd dimension.
 /// A tensor image will be written as an image with multiple samples per pixel, but the tensor shape will be lost.
 /// Color space information and pixel size are not saved either, though the pixel size, if in units of length,
 /// will set the pixels per centimeter value in the TIFF file.
@@ -0,0 +1,223 @@
+/*
+ * DIPlib 3.0
+ * This file contains declarations for processing sequences of frames one at the time.
+ *
+ * (c)2026, Cris Luengo.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef DIP_FRAME_SEQUENCE_H
+#define DIP_FRAME_SEQUENCE_H
+
+#include <functional>
+#include <memory>
+
+#include "diplib.h"
+#include "diplib/file_io.h"
+
+
+/// \file
+/// \brief Functions and classes for processing sequences of frames (e.g. time-lapse series) one frame at the time.
+/// \see frame_sequence
+
+
+namespace dip {
+
+
+/// \defgroup frame_sequence Frame sequences
+/// \brief Processing long sequences of frames, such as time-lapse series, with bounded memory usage.
+///
+/// A frame sequence is read from a `dip::FrameSource`, processed by `dip::ProcessFrameSequence` or
+/// `dip::TemporalFilter`, and written to a `dip::FrameSink`. Only the frames in the temporal window being
+/// processed, and a few frames queued for reading and writing, are kept in memory. Reading frames from the
+/// source and writing frames to the sink each happen in their own thread, concurrently with the processing.
+///
+/// To process frames in a different way, or to read or write them from or to a different place, derive
+/// from `dip::FrameSource` or `dip::FrameSink`, or pass a custom function to `dip::ProcessFrameSequence`.
+/// \{
+
+
+/// \brief A source of frames, to be processed with `dip::ProcessFrameSequence`.
+///
+/// A frame source is used by one thread at the time, but not always the thread that created it.
+class DIP_CLASS_EXPORT FrameSource {
+   public:
+      /// \brief Reads the next frame into `out`, returns `false` if there are no more frames.
+      ///
+      /// If `out` is forged with the sizes and data type of the frame, the frame should be read into its
+      /// existing data segment, so that frame buffers can be reused.
+      virtual bool ReadFrame( Image& out ) = 0;
+
+      /// \brief Returns the number of frames in the sequence, or 0 if not known.
+      virtual dip::uint NumberOfFrames() const { return 0; }
+
+      virtual ~FrameSource() = default;
+};
+
+/// \brief A destination for frames produced by `dip::ProcessFrameSequence`.
+///
+/// A frame sink is used by one thread at the time, but not always the thread that created it.
+class DIP_CLASS_EXPORT FrameSink {
+   public:
+      /// \brief Writes the next frame. The data of `frame` will be overwritten after this function returns,
+      /// copy the data if it needs to be kept.
+      virtual void WriteFrame( Image const& frame ) = 0;
+
+      virtual ~FrameSink() = default;
+};
+
+/// \brief Reads the slices of an image along its last dimension as frames.
+///
+/// The image is not copied, it must not be modified while frames are being read.
+class DIP_CLASS_EXPORT ImageFrameSource : public FrameSource {
+   public:
+      DIP_EXPORT explicit ImageFrameSource( Image const& image );
+      DIP_EXPORT virtual bool ReadFrame( Image& out ) override;
+      virtual dip::uint NumberOfFrames() const override { return image_.Sizes().back(); }
+   private:
+      Image image_;
+      dip::uint next_ = 0;
+};
+
+/// \brief Writes frames to consecutive slices of an image, along its last dimension.
+///
+/// The first frame written determines the sizes, number of tensor elements and data type of `out`, which
+/// will get an additional dimension of size `numberOfFrames`. Writing more frames than that throws an exception.
+class DIP_CLASS_EXPORT ImageFrameSink : public FrameSink {
+   public:
+      DIP_EXPORT ImageFrameSink( Image& out, dip::uint numberOfFrames );
+      DIP_EXPORT virtual void WriteFrame( Image const& frame ) override;
+      /// \brief Returns the number of frames written so far.
+      dip::uint NumberOfFrames() const { return next_; }
+   private:
+      Image& out_;
+      dip::uint numberOfFrames_;
+      dip::uint next_ = 0;
+};
+
+/// \brief Reads the planes of an ICS file, along its last dimension, one at the time.
+///
+/// For files where the planes are stored one after the other (as written by `dip::ImageWriteICS` for scalar
+/// images, compressed or not), the file is read sequentially and kept open. Otherwise, `dip::ImageReadICS` is
+/// used to read each plane, which is slower. The frames have the pixel size and color space stored in the file.
+class DIP_CLASS_EXPORT ICSFrameSource : public FrameSource {
+   public:
+      DIP_EXPORT explicit ICSFrameSource( String const& filename );
+      DIP_EXPORT virtual ~ICSFrameSource() override;
+      DIP_EXPORT virtual bool ReadFrame( Image& out ) override;
+      virtual dip::uint NumberOfFrames() const override { return numberOfFrames_; }
+      /// \brief Returns information about the file. The sizes include the last dimension.
+      FileInformation const& Information() const { return information_; }
+   private:
+      class Reader;
+      std::unique_ptr< Reader > reader_; // Keeps the file open for sequential reading, if possible
+      String filename_;
+      FileInformation information_;
+      dip::uint numberOfFrames_ = 0;
+      dip::uint next_ = 0;
+};
+
+/// \brief Reads the pages of a multi-page TIFF file, or the first page of each of a series of TIFF files,
+/// one at the time.
+///
+/// A multi-page TIFF file is kept open and read sequentially. All frames should have the same sizes,
+/// but this is not enforced. See `dip::ImageReadTIFF` for the types of TIFF files that can be read.
+class DIP_CLASS_EXPORT TIFFFrameSource : public FrameSource {
+   public:
+      /// \brief Reads the pages of the multi-page TIFF file `filename`.
+      DIP_EXPORT explicit TIFFFrameSource( String const& filename );
+      /// \brief Reads the first page of each of the TIFF files in `filenames`.
+      DIP_EXPORT explicit TIFFFrameSource( StringArray const& filenames );
+      DIP_EXPORT virtual ~TIFFFrameSource() override;
+      DIP_EXPORT virtual bool ReadFrame( Image& out ) override;
+      virtual dip::uint NumberOfFrames() const override { return numberOfFrames_; }
+   private:
+      class Reader;
+      std::unique_ptr< Reader > reader_; // Keeps the multi-page file open
+      StringArray filenames_;
+      dip::uint numberOfFrames_ = 0;
+      dip::uint next_ = 0;
+};
+
+
+/// \brief The function called by `dip::ProcessFrameSequence` for each frame.
+///
+/// `window` contains the frames in the temporal window, in order, and `current` is the index into `window`
+/// of the frame for which the output is computed. `out` is to be set to the output frame. It might be
+/// forged, with a previous output frame that is no longer needed, in which case its data segment can be reused.
+using FrameWindowFunction = std::function< void( ImageConstRefArray const& window, dip::uint current, Image& out ) >;
+
+/// \brief Reads frames from `source`, computes an output frame for each input frame using `function`, and
+/// writes these to `sink`.
+///
+/// The output for frame `t` is computed from a temporal window with `windowLength` frames, from frame
+/// `t - windowLength / 2` to frame `t + ( windowLength - 1 ) / 2`. At the beginning and end of the sequence,
+/// the window is shortened to contain only existing frames. `function` is called with the frames in the
+/// window, see `dip::FrameWindowFunction`.
+///
+/// Frames are read from `source` in a separate thread, which reads up to `queueLength` frames ahead of
+/// the ones needed. Frames are written to `sink` in another separate thread, up to `queueLength` frames
+/// can be waiting to be written. Thus, memory usage is bounded by `windowLength + 2 * queueLength` frames
+/// (plus a few frame buffers that are being reused). `function` can use multiple threads, as *DIPlib*
+/// functions do (see \ref design_multithreading).
+///
+/// Frames passed to `function` and to `sink` are reused for subsequent frames, unless `function` or
+/// `sink` keep a reference to them (e.g. by making a copy of the `dip::Image` object).
+///
+/// If `source`, `sink` or `function` throw an exception, processing stops and the exception is rethrown
+/// once the threads have finished.
+DIP_EXPORT void ProcessFrameSequence(
+      FrameSource& source,
+      FrameSink& sink,
+      dip::uint windowLength,
+      FrameWindowFunction const& function,
+      dip::uint queueLength = 4
+);
+
+/// \brief Applies a temporal filter to the frames read from `source`, and writes the result to `sink`.
+///
+/// For each frame, the filter is computed over a temporal window of `windowLength` frames, as described in
+/// `dip::ProcessFrameSequence`. `method` can be one of:
+///  - `"mean"`: running mean.
+///  - `"median"`: temporal median.
+///  - `"minimum"` or `"maximum"`: temporal minimum or maximum.
+///  - `"percentile"`: the `percentile`-th percentile (between 0 and 100) over the window.
+///
+/// If `output` is `"filtered"`, the filtered frames are written to `sink`. If `output` is `"difference"`,
+/// the filtered frame is subtracted from the current frame, which is useful for background subtraction
+/// (e.g. with `method` set to `"median"`).
+///
+/// The frames must be real-valued, and all have the same sizes and number of tensor elements.
+/// The mean and the difference are computed using a floating-point type (see `dip::DataType::SuggestFloat`);
+/// otherwise, the output frames have the data type of the input frames.
+///
+/// The filter is computed by a `dip::Framework::Scan` line filter that takes all frames in the window as
+/// input, and thus is parallelized over the pixels of the frame.
+DIP_EXPORT void TemporalFilter(
+      FrameSource& source,
+      FrameSink& sink,
+      dip::uint windowLength = 5,
+      String const& method = "mean",
+      String const& output = "filtered",
+      dfloat percentile = 50.0,
+      dip::uint queueLength = 4
+);
+
+
+/// \}
+
+} // namespace dip
+
+#endif // DIP_FRAME_SEQUENCE_H
@@ -619,11 +619,10 @@ inline Image CreateCoordinates( UnsignedArray const& sizes, StringSet const& mod
 /// [`lowerBound`, `upperBound`). That is, for each pixel it does
 /// `in += uniformRandomGenerator( lowerBound, upperBound )`. The output image is of the same type as the input image.
 ///
-/// `random` is used to generate the random values needed by the first thread. If the algorithm runs in multiple
-/// threads, portions of the image processed by additional threads take their random values from `random.Split()`,
-/// which is essentially a copy of `random` set to a different random stream. Given a `dip::Random` object in an
-/// identical state before calling this function, the output image will be different depending on the number of
-/// threads used.
+/// A single value is taken from `random`, and used as the key for a counter-based generator: the random values
+/// for each sample depend only on this key and on the sample's linear index (tensor elements are indexed as if
+/// they were the last spatial dimension). Given a `dip::Random` object in an identical state before calling this
+/// function, the output image will be identical independently of the number of threads used.
 ///
 /// \see dip::UniformRandomGenerator.
 DIP_EXPORT void UniformNoise( Image const& in, Image& out, Random& random, dfloat lowerBound = 0.0, dfloat upperBound = 1.0 );
@@ -637,13 +636,13 @@ inline Image UniformNoise( Image const& in, Random& random, dfloat lowerBound =
 ///
 /// The normally distributed noise added to the image is defined by `variance`, and has a zero mean. That is,
 /// for each pixel it does `in += gaussianRandomGenerator( 0, std::sqrt( variance ))`. The output image is of the
-/// same type as the input image.
+/// same type as the input image. The normally distributed values are drawn using the ziggurat method, which for
+/// most samples requires a single 64-bit random value and one table look-up.
 ///
-/// `random` is used to generate the random values needed by the first thread. If the algorithm runs in multiple
-/// threads, portions of the image processed by additional threads take their random values from `random.Split()`,
-/// which is essentially a copy of `random` set to a different random stream. Given a `dip::Random` object in an
-/// identical state before calling this function, the output image will be different depending on the number of
-/// threads used.
+/// A single value is taken from `random`, and used as the key for a counter-based generator: the random values
+/// for each sample depend only on this key and on the sample's linear index (tensor elements are indexed as if
+/// they were the last spatial dimension). Given a `dip::Random` object in an identical state before calling this
+/// function, the output image will be identical independently of the number of threads used.
 ///
 /// \see dip::GaussianRandomGenerator.
 DIP_EXPORT void GaussianNoise( Image const& in, Image& out, Random& random, dfloat variance = 1.0 );
@@ -663,11 +662,10 @@ inline Image GaussianNoise( Image const& in, Random& random, dfloat variance = 1
 ///
 /// The output image is of the same type as the input image.
 ///
-/// `random` is used to generate the random values needed by the first thread. If the algorithm runs in multiple
-/// threads, portions of the image processed by additional threads take their random values from `random.Split()`,
-/// which is essentially a copy of `random` set to a different random stream. Given a `dip::Random` object in an
-/// identical state before calling this function, the output image will be different depending on the number of
-/// threads used.
+/// A single value is taken from `random`, and used as the key for a counter-based generator: the random values
+/// for each sample depend only on this key and on the sample's linear index (tensor elements are indexed as if
+/// they were the last spatial dimension). Given a `dip::Random` object in an identical state before calling this
+/// function, the output image will be identical independently of the number of threads used.
 ///
 /// \see dip::PoissonRandomGenerator.
 DIP_EXPORT void PoissonNoise( Image const& in, Image& out, Random& random, dfloat conversion = 1.0 );
@@ -720,11 +718,10 @@ inline Image PoissonNoise( Image const& in, Random& random, dfloat conversion =
 ///     poissonPoint3 = poissonPoint3 >= threshold;
 /// ```
 ///
-/// `random` is used to generate the random values needed by the first thread. If the algorithm runs in multiple
-/// threads, portions of the image processed by additional threads take their random values from `random.Split()`,
-/// which is essentially a copy of `random` set to a different random stream. Given a `dip::Random` object in an
-/// identical state before calling this function, the output image will be different depending on the number of
-/// threads used.
+/// A single value is taken from `random`, and used as the key for a counter-based generator: the random values
+/// for each sample depend only on this key and on the sample's linear index (tensor elements are indexed as if
+/// they were the last spatial dimension). Given a `dip::Random` object in an identical state before calling this
+/// function, the output image will be identical independently of the number of threads used.
 ///
 /// \see dip::BinaryRandomGenerator.
 DIP_EXPORT void BinaryNoise( Image const& in, Image& out, Random& random, dfloat p10 = 0.05, dfloat p01 = 0.05 );
@@ -745,11 +742,10 @@ inline Image BinaryNoise( Image const& in, Random& random, dfloat p10 = 0.05, df
 /// Note that the noise generated corresponds to a Poisson point process. The distances between changed pixels
 /// have a Poisson distribution.
 ///
-/// `random` is used to generate the random values needed by the first thread. If the algorithm runs in multiple
-/// threads, portions of the image processed by additional threads take their random values from `random.Split()`,
-/// which is essentially a copy of `random` set to a different random stream. Given a `dip::Random` object in an
-/// identical state before calling this function, the output image will be different depending on the number of
-/// threads used.
+/// A single value is taken from `random`, and used as the key for a counter-based generator: the random values
+/// for each sample depend only on this key and on the sample's linear index (tensor elements are indexed as if
+/// they were the last spatial dimension). Given a `dip::Random` object in an identical state before calling this
+/// function, the output image will be identical independently of the number of threads used.
 ///
 /// \see dip::UniformRandomGenerator.
 DIP_EXPORT void SaltPepperNoise( Image const& in, Image& out, Random& random, dfloat p0 = 0.05, dfloat p1 = 0.05, dfloat white = 1.0 );
@@ -215,12 +215,16 @@ inline Image Shift(
 /// Any coordinates outside of the image domain are returned as zero values. That is, no extrapolation is
 /// performed.
 ///
-/// `interpolationMethod` has a restricted set of options: `"linear"`, `"3-cubic"`, or `"nearest"`.
-/// See \ref interpolation_methods for their definition.
+/// `interpolationMethod` has a restricted set of options: `"linear"`, `"3-cubic"`, `"bspline"`, or `"nearest"`.
+/// See \ref interpolation_methods for their definition. The `"bspline"` method here is implemented through
+/// B-spline coefficients that are computed for the whole image, rather than along image lines, and mirror the
+/// image at its edges.
 ///
 /// `out` will be a 1D image with the same size as the `coordinates` array, and the same data type and tensor
 /// shape as `in`. To obtain results in a floating-point type, set the data type of `out` and protect it,
 /// see \ref protect.
+///
+/// This function calls the version of `%dip::ResampleAt` that takes a coordinate image, see below.
 DIP_EXPORT void ResampleAt(
       Image const& in,
       Image& out,
@@ -237,13 +241,46 @@ inline Image ResampleAt(
    return out;
 }
 
-/// \brief Identical to the previous function with the same name, but for a single point.
+/// \brief Identical to the previous function with the same name, but for a single point. `"bspline"` is not supported.
 DIP_EXPORT Image::Pixel ResampleAt(
       Image const& in,
       FloatArray const& coordinates,
       String const& interpolationMethod = S::LINEAR
 );
 
+/// \brief Finds the values of the image at sub-pixel locations given by the image `map`.
+///
+/// `map` is a real-valued vector image with as many tensor elements as `in` has dimensions. Each of its pixels
+/// contains the coordinates of a point in `in`. `out` will have the sizes of `map`, and the same data type and
+/// tensor shape as `in`. To obtain results in a floating-point type, set the data type of `out` and protect it,
+/// see \ref protect. This is the function to use when warping an image with a deformation field, add the
+/// coordinates of each pixel (see `dip::CreateCoordinates`) to the deformation field to obtain `map`.
+///
+/// Coordinates outside of the image domain (or NaN) produce the value `fill` in `out`. `fill` has either one
+/// tensor element or as many as `in`.
+///
+/// `interpolationMethod` has the same options as the version of this function above. Points are processed in
+/// parallel. For each point, the interpolation weights are computed once per dimension, and then applied to
+/// all tensor elements. For `"bspline"`, the B-spline coefficients of `in` are computed once, and used for all
+/// points.
+DIP_EXPORT void ResampleAt(
+      Image const& in,
+      Image const& map,
+      Image& out,
+      String const& interpolationMethod = S::LINEAR,
+      Image::Pixel const& fill = { 0 }
+);
+inline Image ResampleAt(
+      Image const& in,
+      Image const& map,
+      String const& interpolationMethod = S::LINEAR,
+      Image::Pixel const& fill = { 0 }
+) {
+   Image out;
+   ResampleAt( in, map, out, interpolationMethod, fill );
+   return out;
+}
+
 
 // Undocumented internal function called by the other forms of Skew.
 // Each sub-volume perpendicular to axis is shifted with sub-pixel precision, according to `shearArray`.
@@ -0,0 +1,74 @@
+/*
+ * DIPlib 3.0
+ * This file contains declarations for functions that select the instruction set used by multi-versioned functions.
+ *
+ * (c)2026, Cris Luengo.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef DIP_INSTRUCTION_SET_H
+#define DIP_INSTRUCTION_SET_H
+
+#include "diplib.h"
+
+
+/// \file
+/// \brief Declares functions to select which instruction set extensions are used within DIPlib.
+/// \see infrastructure
+
+
+namespace dip {
+
+/// \addtogroup infrastructure
+/// \{
+
+
+/// \brief Selects the instruction set used by the functions in *DIPlib* that are compiled for more than one.
+///
+/// A few of the most time-critical parts of *DIPlib* are compiled for multiple instruction set extensions, such that
+/// a library built for the baseline instruction set (usually SSE2 on x86-64) can still make use of the wider
+/// vector registers of newer processors. These are the data type conversion when copying image data
+/// (used by all frameworks), the separable convolution (used by `dip::Gauss` and the other FIR filters), the
+/// dilation and erosion with rectangular structuring elements, the sample-wise arithmetic operators, and the
+/// exponential, logarithmic and trigonometric functions. See \ref design_instruction_sets.
+///
+/// `instructionSet` is one of:
+///  - `"baseline"`: the instruction set the library was compiled for.
+///  - `"avx2"`: AVX2 and FMA (x86 only).
+///  - `"avx512"`: the AVX-512 F, DQ, BW and VL subsets, as well as AVX2 and FMA (x86 only).
+///  - An empty string: selects the best instruction set supported by the processor, this is the default.
+///
+/// The initial value can be set through the `DIP_INSTRUCTION_SET` environment variable, which takes the same
+/// values. An invalid value in the environment variable is ignored.
+///
+/// Throws if `instructionSet` is not supported by the processor, or was not compiled in. This function is meant
+/// mostly for testing and benchmarking. Results computed with different instruction sets can differ by rounding
+/// errors, as for example AVX2 code uses fused multiply-add instructions.
+///
+/// This function is not thread safe, do not call it while other threads are calling *DIPlib* functions.
+DIP_EXPORT void SetInstructionSet( String const& instructionSet = "" );
+
+/// \brief Returns the name of the instruction set currently used, see `dip::SetInstructionSet`.
+DIP_EXPORT String GetInstructionSet();
+
+/// \brief Returns the names of the instruction sets that can be selected on this machine, see
+/// `dip::SetInstructionSet`. The last one is the one selected by default.
+DIP_EXPORT StringArray SupportedInstructionSets();
+
+/// \}
+
+} // namespace dip
+
+#endif // DIP_INSTRUCTION_SET_H
@@ -270,6 +270,9 @@ inline dfloat Sinc( dfloat x ) {
 /// `vectors` is a pointer to space for `n*n` values and will receive the `n` eigenvectors. The eigenvectors
 /// can be accessed at `&vectors[ 0 ]`, `&vectors[ n ]`, `&vectors[ 2*n ]`, etc.
 /// If `vectors` is `nullptr`, no eigenvectors are computed.
+///
+/// For `n` equal to 2 or 3, a closed-form solution is used, which does not allocate memory. In this case,
+/// the sign of each eigenvector is chosen such that its largest component is positive.
 DIP_EXPORT void SymmetricEigenDecomposition(
       dip::uint n,
       ConstSampleIterator< dfloat > input,
@@ -322,7 +325,14 @@ inline void SymmetricEigenDecompositionPacked(
       SampleIterator< dfloat > lambdas,
       SampleIterator< dfloat > vectors = nullptr
 ) {
-   FloatArray matrix( n * n );
+   // Small matrices are copied to the stack, to avoid allocating memory
+   dfloat smallMatrix[ 9 ];
+   FloatArray largeMatrix;
+   dfloat* matrix = smallMatrix;
+   if( n > 3 ) {
+      largeMatrix.resize( n * n );
+      matrix = largeMatrix.data();
+   }
    // Copy over diagonal elements, which are stored sequentially at the beginning of `input`.
    for( dip::uint ii = 0, kk = 0; ii < n; ++ii, kk += 1 + n ) {
       matrix[ kk ] = *input;
@@ -336,7 +346,7 @@ inline void SymmetricEigenDecompositionPacked(
          ++input;
       }
    }
-   SymmetricEigenDecomposition( n, matrix.data(), lambdas, vectors );
+   SymmetricEigenDecomposition( n, matrix, lambdas, vectors );
 }
 
 /// \brief Finds the eigenvalues and eigenvectors of a square real matrix.
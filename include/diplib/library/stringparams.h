@@ -37,6 +37,8 @@ namespace S {
 // Assorted
 constexpr char const* MINIMUM = "minimum";
 constexpr char const* MAXIMUM = "maximum";
+constexpr char const* SUM = "sum";
+constexpr char const* MEAN = "mean";
 constexpr char const* FIRST = "first";
 constexpr char const* LAST = "last";
 constexpr char const* STABLE = "stable";
@@ -191,6 +191,11 @@ inline Image GeneralConvolution(
 ///
 /// `boundaryCondition` indicates how the boundary should be expanded in each dimension. See `dip::BoundaryCondition`.
 ///
+/// A rectangular kernel is applied as a separable filter, using a running sum along each dimension. Other kernels
+/// use running sums over the runs of the kernel's pixel table, or, for real-valued images and kernels with many
+/// runs but few corners, a summed-area table (integral image), where the cost per pixel depends only on the number
+/// of corners in the kernel's outline.
+///
 /// \see dip::ConvolveFT, dip::SeparableConvolution, dip::GeneralConvolution
 DIP_EXPORT void Uniform(
       Image const& in,
@@ -335,6 +340,43 @@ inline Image GaussIIR(
    return out;
 }
 
+/// \brief Parameters to the cost model used to pick the best implementation of the Gaussian filter.
+///
+/// The cost of each of the implementations is modeled as a time per image pixel, in nanoseconds. For the
+/// separable implementations, it is the cost of filtering along one dimension:
+///
+/// - FIR: `firPerPixel + firPerTap * kernelSize`, with `kernelSize` the length of the 1D kernel.
+/// - IIR: `iirPerPixel * ( 1 + 2 * border / size )`, where the border is the boundary extension added to
+///   each image line of length `size`.
+/// - FT: `ftPerPixel * log2( size )`, summed over all dimensions, this includes the forward and inverse transforms.
+///
+/// The default values are fixed, so that the choice of implementation is the same on every machine.
+/// `dip::CalibrateGaussCostModel` replaces them with values measured on the current machine, and
+/// `dip::SetGaussCostModel` sets them explicitly.
+///
+/// \see dip::Gauss, dip::GetGaussCostModel, dip::SetGaussCostModel, dip::CalibrateGaussCostModel
+struct DIP_NO_EXPORT GaussCostModel {
+   dfloat firPerPixel = 4.0;      ///< Cost of the FIR implementation per pixel, independent of the kernel size.
+   dfloat firPerTap = 1.0;        ///< Cost of the FIR implementation per pixel and per kernel tap.
+   dfloat iirPerPixel = 25.0;     ///< Cost of the IIR implementation per pixel.
+   dfloat ftPerPixel = 6.0;       ///< Cost of the FT implementation per pixel and per unit of `log2( size )`.
+   dfloat iirMinimumSigma = 10.0; ///< The IIR implementation is only used for larger sigma, as it is less precise.
+};
+
+/// \brief Returns the cost model used by `dip::Gauss` to pick the best implementation.
+DIP_EXPORT GaussCostModel GetGaussCostModel();
+
+/// \brief Sets the cost model used by `dip::Gauss` to pick the best implementation, see `dip::GaussCostModel`.
+DIP_EXPORT void SetGaussCostModel( GaussCostModel const& model );
+
+/// \brief Calibrates the cost model used by `dip::Gauss` to pick the best implementation, by timing each of the
+/// implementations on a small image. This takes a few milliseconds.
+///
+/// The calibrated model is set (as with `dip::SetGaussCostModel`) and returned. `dip::GaussCostModel::iirMinimumSigma`
+/// is not changed. Note that, after calibration, the method chosen, and thus the exact output values, can differ
+/// between machines and between runs.
+DIP_EXPORT GaussCostModel CalibrateGaussCostModel();
+
 /// \brief Convolution with a Gaussian kernel and its derivatives
 ///
 /// Convolves the image with a Gaussian kernel. For each dimension, provide a value in `sigmas` and
@@ -346,11 +388,18 @@ inline Image GaussIIR(
 /// - `"FIR"`: Finite impulse response implementation, see `dip::GaussFIR`.
 /// - `"IIR"`: Infinite impulse response implementation, see `dip::GaussIIR`.
 /// - `"FT"`: Fourier domain implementation, see `dip::GaussFT`.
-/// - `"best"`: Picks the best method, according to the values of `sigmas` and `derivativeOrder`:
+/// - `"best"`: Picks the best method, according to the values of `sigmas` and `derivativeOrder`, and the
+///   image sizes:
 ///     - if any `derivativeOrder` is larger than 3, use the FT method,
 ///     - else if any `sigmas` is smaller than 0.8, use the FT method,
-///     - else if any `sigmas` is larger than 10, use the IIR method,
-///     - else use the FIR method.
+///     - else, for each dimension, use the FIR or IIR method, whichever is cheaper according to the cost model
+///       (see `dip::GaussCostModel`). Different dimensions can use different methods. The IIR method is only
+///       considered if sigma is larger than `dip::GaussCostModel::iirMinimumSigma` (10 by default),
+///     - if `boundaryCondition` is `"periodic"` along all dimensions, and the FT method is cheaper than the
+///       combination chosen above, use the FT method instead.
+///
+///   With the default cost model, the choice is the same on all machines. If the cost model is calibrated with
+///   `dip::CalibrateGaussCostModel`, the method chosen, and thus the exact output values, can differ between machines.
 ///
 /// `boundaryCondition` indicates how the boundary should be expanded in each dimension. See `dip::BoundaryCondition`.
 ///
@@ -689,6 +738,10 @@ inline Image Dyz(
 /// By default uses Gaussian derivatives in the computation. Set `method = "finitediff"` for finite difference
 /// approximations to the gradient. See `dip::Derivative` for more information on the other parameters.
 ///
+/// When the Gaussian derivatives are computed with the FIR or IIR implementation, the one-dimensional filter passes
+/// that the tensor components have in common (e.g. the smoothing along *x* for all but the first component) are
+/// computed only once.
+///
 /// \see dip::Derivative, dip::Hessian, dip::GradientMagnitude, dip::GradientDirection2D
 DIP_EXPORT void Gradient(
       Image const& in,
@@ -869,7 +922,8 @@ inline Image Divergence(
 ///
 /// By default this function uses Gaussian derivatives in the computation. Set `method = "finitediff"` for
 /// finite difference approximations to the gradient. See `dip::Derivative` for more information on the other
-/// parameters.
+/// parameters. As in `dip::Gradient`, the FIR and IIR implementations of the Gaussian derivatives share the
+/// one-dimensional filter passes that tensor components have in common.
 ///
 /// The input image must be scalar.
 ///
@@ -412,6 +412,9 @@ inline Image Rank( Image const& in ) {
 /// `out` is a vector image containing the eigenvalues. If `in` is symmetric and
 /// real-valued, then `out` is real-valued, and the eigenvalues are in descending
 /// order. Otherwise, `out` is complex-valued, and not sorted in any specific way.
+///
+/// For real-valued, symmetric 2x2 and 3x3 matrices, a closed-form solution is used. If `in` is
+/// of a single-precision type (or an integer type), the computations are done in single precision.
 DIP_EXPORT void Eigenvalues( Image const& in, Image& out );
 inline Image Eigenvalues( Image const& in ) {
    Image out;
@@ -430,6 +433,9 @@ inline Image Eigenvalues( Image const& in ) {
 /// order. Otherwise, `out` is complex-valued, and not sorted in any specific way.
 ///
 /// The eigenvectors are the columns `eigenvectors`. It has the same data type as `out`.
+///
+/// For real-valued, symmetric 2x2 and 3x3 matrices, a closed-form solution is used, see `dip::Eigenvalues`.
+/// The sign of the eigenvectors is chosen such that their largest component is positive.
 DIP_EXPORT void EigenDecomposition( Image const& in, Image& out, Image& eigenvectors );
 
 /// \brief Finds the largest eigenvector of the symmetric matrix at each pixel in image `in`.
@@ -454,7 +460,7 @@ inline Image LargestEigenVector( Image const& in ) {
 DIP_EXPORT void SmallestEigenVector( Image const& in, Image& out );
 inline Image SmallestEigenVector( Image const& in ) {
    Image out;
-   LargestEigenVector( in, out );
+   SmallestEigenVector( in, out );
    return out;
 }
 
@@ -21,6 +21,7 @@
 #ifndef DIP_MEASUREMENT_H
 #define DIP_MEASUREMENT_H
 
+#include <limits>
 #include <map>
 
 #include "diplib.h"
@@ -689,6 +690,9 @@ class DIP_CLASS_EXPORT LineBased : public Base {
       /// elements, where measurements are accumulated. The `dip::Feature::LineBased::Finish`
       /// function is called after the whole image has been scanned, and should provide the
       /// final measurement result for one object given its index (not object ID).
+      ///
+      /// If `dip::Feature::LineBased::UsesObjectIndices` returns true, `dip::MeasurementTool` calls
+      /// `dip::Feature::LineBased::ScanObjectIndices` instead of this function.
       virtual void ScanLine(
             LineIterator< uint32 > label, ///< Pointer to the line in the labeled image (always scalar)
             LineIterator< dfloat > grey, ///< Pointer to the line in the grey-value image (if given, invalid otherwise)
@@ -697,6 +701,29 @@ class DIP_CLASS_EXPORT LineBased : public Base {
             ObjectIdToIndexMap const& objectIndices ///< A map from objectID (label) to index
       ) = 0;
 
+      /// \brief Value in the `objectIndex` line for pixels that are not part of an object being measured.
+      static constexpr uint32 NO_OBJECT = std::numeric_limits< uint32 >::max();
+
+      /// \brief Returns true if `dip::MeasurementTool` should call `dip::Feature::LineBased::ScanObjectIndices`
+      /// instead of `dip::Feature::LineBased::ScanLine`. The default implementation returns false.
+      virtual bool UsesObjectIndices() const { return false; }
+
+      /// \brief Alternative to `dip::Feature::LineBased::ScanLine`, called instead of it if
+      /// `dip::Feature::LineBased::UsesObjectIndices` returns true.
+      ///
+      /// Instead of the label line, `objectIndex` contains, for each pixel, the index of the object
+      /// it belongs to, or `NO_OBJECT` for background pixels and pixels of objects that are not being
+      /// measured. The `dip::MeasurementTool` looks up the object index once for each run of pixels with
+      /// the same label, for all line-based features together, which is cheaper than each feature looking
+      /// up labels in a `dip::ObjectIdToIndexMap`. The other parameters are as for `ScanLine`.
+      /// The default implementation does nothing.
+      virtual void ScanObjectIndices(
+            LineIterator< uint32 > objectIndex,
+            LineIterator< dfloat > grey,
+            UnsignedArray coordinates,
+            dip::uint dimension
+      );
+
       /// \brief Called once for each object, to finalize the measurement
       virtual void Finish( dip::uint objectIndex, Measurement::ValueIterator output ) = 0;
 };
@@ -30,6 +30,7 @@
 // We don't have OpenMP, these are OpenMP function stubs to avoid conditional compilation elsewhere.
 inline int omp_get_thread_num() { return 0; }
 inline int omp_get_max_threads() { return 1; }
+inline int omp_in_parallel() { return 0; }
 #endif
 
 
@@ -57,6 +58,9 @@ namespace dip {
 ///
 /// If `nThreads` is 0, resets the maximum number of threads to the default value.
 ///
+/// The value set does not apply to *DIPlib* functions called from within an OpenMP parallel region, these
+/// always run in a single thread; see `dip::GetNumberOfThreads`.
+///
 /// If DIPlib was compiled without OpenMP support, this function does nothing.
 DIP_EXPORT void SetNumberOfThreads( dip::uint nThreads );
 
@@ -66,6 +70,12 @@ DIP_EXPORT void SetNumberOfThreads( dip::uint nThreads );
 /// Returns the value given in the last call to `dip::SetNumberOfThreads`, or the default maximum value if that
 /// function was never called.
 ///
+/// When called from within an OpenMP parallel region (for example when a *DIPlib* function is called from
+/// within a `#pragma omp parallel` block, or by a function that processes multiple images in parallel),
+/// returns 1. Nested parallel regions run with a single thread, and the algorithms that use this value
+/// divide their work over the number of threads requested, so they would otherwise leave part of the
+/// work undone.
+///
 /// If DIPlib was compiled without OpenMP support, this function always returns 1.
 DIP_EXPORT dip::uint GetNumberOfThreads();
 
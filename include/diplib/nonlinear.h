@@ -100,7 +100,10 @@ inline Image MedianFilter(
 ///
 /// `boundaryCondition` indicates how the boundary should be expanded in each dimension. See `dip::BoundaryCondition`.
 ///
-/// Uses `dip::FastVarianceAccumulator` for the computation.
+/// Uses `dip::FastVarianceAccumulator` for the computation, with running sums over the runs of the kernel's pixel
+/// table. For kernels with many runs but few corners, such as large rectangles, the sums are instead computed from
+/// summed-area tables (integral images) of the image and its square, at a cost per pixel that is independent of
+/// the kernel size. These tables are accumulated in double precision after subtracting the image mean.
 DIP_EXPORT void VarianceFilter(
       Image const& in,
       Image& out,
@@ -130,6 +133,11 @@ inline Image VarianceFilter(
 /// and at the same distance to the central pixel are solved arbitrarily (in the current implementation, the first
 /// of these pixels encountered is used).
 ///
+/// For kernels with long pixel table runs (such as large rectangular or elliptic kernels), the extremum within each
+/// run is updated incrementally as the kernel slides along the image line, such that the computational cost is
+/// proportional to the number of runs rather than the number of pixels in the kernel. The result is identical to
+/// that of examining each pixel in the kernel.
+///
 /// The Kuwahara-Nagao operator (see `dip::Kuwahara`) is implemented in terms of the `%SelectionFilter`:
 ///
 /// ```cpp
@@ -296,6 +304,11 @@ inline Image NonMaximumSuppression(
 ///
 /// The diffusion is generalized to any image dimensionality. `in` must be scalar and real-valued.
 ///
+/// Multiple iterations are computed in a temporally blocked manner: the image is divided into tiles, and several
+/// iterations are applied to each tile (plus a halo of the appropriate width) while it resides in the cache.
+/// Tiles are processed in parallel. The result is identical to that of calling this function repeatedly with
+/// `iterations` set to 1.
+///
 /// **Literature**
 /// - P. Perona and J. Malik, "Scale-Space and Edge Detection Using Anisotropic Diffusion",
 ///   IEEE Transactions on Pattern Analysis and Machine Intelligence 12(7):629:639, 1990.
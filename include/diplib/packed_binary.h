@@ -0,0 +1,271 @@
+/*
+ * DIPlib 3.0
+ * This file contains declarations for the packed binary image and the functions that operate on it
+ *
+ * (c)2026, Cris Luengo.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#ifndef DIP_PACKED_BINARY_H
+#define DIP_PACKED_BINARY_H
+
+#include <cstdint>
+#include <vector>
+
+#include "diplib.h"
+
+
+/// \file
+/// \brief A binary image representation with one bit per pixel, and the binary morphology that works on it.
+/// \see binary
+
+
+namespace dip {
+
+
+/// \addtogroup binary
+/// \{
+
+
+/// \brief A binary image that stores 64 pixels in each 64-bit word.
+///
+/// A `dip::Image` of type `dip::DT_BIN` uses one byte per pixel. `%PackedBinaryImage` uses one bit per pixel,
+/// such that the logical operators and the binary morphology functions declared in this file process 64 pixels
+/// with each word operation. It is meant as a working representation for algorithms that apply many binary
+/// operations in sequence. Convert a `dip::DT_BIN` image with the constructor, and convert back with `Unpack`.
+///
+/// Its interface is much more limited than that of `dip::Image`: it is always scalar, it owns its data (there
+/// are no views), and the only metadata it keeps is the pixel size.
+///
+/// The pixels are stored as image lines along dimension 0. Each line starts at a new word, pixel `x` of the
+/// line is in bit `x % 64` of word `x / 64`. The bits past the end of the line in the last word are always
+/// zero. Lines are stored one after the other, in the linear order of their coordinates along the other
+/// dimensions (dimension 1 varies fastest).
+class DIP_NO_EXPORT PackedBinaryImage {
+   public:
+      /// \brief The type of the words that the pixels are packed in.
+      using Word = std::uint64_t;
+      /// \brief The number of pixels stored in each `Word`.
+      static constexpr dip::uint wordBits = 64;
+
+      /// \brief The default-initialized image is not forged, it has no sizes and no pixels.
+      PackedBinaryImage() = default;
+
+      /// \brief Creates an image of the given sizes, with all pixels set to `value`.
+      DIP_EXPORT explicit PackedBinaryImage( UnsignedArray const& sizes, bool value = false );
+
+      /// \brief Packs the binary image `image`, which must be forged, scalar and of type `dip::DT_BIN`.
+      DIP_EXPORT explicit PackedBinaryImage( Image const& image );
+
+      /// \brief Unpacks the image into `out`, which will be a scalar `dip::DT_BIN` image of the same sizes.
+      DIP_EXPORT void Unpack( Image& out ) const;
+      Image Unpack() const {
+         Image out;
+         Unpack( out );
+         return out;
+      }
+
+      /// \brief Returns true if the image has pixels.
+      bool IsForged() const { return !sizes_.empty(); }
+
+      /// \brief Returns the image sizes.
+      UnsignedArray const& Sizes() const { return sizes_; }
+
+      /// \brief Returns the number of image dimensions.
+      dip::uint Dimensionality() const { return sizes_.size(); }
+
+      /// \brief Returns the number of pixels in the image.
+      dip::uint NumberOfPixels() const { return IsForged() ? sizes_[ 0 ] * nLines_ : 0; }
+
+      /// \brief Returns the number of image lines along dimension 0.
+      dip::uint NumberOfLines() const { return nLines_; }
+
+      /// \brief Returns the number of words used to store an image line.
+      dip::uint WordsPerLine() const { return wordsPerLine_; }
+
+      /// \brief Returns a pointer to the first word of image line `line`.
+      Word* Line( dip::uint line ) { return data_.data() + line * wordsPerLine_; }
+      Word const* Line( dip::uint line ) const { return data_.data() + line * wordsPerLine_; }
+
+      /// \brief Returns the value of the pixel at `coords`.
+      bool At( UnsignedArray const& coords ) const {
+         dip::uint x = coords[ 0 ];
+         return (( Line( LineIndex( coords ))[ x / wordBits ] >> ( x % wordBits )) & 1u ) != 0;
+      }
+
+      /// \brief Sets the value of the pixel at `coords`.
+      void Set( UnsignedArray const& coords, bool value ) {
+         dip::uint x = coords[ 0 ];
+         Word& word = Line( LineIndex( coords ))[ x / wordBits ];
+         Word bit = Word( 1 ) << ( x % wordBits );
+         word = value ? ( word | bit ) : ( word & ~bit );
+      }
+
+      /// \brief Returns the pixel size.
+      dip::PixelSize const& PixelSize() const { return pixelSize_; }
+
+      /// \brief Sets the pixel size.
+      void SetPixelSize( dip::PixelSize const& pixelSize ) { pixelSize_ = pixelSize; }
+
+      /// \brief Returns the number of set pixels.
+      DIP_EXPORT dip::uint Count() const;
+
+      /// \brief Inverts all pixels.
+      DIP_EXPORT PackedBinaryImage& Invert();
+
+      /// \brief Logical AND with `other`, which must have the same sizes.
+      DIP_EXPORT PackedBinaryImage& operator&=( PackedBinaryImage const& other );
+
+      /// \brief Logical OR with `other`, which must have the same sizes.
+      DIP_EXPORT PackedBinaryImage& operator|=( PackedBinaryImage const& other );
+
+      /// \brief Logical XOR with `other`, which must have the same sizes.
+      DIP_EXPORT PackedBinaryImage& operator^=( PackedBinaryImage const& other );
+
+      /// \brief Compares the sizes and the pixel values of two images.
+      bool operator==( PackedBinaryImage const& other ) const {
+         return ( sizes_ == other.sizes_ ) && ( data_ == other.data_ );
+      }
+      bool operator!=( PackedBinaryImage const& other ) const {
+         return !( *this == other );
+      }
+
+   private:
+      UnsignedArray sizes_;
+      dip::uint wordsPerLine_ = 0;
+      dip::uint nLines_ = 0;
+      std::vector< Word > data_;
+      dip::PixelSize pixelSize_;
+
+      dip::uint LineIndex( UnsignedArray const& coords ) const {
+         DIP_ASSERT( coords.size() == sizes_.size() );
+         dip::uint line = 0;
+         for( dip::uint ii = sizes_.size() - 1; ii > 0; --ii ) {
+            line = line * sizes_[ ii ] + coords[ ii ];
+         }
+         return line;
+      }
+
+      void ClearPadding(); // Sets the bits past the end of each line to zero
+};
+
+inline PackedBinaryImage operator&( PackedBinaryImage const& lhs, PackedBinaryImage const& rhs ) {
+   PackedBinaryImage out = lhs;
+   out &= rhs;
+   return out;
+}
+inline PackedBinaryImage operator|( PackedBinaryImage const& lhs, PackedBinaryImage const& rhs ) {
+   PackedBinaryImage out = lhs;
+   out |= rhs;
+   return out;
+}
+inline PackedBinaryImage operator^( PackedBinaryImage const& lhs, PackedBinaryImage const& rhs ) {
+   PackedBinaryImage out = lhs;
+   out ^= rhs;
+   return out;
+}
+inline PackedBinaryImage operator~( PackedBinaryImage const& in ) {
+   PackedBinaryImage out = in;
+   out.Invert();
+   return out;
+}
+
+/// \brief Binary morphological dilation operation on a packed binary image.
+///
+/// Produces the same result as the `dip::Image` version of `dip::BinaryDilation`, but processes 64 pixels at
+/// the time. Each iteration ORs together the shifted copies of the image, shifts along dimension 0 are bit
+/// shifts, shifts along other dimensions select other image lines.
+DIP_EXPORT PackedBinaryImage BinaryDilation(
+      PackedBinaryImage const& in,
+      dip::sint connectivity = -1,
+      dip::uint iterations = 3,
+      String const& edgeCondition = S::BACKGROUND
+);
+
+/// \brief Binary morphological erosion operation on a packed binary image.
+///
+/// Produces the same result as the `dip::Image` version of `dip::BinaryErosion`. Implemented as the dilation
+/// of the inverted image.
+DIP_EXPORT PackedBinaryImage BinaryErosion(
+      PackedBinaryImage const& in,
+      dip::sint connectivity = -1,
+      dip::uint iterations = 3,
+      String const& edgeCondition = S::OBJECT
+);
+
+/// \brief Binary morphological closing operation on a packed binary image.
+///
+/// Produces the same result as the `dip::Image` version of `dip::BinaryClosing`.
+DIP_EXPORT PackedBinaryImage BinaryClosing(
+      PackedBinaryImage const& in,
+      dip::sint connectivity = -1,
+      dip::uint iterations = 3,
+      String const& edgeCondition = S::SPECIAL
+);
+
+/// \brief Binary morphological opening operation on a packed binary image.
+///
+/// Produces the same result as the `dip::Image` version of `dip::BinaryOpening`.
+DIP_EXPORT PackedBinaryImage BinaryOpening(
+      PackedBinaryImage const& in,
+      dip::sint connectivity = -1,
+      dip::uint iterations = 3,
+      String const& edgeCondition = S::SPECIAL
+);
+
+/// \brief Morphological propagation of binary objects in a packed binary image.
+///
+/// Produces the same result as the `dip::Image` version of `dip::BinaryPropagation`. To use no seeds, pass
+/// a default-initialized `dip::PackedBinaryImage`.
+///
+/// When `iterations` is 0 and `connectivity` is not negative, the propagation alternates forward and backward
+/// raster scans over the image lines. Each line receives the propagation from its neighboring lines, and then
+/// propagates along the line over the runs of mask pixels, 64 pixels at the time. This repeats until a scan
+/// makes no changes. For an alternating connectivity, the result depends on the order in which pixels are
+/// reached, and the propagation is done one iteration at the time, as in the `dip::Image` version.
+DIP_EXPORT PackedBinaryImage BinaryPropagation(
+      PackedBinaryImage const& inSeed,
+      PackedBinaryImage const& inMask,
+      dip::sint connectivity = 1,
+      dip::uint iterations = 0,
+      String const& edgeCondition = S::BACKGROUND
+);
+
+/// \brief Counts the number of set neighbors for each pixel in the packed binary image `in`.
+///
+/// Produces the same result as the `dip::Image` version of `dip::CountNeighbors`. The counts are accumulated
+/// for 64 pixels at the time in bit-sliced counters.
+DIP_EXPORT void CountNeighbors(
+      PackedBinaryImage const& in,
+      Image& out,
+      dip::uint connectivity = 0,
+      dip::String const& mode = S::FOREGROUND,
+      dip::String const& edgeCondition = S::BACKGROUND
+);
+inline Image CountNeighbors(
+      PackedBinaryImage const& in,
+      dip::uint connectivity = 0,
+      dip::String const& mode = S::FOREGROUND,
+      dip::String const& edgeCondition = S::BACKGROUND
+) {
+   Image out;
+   CountNeighbors( in, out, connectivity, mode, edgeCondition );
+   return out;
+}
+
+/// \}
+
+} // namespace dip
+
+#endif // DIP_PACKED_BINARY_H
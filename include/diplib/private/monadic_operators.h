@@ -41,6 +41,14 @@
    DIP_EXPORT void functionName_( Image const& in, Image& out ); \
    inline Image functionName_( Image const& in ) { Image out; functionName_( in, out ); return out; }
 
+#define DIP__MONADIC_OPERATOR_FLEX_WITH_KERNEL( functionName_, functionLambda_, inputDomain_, cost_, kernel_ ) \
+   DIP_EXPORT void functionName_( Image const& in, Image& out ); \
+   inline Image functionName_( Image const& in ) { Image out; functionName_( in, out ); return out; }
+
+#define DIP__MONADIC_OPERATOR_FLOAT_WITH_KERNEL( functionName_, functionLambda_, inputDomain_, cost_, kernel_ ) \
+   DIP_EXPORT void functionName_( Image const& in, Image& out ); \
+   inline Image functionName_( Image const& in ) { Image out; functionName_( in, out ); return out; }
+
 #define DIP__MONADIC_OPERATOR_FLOAT_WITH_PARAM( functionName_, paramType_, paramName_, functionLambda_, inputDomain_, cost_ ) \
    DIP_EXPORT void functionName_( Image const& in, Image& out, paramType_ paramName_ ); \
    inline Image functionName_( Image const& in, paramType_ paramName_ ) { Image out; functionName_( in, out, paramName_ ); return out; }
@@ -83,25 +91,25 @@ DIP__MONADIC_OPERATOR_FLEX( Reciprocal, []( auto its ) { return dipm__Reciprocal
 DIP__MONADIC_OPERATOR_FLEX( Square, []( auto its ) { return *its[ 0 ] * *its[ 0 ]; }, DataType::Class_NonBinary, 1 )
 
 /// \brief Computes the square root of each sample.
-DIP__MONADIC_OPERATOR_FLEX( Sqrt, []( auto its ) { return std::sqrt( *its[ 0 ] ); }, DataType::Class_NonBinary, 20 )
+DIP__MONADIC_OPERATOR_FLEX_WITH_KERNEL( Sqrt, []( auto its ) { return std::sqrt( *its[ 0 ] ); }, DataType::Class_NonBinary, 20, SQRT )
 
 /// \brief Computes the base e exponent (natural exponential) of each sample.
-DIP__MONADIC_OPERATOR_FLEX( Exp, []( auto its ) { return std::exp( *its[ 0 ] ); }, DataType::Class_NonBinary, 20 )
+DIP__MONADIC_OPERATOR_FLEX_WITH_KERNEL( Exp, []( auto its ) { return std::exp( *its[ 0 ] ); }, DataType::Class_NonBinary, 20, EXP )
 
 /// \brief Computes the base 2 exponent of each sample.
-DIP__MONADIC_OPERATOR_FLOAT( Exp2, []( auto its ) { return std::exp2( *its[ 0 ] ); }, DataType::Class_Real, 20 )
+DIP__MONADIC_OPERATOR_FLOAT_WITH_KERNEL( Exp2, []( auto its ) { return std::exp2( *its[ 0 ] ); }, DataType::Class_Real, 20, EXP2 )
 
 /// \brief Computes the base 10 exponent of each sample.
-DIP__MONADIC_OPERATOR_FLOAT( Exp10, []( auto its ) { return std::pow( decltype( *its[ 0 ] )( 10 ), *its[ 0 ] ); }, DataType::Class_Real, 20 )
+DIP__MONADIC_OPERATOR_FLOAT_WITH_KERNEL( Exp10, []( auto its ) { return std::pow( decltype( *its[ 0 ] )( 10 ), *its[ 0 ] ); }, DataType::Class_Real, 20, EXP10 )
 
 /// \brief Computes the natural logarithm (base e logarithm) of each sample.
-DIP__MONADIC_OPERATOR_FLEX( Ln, []( auto its ) { return std::log( *its[ 0 ] ); }, DataType::Class_NonBinary, 20 )
+DIP__MONADIC_OPERATOR_FLEX_WITH_KERNEL( Ln, []( auto its ) { return std::log( *its[ 0 ] ); }, DataType::Class_NonBinary, 20, LN )
 
 /// \brief Computes the base 2 logarithm of each sample.
-DIP__MONADIC_OPERATOR_FLOAT( Log2, []( auto its ) { return std::log( *its[ 0 ] ); }, DataType::Class_Real, 20 )
+DIP__MONADIC_OPERATOR_FLOAT_WITH_KERNEL( Log2, []( auto its ) { return std::log2( *its[ 0 ] ); }, DataType::Class_Real, 20, LOG2 )
 
 /// \brief Computes the base 10 logarithm of each sample.
-DIP__MONADIC_OPERATOR_FLOAT( Log10, []( auto its ) { return std::log10( *its[ 0 ] ); }, DataType::Class_Real, 20 )
+DIP__MONADIC_OPERATOR_FLOAT_WITH_KERNEL( Log10, []( auto its ) { return std::log10( *its[ 0 ] ); }, DataType::Class_Real, 20, LOG10 )
 
 /// \}
 
@@ -109,10 +117,10 @@ DIP__MONADIC_OPERATOR_FLOAT( Log10, []( auto its ) { return std::log10( *its[ 0
 /// \{
 
 /// \brief Computes the sine of each sample.
-DIP__MONADIC_OPERATOR_FLEX( Sin, []( auto its ) { return std::sin( *its[ 0 ] ); }, DataType::Class_NonBinary, 20 )
+DIP__MONADIC_OPERATOR_FLEX_WITH_KERNEL( Sin, []( auto its ) { return std::sin( *its[ 0 ] ); }, DataType::Class_NonBinary, 20, SIN )
 
 /// \brief Computes the cosine of each sample.
-DIP__MONADIC_OPERATOR_FLEX( Cos, []( auto its ) { return std::cos( *its[ 0 ] ); }, DataType::Class_NonBinary, 20 )
+DIP__MONADIC_OPERATOR_FLEX_WITH_KERNEL( Cos, []( auto its ) { return std::cos( *its[ 0 ] ); }, DataType::Class_NonBinary, 20, COS )
 
 /// \brief Computes the tangent of each sample.
 DIP__MONADIC_OPERATOR_FLEX( Tan, []( auto its ) { return std::tan( *its[ 0 ] ); }, DataType::Class_NonBinary, 20 )
@@ -157,10 +165,10 @@ DIP__MONADIC_OPERATOR_FLOAT_WITH_PARAM( BesselYN, dip::uint, alpha, [ alpha ]( a
 DIP__MONADIC_OPERATOR_FLOAT( LnGamma, []( auto its ) { return static_cast< decltype( *its[ 0 ] ) >( std::lgamma( *its[ 0 ] )); }, DataType::Class_Real, 100 )
 
 /// \brief Computes the error function of each sample.
-DIP__MONADIC_OPERATOR_FLOAT( Erf, []( auto its ) { return static_cast< decltype( *its[ 0 ] ) >( std::erf( *its[ 0 ] )); }, DataType::Class_Real, 50 )
+DIP__MONADIC_OPERATOR_FLOAT_WITH_KERNEL( Erf, []( auto its ) { return static_cast< decltype( *its[ 0 ] ) >( std::erf( *its[ 0 ] )); }, DataType::Class_Real, 50, ERF )
 
 /// \brief Computes the complementary error function of each sample.
-DIP__MONADIC_OPERATOR_FLOAT( Erfc, []( auto its ) { return static_cast< decltype( *its[ 0 ] ) >( std::erfc( *its[ 0 ] )); }, DataType::Class_Real, 50 )
+DIP__MONADIC_OPERATOR_FLOAT_WITH_KERNEL( Erfc, []( auto its ) { return static_cast< decltype( *its[ 0 ] ) >( std::erfc( *its[ 0 ] )); }, DataType::Class_Real, 50, ERFC )
 
 /// \brief Computes the sinc function of each sample. \f$\mathrm{sinc}(x) = \sin(x)/x\f$.
 DIP__MONADIC_OPERATOR_FLOAT( Sinc, []( auto its ) { return static_cast< decltype( *its[ 0 ] ) >( Sinc( *its[ 0 ] )); }, DataType::Class_Real, 22 )
@@ -185,5 +193,7 @@ DIP__MONADIC_OPERATOR_BIN( IsFinite, []( auto in ) { return dipm__IsFinite( in )
 
 #undef DIP__MONADIC_OPERATOR_FLEX
 #undef DIP__MONADIC_OPERATOR_FLOAT
+#undef DIP__MONADIC_OPERATOR_FLEX_WITH_KERNEL
+#undef DIP__MONADIC_OPERATOR_FLOAT_WITH_KERNEL
 #undef DIP__MONADIC_OPERATOR_FLOAT_WITH_PARAM
 #undef DIP__MONADIC_OPERATOR_BIN
@@ -52,7 +52,8 @@ namespace dip {
 /// streams. This causes those algorithms to not replicate the same sequence when run with a different number
 /// of threads. Thus, even if seeded with the same value, the same algorithm can yield different results
 /// when run on a different computer with a different number of cores. To guarantee exact replicability,
-/// run your code single-threaded.
+/// run your code single-threaded. The noise generation functions such as `dip::GaussianNoise` do not split
+/// streams, they use a counter-based scheme that yields identical results for any number of threads.
 ///
 /// `%Random` has a 128-bit internal state, and produces 64-bit output with a period of 2<sup>128</sup>.
 /// On architectures where 128-bit integers are not natively supported, this changes to have a 64-bit internal state,
@@ -135,6 +135,11 @@ inline Image SmallObjectsRemove(
 /// The `connectivity` parameter defines the metric, that is, the shape of the structuring element
 /// (see \ref connectivity). Alternating connectivity is only implemented for 2D and 3D images.
 ///
+/// In each iteration, the pixels labeled in the previous iteration are divided over the available
+/// threads (see \ref multithreading). When two or more regions reach the same pixel in the same
+/// iteration, that pixel is assigned the smallest of their labels. Thus, the result does not depend
+/// on the number of threads used.
+///
 /// \see dip::GrowRegionsWeighted, dip::SeededWatershed
 DIP_EXPORT void GrowRegions(
       Image const& label,
@@ -158,8 +163,8 @@ inline Image GrowRegions(
 ///
 /// The regions in the input image `label` are grown according to a grey-weighted distance
 /// metric; the weights are given by `grey`. The optional mask image `mask` limits the
-/// growing (not yet implemented!). All three images must be scalar. `label` must be of
-/// an unsigned integer type, and `grey` must be real-valued.
+/// growing. All three images must be scalar. `label` must be of an unsigned integer type,
+/// and `grey` must be real-valued.
 ///
 /// `out` is of the type `dip::DT_LABEL`, and contains the grown regions.
 ///
@@ -167,6 +172,13 @@ inline Image GrowRegions(
 /// by default. See `dip::GreyWeightedDistanceTransform` for more information on how the
 /// grey-weighted distance is computed.
 ///
+/// If `grey` is of an unsigned integer type, and all neighbor distances in `metric` are integer
+/// (for example with `{ "connected", 1 }` and no pixel size), the cost of each step is an integer,
+/// and the regions are grown in a single pass using a bucket queue. This is significantly faster
+/// than the general algorithm, which computes the grey-weighted distance transform and then applies
+/// `dip::SeededWatershed`. A pixel that is equally distant to two regions can be assigned to
+/// either of them.
+///
 /// \see dip::GrowRegions, dip::SeededWatershed
 DIP_EXPORT void GrowRegionsWeighted(
       Image const& label,
@@ -22,6 +22,7 @@
 #define DIP_SEGMENTATION_H
 
 #include "diplib.h"
+#include "diplib/random.h"
 
 
 /// \file
@@ -52,18 +53,48 @@ namespace dip {
 /// suck in local minima. Repeating the clustering several times and picking the best result
 /// (e.g. determined by times each cluster center is found) can be necessary.
 ///
+/// For large images, set `sampleSize` to a value smaller than the number of pixels in `in`. The clustering will
+/// then first be done on a regularly subsampled version of the image with approximately `sampleSize` pixels,
+/// and the resulting cluster centers refined on the full image. This typically requires only a few passes over
+/// the full image. If `sampleSize` is 0 (the default), the full image is used from the start.
+///
+/// The image is processed in parallel. It is divided into a fixed number of chunks, each with its own set of
+/// accumulators, which are combined in a fixed order. Thus, the result does not depend on the number of threads used.
+///
 /// The returned `dip::CoordinateArray` contains the cluster centers.
+///
+/// The cluster centers are initialized using `random`. The overloads without this parameter use a randomly
+/// seeded generator.
 DIP_EXPORT CoordinateArray KMeansClustering(
       Image const& in,
       Image& out,
-      dip::uint nClusters = 2
+      Random& random,
+      dip::uint nClusters = 2,
+      dip::uint sampleSize = 0
 );
 inline Image KMeansClustering(
       Image const& in,
-      dip::uint nClusters = 2
+      Random& random,
+      dip::uint nClusters = 2,
+      dip::uint sampleSize = 0
+) {
+   Image out;
+   KMeansClustering( in, out, random, nClusters, sampleSize );
+   return out;
+}
+DIP_EXPORT CoordinateArray KMeansClustering(
+      Image const& in,
+      Image& out,
+      dip::uint nClusters = 2,
+      dip::uint sampleSize = 0
+);
+inline Image KMeansClustering(
+      Image const& in,
+      dip::uint nClusters = 2,
+      dip::uint sampleSize = 0
 ) {
    Image out;
-   KMeansClustering( in, out, nClusters );
+   KMeansClustering( in, out, nClusters, sampleSize );
    return out;
 }
 
@@ -441,6 +472,12 @@ inline Image Threshold(
 /// Here we provide an obvious extension to arbitrary dimensions. The final homotopic thinning is
 /// only applied in 2D and 3D, since `dip::EuclideanSkeleton` is not defined for other dimensionalities.
 ///
+/// For 2D images, if `dip::Gradient` would compute the gradient with FIR filters (see `dip::Gauss`),
+/// a fused implementation is used: the gradient, the non-maximum suppression and the selection of edge
+/// candidates are computed in a single parallel pass over the image, without storing the intermediate
+/// images, and the hysteresis threshold is computed only over the edge candidates. The result is the
+/// same as that of the generic implementation, up to rounding errors in the gradient.
+///
 /// **Literature**:
 /// - J. Canny, "A Computational Approach to Edge Detection", IEEE Transactions on Pattern Analysis
 ///   and Machine Intelligence, 8(6):679-697, 1986.
@@ -603,7 +603,7 @@ inline Image PositionMedian( Image const& in, Image const& mask, dip::uint dim,
 ///
 /// The output datatype is DFLOAT for non-complex inputs and DCOMPLEX for complex inputs.
 ///
-/// \see dip::RadialMean, dip::GetCenter, dip::Sum
+/// \see dip::RadialMean, dip::RadialBinning, dip::GetCenter, dip::Sum
 DIP_EXPORT void RadialSum( Image const& in, Image const& mask, Image& out, dfloat binSize, String const& maxRadius = S::OUTERRADIUS, FloatArray const& center = {} );
 inline Image RadialSum( Image const& in, Image const& mask, dfloat binSize, String const& maxRadius = S::OUTERRADIUS, FloatArray const& center = {} ) {
    Image out;
@@ -625,7 +625,7 @@ inline Image RadialSum( Image const& in, Image const& mask, dfloat binSize, Stri
 ///
 /// The output datatype is DFLOAT for non-complex inputs and DCOMPLEX for complex inputs.
 ///
-/// \see dip::RadialSum, dip::GetCenter, dip::Mean
+/// \see dip::RadialSum, dip::RadialBinning, dip::GetCenter, dip::Mean
 DIP_EXPORT void RadialMean( Image const& in, Image const& mask, Image& out, dfloat binSize, String const& maxRadius = S::OUTERRADIUS, FloatArray const& center = {} );
 inline Image RadialMean( Image const& in, Image const& mask, dfloat binSize, String const& maxRadius = S::OUTERRADIUS, FloatArray const& center = {} ) {
    Image out;
@@ -647,7 +647,7 @@ inline Image RadialMean( Image const& in, Image const& mask, dfloat binSize, Str
 ///
 /// The output datatype is equal to the input datatype.
 ///
-/// \see dip::RadialMaximum, dip::GetCenter, dip::Minimum
+/// \see dip::RadialMaximum, dip::RadialBinning, dip::GetCenter, dip::Minimum
 DIP_EXPORT void RadialMinimum( Image const& in, Image const& mask, Image& out, dfloat binSize, String const& maxRadius = S::OUTERRADIUS, FloatArray const& center = {} );
 inline Image RadialMinimum( Image const& in, Image const& mask, dfloat binSize, String const& maxRadius = S::OUTERRADIUS, FloatArray const& center = {} ) {
    Image out;
@@ -669,7 +669,7 @@ inline Image RadialMinimum( Image const& in, Image const& mask, dfloat binSize,
 ///
 /// The output datatype is equal to the input datatype.
 ///
-/// \see dip::RadialMinimum, dip::GetCenter, dip::Maximum
+/// \see dip::RadialMinimum, dip::RadialBinning, dip::GetCenter, dip::Maximum
 DIP_EXPORT void RadialMaximum( Image const& in, Image const& mask, Image& out, dfloat binSize, String const& maxRadius = S::OUTERRADIUS, FloatArray const& center = {} );
 inline Image RadialMaximum( Image const& in, Image const& mask, dfloat binSize, String const& maxRadius = S::OUTERRADIUS, FloatArray const& center = {} ) {
    Image out;
@@ -677,6 +677,113 @@ inline Image RadialMaximum( Image const& in, Image const& mask, dfloat binSize,
    return out;
 }
 
+/// \brief Assigns the pixels of an image to radial bins, to compute radial projections of many images of the
+/// same sizes.
+///
+/// The constructor takes the image sizes and the `binSize`, `maxRadius` and `center` parameters as described for
+/// `dip::RadialSum`, and computes the bin index of each pixel once. `dip::RadialBinning::Project` then computes
+/// any combination of the radial sum, mean, minimum and maximum of an image with these sizes, in a single,
+/// multithreaded pass over the image.
+///
+/// ```cpp
+///     dip::RadialBinning binning( frames[ 0 ].Sizes(), 1.0 );
+///     for( auto const& frame : frames ) {
+///        dip::Image mean, maximum;
+///        dip::ImageRefArray out{ mean, maximum };
+///        binning.Project( dip::SquareModulus( dip::FourierTransform( frame )), {}, out, { "mean", "maximum" } );
+///        // ...
+///     }
+/// ```
+///
+/// `dip::RadialSum`, `dip::RadialMean`, `dip::RadialMinimum` and `dip::RadialMaximum` use this class.
+class DIP_NO_EXPORT RadialBinning {
+   public:
+      /// \brief Computes the radial bins for images of sizes `sizes`. See `dip::RadialSum` for the meaning
+      /// of the other parameters.
+      DIP_EXPORT RadialBinning(
+            UnsignedArray const& sizes,
+            dfloat binSize,
+            String const& maxRadius = S::OUTERRADIUS,
+            FloatArray center = {}
+      );
+
+      /// \brief Returns the sizes of the images that can be projected.
+      UnsignedArray const& Sizes() const { return binIndex_.Sizes(); }
+
+      /// \brief Returns the number of bins, the size of the output images.
+      dip::uint NumberOfBins() const { return nBins_; }
+
+      /// \brief Returns the center of the projection.
+      FloatArray const& Center() const { return center_; }
+
+      /// \brief Returns the bin index for each pixel, a `dip::DT_UINT32` image. Pixels beyond the maximum
+      /// radius have a value of `NumberOfBins()`.
+      Image const& BinIndex() const { return binIndex_; }
+
+      /// \brief Computes radial projections of `in`, one for each element of `statistics`, in a single pass.
+      ///
+      /// `statistics` elements can be `"sum"`, `"mean"`, `"minimum"` and `"maximum"`, `out` must have the same
+      /// number of elements. The sum and mean are of type `dip::DT_DFLOAT` for non-complex inputs, and
+      /// `dip::DT_DCOMPLEX` for complex inputs. The minimum and maximum have the input's data type, and are not
+      /// defined for complex inputs. If `mask` is forged, only the pixels selected by it are projected.
+      DIP_EXPORT void Project(
+            Image const& in,
+            Image const& mask,
+            ImageRefArray& out,
+            StringArray const& statistics
+      ) const;
+
+      /// \brief Computes the radial projection of the sum of the pixel values of `in`.
+      void Sum( Image const& in, Image const& mask, Image& out ) const {
+         ImageRefArray outar{ out };
+         Project( in, mask, outar, { S::SUM } );
+      }
+      Image Sum( Image const& in, Image const& mask = {} ) const {
+         Image out;
+         Sum( in, mask, out );
+         return out;
+      }
+
+      /// \brief Computes the radial projection of the mean of the pixel values of `in`.
+      void Mean( Image const& in, Image const& mask, Image& out ) const {
+         ImageRefArray outar{ out };
+         Project( in, mask, outar, { S::MEAN } );
+      }
+      Image Mean( Image const& in, Image const& mask = {} ) const {
+         Image out;
+         Mean( in, mask, out );
+         return out;
+      }
+
+      /// \brief Computes the radial projection of the minimum of the pixel values of `in`.
+      void Minimum( Image const& in, Image const& mask, Image& out ) const {
+         ImageRefArray outar{ out };
+         Project( in, mask, outar, { S::MINIMUM } );
+      }
+      Image Minimum( Image const& in, Image const& mask = {} ) const {
+         Image out;
+         Minimum( in, mask, out );
+         return out;
+      }
+
+      /// \brief Computes the radial projection of the maximum of the pixel values of `in`.
+      void Maximum( Image const& in, Image const& mask, Image& out ) const {
+         ImageRefArray outar{ out };
+         Project( in, mask, outar, { S::MAXIMUM } );
+      }
+      Image Maximum( Image const& in, Image const& mask = {} ) const {
+         Image out;
+         Maximum( in, mask, out );
+         return out;
+      }
+
+   private:
+      Image binIndex_;
+      dip::uint nBins_;
+      dfloat binSize_;
+      FloatArray center_;
+};
+
 /// \}
 
 
@@ -106,6 +106,15 @@ DIP_EXPORT dip::uint OptimalFourierTransformSize( dip::uint size );
 // TODO: port dip_HartleyTransform (dip_transform.h)
 // TODO: add wavelet transforms
 
+/// \brief Computes the Hough transform for circle centers.
+///
+/// Each set pixel in the 2D binary image `in` votes for all pixels along the line through it in the direction
+/// of the gradient, given by the 2-vector image `gv`. The output is an accumulator image of type `dip::DT_SFLOAT`
+/// and the same sizes as `in`, in which the centers of circles show up as local maxima. If `range` is given, it
+/// must contain two values, the minimum and maximum radius of the circles to look for; only pixels at a distance
+/// within this range vote.
+///
+/// The set pixels are divided over the threads, each of which accumulates into its own image.
 DIP_EXPORT void HoughTransformCircleCenters(
       Image const& in,
       Image const& gv,
@@ -122,6 +131,33 @@ inline Image HoughTransformCircleCenters(
    return out;
 }
 
+/// \brief Computes the Hough transform for lines.
+///
+/// Each set pixel in the 2D binary image `in` votes for all lines that pass through it. A line is parametrized by
+/// the angle \f$\theta\f$ of its normal and its signed distance \f$\rho\f$ to the center pixel of the image
+/// (at coordinates `in.Sizes() / 2`, using integer division), such that \f$x \cos\theta + y \sin\theta = \rho\f$
+/// with \f$x\f$ and \f$y\f$ relative to the center pixel.
+///
+/// The output is an accumulator image of type `dip::DT_SFLOAT`. Along the first dimension it has `nAngles`
+/// angles, sampled uniformly in the range \f$[0,\pi)\f$. Along the second dimension it has `2 * R + 1`
+/// distances in steps of one pixel, with \f$R\f$ the distance from the center pixel to the farthest image corner,
+/// rounded up; index `R` corresponds to \f$\rho = 0\f$. Straight lines in `in` show up as local maxima.
+///
+/// The set pixels are divided over the threads, each of which accumulates into its own image.
+DIP_EXPORT void HoughTransformLines(
+      Image const& in,
+      Image& out,
+      dip::uint nAngles = 180
+);
+inline Image HoughTransformLines(
+      Image const& in,
+      dip::uint nAngles = 180
+) {
+   Image out;
+   HoughTransformLines( in, out, nAngles );
+   return out;
+}
+
 /// \}
 
 } // namespace dip
@@ -130,4 +130,6 @@ void init_filtering( py::module& m ) {
    m.def( "OptimalFourierTransformSize", &dip::OptimalFourierTransformSize, "size"_a );
    m.def( "HoughTransformCircleCenters", py::overload_cast< dip::Image const&, dip::Image const&, dip::UnsignedArray const& >( &dip::HoughTransformCircleCenters ),
           "in"_a, "gv"_a, "range"_a = dip::UnsignedArray{} );
+   m.def( "HoughTransformLines", py::overload_cast< dip::Image const&, dip::uint >( &dip::HoughTransformLines ),
+          "in"_a, "nAngles"_a = 180 );
 }
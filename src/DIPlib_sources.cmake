@@ -14,11 +14,13 @@ set(DIPlib_sources_bogus
 ../include/diplib/display.h
 ../include/diplib/distance.h
 ../include/diplib/file_io.h
+../include/diplib/frame_sequence.h
 ../include/diplib/framework.h
 ../include/diplib/generation.h
 ../include/diplib/generic_iterators.h
 ../include/diplib/geometry.h
 ../include/diplib/histogram.h
+../include/diplib/instruction_set.h
 ../include/diplib/iterators.h
 ../include/diplib/kernel.h
 ../include/diplib/library/clamp_cast.h
@@ -47,6 +49,7 @@ set(DIPlib_sources_bogus
 ../include/diplib/neighborlist.h
 ../include/diplib/nonlinear.h
 ../include/diplib/overload.h
+../include/diplib/packed_binary.h
 ../include/diplib/pixel_table.h
 ../include/diplib/private/constfor.h
 ../include/diplib/private/monadic_operators.h
@@ -68,6 +71,7 @@ binary/binary_support.cpp
 binary/binary_support.h
 binary/bucket.h
 binary/count_neighbors.cpp
+binary/packed_binary.cpp
 binary/skeleton.cpp
 binary/sup_inf_generator.cpp
 binary/thick_thin_2D.cpp
@@ -86,6 +90,7 @@ distance/gdt.cpp
 distance/vdt.cpp
 file_io/file_io_support.cpp
 file_io/file_io_support.h
+file_io/frame_sequence.cpp
 file_io/ics.cpp
 file_io/tiff_read.cpp
 file_io/tiff_write.cpp
@@ -116,7 +121,11 @@ library/image_indexing.cpp
 library/image_manip.cpp
 library/image_views.cpp
 library/information.cpp
+library/instruction_set.cpp
+library/integral_image.cpp
+library/integral_image.h
 library/multithreading.cpp
+library/multiversion.h
 library/neighborhood.cpp
 library/physical_dimensions.cpp
 library/pixel_table.cpp
@@ -145,6 +154,8 @@ math/radial.cpp
 math/select.cpp
 math/statistics.cpp
 math/tensor_operators.cpp
+math/vectorized_math.cpp
+math/vectorized_math.h
 measurement/convex_hull.cpp
 measurement/feature_aspect_ratio_feret.h
 measurement/feature_bending_energy.h
@@ -175,6 +186,7 @@ measurement/feature_mean.h
 measurement/feature_min_val.h
 measurement/feature_minimum.h
 measurement/feature_mu.h
+measurement/feature_object_index_line_based.h
 measurement/feature_p2a.h
 measurement/feature_perimeter.h
 measurement/feature_podczeck_shapes.h
@@ -192,6 +204,8 @@ measurement/measure_chain_code.cpp
 measurement/measure_convex_hull.cpp
 measurement/measurement.cpp
 measurement/measurement_tool.cpp
+measurement/object_id_to_index_table.cpp
+measurement/object_id_to_index_table.h
 measurement/object_to_measurement.cpp
 microscopy/unmix_stains.cpp
 morphology/areaopening.cpp
@@ -210,6 +224,7 @@ nonlinear/anisotropic_diffusion.cpp
 nonlinear/kuwahara.cpp
 nonlinear/nonmaximumsuppression.cpp
 nonlinear/percentile.cpp
+nonlinear/temporal_filter.cpp
 nonlinear/variancefilter.cpp
 regions/grow_regions.cpp
 regions/label.cpp
@@ -221,6 +236,7 @@ segmentation/minimum_variance_partitioning.cpp
 segmentation/threshold.cpp
 support/math_functions.cpp
 support/matrix.cpp
+support/symmetric_eigensolver.h
 transform/fourier.cpp
 transform/hough.cpp
 transform/opencv_dxt.cpp
@@ -20,6 +20,7 @@
 
 #include "diplib.h"
 #include "diplib/analysis.h"
+#include "diplib/multithreading.h"
 #include "diplib/transform.h"
 #include "diplib/math.h"
 #include "diplib/statistics.h"
@@ -238,16 +239,35 @@ FloatArray FindShift_PROJ( Image const& in1, Image const& in2, dip::uint iterati
    return shift;
 }
 
+// Returns the Fourier transform `inFT` prepared to take the role of `in1` in the cross-correlation. For the
+// normalized cross-correlation it is divided by its square modulus, such that computing the cross-correlation
+// with another image requires a single multiplication.
+Image PrepareReferenceFT( Image const& inFT, bool normalize ) {
+   if( !normalize ) {
+      return inFT;
+   }
+   Image out = SquareModulus( inFT );
+   SafeDivide( inFT, out, out, inFT.DataType() );
+   return out;
+}
+
+// Computes the cross-correlation in the spatial domain from `in1FT`, as prepared by `PrepareReferenceFT`, and
+// the Fourier transform of the other image.
+Image CrossCorrelationFromFT( Image const& in1FT, Image const& in2FT ) {
+   Image out;
+   MultiplyConjugate( in1FT, in2FT, out, in1FT.DataType() );
+   FourierTransform( out, out, { "inverse", "real" } );
+   return out;
+}
+
+// Finds the shift as the location of the largest peak in the cross-correlation `cross`, within `maxShift` of
+// the origin.
 FloatArray FindShift_CC(
-      Image const& in1,
-      Image const& in2,
+      Image cross,
       UnsignedArray const& maxShift,
-      String const& normalize = S::DONT_NORMALIZE,
-      bool subpixelPrecision = false
+      bool subpixelPrecision
 ) {
-   dip::uint nDims = in1.Dimensionality();
-   Image cross;
-   DIP_STACK_TRACE_THIS( CrossCorrelationFT( in1, in2, cross, S::SPATIAL, S::SPATIAL, S::SPATIAL, normalize ));
+   dip::uint nDims = cross.Dimensionality();
    DIP_ASSERT( cross.DataType().IsReal() );
    UnsignedArray sizes = cross.Sizes();
    bool crop = false;
@@ -285,14 +305,13 @@ FloatArray FindShift_CC(
    return shift;
 }
 
-FloatArray CorrectIntegerShift(
+// Corrects for the integer shift `shift` by cropping both images to their common part.
+void CorrectIntegerShift(
       Image& in1,
       Image& in2,
-      UnsignedArray const& maxShift
+      FloatArray const& shift
 ) {
    dip::uint nDims = in1.Dimensionality();
-   FloatArray shift;
-   DIP_STACK_TRACE_THIS( shift = FindShift_CC( in1, in2, maxShift ));
    if( shift.any() ) {
       // Shift is non-zero along at least one dimension
       // Correct for this integer shift by cropping both images
@@ -310,42 +329,51 @@ FloatArray CorrectIntegerShift(
       in1.dip__SetSizes( sizes );
       in1.dip__SetOrigin( in1.Pointer( origin ));
    }
-   return shift;
 }
 
-} // namespace
+bool IsValidFindShiftMethod( String const& method ) {
+   return ( method == "integer only" ) || ( method == "CC" ) || ( method == "NCC" ) || ( method == "CPF" ) ||
+          ( method == "MTS" ) || ( method == "ITER" ) || ( method == "PROJ" );
+}
 
-FloatArray FindShift(
-      Image const& c_in1,
-      Image const& c_in2,
+void CheckFindShiftInputs( Image const& in1, Image const& in2 ) {
+   DIP_THROW_IF( !in1.IsForged() || !in2.IsForged(), E::IMAGE_NOT_FORGED );
+   DIP_THROW_IF( !in1.IsScalar() || !in2.IsScalar(), E::IMAGE_NOT_SCALAR );
+   DIP_THROW_IF( !in1.DataType().IsReal() || !in2.DataType().IsReal(), E::DATA_TYPE_NOT_SUPPORTED );
+   DIP_THROW_IF( in1.Sizes() != in2.Sizes(), E::SIZES_DONT_MATCH );
+}
+
+// Estimates the shift of `in2` with respect to `in1`, as `dip::FindShift` does. `in1FT` is the Fourier transform
+// of `in1` as prepared by `PrepareReferenceFT` (normalized only for the "NCC" method), `in2FT` is the Fourier
+// transform of `in2`. `method` must be valid, and `maxShift` must have one element per image dimension.
+FloatArray FindShiftFromFT(
+      Image const& in1,
+      Image const& in2,
+      Image const& in1FT,
+      Image const& in2FT,
       String const& method,
       dfloat parameter,
-      UnsignedArray maxShift
+      UnsignedArray const& maxShift
 ) {
-   DIP_THROW_IF( !c_in1.IsForged() || !c_in2.IsForged(), E::IMAGE_NOT_FORGED );
-   DIP_THROW_IF( !c_in1.IsScalar() || !c_in2.IsScalar(), E::IMAGE_NOT_SCALAR );
-   DIP_THROW_IF( !c_in1.DataType().IsReal() || !c_in2.DataType().IsReal(), E::DATA_TYPE_NOT_SUPPORTED );
-   DIP_THROW_IF( c_in1.Sizes() != c_in2.Sizes(), E::SIZES_DONT_MATCH );
-   dip::uint nDims = c_in1.Dimensionality();
-   DIP_STACK_TRACE_THIS( ArrayUseParameter( maxShift, nDims, std::numeric_limits< dip::uint >::max() ));
-   FloatArray shift( nDims, 0.0 );
+   FloatArray shift;
+   Image cross;
+   DIP_STACK_TRACE_THIS( cross = CrossCorrelationFromFT( in1FT, in2FT ));
    if( method == "integer only" ) {
-      DIP_STACK_TRACE_THIS( shift = FindShift_CC( c_in1, c_in2, maxShift, S::DONT_NORMALIZE, false ));
-   } else if( method == "CC" ) {
-      DIP_STACK_TRACE_THIS( shift = FindShift_CC( c_in1, c_in2, maxShift, S::DONT_NORMALIZE, true ));
-   } else if( method == "NCC" ) {
-      DIP_STACK_TRACE_THIS( shift = FindShift_CC( c_in1, c_in2, maxShift, S::NORMALIZE, true ));
+      DIP_STACK_TRACE_THIS( shift = FindShift_CC( cross, maxShift, false ));
+   } else if(( method == "CC" ) || ( method == "NCC" )) {
+      DIP_STACK_TRACE_THIS( shift = FindShift_CC( cross, maxShift, true ));
    } else {
-      Image in1 = c_in1.QuickCopy();
-      Image in2 = c_in2.QuickCopy();
-      DIP_STACK_TRACE_THIS( shift = CorrectIntegerShift( in1, in2, maxShift )); // modifies in1 and in2
+      Image c_in1 = in1.QuickCopy();
+      Image c_in2 = in2.QuickCopy();
+      DIP_STACK_TRACE_THIS( shift = FindShift_CC( cross, maxShift, false ));
+      CorrectIntegerShift( c_in1, c_in2, shift ); // modifies c_in1 and c_in2
       if( method == "CPF" ) {
-         DIP_STACK_TRACE_THIS( shift += FindShift_CPF( in1, in2, parameter ));
+         DIP_STACK_TRACE_THIS( shift += FindShift_CPF( c_in1, c_in2, parameter ));
       } else if( method == "MTS" ) {
          if( parameter <= 0.0 ) {
             parameter = 1.0;
          }
-         DIP_STACK_TRACE_THIS( shift += FindShift_MTS( in1, in2, 1, 0.0, parameter ));
+         DIP_STACK_TRACE_THIS( shift += FindShift_MTS( c_in1, c_in2, 1, 0.0, parameter ));
       } else {
          dip::uint maxIter = 5;  // default number of iteration => accuracy ~ 1e-4
          dfloat accuracy = 0.0;  // signals early break if bias correction is possible
@@ -357,17 +385,178 @@ FloatArray FindShift(
             accuracy = parameter;
          }
          if( method == "ITER" ) {
-            DIP_STACK_TRACE_THIS( shift += FindShift_MTS( in1, in2, maxIter, accuracy, 1.0 ));
-         } else if( method == "PROJ" ) {
-            DIP_STACK_TRACE_THIS( shift += FindShift_PROJ( in1, in2, maxIter, accuracy, 1.0 )); // calls FindShift_MTS
-         } else {
-            DIP_THROW_INVALID_FLAG( method );
+            DIP_STACK_TRACE_THIS( shift += FindShift_MTS( c_in1, c_in2, maxIter, accuracy, 1.0 ));
+         } else { // method == "PROJ"
+            DIP_STACK_TRACE_THIS( shift += FindShift_PROJ( c_in1, c_in2, maxIter, accuracy, 1.0 )); // calls FindShift_MTS
+         }
+      }
+   }
+   return shift;
+}
+
+// Calls `function( index )` for each of `n` indices, in parallel. Exceptions thrown are re-thrown once all threads
+// finished.
+template< typename F >
+void ParallelForEach( dip::uint n, F const& function ) {
+   if( n == 0 ) {
+      return;
+   }
+#ifdef DIP__HAS_FFTW
+   dip::uint nThreads = 1; // The FFTW planner is not thread safe
+#else
+   dip::uint nThreads = std::min( GetNumberOfThreads(), n );
+#endif
+   AssertionError assertionError;
+   ParameterError parameterError;
+   RunTimeError runTimeError;
+   Error error;
+   #pragma omp parallel for schedule( dynamic ) num_threads( static_cast< int >( nThreads ))
+   for( dip::sint ii = 0; ii < static_cast< dip::sint >( n ); ++ii ) {
+      try {
+         function( static_cast< dip::uint >( ii ));
+      } catch( dip::AssertionError const& e ) {
+         #pragma omp critical( ParallelForEach )
+         if( !assertionError.IsSet() ) {
+            assertionError = e;
+            DIP_ADD_STACK_TRACE( assertionError );
+         }
+      } catch( dip::ParameterError const& e ) {
+         #pragma omp critical( ParallelForEach )
+         if( !parameterError.IsSet() ) {
+            parameterError = e;
+            DIP_ADD_STACK_TRACE( parameterError );
+         }
+      } catch( dip::RunTimeError const& e ) {
+         #pragma omp critical( ParallelForEach )
+         if( !runTimeError.IsSet() ) {
+            runTimeError = e;
+            DIP_ADD_STACK_TRACE( runTimeError );
+         }
+      } catch( dip::Error const& e ) {
+         #pragma omp critical( ParallelForEach )
+         if( !error.IsSet() ) {
+            error = e;
+            DIP_ADD_STACK_TRACE( error );
+         }
+      } catch( std::exception const& stde ) {
+         #pragma omp critical( ParallelForEach )
+         if( !runTimeError.IsSet() ) {
+            runTimeError = dip::RunTimeError( stde.what() );
+            DIP_ADD_STACK_TRACE( runTimeError );
          }
       }
    }
+   if( assertionError.IsSet() ) {
+      throw assertionError;
+   }
+   if( parameterError.IsSet() ) {
+      throw parameterError;
+   }
+   if( runTimeError.IsSet() ) {
+      throw runTimeError;
+   }
+   if( error.IsSet() ) {
+      throw error;
+   }
+}
+
+} // namespace
+
+FloatArray FindShift(
+      Image const& in1,
+      Image const& in2,
+      String const& method,
+      dfloat parameter,
+      UnsignedArray maxShift
+) {
+   CheckFindShiftInputs( in1, in2 );
+   if( !IsValidFindShiftMethod( method )) {
+      DIP_THROW_INVALID_FLAG( method );
+   }
+   dip::uint nDims = in1.Dimensionality();
+   DIP_STACK_TRACE_THIS( ArrayUseParameter( maxShift, nDims, std::numeric_limits< dip::uint >::max() ));
+   FloatArray shift;
+   DIP_START_STACK_TRACE
+      Image in1FT = PrepareReferenceFT( FourierTransform( in1 ), method == "NCC" );
+      Image in2FT = FourierTransform( in2 );
+      shift = FindShiftFromFT( in1, in2, in1FT, in2FT, method, parameter, maxShift );
+   DIP_END_STACK_TRACE
+   return shift;
+}
+
+ShiftEstimator::ShiftEstimator(
+      Image const& reference,
+      String const& method,
+      dfloat parameter,
+      UnsignedArray maxShift
+) : reference_( reference ), method_( method ), parameter_( parameter ), maxShift_( std::move( maxShift )) {
+   DIP_THROW_IF( !reference_.IsForged(), E::IMAGE_NOT_FORGED );
+   DIP_THROW_IF( !reference_.IsScalar(), E::IMAGE_NOT_SCALAR );
+   DIP_THROW_IF( !reference_.DataType().IsReal(), E::DATA_TYPE_NOT_SUPPORTED );
+   if( !IsValidFindShiftMethod( method_ )) {
+      DIP_THROW_INVALID_FLAG( method_ );
+   }
+   DIP_STACK_TRACE_THIS( ArrayUseParameter( maxShift_, reference_.Dimensionality(), std::numeric_limits< dip::uint >::max() ));
+   DIP_STACK_TRACE_THIS( referenceFT_ = PrepareReferenceFT( FourierTransform( reference_ ), method_ == "NCC" ));
+}
+
+FloatArray ShiftEstimator::Estimate( Image const& in ) const {
+   CheckFindShiftInputs( reference_, in );
+   FloatArray shift;
+   DIP_START_STACK_TRACE
+      Image inFT = FourierTransform( in );
+      shift = FindShiftFromFT( reference_, in, referenceFT_, inFT, method_, parameter_, maxShift_ );
+   DIP_END_STACK_TRACE
    return shift;
 }
 
+FloatCoordinateArray ShiftEstimator::Estimate( ImageConstRefArray const& in ) const {
+   for( auto const& img : in ) {
+      CheckFindShiftInputs( reference_, img.get() );
+   }
+   FloatCoordinateArray shifts( in.size() );
+   ParallelForEach( in.size(), [ & ]( dip::uint ii ) {
+      Image inFT = FourierTransform( in[ ii ].get() );
+      shifts[ ii ] = FindShiftFromFT( reference_, in[ ii ].get(), referenceFT_, inFT, method_, parameter_, maxShift_ );
+   } );
+   return shifts;
+}
+
+FloatCoordinateArray ShiftEstimator::EstimateChained( ImageConstRefArray const& in ) const {
+   for( auto const& img : in ) {
+      CheckFindShiftInputs( reference_, img.get() );
+   }
+   // Each thread processes a contiguous block of images. Each image is compared to the previous one, whose
+   // Fourier transform we keep from the previous iteration. Only the first image of each block needs the
+   // Fourier transform of an image that is processed by another thread.
+   dip::uint nImages = in.size();
+   if( nImages == 0 ) {
+      return {};
+   }
+   dip::uint blockSize = div_ceil( nImages, std::min( GetNumberOfThreads(), nImages ));
+   dip::uint nBlocks = div_ceil( nImages, blockSize );
+   bool normalize = method_ == "NCC";
+   FloatCoordinateArray shifts( nImages );
+   ParallelForEach( nBlocks, [ & ]( dip::uint block ) {
+      dip::uint first = block * blockSize;
+      dip::uint last = std::min( first + blockSize, nImages );
+      Image previousFT = first == 0
+                         ? referenceFT_
+                         : PrepareReferenceFT( FourierTransform( in[ first - 1 ].get() ), normalize );
+      for( dip::uint ii = first; ii < last; ++ii ) {
+         Image const& previous = ii == 0 ? reference_ : in[ ii - 1 ].get();
+         Image inFT = FourierTransform( in[ ii ].get() );
+         shifts[ ii ] = FindShiftFromFT( previous, in[ ii ].get(), previousFT, inFT, method_, parameter_, maxShift_ );
+         previousFT = PrepareReferenceFT( inFT, normalize );
+      }
+   } );
+   // Accumulate the frame-to-frame shifts
+   for( dip::uint ii = 1; ii < nImages; ++ii ) {
+      shifts[ ii ] += shifts[ ii - 1 ];
+   }
+   return shifts;
+}
+
 } // namespace dip
 
 #ifdef DIP__ENABLE_DOCTEST
@@ -437,6 +626,41 @@ DOCTEST_TEST_CASE("[DIPlib] testing the FindShift fuction") {
    DOCTEST_REQUIRE( result.size() == 2 );
    DOCTEST_CHECK( std::abs( result[ 0 ] - shift[ 0 ] ) < 0.03 );
    DOCTEST_CHECK( std::abs( result[ 1 ] - shift[ 1 ] ) < 0.03 );
+
+   // ShiftEstimator recovers the known shift
+   dip::Image in3 = dip::Shift( in1, { -3.61, 2.45 }, "3-cubic" );
+   for( auto method : { std::make_pair( "NCC", 0.2 ), std::make_pair( "ITER", 0.002 ) } ) {
+      dip::ShiftEstimator estimator( in1, method.first );
+      result = estimator.Estimate( in2 );
+      DOCTEST_REQUIRE( result.size() == 2 );
+      DOCTEST_CHECK( std::abs( result[ 0 ] - shift[ 0 ] ) < method.second );
+      DOCTEST_CHECK( std::abs( result[ 1 ] - shift[ 1 ] ) < method.second );
+      // Reusing the estimator gives the same results as a fresh one
+      dip::FloatArray other = estimator.Estimate( in3 );
+      DOCTEST_CHECK( std::abs( other[ 0 ] + 3.61 ) < method.second );
+      DOCTEST_CHECK( std::abs( other[ 1 ] - 2.45 ) < method.second );
+      DOCTEST_CHECK( estimator.Estimate( in2 ) == result );
+      DOCTEST_CHECK( dip::ShiftEstimator( in1, method.first ).Estimate( in3 ) == other );
+   }
+
+   // A sequence of images drifting away from the reference
+   dip::ImageArray frames( 5 );
+   for( dip::uint ii = 0; ii < frames.size(); ++ii ) {
+      frames[ ii ] = dip::Shift( in1, { 1.3 * static_cast< dip::dfloat >( ii + 1 ), -0.7 * static_cast< dip::dfloat >( ii + 1 ) }, "3-cubic" );
+   }
+   dip::ShiftEstimator estimator( in1, "ITER" );
+   dip::FloatCoordinateArray shifts = estimator.Estimate( dip::CreateImageConstRefArray( frames ));
+   dip::FloatCoordinateArray chained = estimator.EstimateChained( dip::CreateImageConstRefArray( frames ));
+   DOCTEST_REQUIRE( shifts.size() == frames.size() );
+   DOCTEST_REQUIRE( chained.size() == frames.size() );
+   for( dip::uint ii = 0; ii < frames.size(); ++ii ) {
+      DOCTEST_CHECK( shifts[ ii ] == estimator.Estimate( frames[ ii ] ));
+      DOCTEST_CHECK( std::abs( shifts[ ii ][ 0 ] - 1.3 * static_cast< dip::dfloat >( ii + 1 )) < 0.01 );
+      DOCTEST_CHECK( std::abs( shifts[ ii ][ 1 ] + 0.7 * static_cast< dip::dfloat >( ii + 1 )) < 0.01 );
+      // Errors accumulate along the chain
+      DOCTEST_CHECK( std::abs( chained[ ii ][ 0 ] - 1.3 * static_cast< dip::dfloat >( ii + 1 )) < 0.05 );
+      DOCTEST_CHECK( std::abs( chained[ ii ][ 1 ] + 0.7 * static_cast< dip::dfloat >( ii + 1 )) < 0.05 );
+   }
 }
 
 #endif // DIP__ENABLE_DOCTEST
@@ -0,0 +1,729 @@
+/*
+ * DIPlib 3.0
+ * This file contains the packed binary image and the binary morphology on it.
+ *
+ * (c)2026, Cris Luengo.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "diplib.h"
+#include "diplib/packed_binary.h"
+#include "diplib/multithreading.h"
+#include "binary_support.h"
+
+namespace dip {
+
+namespace {
+
+using Word = PackedBinaryImage::Word;
+constexpr dip::uint wordBits = PackedBinaryImage::wordBits;
+constexpr Word allOnes = ~Word( 0 );
+
+// Mask for the valid bits in the last word of a line of `length` pixels
+Word LastWordMask( dip::uint length ) {
+   dip::uint n = length % wordBits;
+   return n == 0 ? allOnes : ( Word( 1 ) << n ) - 1;
+}
+
+dip::uint PopCount( Word word ) {
+   word = word - (( word >> 1 ) & 0x5555555555555555u );
+   word = ( word & 0x3333333333333333u ) + (( word >> 2 ) & 0x3333333333333333u );
+   word = ( word + ( word >> 4 )) & 0x0F0F0F0F0F0F0F0Fu;
+   return static_cast< dip::uint >(( word * 0x0101010101010101u ) >> 56 );
+}
+
+// Computes the coordinates of image line `line` along dimensions 1 and up; `coords[ 0 ]` is set to 0.
+void LineCoordinates( dip::uint line, UnsignedArray const& sizes, UnsignedArray& coords ) {
+   coords[ 0 ] = 0;
+   for( dip::uint ii = 1; ii < sizes.size(); ++ii ) {
+      coords[ ii ] = line % sizes[ ii ];
+      line /= sizes[ ii ];
+   }
+}
+
+// Offset to the first pixel of image line `line` in an image with the given strides
+dip::sint LineOffset( dip::uint line, UnsignedArray const& sizes, IntegerArray const& strides ) {
+   dip::sint offset = 0;
+   for( dip::uint ii = 1; ii < sizes.size(); ++ii ) {
+      offset += static_cast< dip::sint >( line % sizes[ ii ] ) * strides[ ii ];
+      line /= sizes[ ii ];
+   }
+   return offset;
+}
+
+// Calls `function( line )` for each image line, in parallel if the work is large enough.
+template< typename F >
+void ForEachLine( dip::uint nLines, dip::uint operations, F const& function ) {
+   dip::uint nThreads = std::min( GetNumberOfThreads(), nLines );
+   if( operations < threadingThreshold ) {
+      nThreads = 1;
+   }
+   #pragma omp parallel for schedule( static ) num_threads( static_cast< int >( nThreads ))
+   for( dip::sint line = 0; line < static_cast< dip::sint >( nLines ); ++line ) {
+      function( static_cast< dip::uint >( line ));
+   }
+}
+
+// A neighboring image line, and which of its pixels are neighbors. The neighborhood of pixel `x` contains
+// pixel `x` of this line if `center`, and pixels `x-1` and `x+1` of this line if `sides`.
+struct LineNeighbor {
+   IntegerArray offset; // offset along dimensions 1 and up, `offset[ 0 ]` is always 0
+   bool center;
+   bool sides;
+};
+using LineNeighborList = std::vector< LineNeighbor >;
+
+// The neighborhood given by `connectivity` as a set of neighboring image lines. The line itself is included
+// (with `center` false) if `includeSelf`.
+LineNeighborList GetLineNeighbors( dip::uint nDims, dip::uint connectivity, bool includeSelf ) {
+   if( connectivity == 0 ) {
+      connectivity = nDims;
+   }
+   dip::uint nOffsets = 1;
+   for( dip::uint ii = 1; ii < nDims; ++ii ) {
+      nOffsets *= 3;
+   }
+   LineNeighborList neighbors;
+   IntegerArray offset( nDims, 0 );
+   for( dip::uint index = 0; index < nOffsets; ++index ) {
+      dip::uint count = 0;
+      dip::uint digits = index;
+      for( dip::uint ii = 1; ii < nDims; ++ii ) {
+         offset[ ii ] = static_cast< dip::sint >( digits % 3 ) - 1;
+         digits /= 3;
+         if( offset[ ii ] != 0 ) {
+            ++count;
+         }
+      }
+      if(( count == 0 ) && !includeSelf ) {
+         continue;
+      }
+      LineNeighbor neighbor{ offset, ( count > 0 ) && ( count <= connectivity ), count < connectivity };
+      if( neighbor.center || neighbor.sides ) {
+         neighbors.push_back( std::move( neighbor ));
+      }
+   }
+   return neighbors;
+}
+
+dip::uint NumberOfNeighbors( LineNeighborList const& neighbors ) {
+   dip::uint n = 0;
+   for( auto const& neighbor : neighbors ) {
+      n += ( neighbor.center ? 1u : 0u ) + ( neighbor.sides ? 2u : 0u );
+   }
+   return n;
+}
+
+// Returns the image line at `coords + offset`, or `nullptr` if it is outside the image.
+Word const* NeighborLine( PackedBinaryImage const& image, UnsignedArray const& coords, IntegerArray const& offset ) {
+   UnsignedArray const& sizes = image.Sizes();
+   dip::uint line = 0;
+   for( dip::uint ii = sizes.size() - 1; ii > 0; --ii ) {
+      dip::sint pos = static_cast< dip::sint >( coords[ ii ] ) + offset[ ii ];
+      if(( pos < 0 ) || ( pos >= static_cast< dip::sint >( sizes[ ii ] ))) {
+         return nullptr;
+      }
+      line = line * sizes[ ii ] + static_cast< dip::uint >( pos );
+   }
+   return image.Line( line );
+}
+
+// Calls `op( ii, word )` for each word `ii` of the image line `src` of `length` pixels shifted by `shift`
+// pixels: the pixel at `x` gets the value of the pixel at `x + shift`. `src` is `nullptr` for a line outside
+// the image. Pixels outside the image have the value `edge`.
+template< typename F >
+void ForEachShiftedWord( Word const* src, dip::uint length, dip::sint shift, bool edge, F const& op ) {
+   dip::uint nWords = div_ceil( length, wordBits );
+   dip::uint last = nWords - 1;
+   Word lastMask = LastWordMask( length );
+   if( !src ) {
+      Word value = edge ? allOnes : 0;
+      for( dip::uint ii = 0; ii < last; ++ii ) {
+         op( ii, value );
+      }
+      op( last, value & lastMask );
+   } else if( shift < 0 ) {
+      Word carry = edge ? 1 : 0;
+      for( dip::uint ii = 0; ii < last; ++ii ) {
+         Word word = src[ ii ];
+         op( ii, ( word << 1 ) | carry );
+         carry = word >> ( wordBits - 1 );
+      }
+      op( last, (( src[ last ] << 1 ) | carry ) & lastMask );
+   } else if( shift > 0 ) {
+      for( dip::uint ii = 0; ii < last; ++ii ) {
+         op( ii, ( src[ ii ] >> 1 ) | ( src[ ii + 1 ] << ( wordBits - 1 )));
+      }
+      Word word = src[ last ] >> 1; // the padding bits are 0, so the last pixel gets a 0 here
+      if( edge ) {
+         word |= Word( 1 ) << (( length - 1 ) % wordBits );
+      }
+      op( last, word );
+   } else {
+      for( dip::uint ii = 0; ii < nWords; ++ii ) {
+         op( ii, src[ ii ] );
+      }
+   }
+}
+
+// Calls `op( ii, word )` for each word of each neighbor of the pixels in line `coords`. The pixels themselves
+// are not included.
+template< typename F >
+void ForEachNeighborWord(
+      PackedBinaryImage const& in,
+      UnsignedArray const& coords,
+      LineNeighborList const& neighbors,
+      bool edge,
+      F const& op
+) {
+   dip::uint length = in.Sizes()[ 0 ];
+   for( auto const& neighbor : neighbors ) {
+      Word const* src = NeighborLine( in, coords, neighbor.offset );
+      if( !src && !edge ) {
+         continue;
+      }
+      if( neighbor.center ) {
+         ForEachShiftedWord( src, length, 0, edge, op );
+      }
+      if( neighbor.sides ) {
+         ForEachShiftedWord( src, length, -1, edge, op );
+         ForEachShiftedWord( src, length, 1, edge, op );
+      }
+   }
+}
+
+// One iteration of the dilation, which propagates only from the pixels in `front`, the pixels set in the previous
+// iteration. This is how the `dip::Image` versions work, and it makes a difference for alternating connectivities.
+// The new pixels are set in `out` and written to `newFront`. If `mask` is given, only pixels within the mask are
+// added. Returns false if no pixels were added.
+bool DilationStep(
+      PackedBinaryImage const& front,
+      PackedBinaryImage& newFront,
+      PackedBinaryImage& out,
+      PackedBinaryImage const* mask,
+      LineNeighborList const& neighbors,
+      bool edge
+) {
+   dip::uint nWords = out.WordsPerLine();
+   std::vector< uint8 > changed( out.NumberOfLines(), 0 ); // not `std::vector< bool >`, threads write to different elements
+   ForEachLine( out.NumberOfLines(), out.NumberOfLines() * nWords * ( 2 * neighbors.size() + 2 ), [ & ]( dip::uint line ) {
+      UnsignedArray coords( out.Dimensionality() );
+      LineCoordinates( line, out.Sizes(), coords );
+      Word* dst = newFront.Line( line );
+      std::fill( dst, dst + nWords, Word( 0 ));
+      ForEachNeighborWord( front, coords, neighbors, edge, [ dst ]( dip::uint ii, Word word ) { dst[ ii ] |= word; } );
+      Word* o = out.Line( line );
+      Word const* m = mask ? mask->Line( line ) : nullptr;
+      for( dip::uint ii = 0; ii < nWords; ++ii ) {
+         Word word = dst[ ii ] & ~o[ ii ];
+         if( m ) {
+            word &= m[ ii ];
+         }
+         dst[ ii ] = word;
+         if( word != 0 ) {
+            o[ ii ] |= word;
+            changed[ line ] = 1;
+         }
+      }
+   } );
+   return std::find( changed.begin(), changed.end(), 1 ) != changed.end();
+}
+
+// Applies `iterations` dilation steps to `out`, alternating between `neighbors0` and `neighbors1`. Pixels outside
+// the image only propagate in the first step, later steps would only reach the same image border pixels again.
+void IterativeDilation(
+      PackedBinaryImage& out,
+      PackedBinaryImage const* mask,
+      LineNeighborList const& neighbors0,
+      LineNeighborList const& neighbors1,
+      dip::uint iterations,
+      bool edge
+) {
+   PackedBinaryImage front = out;
+   PackedBinaryImage newFront = out;
+   for( dip::uint ii = 0; ii < iterations; ++ii ) {
+      if( !DilationStep( front, newFront, out, mask, ii & 1 ? neighbors1 : neighbors0, edge && ( ii == 0 ))) {
+         break; // Nothing will change any more
+      }
+      std::swap( front, newFront );
+   }
+}
+
+PackedBinaryImage DilationErosion(
+      PackedBinaryImage const& in,
+      dip::sint connectivity,
+      dip::uint iterations,
+      bool edge,
+      bool erosion
+) {
+   DIP_THROW_IF( !in.IsForged(), E::IMAGE_NOT_FORGED );
+   dip::uint nDims = in.Dimensionality();
+   DIP_THROW_IF( connectivity > static_cast< dip::sint >( nDims ), E::ILLEGAL_CONNECTIVITY );
+   LineNeighborList neighbors0 = GetLineNeighbors( nDims, GetAbsBinaryConnectivity( nDims, connectivity, 0 ), true );
+   LineNeighborList neighbors1 = GetLineNeighbors( nDims, GetAbsBinaryConnectivity( nDims, connectivity, 1 ), true );
+   // The erosion is the dilation of the background, with the inverse edge condition
+   PackedBinaryImage out = in;
+   if( erosion ) {
+      out.Invert();
+      edge = !edge;
+   }
+   IterativeDilation( out, nullptr, neighbors0, neighbors1, iterations, edge );
+   if( erosion ) {
+      out.Invert();
+   }
+   return out;
+}
+
+// Propagates the set pixels of the line `line` along the line, over the runs of set pixels in `mask`. The pixels
+// outside the line have the value `edge`.
+void FillLine( Word* line, Word const* mask, dip::uint length, bool edge ) {
+   dip::uint nWords = div_ceil( length, wordBits );
+   // Towards increasing x
+   Word carry = edge ? 1 : 0;
+   for( dip::uint ii = 0; ii < nWords; ++ii ) {
+      Word p = mask[ ii ];
+      Word g = line[ ii ] | ( p & carry );
+      // Kogge-Stone fill: after the step with shift `s`, `p` marks pixels that have `2s` mask pixels to their left
+      g |= p & ( g << 1 );  p &= p << 1;
+      g |= p & ( g << 2 );  p &= p << 2;
+      g |= p & ( g << 4 );  p &= p << 4;
+      g |= p & ( g << 8 );  p &= p << 8;
+      g |= p & ( g << 16 ); p &= p << 16;
+      g |= p & ( g << 32 );
+      line[ ii ] = g;
+      carry = g >> ( wordBits - 1 );
+   }
+   // Towards decreasing x
+   carry = edge ? Word( 1 ) << (( length - 1 ) % wordBits ) : 0;
+   for( dip::uint ii = nWords; ii > 0; ) {
+      --ii;
+      Word p = mask[ ii ];
+      Word g = line[ ii ] | ( p & carry );
+      g |= p & ( g >> 1 );  p &= p >> 1;
+      g |= p & ( g >> 2 );  p &= p >> 2;
+      g |= p & ( g >> 4 );  p &= p >> 4;
+      g |= p & ( g >> 8 );  p &= p >> 8;
+      g |= p & ( g >> 16 ); p &= p >> 16;
+      g |= p & ( g >> 32 );
+      line[ ii ] = g;
+      carry = ( g & 1 ) << ( wordBits - 1 );
+   }
+}
+
+// Propagates `out` within `mask` until nothing changes, with alternating forward and backward raster scans.
+void PropagateToCompletion( PackedBinaryImage& out, PackedBinaryImage const& mask, dip::uint connectivity, bool edge ) {
+   LineNeighborList neighbors = GetLineNeighbors( out.Dimensionality(), connectivity, false );
+   dip::uint nLines = out.NumberOfLines();
+   dip::uint nWords = out.WordsPerLine();
+   dip::uint length = out.Sizes()[ 0 ];
+   std::vector< Word > buffer( nWords );
+   UnsignedArray coords( out.Dimensionality() );
+   auto processLine = [ & ]( dip::uint line ) {
+      LineCoordinates( line, out.Sizes(), coords );
+      std::fill( buffer.begin(), buffer.end(), Word( 0 ));
+      ForEachNeighborWord( out, coords, neighbors, edge, [ & ]( dip::uint ii, Word word ) { buffer[ ii ] |= word; } );
+      Word* dst = out.Line( line );
+      Word const* m = mask.Line( line );
+      for( dip::uint ii = 0; ii < nWords; ++ii ) {
+         buffer[ ii ] = ( buffer[ ii ] & m[ ii ] ) | dst[ ii ];
+      }
+      FillLine( buffer.data(), m, length, edge );
+      bool changed = false;
+      for( dip::uint ii = 0; ii < nWords; ++ii ) {
+         if( buffer[ ii ] != dst[ ii ] ) {
+            dst[ ii ] = buffer[ ii ];
+            changed = true;
+         }
+      }
+      return changed;
+   };
+   bool forward = true;
+   bool changed;
+   do {
+      changed = false;
+      if( forward ) {
+         for( dip::uint line = 0; line < nLines; ++line ) {
+            changed |= processLine( line );
+         }
+      } else {
+         for( dip::uint line = nLines; line > 0; ) {
+            --line;
+            changed |= processLine( line );
+         }
+      }
+      forward = !forward;
+   } while( changed );
+}
+
+} // namespace
+
+PackedBinaryImage::PackedBinaryImage( UnsignedArray const& sizes, bool value ) : sizes_( sizes ) {
+   DIP_THROW_IF( sizes_.empty(), E::DIMENSIONALITY_NOT_SUPPORTED );
+   DIP_THROW_IF( !sizes_.all(), E::INVALID_PARAMETER );
+   wordsPerLine_ = div_ceil( sizes_[ 0 ], wordBits );
+   nLines_ = sizes_.product() / sizes_[ 0 ];
+   data_.assign( nLines_ * wordsPerLine_, value ? allOnes : 0 );
+   if( value ) {
+      ClearPadding();
+   }
+}
+
+PackedBinaryImage::PackedBinaryImage( Image const& image ) {
+   DIP_THROW_IF( !image.IsForged(), E::IMAGE_NOT_FORGED );
+   DIP_THROW_IF( !image.IsScalar(), E::IMAGE_NOT_SCALAR );
+   DIP_THROW_IF( !image.DataType().IsBinary(), E::IMAGE_NOT_BINARY );
+   DIP_STACK_TRACE_THIS( *this = PackedBinaryImage( image.Sizes() ));
+   pixelSize_ = image.PixelSize();
+   bin const* origin = static_cast< bin const* >( image.Origin() );
+   IntegerArray const& strides = image.Strides();
+   dip::sint stride = strides[ 0 ];
+   dip::uint length = sizes_[ 0 ];
+   for( dip::uint line = 0; line < nLines_; ++line ) {
+      bin const* in = origin + LineOffset( line, sizes_, strides );
+      Word* out = Line( line );
+      for( dip::uint ii = 0; ii < wordsPerLine_; ++ii ) {
+         dip::uint n = std::min( wordBits, length - ii * wordBits );
+         Word word = 0;
+         for( dip::uint jj = 0; jj < n; ++jj, in += stride ) {
+            if( *in ) {
+               word |= Word( 1 ) << jj;
+            }
+         }
+         out[ ii ] = word;
+      }
+   }
+}
+
+void PackedBinaryImage::Unpack( Image& out ) const {
+   DIP_THROW_IF( !IsForged(), E::IMAGE_NOT_FORGED );
+   DIP_STACK_TRACE_THIS( out.ReForge( sizes_, 1, DT_BIN ));
+   out.SetPixelSize( pixelSize_ );
+   bin* origin = static_cast< bin* >( out.Origin() );
+   IntegerArray const& strides = out.Strides();
+   dip::sint stride = strides[ 0 ];
+   dip::uint length = sizes_[ 0 ];
+   for( dip::uint line = 0; line < nLines_; ++line ) {
+      bin* dst = origin + LineOffset( line, sizes_, strides );
+      Word const* in = Line( line );
+      for( dip::uint ii = 0; ii < wordsPerLine_; ++ii ) {
+         dip::uint n = std::min( wordBits, length - ii * wordBits );
+         Word word = in[ ii ];
+         for( dip::uint jj = 0; jj < n; ++jj, dst += stride ) {
+            *dst = (( word >> jj ) & 1u ) != 0;
+         }
+      }
+   }
+}
+
+dip::uint PackedBinaryImage::Count() const {
+   dip::uint count = 0;
+   for( Word word : data_ ) {
+      count += PopCount( word );
+   }
+   return count;
+}
+
+PackedBinaryImage& PackedBinaryImage::Invert() {
+   for( Word& word : data_ ) {
+      word = ~word;
+   }
+   ClearPadding();
+   return *this;
+}
+
+PackedBinaryImage& PackedBinaryImage::operator&=( PackedBinaryImage const& other ) {
+   DIP_THROW_IF( sizes_ != other.sizes_, E::SIZES_DONT_MATCH );
+   for( dip::uint ii = 0; ii < data_.size(); ++ii ) {
+      data_[ ii ] &= other.data_[ ii ];
+   }
+   return *this;
+}
+
+PackedBinaryImage& PackedBinaryImage::operator|=( PackedBinaryImage const& other ) {
+   DIP_THROW_IF( sizes_ != other.sizes_, E::SIZES_DONT_MATCH );
+   for( dip::uint ii = 0; ii < data_.size(); ++ii ) {
+      data_[ ii ] |= other.data_[ ii ];
+   }
+   return *this;
+}
+
+PackedBinaryImage& PackedBinaryImage::operator^=( PackedBinaryImage const& other ) {
+   DIP_THROW_IF( sizes_ != other.sizes_, E::SIZES_DONT_MATCH );
+   for( dip::uint ii = 0; ii < data_.size(); ++ii ) {
+      data_[ ii ] ^= other.data_[ ii ];
+   }
+   return *this;
+}
+
+void PackedBinaryImage::ClearPadding() {
+   if( !IsForged() ) {
+      return;
+   }
+   Word mask = LastWordMask( sizes_[ 0 ] );
+   for( dip::uint line = 0; line < nLines_; ++line ) {
+      Line( line )[ wordsPerLine_ - 1 ] &= mask;
+   }
+}
+
+PackedBinaryImage BinaryDilation(
+      PackedBinaryImage const& in,
+      dip::sint connectivity,
+      dip::uint iterations,
+      String const& edgeCondition
+) {
+   bool edge;
+   DIP_STACK_TRACE_THIS( edge = BooleanFromString( edgeCondition, S::OBJECT, S::BACKGROUND ));
+   PackedBinaryImage out;
+   DIP_STACK_TRACE_THIS( out = DilationErosion( in, connectivity, iterations, edge, false ));
+   return out;
+}
+
+PackedBinaryImage BinaryErosion(
+      PackedBinaryImage const& in,
+      dip::sint connectivity,
+      dip::uint iterations,
+      String const& edgeCondition
+) {
+   bool edge;
+   DIP_STACK_TRACE_THIS( edge = BooleanFromString( edgeCondition, S::OBJECT, S::BACKGROUND ));
+   PackedBinaryImage out;
+   DIP_STACK_TRACE_THIS( out = DilationErosion( in, connectivity, iterations, edge, true ));
+   return out;
+}
+
+PackedBinaryImage BinaryClosing(
+      PackedBinaryImage const& in,
+      dip::sint connectivity,
+      dip::uint iterations,
+      String const& edgeCondition
+) {
+   bool dilationEdge = false;
+   bool erosionEdge = true;
+   if( edgeCondition != S::SPECIAL ) {
+      DIP_STACK_TRACE_THIS( dilationEdge = erosionEdge = BooleanFromString( edgeCondition, S::OBJECT, S::BACKGROUND ));
+   }
+   PackedBinaryImage out;
+   DIP_START_STACK_TRACE
+      out = DilationErosion( in, connectivity, iterations, dilationEdge, false );
+      out = DilationErosion( out, connectivity, iterations, erosionEdge, true );
+   DIP_END_STACK_TRACE
+   return out;
+}
+
+PackedBinaryImage BinaryOpening(
+      PackedBinaryImage const& in,
+      dip::sint connectivity,
+      dip::uint iterations,
+      String const& edgeCondition
+) {
+   bool erosionEdge = true;
+   bool dilationEdge = false;
+   if( edgeCondition != S::SPECIAL ) {
+      DIP_STACK_TRACE_THIS( erosionEdge = dilationEdge = BooleanFromString( edgeCondition, S::OBJECT, S::BACKGROUND ));
+   }
+   PackedBinaryImage out;
+   DIP_START_STACK_TRACE
+      out = DilationErosion( in, connectivity, iterations, erosionEdge, true );
+      out = DilationErosion( out, connectivity, iterations, dilationEdge, false );
+   DIP_END_STACK_TRACE
+   return out;
+}
+
+PackedBinaryImage BinaryPropagation(
+      PackedBinaryImage const& inSeed,
+      PackedBinaryImage const& inMask,
+      dip::sint connectivity,
+      dip::uint iterations,
+      String const& edgeCondition
+) {
+   DIP_THROW_IF( !inMask.IsForged(), E::IMAGE_NOT_FORGED );
+   DIP_THROW_IF( inSeed.IsForged() && ( inSeed.Sizes() != inMask.Sizes() ), E::SIZES_DONT_MATCH );
+   dip::uint nDims = inMask.Dimensionality();
+   DIP_THROW_IF( connectivity > static_cast< dip::sint >( nDims ), E::ILLEGAL_CONNECTIVITY );
+   bool edge;
+   DIP_STACK_TRACE_THIS( edge = BooleanFromString( edgeCondition, S::OBJECT, S::BACKGROUND ));
+   dip::uint connectivity0;
+   DIP_STACK_TRACE_THIS( connectivity0 = GetAbsBinaryConnectivity( nDims, connectivity, 0 ));
+   dip::uint connectivity1 = GetAbsBinaryConnectivity( nDims, connectivity, 1 );
+   PackedBinaryImage out = inSeed.IsForged() ? inSeed : PackedBinaryImage( inMask.Sizes() );
+   if( !out.PixelSize().IsDefined() ) {
+      out.SetPixelSize( inMask.PixelSize() );
+   }
+   if(( iterations == 0 ) && ( connectivity0 == connectivity1 )) {
+      PropagateToCompletion( out, inMask, connectivity0, edge );
+   } else {
+      // With an alternating connectivity the result depends on the order in which pixels are reached,
+      // we need to do the same iterations as the `dip::Image` version
+      if( iterations == 0 ) {
+         iterations = std::numeric_limits< dip::uint >::max();
+      }
+      LineNeighborList neighbors0 = GetLineNeighbors( nDims, connectivity0, true );
+      LineNeighborList neighbors1 = GetLineNeighbors( nDims, connectivity1, true );
+      IterativeDilation( out, &inMask, neighbors0, neighbors1, iterations, edge );
+   }
+   // Seed pixels outside the mask take part in the propagation, but are not part of the output
+   out &= inMask;
+   return out;
+}
+
+void CountNeighbors(
+      PackedBinaryImage const& in,
+      Image& out,
+      dip::uint connectivity,
+      dip::String const& s_mode,
+      dip::String const& s_edgeCondition
+) {
+   DIP_THROW_IF( !in.IsForged(), E::IMAGE_NOT_FORGED );
+   DIP_THROW_IF( connectivity > in.Dimensionality(), E::ILLEGAL_CONNECTIVITY );
+   bool all;
+   bool edge;
+   DIP_START_STACK_TRACE
+      all = BooleanFromString( s_mode, S::ALL, S::FOREGROUND );
+      edge = BooleanFromString( s_edgeCondition, S::OBJECT, S::BACKGROUND );
+   DIP_END_STACK_TRACE
+   LineNeighborList neighbors = GetLineNeighbors( in.Dimensionality(), connectivity, true );
+   dip::uint maxCount = NumberOfNeighbors( neighbors ) + 1;
+   DIP_THROW_IF( maxCount > std::numeric_limits< uint8 >::max(), E::DIMENSIONALITY_NOT_SUPPORTED );
+   dip::uint nPlanes = 1;
+   while(( maxCount >> nPlanes ) > 0 ) {
+      ++nPlanes;
+   }
+   DIP_STACK_TRACE_THIS( out.ReForge( in.Sizes(), 1, DT_UINT8 ));
+   out.SetPixelSize( in.PixelSize() );
+   uint8* origin = static_cast< uint8* >( out.Origin() );
+   IntegerArray const& strides = out.Strides();
+   dip::sint stride = strides[ 0 ];
+   dip::uint length = in.Sizes()[ 0 ];
+   dip::uint nWords = in.WordsPerLine();
+   ForEachLine( in.NumberOfLines(), in.NumberOfPixels() * nPlanes + in.NumberOfLines() * nWords * maxCount * 2, [ & ]( dip::uint line ) {
+      UnsignedArray coords( in.Dimensionality() );
+      LineCoordinates( line, in.Sizes(), coords );
+      // Bit-sliced counters: bit `jj` of word `ii` of plane `p` is bit `p` of the count for pixel `ii * wordBits + jj`
+      std::vector< Word > planes( nPlanes * nWords, 0 );
+      auto add = [ & ]( dip::uint ii, Word word ) {
+         for( dip::uint p = 0; ( p < nPlanes ) && ( word != 0 ); ++p ) {
+            Word& plane = planes[ p * nWords + ii ];
+            Word carry = plane & word;
+            plane ^= word;
+            word = carry;
+         }
+      };
+      Word const* src = in.Line( line );
+      for( dip::uint ii = 0; ii < nWords; ++ii ) {
+         add( ii, src[ ii ] ); // the pixel itself
+      }
+      ForEachNeighborWord( in, coords, neighbors, edge, add );
+      if( !all ) {
+         for( dip::uint p = 0; p < nPlanes; ++p ) {
+            for( dip::uint ii = 0; ii < nWords; ++ii ) {
+               planes[ p * nWords + ii ] &= src[ ii ];
+            }
+         }
+      }
+      uint8* dst = origin + LineOffset( line, in.Sizes(), strides );
+      for( dip::uint x = 0; x < length; ++x, dst += stride ) {
+         dip::uint ii = x / wordBits;
+         dip::uint jj = x % wordBits;
+         uint8 count = 0;
+         for( dip::uint p = 0; p < nPlanes; ++p ) {
+            count = static_cast< uint8 >( count | ((( planes[ p * nWords + ii ] >> jj ) & 1u ) << p ));
+         }
+         *dst = count;
+      }
+   } );
+}
+
+} // namespace dip
+
+
+#ifdef DIP__ENABLE_DOCTEST
+#include "doctest.h"
+#include "diplib/binary.h"
+#include "diplib/iterators.h"
+#include "diplib/random.h"
+#include "diplib/statistics.h"
+
+namespace {
+
+dip::Image RandomBinaryImage( dip::UnsignedArray const& sizes, std::uint64_t seed ) {
+   dip::Image img( sizes, 1, dip::DT_BIN );
+   dip::Random random( seed );
+   dip::ImageIterator< dip::bin > it( img );
+   do {
+      *it = ( random() % 5 ) < 2;
+   } while( ++it );
+   return img;
+}
+
+bool Identical( dip::PackedBinaryImage const& packed, dip::Image const& reference ) {
+   return dip::Count( packed.Unpack() != reference ) == 0;
+}
+
+} // namespace
+
+DOCTEST_TEST_CASE("[DIPlib] testing the packed binary image") {
+   dip::Image img = RandomBinaryImage( { 100, 37 }, 0 );
+   dip::PackedBinaryImage packed( img );
+   DOCTEST_CHECK( packed.WordsPerLine() == 2 );
+   DOCTEST_CHECK( packed.Count() == dip::Count( img ));
+   DOCTEST_CHECK( Identical( packed, img ));
+   DOCTEST_CHECK( packed.At( { 99, 36 } ) == static_cast< bool >( img.At< dip::bin >( 99, 36 )));
+   DOCTEST_CHECK( Identical( ~packed, !img ));
+   dip::Image img2 = RandomBinaryImage( { 100, 37 }, 1 );
+   dip::PackedBinaryImage packed2( img2 );
+   DOCTEST_CHECK( Identical( packed & packed2, img & img2 ));
+   DOCTEST_CHECK( Identical( packed | packed2, img | img2 ));
+   DOCTEST_CHECK( Identical( packed ^ packed2, img ^ img2 ));
+}
+
+DOCTEST_TEST_CASE("[DIPlib] testing the packed binary morphology") {
+   for( auto const& sizes : { dip::UnsignedArray{ 100, 37 }, dip::UnsignedArray{ 64, 20 }, dip::UnsignedArray{ 70, 9, 8 } } ) {
+      dip::Image img = RandomBinaryImage( sizes, 2 );
+      dip::Image seed = RandomBinaryImage( sizes, 3 ) & RandomBinaryImage( sizes, 4 ) & RandomBinaryImage( sizes, 5 );
+      dip::PackedBinaryImage packed( img );
+      dip::PackedBinaryImage packedSeed( seed );
+      dip::sint nDims = static_cast< dip::sint >( sizes.size() );
+      for( dip::sint connectivity = -nDims; connectivity <= nDims; ++connectivity ) {
+         for( auto const& edgeCondition : { dip::S::BACKGROUND, dip::S::OBJECT } ) {
+            DOCTEST_CHECK( Identical( dip::BinaryDilation( packed, connectivity, 3, edgeCondition ),
+                                      dip::BinaryDilation( img, connectivity, 3, edgeCondition )));
+            DOCTEST_CHECK( Identical( dip::BinaryErosion( packed, connectivity, 2, edgeCondition ),
+                                      dip::BinaryErosion( img, connectivity, 2, edgeCondition )));
+            DOCTEST_CHECK( Identical( dip::BinaryOpening( packed, connectivity, 2, edgeCondition ),
+                                      dip::BinaryOpening( img, connectivity, 2, edgeCondition )));
+            DOCTEST_CHECK( Identical( dip::BinaryPropagation( packedSeed, packed, connectivity, 0, edgeCondition ),
+                                      dip::BinaryPropagation( seed, img, connectivity, 0, edgeCondition )));
+            DOCTEST_CHECK( Identical( dip::BinaryPropagation( packedSeed, packed, connectivity, 4, edgeCondition ),
+                                      dip::BinaryPropagation( seed, img, connectivity, 4, edgeCondition )));
+            if( connectivity >= 0 ) {
+               dip::uint c = static_cast< dip::uint >( connectivity );
+               DOCTEST_CHECK( dip::Count( dip::CountNeighbors( packed, c, dip::S::ALL, edgeCondition ) !=
+                                          dip::CountNeighbors( img, c, dip::S::ALL, edgeCondition )) == 0 );
+               DOCTEST_CHECK( dip::Count( dip::CountNeighbors( packed, c, dip::S::FOREGROUND, edgeCondition ) !=
+                                          dip::CountNeighbors( img, c, dip::S::FOREGROUND, edgeCondition )) == 0 );
+            }
+         }
+      }
+      DOCTEST_CHECK( Identical( dip::BinaryClosing( packed, 1, 2, dip::S::SPECIAL ), dip::BinaryClosing( img, 1, 2, dip::S::SPECIAL )));
+      DOCTEST_CHECK( Identical( dip::BinaryPropagation( dip::PackedBinaryImage(), packed, 1, 0, dip::S::OBJECT ),
+                                dip::BinaryPropagation( dip::Image(), img, 1, 0, dip::S::OBJECT )));
+   }
+}
+
+#endif // DIP__ENABLE_DOCTEST
@@ -18,8 +18,11 @@
  * limitations under the License.
  */
 
+#include <vector>
+
 #include "diplib.h"
 #include "diplib/binary.h"
+#include "diplib/multithreading.h"
 #include "bucket.h"
 
 #if defined(__GNUG__) || defined(__clang__)
@@ -3969,6 +3972,8 @@ void Eusk3D(
 
    // create bucket structure buckets
    Bucket b( nbuckets, QUEUE_SIZE_3D );
+   std::vector< uint8* > pixels;  // pixels at the current distance
+   std::vector< uint8 > candidate; // pixels that pass the tests in the old image
 
    // fill bucket 0
    EuskFillBucketZero( b, pimb1, mi, edge, sizex, sizey, sizez, strideX, strideY, strideZ );
@@ -4641,47 +4646,82 @@ void Eusk3D(
       b.closewrite();
       b.Free( dist - d9 );
 
+      // copy the pixels at distance 'dist' to an array, so they can be processed in parallel
+      pixels.clear();
+      b.startread( dist );
+      while( b.go ) {
+         b.RCLP( pim );
+         pixels.push_back( pim );
+      }
+      dip::sint nPixels = static_cast< dip::sint >( pixels.size() );
+      candidate.resize( pixels.size() );
+      int nThreads = ( pixels.size() * 200 < threadingThreshold ) ? 1 : static_cast< int >( GetNumberOfThreads() );
+
       for( dip::uint ii = 0; ii < 3; ++ii ) {
-         b.startread( dist );
-         while( b.go ) {
-            b.RCL( pim, dirc );
+         // The tests in the old image only read bit plane mo, which doesn't change until the end of this sub-iteration.
+         // They are done in parallel for all pixels.
+         #pragma omp parallel for schedule( static ) num_threads( nThreads )
+         for( dip::sint jj = 0; jj < nPixels; ++jj ) {
+            uint8* p = pixels[ static_cast< dip::uint >( jj ) ];
+            candidate[ static_cast< dip::uint >( jj ) ] = false;
 
             // can be obtained from direction as well?
-            if(( *( pim + bvcontour[ ii ][ 0 ] ) & mo ) &&
-               ( *( pim + bvcontour[ ii ][ 1 ] ) & mo ) &&
-               ( *( pim + bvcontour[ ii ][ 2 ] ) & mo )) {
+            if(( *( p + bvcontour[ ii ][ 0 ] ) & mo ) &&
+               ( *( p + bvcontour[ ii ][ 1 ] ) & mo ) &&
+               ( *( p + bvcontour[ ii ][ 2 ] ) & mo )) {
                   continue;
             }
 
             // put neighbourhood in local tables
-            PutInLocal( pim, strideX, strideY, strideZ, mo, uint8( mi | mo ), oldlocal, newlocal );
+            dip::sint local[ 27 ];  // old local neighbourhood
+            dip::sint unused[ 27 ]; // new local neighbourhood, not used here
+            PutInLocal( p, strideX, strideY, strideZ, mo, uint8( mi | mo ), local, unused );
 
             // test in the old image on edge and end voxels
-            if( end && EndOk( oldlocal, end, endpixel )) { continue; }
+            if( end && EndOk( local, end, endpixel )) { continue; }
 
             // euler number must not change upon removal of central pixel
-            if( !EulerOk( oldlocal )) { continue; }
+            if( !EulerOk( local )) { continue; }
 
             // number of objects must not change upon removal of pixel
-            if( !ToriwakiOk( oldlocal )) { continue; }
+            if( !ToriwakiOk( local )) { continue; }
 
-            // now the same in recursive image, first euler
-            if( !EulerOk( newlocal )) { continue; }
+            candidate[ static_cast< dip::uint >( jj ) ] = true;
+         }
 
-            // and toriwaki
-            if( !ToriwakiOk( newlocal )) { continue; }
+         // The tests in the recursive image depend on the pixels removed before, and are done sequentially, in the
+         // original order. The recursive image only differs from the old one where pixels were removed in this
+         // sub-iteration; if none of the neighbours was, the tests above apply and the pixel can be removed.
+         for( dip::uint jj = 0; jj < pixels.size(); ++jj ) {
+            if( !candidate[ jj ] ) {
+               continue;
+            }
+            pim = pixels[ jj ];
+            PutInLocal( pim, strideX, strideY, strideZ, mo, uint8( mi | mo ), oldlocal, newlocal );
+            bool changed = false;
+            for( dip::uint kk = 0; kk < 27; ++kk ) {
+               if( !oldlocal[ kk ] != !newlocal[ kk ] ) {
+                  changed = true;
+                  break;
+               }
+            }
+            if( changed ) {
+               // now the same in recursive image, first euler
+               if( !EulerOk( newlocal )) { continue; }
+
+               // and toriwaki
+               if( !ToriwakiOk( newlocal )) { continue; }
+            }
 
             // REMOVE
             *pim &= ~mi;
          }
 
          // update image, if pixel may be removed: remove mo, restore mi
-         b.startread( dist );
-         while( b.go ) {
-            b.RCLP( pim );
-            if( !( *pim & mi )) {
-               *pim |= mi;
-               *pim &= ~mo;
+         for( uint8* p : pixels ) {
+            if( !( *p & mi )) {
+               *p |= mi;
+               *p &= ~mo;
             }
          }
       }
@@ -4765,3 +4805,47 @@ void EuclideanSkeleton(
 #if defined(__GNUG__) || defined(__clang__)
 #pragma GCC diagnostic pop
 #endif
+
+#ifdef DIP__ENABLE_DOCTEST
+#include "doctest.h"
+#include "diplib/iterators.h"
+#include "diplib/statistics.h"
+#include "diplib/regions.h"
+#include "diplib/multithreading.h"
+
+DOCTEST_TEST_CASE("[DIPlib] testing the 3D Euclidean skeleton") {
+   // A box with a cylindrical tunnel along z, and a ball attached to it; large enough that the removal tests
+   // are done in parallel
+   dip::Image in( { 90, 70, 50 }, 1, dip::DT_BIN );
+   dip::ImageIterator< dip::bin > it( in );
+   do {
+      dip::UnsignedArray const& coords = it.Coordinates();
+      dip::dfloat x = static_cast< dip::dfloat >( coords[ 0 ] );
+      dip::dfloat y = static_cast< dip::dfloat >( coords[ 1 ] );
+      dip::dfloat z = static_cast< dip::dfloat >( coords[ 2 ] );
+      bool box = ( x > 5 ) && ( x < 55 ) && ( y > 5 ) && ( y < 60 ) && ( z > 5 ) && ( z < 45 );
+      bool tunnel = ( x - 30 ) * ( x - 30 ) + ( y - 32 ) * ( y - 32 ) < 100;
+      bool ball = ( x - 68 ) * ( x - 68 ) + ( y - 30 ) * ( y - 30 ) + ( z - 25 ) * ( z - 25 ) < 400;
+      *it = ( box && !tunnel ) || ball;
+   } while( ++it );
+   // Pixel counts produced by the original, sequential algorithm
+   std::vector< std::pair< dip::String, dip::uint >> expected{
+         { dip::S::LOOSE_ENDS_AWAY, 6221 }, { dip::S::NATURAL, 1653 }, { dip::S::ONE_NEIGHBOR, 6221 },
+         { dip::S::TWO_NEIGHBORS, 13413 }, { dip::S::THREE_NEIGHBORS, 6221 }};
+   dip::uint nThreads = dip::GetNumberOfThreads();
+   for( auto const& e : expected ) {
+      dip::String const& endPixelCondition = e.first;
+      dip::SetNumberOfThreads( 1 );
+      dip::Image sequential = dip::EuclideanSkeleton( in, endPixelCondition );
+      dip::SetNumberOfThreads( 0 );
+      dip::Image parallel = dip::EuclideanSkeleton( in, endPixelCondition );
+      DOCTEST_CHECK( dip::Count( sequential != parallel ) == 0 );
+      DOCTEST_CHECK( dip::Count( parallel & !in ) == 0 );
+      // The skeleton is a single object
+      DOCTEST_CHECK( dip::Maximum( dip::Label( parallel, 3 )).As< dip::uint >() == 1 );
+      DOCTEST_CHECK( dip::Count( parallel ) == e.second );
+   }
+   dip::SetNumberOfThreads( nThreads );
+}
+
+#endif // DIP__ENABLE_DOCTEST
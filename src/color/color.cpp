@@ -19,6 +19,8 @@
  * limitations under the License.
  */
 
+#include <cstring>
+#include <mutex>
 #include <queue>
 
 #include "diplib.h"
@@ -29,6 +31,26 @@ namespace dip {
 namespace {
 // XYZ matrix for conversion between RGB and XYZ.
 using XYZMatrix = std::array< dfloat, 9 >;
+
+// Computes `x^(1/N)` for `x > 0` in single precision, to within a few ulp. The initial estimate is computed from
+// the floating-point representation, and refined with Newton steps. This has no branches and no library calls,
+// such that the loops in the `ConvertSinglePrecision` methods can be vectorized.
+template< uint32 N >
+inline sfloat FastRoot( sfloat x ) {
+   uint32 bits;
+   std::memcpy( &bits, &x, sizeof( bits ));
+   bits = bits / N + ( N - 1 ) * ( 0x3F800000u / N );
+   sfloat y;
+   std::memcpy( &y, &bits, sizeof( y ));
+   for( dip::uint ii = 0; ii < 3; ++ii ) {
+      sfloat power = y; // y^(N-1)
+      for( uint32 jj = 2; jj < N; ++jj ) {
+         power *= y;
+      }
+      y = ( static_cast< sfloat >( N - 1 ) * y + x / power ) * ( 1.0f / static_cast< sfloat >( N ));
+   }
+   return y;
+}
 }
 }
 
@@ -48,7 +70,16 @@ constexpr ColorSpaceManager::XYZ ColorSpaceManager::IlluminantD55;
 constexpr ColorSpaceManager::XYZ ColorSpaceManager::IlluminantD65;
 constexpr ColorSpaceManager::XYZ ColorSpaceManager::IlluminantE;
 
-ColorSpaceManager::ColorSpaceManager() {
+struct ColorSpaceManager::LookupTableCache {
+   struct Table {
+      dip::uint version;           // `converterVersion_` at the time the table was computed
+      std::vector< sfloat > values;
+   };
+   std::mutex mutex;
+   std::map< std::pair< dip::uint, dip::uint >, std::shared_ptr< Table const >> tables; // key is (start, end) color space indices
+};
+
+ColorSpaceManager::ColorSpaceManager() : lookupTables_( std::make_shared< LookupTableCache >() ) {
    // grey (or gray)
    Define( "grey", 1 );
    DefineAlias( "gray", "grey" );
@@ -73,19 +104,19 @@ ColorSpaceManager::ColorSpaceManager() {
    Register( new cmy2cmyk );
    Register( new cmyk2cmy );
    // HSI
-   Define( "HSI", 3 );
+   Define( "HSI", 3, true );
    DefineAlias( "hsi", "HSI" );
    Register( new grey2hsi );
    Register( new hsi2grey );
    Register( new rgb2hsi );
    Register( new hsi2rgb );
    // HCV
-   Define( "HCV", 3 );
+   Define( "HCV", 3, true );
    DefineAlias( "hcv", "HCV" );
    Register( new rgb2hcv );
    Register( new hcv2rgb );
    // HSV
-   Define( "HSV", 3 );
+   Define( "HSV", 3, true );
    DefineAlias( "hsv", "HSV" );
    Register( new hcv2hsv );
    Register( new hsv2hcv );
@@ -125,7 +156,7 @@ ColorSpaceManager::ColorSpaceManager() {
    Register( new luv2xyz );
    Register( new luv2grey );
    // LCH
-   Define( "LCH", 3 );
+   Define( "LCH", 3, true );
    DefineAlias( "lch", "LCH" );
    DefineAlias( "L*C*H*", "LCH" );
    DefineAlias( "l*c*h*", "LCH" );
@@ -135,6 +166,24 @@ ColorSpaceManager::ColorSpaceManager() {
    Register( new lch2grey );
 }
 
+ColorSpaceManager::ColorSpaceManager( ColorSpaceManager const& other ) :
+      names_( other.names_ ),
+      colorSpaces_( other.colorSpaces_ ),
+      useLookupTable_( other.useLookupTable_ ),
+      converterVersion_( other.converterVersion_ ),
+      lookupTables_( std::make_shared< LookupTableCache >() ) {}
+
+ColorSpaceManager& ColorSpaceManager::operator=( ColorSpaceManager const& other ) {
+   if( this != &other ) {
+      names_ = other.names_;
+      colorSpaces_ = other.colorSpaces_;
+      useLookupTable_ = other.useLookupTable_;
+      converterVersion_ = other.converterVersion_;
+      lookupTables_ = std::make_shared< LookupTableCache >();
+   }
+   return *this;
+}
+
 
 namespace {
 
@@ -146,12 +195,24 @@ struct ConversionStep {
 
 using ConversionStepArray = std::vector< ConversionStep >;
 
+dip::uint ConversionCost( ConversionStepArray const& steps ) {
+   dip::uint cost = 0;
+   for( auto const& step : steps ) {
+      dip::uint c = step.converterFunction->Cost();
+      if( c >= 100 ) {
+         c -= 99; // This is usually the case for conversion to gray, to indicate data loss
+      }
+      cost += 50 * c; // This is very rough, most methods indicate a cost of 1 through 3, which we map here to 50-150.
+   }
+   return cost;
+}
+
 class ConverterLineFilter : public Framework::ScanLineFilter {
    public:
       ConverterLineFilter( ConversionStepArray const& steps ) : steps_( steps ) {
          maxIntermediateChannels_ = steps[ 0 ].nOutputChannels;
          for( dip::uint ii = 1; ii < steps.size() - 1; ++ii ) {
-            maxIntermediateChannels_ = std::max( maxIntermediateChannels_, steps[ 1 ].nOutputChannels );
+            maxIntermediateChannels_ = std::max( maxIntermediateChannels_, steps[ ii ].nOutputChannels );
          }
          nBuffers_ = std::min< dip::uint >( 2, steps.size() - 1 );
       }
@@ -160,15 +221,7 @@ class ConverterLineFilter : public Framework::ScanLineFilter {
          buffer2_.resize( threads );
       }
       virtual dip::uint GetNumberOfOperations( dip::uint, dip::uint, dip::uint ) override {
-         dip::uint cost = 0;
-         for( auto const& step : steps_ ) {
-            dip::uint c = step.converterFunction->Cost();
-            if( c >= 100 ) {
-               c -= 99; // This is usually the case for conversion to gray, to indicate data loss
-            }
-            cost += 50 * c; // This is very rough, most methods indicate a cost of 1 through 3, which we map here to 50-150.
-         }
-         return cost;
+         return ConversionCost( steps_ );
       }
       virtual void Filter( Framework::ScanLineFilterParameters const& params ) override {
          dip::uint thread = params.thread;
@@ -220,6 +273,149 @@ class ConverterLineFilter : public Framework::ScanLineFilter {
       // It also means we don't need to worry about how many channels an intermediate representation needs.
 };
 
+// Applies all steps to a block of pixels before moving on to the next block. The blocks are small enough that the
+// intermediate results stay in the cache. Within the block, each channel is stored contiguously.
+class SinglePrecisionConverterLineFilter : public Framework::ScanLineFilter {
+   public:
+      SinglePrecisionConverterLineFilter( ConversionStepArray const& steps, dip::uint nInputChannels ) : steps_( steps ) {
+         maxChannels_ = nInputChannels;
+         for( auto const& step : steps ) {
+            maxChannels_ = std::max( maxChannels_, step.nOutputChannels );
+         }
+      }
+      virtual void SetNumberOfThreads( dip::uint threads ) override {
+         buffers_.resize( threads );
+      }
+      virtual dip::uint GetNumberOfOperations( dip::uint, dip::uint, dip::uint ) override {
+         return ConversionCost( steps_ ) / 2; // Cheaper than the double-precision version
+      }
+      virtual void Filter( Framework::ScanLineFilterParameters const& params ) override {
+         std::vector< sfloat >& buffer = buffers_[ params.thread ];
+         buffer.resize( 2 * maxChannels_ * blockSize );
+         std::vector< sfloat const* > inputPointers( maxChannels_ );
+         std::vector< sfloat* > outputPointers( maxChannels_ );
+         sfloat const* in = static_cast< sfloat const* >( params.inBuffer[ 0 ].buffer );
+         dip::sint inStride = params.inBuffer[ 0 ].stride;
+         dip::sint inTStride = params.inBuffer[ 0 ].tensorStride;
+         dip::uint inChans = params.inBuffer[ 0 ].tensorLength;
+         sfloat* out = static_cast< sfloat* >( params.outBuffer[ 0 ].buffer );
+         dip::sint outStride = params.outBuffer[ 0 ].stride;
+         dip::sint outTStride = params.outBuffer[ 0 ].tensorStride;
+         dip::uint outChans = params.outBuffer[ 0 ].tensorLength;
+         for( dip::uint start = 0; start < params.bufferLength; start += blockSize ) {
+            dip::uint nPixels = std::min( blockSize, params.bufferLength - start );
+            sfloat* src = buffer.data();
+            sfloat* dst = src + maxChannels_ * blockSize;
+            for( dip::uint jj = 0; jj < inChans; ++jj ) {
+               sfloat const* pin = in + static_cast< dip::sint >( jj ) * inTStride;
+               for( dip::uint ii = 0; ii < nPixels; ++ii, pin += inStride ) {
+                  src[ jj * blockSize + ii ] = *pin;
+               }
+            }
+            dip::uint chans = inChans;
+            for( auto const& step : steps_ ) {
+               for( dip::uint jj = 0; jj < chans; ++jj ) {
+                  inputPointers[ jj ] = src + jj * blockSize;
+               }
+               for( dip::uint jj = 0; jj < step.nOutputChannels; ++jj ) {
+                  outputPointers[ jj ] = dst + jj * blockSize;
+               }
+               step.converterFunction->ConvertSinglePrecision( inputPointers.data(), outputPointers.data(), nPixels );
+               chans = step.nOutputChannels;
+               std::swap( src, dst );
+            }
+            for( dip::uint jj = 0; jj < outChans; ++jj ) {
+               sfloat* pout = out + static_cast< dip::sint >( jj ) * outTStride;
+               for( dip::uint ii = 0; ii < nPixels; ++ii, pout += outStride ) {
+                  *pout = src[ jj * blockSize + ii ];
+               }
+            }
+            in += static_cast< dip::sint >( nPixels ) * inStride;
+            out += static_cast< dip::sint >( nPixels ) * outStride;
+         }
+      }
+   private:
+      static constexpr dip::uint blockSize = 256;
+      ConversionStepArray const& steps_;
+      dip::uint maxChannels_;
+      std::vector< std::vector< sfloat >> buffers_; // one for each thread
+};
+
+constexpr dip::uint SinglePrecisionConverterLineFilter::blockSize;
+
+// The 3D look-up table has nodes at input values 0, 8, 16, ... 256.
+constexpr dip::uint lookupTableShift = 3;
+constexpr dip::uint lookupTableStep = 1u << lookupTableShift;
+constexpr dip::uint lookupTableSize = 256 / lookupTableStep + 1;
+
+// Computes the look-up table for the conversion `steps`, from a three-channel color space. Table values for
+// node (x,y,z) are at `(( z * lookupTableSize + y ) * lookupTableSize + x ) * nOutputChannels`.
+std::vector< sfloat > ComputeLookupTable( ConversionStepArray const& steps ) {
+   dip::uint nOut = steps.back().nOutputChannels;
+   Image grid( { lookupTableSize, lookupTableSize, lookupTableSize }, 3, DT_DFLOAT );
+   ImageIterator< dfloat > it( grid );
+   do {
+      UnsignedArray const& coords = it.Coordinates();
+      for( dip::uint ii = 0; ii < 3; ++ii ) {
+         it[ ii ] = static_cast< dfloat >( coords[ ii ] * lookupTableStep );
+      }
+   } while( ++it );
+   Image result;
+   ConverterLineFilter lineFilter( steps );
+   Framework::ScanMonadic( grid, result, DT_DFLOAT, DT_DFLOAT, nOut, lineFilter );
+   std::vector< sfloat > table( lookupTableSize * lookupTableSize * lookupTableSize * nOut );
+   ImageIterator< dfloat > rit( result );
+   auto pout = table.begin();
+   do { // `result` is a new image, the iterator visits the pixels in the same order as `table`
+      for( dip::uint ii = 0; ii < nOut; ++ii, ++pout ) {
+         *pout = static_cast< sfloat >( rit[ ii ] );
+      }
+   } while( ++rit );
+   return table;
+}
+
+// Converts 8-bit input pixels using trilinear interpolation in the look-up table
+class LookupTableLineFilter : public Framework::ScanLineFilter {
+   public:
+      LookupTableLineFilter( std::vector< sfloat > const& table, dip::uint nOutputChannels ) : table_( table ), nOut_( nOutputChannels ) {}
+      virtual dip::uint GetNumberOfOperations( dip::uint, dip::uint, dip::uint ) override {
+         return 20 + 16 * nOut_;
+      }
+      virtual void Filter( Framework::ScanLineFilterParameters const& params ) override {
+         uint8 const* in = static_cast< uint8 const* >( params.inBuffer[ 0 ].buffer );
+         dip::sint inStride = params.inBuffer[ 0 ].stride;
+         dip::sint inTStride = params.inBuffer[ 0 ].tensorStride;
+         sfloat* out = static_cast< sfloat* >( params.outBuffer[ 0 ].buffer );
+         dip::sint outStride = params.outBuffer[ 0 ].stride;
+         dip::sint outTStride = params.outBuffer[ 0 ].tensorStride;
+         dip::uint dx = nOut_;
+         dip::uint dy = lookupTableSize * dx;
+         dip::uint dz = lookupTableSize * dy;
+         constexpr sfloat scale = 1.0f / static_cast< sfloat >( lookupTableStep );
+         for( dip::uint ii = 0; ii < params.bufferLength; ++ii, in += inStride, out += outStride ) {
+            dip::uint x = in[ 0 ];
+            dip::uint y = in[ inTStride ];
+            dip::uint z = in[ 2 * inTStride ];
+            sfloat fx = static_cast< sfloat >( x & ( lookupTableStep - 1 )) * scale;
+            sfloat fy = static_cast< sfloat >( y & ( lookupTableStep - 1 )) * scale;
+            sfloat fz = static_cast< sfloat >( z & ( lookupTableStep - 1 )) * scale;
+            sfloat const* p = table_.data() + ( z >> lookupTableShift ) * dz + ( y >> lookupTableShift ) * dy + ( x >> lookupTableShift ) * dx;
+            for( dip::uint jj = 0; jj < nOut_; ++jj, ++p ) {
+               sfloat v00 = p[ 0 ] + fx * ( p[ dx ] - p[ 0 ] );
+               sfloat v10 = p[ dy ] + fx * ( p[ dy + dx ] - p[ dy ] );
+               sfloat v01 = p[ dz ] + fx * ( p[ dz + dx ] - p[ dz ] );
+               sfloat v11 = p[ dz + dy ] + fx * ( p[ dz + dy + dx ] - p[ dz + dy ] );
+               sfloat v0 = v00 + fy * ( v10 - v00 );
+               sfloat v1 = v01 + fy * ( v11 - v01 );
+               out[ static_cast< dip::sint >( jj ) * outTStride ] = v0 + fz * ( v1 - v0 );
+            }
+         }
+      }
+   private:
+      std::vector< sfloat > const& table_;
+      dip::uint nOut_;
+};
+
 } // namespace
 
 void ColorSpaceManager::Convert(
@@ -261,17 +457,33 @@ void ColorSpaceManager::Convert(
       }
       steps.back().last = true;
       //std::cout << colorSpaces_[ path.back() ].name << std::endl;
+      dip::uint nOut = steps.back().nOutputChannels;
+      bool singlePrecision = DataType::SuggestFloat( in.DataType() ) == DT_SFLOAT;
+      for( auto const& step : steps ) {
+         singlePrecision &= step.converterFunction->HasSinglePrecision();
+      }
       // Call scan framework
       DIP_START_STACK_TRACE
-         ConverterLineFilter lineFilter( steps );
-         Framework::ScanMonadic(
-               in,
-               out,
-               DT_DFLOAT,
-               DataType::SuggestFloat( in.DataType() ),
-               steps.back().nOutputChannels,
-               lineFilter
-         );
+         if( useLookupTable_ && ( in.DataType() == DT_UINT8 ) && ( in.TensorElements() == 3 ) && !colorSpaces_[ endIndex ].hasHue ) {
+            std::shared_ptr< LookupTableCache::Table const > table;
+            {
+               std::lock_guard< std::mutex > lock( lookupTables_->mutex );
+               auto& entry = lookupTables_->tables[ std::make_pair( startIndex, endIndex ) ];
+               if( !entry || ( entry->version != converterVersion_ )) {
+                  entry = std::make_shared< LookupTableCache::Table >( LookupTableCache::Table{ converterVersion_, ComputeLookupTable( steps ) } );
+               }
+               table = entry;
+            }
+            LookupTableLineFilter lineFilter( table->values, nOut );
+            ImageRefArray outar{ out };
+            Framework::Scan( { in }, outar, { DT_UINT8 }, { DT_SFLOAT }, { DT_SFLOAT }, { nOut }, lineFilter );
+         } else if( singlePrecision ) {
+            SinglePrecisionConverterLineFilter lineFilter( steps, in.TensorElements() );
+            Framework::ScanMonadic( in, out, DT_SFLOAT, DT_SFLOAT, nOut, lineFilter );
+         } else {
+            ConverterLineFilter lineFilter( steps );
+            Framework::ScanMonadic( in, out, DT_DFLOAT, DataType::SuggestFloat( in.DataType() ), nOut, lineFilter );
+         }
       DIP_END_STACK_TRACE
       out.ReshapeTensorAsVector();
    }
@@ -385,6 +597,7 @@ void ColorSpaceManager::SetWhitePoint( XYZ whitePoint ) {
 #ifdef DIP__ENABLE_DOCTEST
 #include "doctest.h"
 #include "diplib/math.h"
+#include "diplib/statistics.h"
 
 DOCTEST_TEST_CASE("[DIPlib] testing the ColorSpaceManager class") {
    dip::ColorSpaceManager csm;
@@ -428,4 +641,60 @@ DOCTEST_TEST_CASE("[DIPlib] testing the ColorSpaceManager class") {
    DOCTEST_CHECK_FALSE( xyz.At( 0 ) == out.At( 0 ));
 }
 
+DOCTEST_TEST_CASE("[DIPlib] testing the single-precision and look-up table color space conversions") {
+   dip::ColorSpaceManager csm;
+   dip::Image img( { 64, 64, 4 }, 3, dip::DT_UINT8 );
+   dip::ImageIterator< dip::uint8 > it( img );
+   do {
+      dip::UnsignedArray const& coords = it.Coordinates();
+      it[ 0 ] = static_cast< dip::uint8 >( coords[ 0 ] * 4 + coords[ 2 ] );
+      it[ 1 ] = static_cast< dip::uint8 >( coords[ 1 ] * 4 + 3 - coords[ 2 ] );
+      it[ 2 ] = static_cast< dip::uint8 >(( coords[ 0 ] * 37 + coords[ 1 ] * 11 ) % 256 );
+   } while( ++it );
+   img.SetColorSpace( "sRGB" );
+   dip::Image dimg = img;
+   dimg.Convert( dip::DT_DFLOAT );
+   dip::Image reference = csm.Convert( dimg, "Lab" ); // double precision
+   dip::Image single = csm.Convert( img, "Lab" );
+   DOCTEST_CHECK( single.DataType() == dip::DT_SFLOAT );
+   DOCTEST_CHECK( dip::MaximumAbsoluteError( single, reference ) < 1e-3 );
+   dip::Image back = csm.Convert( single, "sRGB" );
+   DOCTEST_CHECK( dip::MaximumAbsoluteError( back, dimg ) < 0.02 ); // limited by the precision of `single`
+   csm.EnableLookupTable();
+   dip::Image lut = csm.Convert( img, "Lab" );
+   DOCTEST_CHECK( lut.ColorSpace() == "Lab" );
+   DOCTEST_CHECK( dip::MaximumAbsoluteError( lut, reference ) < 0.5 );
+   // Changing the white point must invalidate the cached table
+   csm.SetWhitePoint( dip::ColorSpaceManager::IlluminantD50 );
+   reference = csm.Convert( dimg, "Lab" );
+   lut = csm.Convert( img, "Lab" );
+   DOCTEST_CHECK( dip::MaximumAbsoluteError( lut, reference ) < 0.5 );
+   // A copy has its own cache, changing its white point must not pick up the table cached in `csm`
+   dip::ColorSpaceManager copy = csm;
+   copy.SetWhitePoint( dip::ColorSpaceManager::IlluminantA );
+   copy.EnableLookupTable( false );
+   reference = copy.Convert( dimg, "Lab" );
+   copy.EnableLookupTable();
+   lut = copy.Convert( img, "Lab" );
+   DOCTEST_CHECK( dip::MaximumAbsoluteError( lut, reference ) < 0.5 );
+}
+
+DOCTEST_TEST_CASE("[DIPlib] testing the look-up table color space conversion to a hue color space") {
+   // Colors near red, with a hue on either side of 0 degrees
+   dip::Image img( { 4 }, 3, dip::DT_UINT8 );
+   img.At( 0 ) = { 255, 0, 2 };
+   img.At( 1 ) = { 255, 2, 0 };
+   img.At( 2 ) = { 250, 5, 10 };
+   img.At( 3 ) = { 131, 3, 1 };
+   img.SetColorSpace( "RGB" );
+   dip::ColorSpaceManager csm;
+   dip::Image exact = csm.Convert( img, "HSV" );
+   csm.EnableLookupTable();
+   dip::Image lut = csm.Convert( img, "HSV" );
+   DOCTEST_CHECK( lut.ColorSpace() == "HSV" );
+   DOCTEST_CHECK( dip::MaximumAbsoluteError( lut, exact ) == 0 );
+   DOCTEST_CHECK( lut.At( 0 )[ 0 ].As< dip::dfloat >() > 359 );
+   DOCTEST_CHECK( lut.At( 1 )[ 0 ].As< dip::dfloat >() < 1 );
+}
+
 #endif // DIP__ENABLE_DOCTEST
@@ -44,6 +44,17 @@ class lab2grey : public ColorSpaceConverter {
             output[ 0 ] = y * 255; // Yn == 1.000 by definition
          } while( ++input, ++output );
       }
+      virtual bool HasSinglePrecision() const override { return true; }
+      virtual void ConvertSinglePrecision( sfloat const* const* input, sfloat* const* output, dip::uint nPixels ) const override {
+         sfloat const* in = input[ 0 ];
+         sfloat* out = output[ 0 ];
+         for( dip::uint ii = 0; ii < nPixels; ++ii ) {
+            sfloat L = in[ ii ];
+            sfloat y = ( L + 16.0f ) * ( 1.0f / 116.0f );
+            y = L > static_cast< sfloat >( kappa * epsilon ) ? y * y * y : L * static_cast< sfloat >( 1.0 / kappa );
+            out[ ii ] = y * 255.0f;
+         }
+      }
 };
 
 class grey2lab : public ColorSpaceConverter {
@@ -61,6 +72,19 @@ class grey2lab : public ColorSpaceConverter {
             output[ 2 ] = 0;
          } while( ++input, ++output );
       }
+      virtual bool HasSinglePrecision() const override { return true; }
+      virtual void ConvertSinglePrecision( sfloat const* const* input, sfloat* const* output, dip::uint nPixels ) const override {
+         sfloat const* in = input[ 0 ];
+         sfloat* out = output[ 0 ];
+         for( dip::uint ii = 0; ii < nPixels; ++ii ) {
+            sfloat y = in[ ii ] * ( 1.0f / 255.0f );
+            out[ ii ] = y > static_cast< sfloat >( epsilon )
+                        ? 116.0f * FastRoot< 3 >( y ) - 16.0f
+                        : static_cast< sfloat >( kappa ) * y;
+         }
+         std::fill( output[ 1 ], output[ 1 ] + nPixels, 0.0f );
+         std::fill( output[ 2 ], output[ 2 ] + nPixels, 0.0f );
+      }
 };
 
 class lab2xyz : public ColorSpaceConverter {
@@ -87,6 +111,32 @@ class lab2xyz : public ColorSpaceConverter {
             output[ 2 ] = z * whitePoint_[ 2 ];
          } while( ++input, ++output );
       }
+      virtual bool HasSinglePrecision() const override { return true; }
+      virtual void ConvertSinglePrecision( sfloat const* const* input, sfloat* const* output, dip::uint nPixels ) const override {
+         constexpr sfloat e1_3 = static_cast< sfloat >( epsilon1_3 );
+         constexpr sfloat k = static_cast< sfloat >( kappa );
+         sfloat wx = static_cast< sfloat >( whitePoint_[ 0 ] );
+         sfloat wy = static_cast< sfloat >( whitePoint_[ 1 ] );
+         sfloat wz = static_cast< sfloat >( whitePoint_[ 2 ] );
+         sfloat const* inL = input[ 0 ];
+         sfloat const* inA = input[ 1 ];
+         sfloat const* inB = input[ 2 ];
+         sfloat* outX = output[ 0 ];
+         sfloat* outY = output[ 1 ];
+         sfloat* outZ = output[ 2 ];
+         for( dip::uint ii = 0; ii < nPixels; ++ii ) {
+            sfloat L = inL[ ii ];
+            sfloat fy = ( L + 16.0f ) * ( 1.0f / 116.0f );
+            sfloat fx = inA[ ii ] * ( 1.0f / 500.0f ) + fy;
+            sfloat fz = fy - inB[ ii ] * ( 1.0f / 200.0f );
+            sfloat x = fx > e1_3 ? fx * fx * fx : ( 116.0f * fx - 16.0f ) / k;
+            sfloat y = fy > e1_3 ? fy * fy * fy : L / k;
+            sfloat z = fz > e1_3 ? fz * fz * fz : ( 116.0f * fz - 16.0f ) / k;
+            outX[ ii ] = x * wx;
+            outY[ ii ] = y * wy;
+            outZ[ ii ] = z * wz;
+         }
+      }
       void SetWhitePoint( ColorSpaceManager::XYZ const& whitePoint ) {
          whitePoint_ = whitePoint;
       }
@@ -118,6 +168,31 @@ class xyz2lab : public ColorSpaceConverter {
             output[ 2 ] = 200.0 * ( fy - fz );
          } while( ++input, ++output );
       }
+      virtual bool HasSinglePrecision() const override { return true; }
+      virtual void ConvertSinglePrecision( sfloat const* const* input, sfloat* const* output, dip::uint nPixels ) const override {
+         constexpr sfloat e = static_cast< sfloat >( epsilon );
+         constexpr sfloat k = static_cast< sfloat >( kappa );
+         sfloat wx = static_cast< sfloat >( 1.0 / whitePoint_[ 0 ] );
+         sfloat wy = static_cast< sfloat >( 1.0 / whitePoint_[ 1 ] );
+         sfloat wz = static_cast< sfloat >( 1.0 / whitePoint_[ 2 ] );
+         sfloat const* inX = input[ 0 ];
+         sfloat const* inY = input[ 1 ];
+         sfloat const* inZ = input[ 2 ];
+         sfloat* outL = output[ 0 ];
+         sfloat* outA = output[ 1 ];
+         sfloat* outB = output[ 2 ];
+         for( dip::uint ii = 0; ii < nPixels; ++ii ) {
+            sfloat x = inX[ ii ] * wx;
+            sfloat y = inY[ ii ] * wy;
+            sfloat z = inZ[ ii ] * wz;
+            sfloat fx = x > e ? FastRoot< 3 >( x ) : ( k * x + 16.0f ) * ( 1.0f / 116.0f );
+            sfloat fy = y > e ? FastRoot< 3 >( y ) : ( k * y + 16.0f ) * ( 1.0f / 116.0f );
+            sfloat fz = z > e ? FastRoot< 3 >( z ) : ( k * z + 16.0f ) * ( 1.0f / 116.0f );
+            outL[ ii ] = 116.0f * fy - 16.0f;
+            outA[ ii ] = 500.0f * ( fx - fy );
+            outB[ ii ] = 200.0f * ( fy - fz );
+         }
+      }
       void SetWhitePoint( ColorSpaceManager::XYZ const& whitePoint ) {
          whitePoint_ = whitePoint;
       }
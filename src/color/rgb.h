@@ -34,6 +34,19 @@ class rgb2grey : public ColorSpaceConverter {
                           input[ 2 ] * Y_[ 2 ];
          } while( ++input, ++output );
       }
+      virtual bool HasSinglePrecision() const override { return true; }
+      virtual void ConvertSinglePrecision( sfloat const* const* input, sfloat* const* output, dip::uint nPixels ) const override {
+         sfloat y0 = static_cast< sfloat >( Y_[ 0 ] );
+         sfloat y1 = static_cast< sfloat >( Y_[ 1 ] );
+         sfloat y2 = static_cast< sfloat >( Y_[ 2 ] );
+         sfloat const* R = input[ 0 ];
+         sfloat const* G = input[ 1 ];
+         sfloat const* B = input[ 2 ];
+         sfloat* out = output[ 0 ];
+         for( dip::uint ii = 0; ii < nPixels; ++ii ) {
+            out[ ii ] = R[ ii ] * y0 + G[ ii ] * y1 + B[ ii ] * y2;
+         }
+      }
       void SetWhitePoint( XYZMatrix const& matrix ) {
          Y_[ 0 ] = matrix[ 1 ];
          Y_[ 1 ] = matrix[ 4 ];
@@ -54,6 +67,12 @@ class grey2rgb : public ColorSpaceConverter {
             output[ 2 ] = input[ 0 ];
          } while( ++input, ++output );
       }
+      virtual bool HasSinglePrecision() const override { return true; }
+      virtual void ConvertSinglePrecision( sfloat const* const* input, sfloat* const* output, dip::uint nPixels ) const override {
+         for( dip::uint jj = 0; jj < 3; ++jj ) {
+            std::copy( input[ 0 ], input[ 0 ] + nPixels, output[ jj ] );
+         }
+      }
 };
 
 // sRGB transformations
@@ -81,6 +100,23 @@ inline dfloat SToLinear( dfloat in ) {
    }
 }
 
+// Single-precision versions, these have no branches and no library calls
+inline sfloat LinearToS( sfloat in ) {
+   sfloat root = FastRoot< 3 >( in );
+   sfloat power = root * FastRoot< 4 >( root ); // == in^(5/12) == in^(1/gamma)
+   return in <= static_cast< sfloat >( K_0 / phi )
+          ? in * static_cast< sfloat >( phi )
+          : static_cast< sfloat >( 1 + a ) * power - static_cast< sfloat >( a );
+}
+inline sfloat SToLinear( sfloat in ) {
+   sfloat base = ( in + static_cast< sfloat >( a )) * static_cast< sfloat >( 1 / ( 1 + a ));
+   base *= base;
+   sfloat power = base * FastRoot< 5 >( base ); // == base^(12/5) == base^gamma
+   return in <= static_cast< sfloat >( K_0 )
+          ? in * static_cast< sfloat >( 1 / phi )
+          : power;
+}
+
 class rgb2srgb : public ColorSpaceConverter {
    public:
       virtual String InputColorSpace() const override { return "RGB"; }
@@ -93,6 +129,16 @@ class rgb2srgb : public ColorSpaceConverter {
             output[ 2 ] = LinearToS( input[ 2 ] / 255.0 ) * 255.0;
          } while( ++input, ++output );
       }
+      virtual bool HasSinglePrecision() const override { return true; }
+      virtual void ConvertSinglePrecision( sfloat const* const* input, sfloat* const* output, dip::uint nPixels ) const override {
+         for( dip::uint jj = 0; jj < 3; ++jj ) {
+            sfloat const* in = input[ jj ];
+            sfloat* out = output[ jj ];
+            for( dip::uint ii = 0; ii < nPixels; ++ii ) {
+               out[ ii ] = LinearToS( in[ ii ] * ( 1.0f / 255.0f )) * 255.0f;
+            }
+         }
+      }
 };
 
 class srgb2rgb : public ColorSpaceConverter {
@@ -107,6 +153,16 @@ class srgb2rgb : public ColorSpaceConverter {
             output[ 2 ] = SToLinear( input[ 2 ] / 255.0 ) * 255.0;
          } while( ++input, ++output );
       }
+      virtual bool HasSinglePrecision() const override { return true; }
+      virtual void ConvertSinglePrecision( sfloat const* const* input, sfloat* const* output, dip::uint nPixels ) const override {
+         for( dip::uint jj = 0; jj < 3; ++jj ) {
+            sfloat const* in = input[ jj ];
+            sfloat* out = output[ jj ];
+            for( dip::uint ii = 0; ii < nPixels; ++ii ) {
+               out[ ii ] = SToLinear( in[ ii ] * ( 1.0f / 255.0f )) * 255.0f;
+            }
+         }
+      }
 };
 
 } // namespace
@@ -22,6 +22,28 @@ namespace dip {
 
 namespace {
 
+// Single-precision `output = scale * matrix * input`, with `matrix` stored column-wise, as in the `Convert` methods below
+inline void MatrixMultiply( XYZMatrix const& matrix, dfloat scale, sfloat const* const* input, sfloat* const* output, dip::uint nPixels ) {
+   std::array< sfloat, 9 > m;
+   for( dip::uint ii = 0; ii < 9; ++ii ) {
+      m[ ii ] = static_cast< sfloat >( matrix[ ii ] * scale );
+   }
+   sfloat const* in0 = input[ 0 ];
+   sfloat const* in1 = input[ 1 ];
+   sfloat const* in2 = input[ 2 ];
+   sfloat* out0 = output[ 0 ];
+   sfloat* out1 = output[ 1 ];
+   sfloat* out2 = output[ 2 ];
+   for( dip::uint ii = 0; ii < nPixels; ++ii ) {
+      sfloat v0 = in0[ ii ];
+      sfloat v1 = in1[ ii ];
+      sfloat v2 = in2[ ii ];
+      out0[ ii ] = v0 * m[ 0 ] + v1 * m[ 3 ] + v2 * m[ 6 ];
+      out1[ ii ] = v0 * m[ 1 ] + v1 * m[ 4 ] + v2 * m[ 7 ];
+      out2[ ii ] = v0 * m[ 2 ] + v1 * m[ 5 ] + v2 * m[ 8 ];
+   }
+}
+
 class xyz2grey : public ColorSpaceConverter {
    public:
       virtual String InputColorSpace() const override { return "XYZ"; }
@@ -32,6 +54,14 @@ class xyz2grey : public ColorSpaceConverter {
             output[ 0 ] = input[ 1 ] * 255;
          } while( ++input, ++output );
       }
+      virtual bool HasSinglePrecision() const override { return true; }
+      virtual void ConvertSinglePrecision( sfloat const* const* input, sfloat* const* output, dip::uint nPixels ) const override {
+         sfloat const* Y = input[ 1 ];
+         sfloat* out = output[ 0 ];
+         for( dip::uint ii = 0; ii < nPixels; ++ii ) {
+            out[ ii ] = Y[ ii ] * 255.0f;
+         }
+      }
 };
 
 class yxy2grey : public xyz2grey {
@@ -50,6 +80,17 @@ class grey2xyz : public ColorSpaceConverter {
             output[ 2 ] = input[ 0 ] * whitePoint_[ 2 ] / 255;
          } while( ++input, ++output );
       }
+      virtual bool HasSinglePrecision() const override { return true; }
+      virtual void ConvertSinglePrecision( sfloat const* const* input, sfloat* const* output, dip::uint nPixels ) const override {
+         for( dip::uint jj = 0; jj < 3; ++jj ) {
+            sfloat scale = static_cast< sfloat >( whitePoint_[ jj ] / 255 );
+            sfloat const* in = input[ 0 ];
+            sfloat* out = output[ jj ];
+            for( dip::uint ii = 0; ii < nPixels; ++ii ) {
+               out[ ii ] = in[ ii ] * scale;
+            }
+         }
+      }
       void SetWhitePoint( ColorSpaceManager::XYZ const& whitePoint ) {
          whitePoint_ = whitePoint;
       }
@@ -68,6 +109,10 @@ class rgb2xyz : public ColorSpaceConverter {
             output[ 2 ] = ( input[ 0 ] * matrix_[ 2 ] + input[ 1 ] * matrix_[ 5 ] + input[ 2 ] * matrix_[ 8 ] ) / 255;
          } while( ++input, ++output );
       }
+      virtual bool HasSinglePrecision() const override { return true; }
+      virtual void ConvertSinglePrecision( sfloat const* const* input, sfloat* const* output, dip::uint nPixels ) const override {
+         MatrixMultiply( matrix_, 1.0 / 255.0, input, output, nPixels );
+      }
       void SetWhitePoint( XYZMatrix const& matrix ) {
          matrix_ = matrix;
          /*
@@ -98,6 +143,10 @@ class xyz2rgb : public ColorSpaceConverter {
             output[ 2 ] = ( input[ 0 ] * invMatrix_[ 2 ] + input[ 1 ] * invMatrix_[ 5 ] + input[ 2 ] * invMatrix_[ 8 ] ) * 255;
          } while( ++input, ++output );
       }
+      virtual bool HasSinglePrecision() const override { return true; }
+      virtual void ConvertSinglePrecision( sfloat const* const* input, sfloat* const* output, dip::uint nPixels ) const override {
+         MatrixMultiply( invMatrix_, 255.0, input, output, nPixels );
+      }
       void SetWhitePoint( XYZMatrix const& matrix ) {
          Inverse( 3, matrix.data(), invMatrix_.data() );
          /*
@@ -18,6 +18,9 @@
  * limitations under the License.
  */
 
+#include <algorithm>
+#include <vector>
+
 #include "diplib.h"
 #include "diplib/display.h"
 #include "diplib/math.h"
@@ -26,6 +29,29 @@
 
 namespace dip {
 
+namespace {
+
+// Computes the 5th and 95th percentiles of `img` from a single copy of its samples, with the same ranks as
+// `dip::Percentile`. Like `Image::Sample( Percentile( img ))`, it uses only the first tensor element.
+ImageDisplay::Limits PercentileLimits( Image const& img ) {
+   Image samples;
+   samples.ReForge( img.Sizes(), 1, DT_DFLOAT );
+   samples.Copy( img.IsScalar() ? img : Image( img[ 0 ] ));
+   dfloat* begin = static_cast< dfloat* >( samples.Origin() );
+   dfloat* end = begin + samples.NumberOfPixels();
+   dfloat N1 = static_cast< dfloat >( samples.NumberOfPixels() - 1 );
+   dfloat* lower = begin + round_cast( N1 * 5.0 / 100.0 );
+   dfloat* upper = begin + round_cast( N1 * 95.0 / 100.0 );
+   std::nth_element( begin, lower, end );
+   // All elements after `lower` are not smaller than it, `upper` is among them
+   if( upper > lower ) {
+      std::nth_element( lower + 1, upper, end );
+   }
+   return { *lower, *upper };
+}
+
+} // namespace
+
 // Don't call this function if mappingMode_ == MappingMode::MANUAL or mappingMode_ == MappingMode::MODULO!
 void ImageDisplay::ComputeLimits( bool set ) {
    Limits* lims;
@@ -80,8 +106,7 @@ void ImageDisplay::ComputeLimits( bool set ) {
             }
          }
          if( mappingMode_ == MappingMode::PERCENTILE ) {
-            lims->lower = static_cast< dfloat >( Image::Sample( Percentile( tmp, {}, 5.0 )));
-            lims->upper = static_cast< dfloat >( Image::Sample( Percentile( tmp, {}, 95.0 )));
+            *lims = PercentileLimits( tmp );
          } else {
             MinMaxAccumulator res = MaximumAndMinimum( tmp );
             lims->lower = res.Minimum();
@@ -95,6 +120,16 @@ void ImageDisplay::ComputeLimits( bool set ) {
          }
       }
    }
+   if( !globalStretch_ && tmp.IsForged() && !rgbSliceIsDirty_ ) {
+      // Remember the limits for the current projection
+      CachedProjection* projection = CurrentProjection();
+      if( projection ) {
+         projection->limits = sliceLimits_;
+         projection->red = red_;
+         projection->green = green_;
+         projection->blue = blue_;
+      }
+   }
    if( set ) {
       range_ = *lims;
    }
@@ -107,6 +142,17 @@ void ImageDisplay::InvalidateSliceLimits() {
    }
 }
 
+ImageDisplay::CachedProjection* ImageDisplay::CurrentProjection() {
+   if(( projectionMode_ == ProjectionMode::SLICE ) || ( image_.Dimensionality() <= ( twoDimOut_ ? 2u : 1u ))) {
+      return nullptr;
+   }
+   auto it = projectionCache_.find( ProjectionKey{ projectionMode_, dim1_, dim2_ } );
+   if( it == projectionCache_.end() ) {
+      return nullptr;
+   }
+   return &( it->second );
+}
+
 ImageDisplay::Limits ImageDisplay::GetLimits( bool compute ) {
    Limits* lims;
    if( globalStretch_ ) {
@@ -128,42 +174,40 @@ void ImageDisplay::UpdateSlice() {
    if( sliceIsDirty_ ) {
       dip::uint nDims = image_.Dimensionality();
       dip::uint outDims = twoDimOut_ ? 2 : 1;
+      UnsignedArray order = twoDimOut_ ? UnsignedArray{ dim1_, dim2_ } : UnsignedArray{ dim1_ };
       if( nDims > outDims ) {
-         switch( projectionMode_ ) {
-            //case ProjectionMode::SLICE:
-            default: {
-               RangeArray rangeArray( nDims ); // By default, covers all image pixels
-               for( dip::uint ii = 0; ii < nDims; ++ii ) {
-                  if(( ii != dim1_ ) && ( ii != dim2_ )) {
-                     rangeArray[ ii ] = Range( static_cast< dip::sint >( coordinates_[ ii ] ));
-                  }
+         if( projectionMode_ == ProjectionMode::SLICE ) {
+            RangeArray rangeArray( nDims ); // By default, covers all image pixels
+            for( dip::uint ii = 0; ii < nDims; ++ii ) {
+               if(( ii != dim1_ ) && ( ii != dim2_ )) {
+                  rangeArray[ ii ] = Range( static_cast< dip::sint >( coordinates_[ ii ] ));
                }
-               slice_ = image_.At( rangeArray );
-               break;
             }
-            case ProjectionMode::MAX: {
+            slice_ = image_.At( rangeArray );
+            slice_.PermuteDimensions( order );
+         } else {
+            // Projections don't depend on `coordinates_`, we compute each one only once
+            ProjectionKey key{ projectionMode_, dim1_, dim2_ };
+            auto it = projectionCache_.find( key );
+            if( it == projectionCache_.end() ) {
                BooleanArray process( nDims, true );
                process[ dim1_ ] = false;
                process[ dim2_ ] = false;
-               if( image_.DataType().IsComplex() ) {
-                  MaximumAbs( image_, {}, slice_, process );
-               } else {
-                  Maximum( image_, {}, slice_, process );
+               Image projection;
+               if( projectionMode_ == ProjectionMode::MAX ) {
+                  if( image_.DataType().IsComplex() ) {
+                     MaximumAbs( image_, {}, projection, process );
+                  } else {
+                     Maximum( image_, {}, projection, process );
+                  }
+               } else { // ProjectionMode::MEAN
+                  Mean( image_, {}, projection, "", process );
                }
-               break;
-            }
-            case ProjectionMode::MEAN: {
-               BooleanArray process( nDims, true );
-               process[ dim1_ ] = false;
-               process[ dim2_ ] = false;
-               Mean( image_, {}, slice_, "", process );
-               break;
+               projection.PermuteDimensions( order );
+               it = projectionCache_.emplace( key, CachedProjection{} ).first;
+               it->second.slice = std::move( projection );
             }
-         }
-         if( dim1_ == dim2_ ) {
-            slice_.PermuteDimensions( { dim1_ } );
-         } else {
-            slice_.PermuteDimensions( { dim1_, dim2_ } );
+            slice_ = it->second.slice.QuickCopy();
          }
       } else {
          slice_ = image_.QuickCopy();
@@ -206,6 +250,10 @@ void ImageDisplay::UpdateRgbSlice() {
       rgbSliceIsDirty_ = false;
       outputIsDirty_ = true;
       InvalidateSliceLimits();
+      CachedProjection* projection = CurrentProjection();
+      if( projection && ( projection->red == red_ ) && ( projection->green == green_ ) && ( projection->blue == blue_ )) {
+         sliceLimits_ = projection->limits;
+      }
    }
 }
 
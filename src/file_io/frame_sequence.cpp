@@ -0,0 +1,384 @@
+/*
+ * DIPlib 3.0
+ * This file contains definitions for processing sequences of frames one at the time.
+ *
+ * (c)2026, Cris Luengo.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+#include "diplib.h"
+#include "diplib/frame_sequence.h"
+
+namespace dip {
+
+namespace {
+
+// A bounded queue of frames, used to pass frames between threads. `Push` blocks while the queue is full,
+// `Pop` blocks while it is empty. After `Close`, `Pop` returns `false` once the queue is empty; after
+// `Abort`, both return `false` immediately.
+class FrameQueue {
+   public:
+      explicit FrameQueue( dip::uint capacity ) : capacity_( capacity ) {}
+
+      bool Push( Image&& frame ) {
+         std::unique_lock< std::mutex > lock( mutex_ );
+         notFull_.wait( lock, [ this ] { return aborted_ || ( queue_.size() < capacity_ ); } );
+         if( aborted_ ) {
+            return false;
+         }
+         queue_.push_back( std::move( frame ));
+         notEmpty_.notify_one();
+         return true;
+      }
+
+      bool Pop( Image& frame ) {
+         std::unique_lock< std::mutex > lock( mutex_ );
+         notEmpty_.wait( lock, [ this ] { return aborted_ || closed_ || !queue_.empty(); } );
+         if( aborted_ || queue_.empty() ) {
+            return false;
+         }
+         frame = std::move( queue_.front() );
+         queue_.pop_front();
+         notFull_.notify_one();
+         return true;
+      }
+
+      // Non-blocking versions, used for the queues that recycle frame buffers
+      void TryPush( Image&& frame ) {
+         std::lock_guard< std::mutex > lock( mutex_ );
+         if( queue_.size() < capacity_ ) {
+            queue_.push_back( std::move( frame ));
+         }
+      }
+      bool TryPop( Image& frame ) {
+         std::lock_guard< std::mutex > lock( mutex_ );
+         if( queue_.empty() ) {
+            return false;
+         }
+         frame = std::move( queue_.front() );
+         queue_.pop_front();
+         return true;
+      }
+
+      void Close() {
+         std::lock_guard< std::mutex > lock( mutex_ );
+         closed_ = true;
+         notEmpty_.notify_all();
+      }
+
+      void Abort() {
+         std::lock_guard< std::mutex > lock( mutex_ );
+         aborted_ = true;
+         notEmpty_.notify_all();
+         notFull_.notify_all();
+      }
+
+   private:
+      std::mutex mutex_;
+      std::condition_variable notEmpty_;
+      std::condition_variable notFull_;
+      std::deque< Image > queue_;
+      dip::uint capacity_;
+      bool closed_ = false;
+      bool aborted_ = false;
+};
+
+// Puts `frame` in the queue of free frame buffers, if no one else holds on to its data
+void RecycleFrame( FrameQueue& freeFrames, Image& frame ) {
+   if( frame.IsForged() && !frame.IsShared() && !frame.IsExternalData() ) {
+      freeFrames.TryPush( std::move( frame ));
+   }
+   frame = Image{};
+}
+
+// Copies `frame` into `out`, reusing the data segment of `out` if it has the right sizes and data type
+void CopyFrame( Image const& frame, Image& out ) {
+   if( out.IsForged() && ( out.DataType() != frame.DataType() )) {
+      out.Strip();
+   }
+   out.Copy( frame );
+}
+
+} // namespace
+
+ImageFrameSource::ImageFrameSource( Image const& image ) : image_( image ) {
+   DIP_THROW_IF( !image_.IsForged(), E::IMAGE_NOT_FORGED );
+   DIP_THROW_IF( image_.Dimensionality() < 1, E::DIMENSIONALITY_NOT_SUPPORTED );
+}
+
+bool ImageFrameSource::ReadFrame( Image& out ) {
+   dip::uint dim = image_.Dimensionality() - 1;
+   if( next_ >= image_.Size( dim )) {
+      return false;
+   }
+   RangeArray ranges( image_.Dimensionality() );
+   ranges[ dim ] = Range{ static_cast< dip::sint >( next_ ) };
+   Image frame = image_.At( ranges );
+   frame.Squeeze( dim );
+   CopyFrame( frame, out );
+   ++next_;
+   return true;
+}
+
+ImageFrameSink::ImageFrameSink( Image& out, dip::uint numberOfFrames ) : out_( out ), numberOfFrames_( numberOfFrames ) {
+   DIP_THROW_IF( numberOfFrames_ < 1, E::INVALID_PARAMETER );
+}
+
+void ImageFrameSink::WriteFrame( Image const& frame ) {
+   DIP_THROW_IF( !frame.IsForged(), E::IMAGE_NOT_FORGED );
+   DIP_THROW_IF( next_ >= numberOfFrames_, "Too many frames written to ImageFrameSink" );
+   dip::uint nDims = frame.Dimensionality();
+   if( next_ == 0 ) {
+      UnsignedArray sizes = frame.Sizes();
+      sizes.push_back( numberOfFrames_ );
+      out_.ReForge( sizes, frame.TensorElements(), frame.DataType() );
+      out_.ReshapeTensor( frame.Tensor() );
+      out_.SetColorSpace( frame.ColorSpace() );
+      PixelSize pixelSize = frame.PixelSize();
+      if( pixelSize.IsDefined() ) {
+         pixelSize.Set( nDims, PhysicalQuantity::Pixel() );
+         out_.SetPixelSize( pixelSize );
+      }
+   }
+   DIP_THROW_IF( out_.Dimensionality() != nDims + 1, E::DIMENSIONALITIES_DONT_MATCH );
+   RangeArray ranges( nDims + 1 );
+   ranges[ nDims ] = Range{ static_cast< dip::sint >( next_ ) };
+   Image slice = out_.At( ranges );
+   slice.Squeeze( nDims );
+   DIP_THROW_IF( slice.Sizes() != frame.Sizes(), E::SIZES_DONT_MATCH );
+   DIP_THROW_IF( slice.TensorElements() != frame.TensorElements(), E::NTENSORELEM_DONT_MATCH );
+   slice.Protect();
+   slice.Copy( frame );
+   ++next_;
+}
+
+void ProcessFrameSequence(
+      FrameSource& source,
+      FrameSink& sink,
+      dip::uint windowLength,
+      FrameWindowFunction const& function,
+      dip::uint queueLength
+) {
+   DIP_THROW_IF( windowLength < 1, E::INVALID_PARAMETER );
+   DIP_THROW_IF( queueLength < 1, E::INVALID_PARAMETER );
+   dip::uint const before = windowLength / 2;
+   dip::uint const after = ( windowLength - 1 ) / 2;
+
+   // Frames travel from the reader thread to this thread through `input`, and from this thread to the writer
+   // thread through `output`. Frame buffers that are no longer needed travel back through `freeInput` and
+   // `freeOutput`, so that the reader and the processing function can reuse them.
+   FrameQueue input( queueLength );
+   FrameQueue output( queueLength );
+   FrameQueue freeInput( queueLength + 1 );
+   FrameQueue freeOutput( queueLength + 1 );
+
+   std::exception_ptr readerError;
+   std::exception_ptr writerError;
+   std::exception_ptr error;
+   std::thread reader;
+   std::thread writer;
+   bool failed = false;
+
+   try {
+      reader = std::thread( [ & ] {
+         try {
+            while( true ) {
+               Image frame;
+               freeInput.TryPop( frame );
+               if( !source.ReadFrame( frame ) || !input.Push( std::move( frame ))) {
+                  break;
+               }
+            }
+         } catch( ... ) {
+            readerError = std::current_exception();
+         }
+         input.Close();
+      } );
+      writer = std::thread( [ & ] {
+         try {
+            Image frame;
+            while( output.Pop( frame )) {
+               sink.WriteFrame( frame );
+               RecycleFrame( freeOutput, frame );
+            }
+         } catch( ... ) {
+            writerError = std::current_exception();
+            output.Abort();
+         }
+      } );
+
+      // The frames in the temporal window, `window[ 0 ]` is frame number `first`
+      std::deque< Image > window;
+      dip::uint first = 0;
+      bool endOfSequence = false;
+      for( dip::uint current = 0; ; ++current ) {
+         // Read frames until the window extends to `current + after`, or until the sequence ends
+         while( !endOfSequence && ( first + window.size() <= current + after )) {
+            Image frame;
+            if( input.Pop( frame )) {
+               window.push_back( std::move( frame ));
+            } else {
+               endOfSequence = true;
+            }
+         }
+         if( endOfSequence && readerError ) { // `readerError` is set before `input` is closed
+            failed = true;
+            break;
+         }
+         if( current >= first + window.size() ) {
+            break;
+         }
+         // Drop frames that are no longer in the window
+         while( first + before < current ) {
+            RecycleFrame( freeInput, window.front() );
+            window.pop_front();
+            ++first;
+         }
+         ImageConstRefArray windowRefs;
+         windowRefs.reserve( window.size() );
+         for( auto const& frame : window ) {
+            windowRefs.push_back( frame );
+         }
+         Image out;
+         freeOutput.TryPop( out );
+         function( windowRefs, current - first, out );
+         if( !output.Push( std::move( out ))) {
+            failed = true; // The writer failed
+            break;
+         }
+      }
+   } catch( ... ) {
+      error = std::current_exception();
+      failed = true;
+   }
+
+   if( failed ) {
+      input.Abort();
+      output.Abort();
+   } else {
+      output.Close();
+      input.Abort(); // The reader should be done already, but just in case
+   }
+   if( reader.joinable() ) {
+      reader.join();
+   }
+   if( writer.joinable() ) {
+      writer.join();
+   }
+   if( error ) {
+      std::rethrow_exception( error );
+   }
+   if( readerError ) {
+      std::rethrow_exception( readerError );
+   }
+   if( writerError ) {
+      std::rethrow_exception( writerError );
+   }
+}
+
+} // namespace dip
+
+
+#ifdef DIP__ENABLE_DOCTEST
+#include "doctest.h"
+#include "diplib/generation.h"
+#include "diplib/testing.h"
+
+namespace {
+
+class FailingFrameSource : public dip::FrameSource {
+   public:
+      FailingFrameSource( dip::uint failAt ) : failAt_( failAt ) {}
+      virtual bool ReadFrame( dip::Image& out ) override {
+         if( next_ == failAt_ ) {
+            DIP_THROW( "Failed reading frame" );
+         }
+         out = dip::Image( dip::UnsignedArray{ 10, 12 }, 1, dip::DT_UINT8 );
+         out.Fill( next_ );
+         ++next_;
+         return true;
+      }
+   private:
+      dip::uint failAt_;
+      dip::uint next_ = 0;
+};
+
+} // namespace
+
+DOCTEST_TEST_CASE("[DIPlib] testing frame sequence processing") {
+   dip::Image stack{ dip::UnsignedArray{ 20, 15, 9 }, 3, dip::DT_UINT8 };
+   stack.Fill( 0 );
+   dip::Random random( 0 );
+   dip::UniformNoise( stack, stack, random, 0.0, 255.0 );
+   stack.SetColorSpace( "RGB" );
+
+   // A window length of 1 with the identity function copies the sequence
+   dip::ImageFrameSource source( stack );
+   DOCTEST_CHECK( source.NumberOfFrames() == 9 );
+   dip::Image result;
+   dip::ImageFrameSink sink( result, 9 );
+   dip::ProcessFrameSequence( source, sink, 1, []( dip::ImageConstRefArray const& window, dip::uint current, dip::Image& out ) {
+      out.Copy( window[ current ].get() );
+   }, 2 );
+   DOCTEST_CHECK( sink.NumberOfFrames() == 9 );
+   DOCTEST_CHECK( result.ColorSpace() == "RGB" );
+   DOCTEST_CHECK( dip::testing::CompareImages( stack, result ));
+
+   // The function sees the right frames in the window
+   dip::Image indices{ dip::UnsignedArray{ 4, 7 }, 1, dip::DT_UINT32 };
+   for( dip::uint ii = 0; ii < 7; ++ii ) {
+      indices.At( dip::Range{}, dip::Range{ static_cast< dip::sint >( ii ) } ).Fill( ii );
+   }
+   std::vector< dip::uint > firsts;
+   std::vector< dip::uint > lengths;
+   dip::ImageFrameSource indexSource( indices );
+   dip::Image indexResult;
+   dip::ImageFrameSink indexSink( indexResult, 7 );
+   dip::ProcessFrameSequence( indexSource, indexSink, 4, [ & ]( dip::ImageConstRefArray const& window, dip::uint current, dip::Image& out ) {
+      firsts.push_back( window[ 0 ].get().At< dip::uint32 >( 0 ));
+      lengths.push_back( window.size() );
+      out.Copy( window[ current ].get() );
+   } );
+   DOCTEST_CHECK( firsts == std::vector< dip::uint >{ 0, 0, 0, 1, 2, 3, 4 } );
+   DOCTEST_CHECK( lengths == std::vector< dip::uint >{ 2, 3, 4, 4, 4, 4, 3 } );
+   DOCTEST_CHECK( dip::testing::CompareImages( indices, indexResult ));
+
+   // Errors are propagated
+   FailingFrameSource failingSource( 5 );
+   dip::Image failingResult;
+   dip::ImageFrameSink failingSink( failingResult, 20 );
+   DOCTEST_CHECK_THROWS( dip::ProcessFrameSequence( failingSource, failingSink, 3, []( dip::ImageConstRefArray const& window, dip::uint current, dip::Image& out ) {
+      out.Copy( window[ current ].get() );
+   } ));
+   dip::ImageFrameSource source2( stack );
+   dip::Image result2;
+   dip::ImageFrameSink sink2( result2, 5 ); // Too few frames
+   DOCTEST_CHECK_THROWS( dip::ProcessFrameSequence( source2, sink2, 3, []( dip::ImageConstRefArray const& window, dip::uint current, dip::Image& out ) {
+      out.Copy( window[ current ].get() );
+   } ));
+   dip::ImageFrameSource source3( stack );
+   dip::Image result3;
+   dip::ImageFrameSink sink3( result3, 9 );
+   DOCTEST_CHECK_THROWS( dip::ProcessFrameSequence( source3, sink3, 3, []( dip::ImageConstRefArray const&, dip::uint, dip::Image& ) {
+      DIP_THROW( "Failed processing frame" );
+   } ));
+}
+
+#endif // DIP__ENABLE_DOCTEST
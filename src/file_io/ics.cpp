@@ -24,6 +24,7 @@
 
 #include "diplib.h"
 #include "diplib/file_io.h"
+#include "diplib/frame_sequence.h"
 #include "diplib/generic_iterators.h"
 #include "diplib/library/copy_buffer.h"
 
@@ -640,6 +641,92 @@ bool ImageIsICS( String const& filename ) {
    return IcsVersion( filename.c_str(), 1 ) != 0;
 }
 
+class ICSFrameSource::Reader {
+   public:
+      explicit Reader( String const& filename ) : icsFile( filename, "r" ) {}
+      IcsFile icsFile;
+};
+
+ICSFrameSource::ICSFrameSource( String const& filename ) {
+   std::unique_ptr< Reader > reader( new Reader( filename ));
+   GetICSInfoData data;
+   DIP_STACK_TRACE_THIS( data = GetICSInfo( reader->icsFile ));
+   information_ = data.fileInformation;
+   filename_ = information_.name;
+   dip::uint nDims = information_.sizes.size();
+   DIP_THROW_IF( nDims < 1, E::DIMENSIONALITY_NOT_SUPPORTED );
+   numberOfFrames_ = information_.sizes.back();
+   // The planes are stored one after the other if the dimensions are in the file in the same order as in the
+   // image, with the tensor dimension (if any) first
+   bool sequential;
+   if( information_.tensorElements > 1 ) {
+      sequential = data.order.back() == 0;
+      for( dip::uint ii = 0; ii < nDims; ++ii ) {
+         sequential &= data.order[ ii ] == ii + 1;
+      }
+   } else {
+      sequential = true;
+      for( dip::uint ii = 0; ii < nDims; ++ii ) {
+         sequential &= data.order[ ii ] == ii;
+      }
+   }
+   if( sequential ) {
+      reader_ = std::move( reader );
+   } else {
+      reader->icsFile.Close();
+   }
+}
+
+ICSFrameSource::~ICSFrameSource() = default;
+
+bool ICSFrameSource::ReadFrame( Image& out ) {
+   if( next_ >= numberOfFrames_ ) {
+      return false;
+   }
+   dip::uint nDims = information_.sizes.size();
+   if( reader_ ) {
+      UnsignedArray sizes = information_.sizes;
+      sizes.pop_back();
+      dip::uint tensorElements = information_.tensorElements;
+      DataType dataType = information_.dataType;
+      if( out.IsForged() && (( out.Sizes() != sizes ) || ( out.TensorElements() != tensorElements ) || ( out.DataType() != dataType ))) {
+         out.Strip();
+      }
+      out.ReForge( sizes, tensorElements, dataType );
+      // Read directly into `out` if its strides match the file, otherwise through a temporary buffer
+      Image plane = out.HasNormalStrides() ? out.QuickCopy() : Image( sizes, tensorElements, dataType );
+      CALL_ICS( IcsGetDataBlock( reader_->icsFile, plane.Origin(), plane.NumberOfSamples() * dataType.SizeOf() ),
+                "Couldn't read pixel data from ICS file" );
+      if( !plane.SharesData( out )) {
+         out.Copy( plane );
+      }
+   } else {
+      RangeArray roi( nDims );
+      roi.back() = Range{ static_cast< dip::sint >( next_ ) };
+      Image plane;
+      DIP_STACK_TRACE_THIS( ImageReadICS( plane, filename_, roi ));
+      plane.Squeeze( nDims - 1 );
+      if( out.IsForged() && ( out.DataType() != plane.DataType() )) {
+         out.Strip();
+      }
+      out.Copy( plane );
+   }
+   PixelSize pixelSize;
+   for( dip::uint ii = 0; ii < nDims - 1; ++ii ) {
+      pixelSize.Set( ii, information_.pixelSize[ ii ] );
+   }
+   out.SetPixelSize( pixelSize );
+   if( out.TensorElements() > 1 ) {
+      out.SetColorSpace( information_.colorSpace );
+   }
+   ++next_;
+   if( reader_ && ( next_ == numberOfFrames_ )) {
+      reader_->icsFile.Close();
+      reader_.reset();
+   }
+   return true;
+}
+
 namespace {
 
 inline bool StridesArePositive( IntegerArray strides ) {
@@ -797,7 +884,10 @@ void ImageWriteICS(
 } // namespace dip
 
 #ifdef DIP__ENABLE_DOCTEST
+#include <cstdio>
+
 #include "doctest.h"
+#include "diplib/iterators.h"
 #include "diplib/testing.h"
 
 DOCTEST_TEST_CASE( "[DIPlib] testing ICS file reading and writing" ) {
@@ -836,12 +926,63 @@ DOCTEST_TEST_CASE( "[DIPlib] testing ICS file reading and writing" ) {
    DOCTEST_CHECK( dip::testing::CompareImages( image, result ));
 }
 
+DOCTEST_TEST_CASE( "[DIPlib] testing ICSFrameSource" ) {
+   dip::Image image{ dip::UnsignedArray{ 21, 13, 6 }, 3, dip::DT_UINT16 };
+   dip::ImageIterator< dip::uint16 > it( image );
+   dip::uint16 value = 0;
+   do {
+      for( auto& sample : it ) {
+         sample = value++;
+      }
+   } while( ++it );
+   image.SetColorSpace( "RGB" );
+   auto copyFrames = []( dip::ImageConstRefArray const& window, dip::uint current, dip::Image& out ) {
+      out.Copy( window[ current ].get() );
+   };
+
+   // Planes stored one after the other, read sequentially
+   dip::Image scalar = image[ 1 ];
+   dip::ImageWriteICS( scalar, "test3.ics", {}, 7, { "v1", "gzip" } );
+   dip::ICSFrameSource source( "test3" );
+   DOCTEST_CHECK( source.NumberOfFrames() == 6 );
+   dip::Image result;
+   dip::ImageFrameSink sink( result, 6 );
+   dip::ProcessFrameSequence( source, sink, 1, copyFrames );
+   DOCTEST_CHECK( dip::testing::CompareImages( scalar, result ));
+
+   dip::ImageWriteICS( image, "test3.ics", {}, 7, { "v1", "uncompressed", "fast" } ); // tensor dimension first
+   dip::ICSFrameSource source2( "test3" );
+   dip::ImageFrameSink sink2( result, 6 );
+   dip::ProcessFrameSequence( source2, sink2, 1, copyFrames );
+   DOCTEST_CHECK( result.ColorSpace() == "RGB" );
+   DOCTEST_CHECK( dip::testing::CompareImages( image, result ));
+
+   // Planes not stored contiguously, read one at the time
+   dip::ImageWriteICS( image, "test3.ics", {}, 7, { "v1", "gzip" } ); // tensor dimension last
+   dip::ICSFrameSource source3( "test3" );
+   dip::ImageFrameSink sink3( result, 6 );
+   dip::ProcessFrameSequence( source3, sink3, 1, copyFrames );
+   DOCTEST_CHECK( result.ColorSpace() == "RGB" );
+   DOCTEST_CHECK( dip::testing::CompareImages( image, result ));
+
+   image.SwapDimensions( 0, 2 );
+   dip::ImageWriteICS( image, "test3.ics", {}, 7, { "v1", "uncompressed", "fast" } );
+   dip::ICSFrameSource source4( "test3" );
+   DOCTEST_CHECK( source4.NumberOfFrames() == 21 );
+   dip::ImageFrameSink sink4( result, 21 );
+   dip::ProcessFrameSequence( source4, sink4, 1, copyFrames );
+   DOCTEST_CHECK( dip::testing::CompareImages( image, result ));
+   std::remove( "test3.ics" );
+   std::remove( "test3.ids" );
+}
+
 #endif // DIP__ENABLE_DOCTEST
 
 #else // DIP__HAS_ICS
 
 #include "diplib.h"
 #include "diplib/file_io.h"
+#include "diplib/frame_sequence.h"
 
 namespace dip {
 
@@ -867,6 +1008,18 @@ void ImageWriteICS( Image const&, String const&, StringArray const&, dip::uint,
    DIP_THROW( NOT_AVAILABLE );
 }
 
+class ICSFrameSource::Reader {};
+
+ICSFrameSource::ICSFrameSource( String const& ) {
+   DIP_THROW( NOT_AVAILABLE );
+}
+
+ICSFrameSource::~ICSFrameSource() = default;
+
+bool ICSFrameSource::ReadFrame( Image& ) {
+   DIP_THROW( NOT_AVAILABLE );
+}
+
 }
 
 #endif // DIP__HAS_ICS
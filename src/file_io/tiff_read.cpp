@@ -20,9 +20,17 @@
 
 #ifdef DIP__HAS_TIFF
 
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
 #include "diplib.h"
 #include "diplib/file_io.h"
 #include "diplib/generic_iterators.h"
+#include "diplib/frame_sequence.h"
+#include "diplib/multithreading.h"
 
 #include "file_io_support.h"
 
@@ -40,9 +48,13 @@ constexpr char const* TIFF_DIRECTORY_NOT_FOUND = "Could not find the requested i
 class TiffFile {
    public:
       explicit TiffFile( String filename ) : filename_( std::move( filename )) {
-         // Set error and warning handlers, these are library-wide!
-         TIFFSetErrorHandler( nullptr );
-         TIFFSetWarningHandler( nullptr );
+         // Set error and warning handlers, these are library-wide! Files are opened concurrently, so we do
+         // this only once.
+         static std::once_flag handlersSet;
+         std::call_once( handlersSet, [] {
+            TIFFSetErrorHandler( nullptr );
+            TIFFSetWarningHandler( nullptr );
+         } );
          // Open the file for reading
          tiff_ = TIFFOpen( filename_.c_str(), "rc" ); // c == Disable the use of strip chopping when reading images.
          if( tiff_ == nullptr ) {
@@ -903,6 +915,132 @@ void ReadTIFFGreyValue(
    }
 }
 
+// Calls `read( thread, index )` for each `index` in [0,n), on `nThreads` threads; indices are handed out in
+// increasing order. If `deliver` is given, it is called in the calling thread for each index, in order, once
+// `read` is done with it, and at most `window` indices are read ahead of the one being delivered. Otherwise,
+// the calling thread is one of the `nThreads` threads. The first exception thrown stops the reading and is
+// rethrown once all threads have finished.
+void ReadConcurrently(
+      dip::uint n,
+      dip::uint nThreads,
+      std::function< void( dip::uint thread, dip::uint index ) > const& read,
+      std::function< void( dip::uint index ) > const& deliver = {},
+      dip::uint window = 0
+) {
+   std::mutex mutex;
+   std::condition_variable condition;
+   dip::uint next = 0;        // The next index to read
+   dip::uint delivered = 0;   // The indices below this one have been delivered
+   std::vector< bool > done( n, false );
+   bool abort = false;
+   std::exception_ptr error;
+   auto Fail = [ & ]( std::exception_ptr e ) {
+      std::lock_guard< std::mutex > lock( mutex );
+      if( !error ) {
+         error = e;
+      }
+      abort = true;
+      condition.notify_all();
+   };
+   auto Worker = [ & ]( dip::uint thread ) {
+      while( true ) {
+         dip::uint index;
+         {
+            std::unique_lock< std::mutex > lock( mutex );
+            condition.wait( lock, [ & ] { return abort || ( next >= n ) || !deliver || ( next < delivered + window ); } );
+            if( abort || ( next >= n )) {
+               return;
+            }
+            index = next++;
+         }
+         try {
+            read( thread, index );
+         } catch( ... ) {
+            Fail( std::current_exception() );
+            return;
+         }
+         std::lock_guard< std::mutex > lock( mutex );
+         done[ index ] = true;
+         condition.notify_all();
+      }
+   };
+   std::vector< std::thread > threads;
+   dip::uint nWorkers = deliver ? nThreads : nThreads - 1; // Without `deliver`, the calling thread is a worker
+   try {
+      for( dip::uint ii = 0; ii < nWorkers; ++ii ) {
+         threads.emplace_back( Worker, ii );
+      }
+   } catch( ... ) {
+      Fail( std::current_exception() );
+   }
+   if( deliver ) {
+      for( dip::uint ii = 0; ii < n; ++ii ) {
+         {
+            std::unique_lock< std::mutex > lock( mutex );
+            condition.wait( lock, [ & ] { return abort || done[ ii ]; } );
+            if( abort ) {
+               break;
+            }
+         }
+         try {
+            deliver( ii );
+         } catch( ... ) {
+            Fail( std::current_exception() );
+            break;
+         }
+         std::lock_guard< std::mutex > lock( mutex );
+         delivered = ii + 1;
+         condition.notify_all();
+      }
+   } else {
+      Worker( nWorkers );
+   }
+   for( auto& thread : threads ) {
+      thread.join();
+   }
+   if( error ) {
+      std::rethrow_exception( error );
+   }
+}
+
+// Test image plane to make sure it matches expectations
+void CheckTIFFStackPage(
+      TiffFile& tiff,
+      GetTIFFInfoData const& data,
+      DataType dataType
+) {
+   uint32 temp32;
+   READ_REQUIRED_TIFF_TAG( tiff, TIFFTAG_IMAGEWIDTH, &temp32 );
+   if( temp32 != data.fileInformation.sizes[ 0 ] ) {
+      DIP_THROW_RUNTIME( "Reading multi-slice TIFF: width of images not consistent" );
+   }
+   READ_REQUIRED_TIFF_TAG( tiff, TIFFTAG_IMAGELENGTH, &temp32 );
+   if( temp32 != data.fileInformation.sizes[ 1 ] ) {
+      DIP_THROW_RUNTIME( "Reading multi-slice TIFF: length of images not consistent" );
+   }
+   uint16 photometricInterpretation;
+   if( !TIFFGetField( tiff, TIFFTAG_PHOTOMETRIC, &photometricInterpretation )) {
+      photometricInterpretation = PHOTOMETRIC_MINISBLACK;
+   }
+   DataType pageDataType;
+   uint16 samplesPerPixel;
+   if( photometricInterpretation == PHOTOMETRIC_PALETTE ) {
+      pageDataType = DT_UINT16;
+      samplesPerPixel = 3;
+   } else {
+      DIP_STACK_TRACE_THIS( pageDataType = FindTIFFDataType( tiff ));
+      if( !TIFFGetField( tiff, TIFFTAG_SAMPLESPERPIXEL, &samplesPerPixel )) {
+         samplesPerPixel = 1;
+      }
+   }
+   if( pageDataType != dataType ) {
+      DIP_THROW_RUNTIME( "Reading multi-slice TIFF: data type not consistent" );
+   }
+   if( samplesPerPixel != data.fileInformation.tensorElements ) {
+      DIP_THROW_RUNTIME( "Reading multi-slice TIFF: samples per pixel not consistent" );
+   }
+}
+
 void ImageReadTIFFStack(
       Image& image,
       TiffFile& tiff,
@@ -914,62 +1052,104 @@ void ImageReadTIFFStack(
    data.fileInformation.sizes.push_back( imageNumbers.Size() );
    roiSpec.sizes.push_back( imageNumbers.Size() );
    roiSpec.mirror.push_back( false );
-   std::cout << "[ImageReadTIFFStack] roiSpec.sizes = " << roiSpec.sizes << ", roiSpec.tensorElements = " << roiSpec.tensorElements << '\n';
    image.ReForge( roiSpec.sizes, roiSpec.tensorElements, data.fileInformation.dataType );
    uint8* imagedata = static_cast< uint8* >( image.Origin() );
    dip::sint z_stride = image.Stride( 2 ) * static_cast< dip::sint >( data.fileInformation.dataType.SizeOf() );
-
-   // Read the image data for first plane
-   DIP_STACK_TRACE_THIS( ReadTIFFData( imagedata, image.Strides(), image.TensorStride(), image.DataType(), tiff, data.fileInformation, roiSpec ));
-
-   // Read the image data for other planes
-   dip::uint directory = imageNumbers.Offset();
-   for( dip::uint ii = 1; ii < image.Size( 2 ); ++ii ) {
-      imagedata += z_stride;
-      if( imageNumbers.start > imageNumbers.stop ) {
-         directory -= imageNumbers.step;
-      } else {
-         directory += imageNumbers.step;
+   dip::uint nPlanes = image.Size( 2 );
+   auto Directory = [ & ]( dip::uint plane ) {
+      return imageNumbers.start > imageNumbers.stop ? imageNumbers.Offset() - plane * imageNumbers.step
+                                                    : imageNumbers.Offset() + plane * imageNumbers.step;
+   };
+
+   // Each thread reads planes through its own handle to the file, the first thread uses `tiff`, which is
+   // at the directory for the first plane. Planes are handed out in order, so a thread usually moves
+   // forward a few directories to find its next plane. Small stacks are read in the calling thread only, it's not
+   // worth opening the file multiple times for them.
+   dip::uint nSamples = image.NumberOfPixels() * image.TensorElements();
+   dip::uint nThreads = nSamples < threadingThreshold ? 1 : std::min( GetNumberOfThreads(), nPlanes );
+   std::vector< std::unique_ptr< TiffFile >> files( nThreads );
+   std::vector< dip::uint > directories( nThreads, 0 );
+   directories[ 0 ] = Directory( 0 );
+   ReadConcurrently( nPlanes, nThreads, [ & ]( dip::uint thread, dip::uint plane ) {
+      if(( thread > 0 ) && !files[ thread ] ) {
+         files[ thread ].reset( new TiffFile( tiff.FileName() ));
       }
-      if( TIFFSetDirectory( tiff, static_cast< uint16 >( directory )) == 0 ) {
-         DIP_THROW_RUNTIME( TIFF_DIRECTORY_NOT_FOUND );
-      }
-
-      // Test image plane to make sure it matches expectations
-      uint32 temp32;
-      READ_REQUIRED_TIFF_TAG( tiff, TIFFTAG_IMAGEWIDTH, &temp32 );
-      if( temp32 != data.fileInformation.sizes[ 0 ] ) {
-         DIP_THROW_RUNTIME( "Reading multi-slice TIFF: width of images not consistent" );
-      }
-      READ_REQUIRED_TIFF_TAG( tiff, TIFFTAG_IMAGELENGTH, &temp32 );
-      if( temp32 != data.fileInformation.sizes[ 1 ] ) {
-         DIP_THROW_RUNTIME( "Reading multi-slice TIFF: length of images not consistent" );
+      TiffFile& file = thread > 0 ? *files[ thread ] : tiff;
+      dip::uint directory = Directory( plane );
+      if( directory != directories[ thread ] ) {
+         if( directory > directories[ thread ] && directory - directories[ thread ] <= nThreads * imageNumbers.step ) {
+            while( directories[ thread ] < directory ) {
+               if( TIFFReadDirectory( file ) == 0 ) {
+                  DIP_THROW_RUNTIME( TIFF_DIRECTORY_NOT_FOUND );
+               }
+               ++directories[ thread ];
+            }
+         } else {
+            if( TIFFSetDirectory( file, static_cast< uint16 >( directory )) == 0 ) {
+               DIP_THROW_RUNTIME( TIFF_DIRECTORY_NOT_FOUND );
+            }
+            directories[ thread ] = directory;
+         }
       }
-      uint16 photometricInterpretation;
-      if( !TIFFGetField( tiff, TIFFTAG_PHOTOMETRIC, &photometricInterpretation )) {
-         photometricInterpretation = PHOTOMETRIC_MINISBLACK;
+      if( plane > 0 ) {
+         DIP_STACK_TRACE_THIS( CheckTIFFStackPage( file, data, image.DataType() ));
       }
-      DataType dataType;
-      uint16 samplesPerPixel;
-      if( photometricInterpretation == PHOTOMETRIC_PALETTE ) {
-         dataType = DT_UINT16;
-         samplesPerPixel = 3;
-      } else {
-         DIP_STACK_TRACE_THIS( dataType = FindTIFFDataType( tiff ));
-         if( !TIFFGetField( tiff, TIFFTAG_SAMPLESPERPIXEL, &samplesPerPixel )) {
-            samplesPerPixel = 1;
+
+      // Read the image data for this plane
+      DIP_STACK_TRACE_THIS( ReadTIFFData( imagedata + static_cast< dip::sint >( plane ) * z_stride, image.Strides(),
+                                          image.TensorStride(), image.DataType(), file, data.fileInformation, roiSpec ));
+   } );
+}
+
+// Reads the current directory of `tiff` into `out`
+FileInformation ReadTIFFPage(
+      Image& out,
+      TiffFile& tiff,
+      RangeArray const& roi,
+      Range const& channels
+) {
+   // Get info
+   GetTIFFInfoData data;
+   DIP_STACK_TRACE_THIS( data = GetTIFFInfo( tiff ));
+
+   // Check & fix ROI information
+   RoiSpec roiSpec;
+   DIP_STACK_TRACE_THIS( roiSpec = CheckAndConvertRoi( roi, channels, data.fileInformation, 2 ));
+
+   // Hack by Bernd Rieger to recognize Leica 12 bit TIFFs
+   // These are written as color-mapped images, but they are not
+   if( data.photometricInterpretation == PHOTOMETRIC_PALETTE ) {
+      uint16 bitsPerSample;
+      String artist( 128, ' ' );
+      if(( TIFFGetField( tiff, TIFFTAG_BITSPERSAMPLE, &bitsPerSample )) &&
+         ( TIFFGetField( tiff, TIFFTAG_ARTIST, &( artist[ 0 ] )))) {
+         if(( artist == "Yves Nicodem" ) || ( artist == "TCS User" )) {
+            data.fileInformation.colorSpace = "";
+            data.photometricInterpretation = PHOTOMETRIC_MINISBLACK;
          }
       }
-      if( dataType != image.DataType() ) {
-         DIP_THROW_RUNTIME( "Reading multi-slice TIFF: data type not consistent" );
-      }
-      if( samplesPerPixel != data.fileInformation.tensorElements ) {
-         DIP_THROW_RUNTIME( "Reading multi-slice TIFF: samples per pixel not consistent" );
+   }
+   if( data.photometricInterpretation == PHOTOMETRIC_PALETTE ) {
+      DIP_THROW_IF( !roiSpec.isFullImage, "Reading ROI not supported for colormapped images" );
+      DIP_STACK_TRACE_THIS( ReadTIFFColorMap( out, tiff, data ));
+   } else {
+      if( data.fileInformation.dataType.IsBinary() ) {
+         DIP_THROW_IF( !roiSpec.isFullImage, "Reading ROI not supported for binary images" );
+         DIP_STACK_TRACE_THIS( ReadTIFFBinary( out, tiff, data ));
+      } else {
+         DIP_STACK_TRACE_THIS( ReadTIFFGreyValue( out, tiff, data, roiSpec ));
       }
+   }
 
-      // Read the image data for this plane
-      DIP_STACK_TRACE_THIS( ReadTIFFData( imagedata, image.Strides(), image.TensorStride(), image.DataType(), tiff, data.fileInformation, roiSpec ));
+   if( roiSpec.isAllChannels ) {
+      out.SetColorSpace( data.fileInformation.colorSpace );
    }
+   out.SetPixelSize( data.fileInformation.pixelSize );
+
+   // Apply the mirroring to the output image
+   out.Mirror( roiSpec.mirror );
+
+   return data.fileInformation;
 }
 
 } // namespace
@@ -992,44 +1172,20 @@ FileInformation ImageReadTIFF(
       DIP_THROW_RUNTIME( TIFF_DIRECTORY_NOT_FOUND );
    }
 
+   if( imageNumbers.start == imageNumbers.stop ) {
+      return ReadTIFFPage( out, tiff, roi, channels );
+   }
+
    // Get info
    GetTIFFInfoData data;
    DIP_STACK_TRACE_THIS( data = GetTIFFInfo( tiff ));
 
    // Check & fix ROI information
-   //dip::uint nDims = imageNumbers.start == imageNumbers.stop ? 2 : 3;
    RoiSpec roiSpec;
    DIP_STACK_TRACE_THIS( roiSpec = CheckAndConvertRoi( roi, channels, data.fileInformation, 2 ));
 
-   if( imageNumbers.start != imageNumbers.stop ) {
-      // Read in multiple pages as a 3D image
-      DIP_STACK_TRACE_THIS( ImageReadTIFFStack( out, tiff, data, imageNumbers, roiSpec ));
-   } else {
-      // Hack by Bernd Rieger to recognize Leica 12 bit TIFFs
-      // These are written as color-mapped images, but they are not
-      if( data.photometricInterpretation == PHOTOMETRIC_PALETTE ) {
-         uint16 bitsPerSample;
-         String artist( 128, ' ' );
-         if(( TIFFGetField( tiff, TIFFTAG_BITSPERSAMPLE, &bitsPerSample )) &&
-            ( TIFFGetField( tiff, TIFFTAG_ARTIST, &( artist[ 0 ] )))) {
-            if(( artist == "Yves Nicodem" ) || ( artist == "TCS User" )) {
-               data.fileInformation.colorSpace = "";
-               data.photometricInterpretation = PHOTOMETRIC_MINISBLACK;
-            }
-         }
-      }
-      if( data.photometricInterpretation == PHOTOMETRIC_PALETTE ) {
-         DIP_THROW_IF( !roiSpec.isFullImage, "Reading ROI not supported for colormapped images" );
-         DIP_STACK_TRACE_THIS( ReadTIFFColorMap( out, tiff, data ));
-      } else {
-         if( data.fileInformation.dataType.IsBinary() ) {
-            DIP_THROW_IF( !roiSpec.isFullImage, "Reading ROI not supported for binary images" );
-            DIP_STACK_TRACE_THIS( ReadTIFFBinary( out, tiff, data ));
-         } else {
-            DIP_STACK_TRACE_THIS( ReadTIFFGreyValue( out, tiff, data, roiSpec ));
-         }
-      }
-   }
+   // Read in multiple pages as a 3D image
+   DIP_STACK_TRACE_THIS( ImageReadTIFFStack( out, tiff, data, imageNumbers, roiSpec ));
 
    if( roiSpec.isAllChannels ) {
       out.SetColorSpace( data.fileInformation.colorSpace );
@@ -1059,39 +1215,130 @@ FileInformation ImageReadTIFF(
 
 void ImageReadTIFFSeries(
       Image& out,
-      StringArray const& filenames
+      StringArray const& filenames,
+      dip::uint nThreads
 ) {
    DIP_THROW_IF( filenames.size() < 1, E::ARRAY_PARAMETER_EMPTY );
 
    // Read in first image
    Image tmp;
-   dip::uint ii = 0;
-   DIP_STACK_TRACE_THIS( ImageReadTIFF( tmp, filenames[ ii ] )); // TODO: Read in first image plane or all image planes?
+   DIP_STACK_TRACE_THIS( ImageReadTIFF( tmp, filenames[ 0 ] )); // TODO: Read in first image plane or all image planes?
 
    // Prepare the output image
    UnsignedArray sizes = tmp.Sizes();
+   dip::uint dim = sizes.size();
    sizes.push_back( filenames.size() );
    out.ReForge( sizes, tmp.TensorElements(), tmp.DataType() );
-
-   // Iterate over the sub-images through the last dimension
-   ImageSliceIterator it( out, out.Dimensionality() - 1 );
-
-   // Write the first image into the output
-   it->Copy( tmp );
    // Make sure we copy over the color space information also
    if( tmp.IsColor() ) {
       out.SetColorSpace( tmp.ColorSpace() );
    }
 
-   // Read in the rest of the images, and write them into the output
-   while( ++ii, ++it ) {
-      DIP_STACK_TRACE_THIS( ImageReadTIFF( tmp, filenames[ ii ] ));
+   // Read in the rest of the images concurrently, and write them into the output
+   auto Slice = [ & ]( dip::uint index ) {
+      RangeArray ranges( dim + 1 );
+      ranges[ dim ] = Range{ static_cast< dip::sint >( index ) };
+      Image slice = out.At( ranges );
+      slice.Squeeze( dim );
+      slice.Protect();
+      return slice;
+   };
+   Slice( 0 ).Copy( tmp );
+   if( nThreads == 0 ) {
+      nThreads = GetNumberOfThreads();
+   }
+   nThreads = std::max< dip::uint >( std::min( nThreads, filenames.size() - 1 ), 1 );
+   ImageArray buffers( nThreads );
+   ReadConcurrently( filenames.size() - 1, nThreads, [ & ]( dip::uint thread, dip::uint index ) {
+      ++index; // We've already read the first image
+      DIP_STACK_TRACE_THIS( ImageReadTIFF( buffers[ thread ], filenames[ index ] ));
       try {
-         it->Copy( tmp );
+         Slice( index ).Copy( buffers[ thread ] );
       } catch( Error const& ) {
          DIP_THROW_RUNTIME( "Images in series do not have consistent sizes" );
       }
+   } );
+}
+
+void ImageReadTIFFSeries(
+      StringArray const& filenames,
+      TIFFSeriesCallback const& callback,
+      dip::uint nThreads
+) {
+   DIP_THROW_IF( !callback, E::INVALID_PARAMETER );
+   if( nThreads == 0 ) {
+      nThreads = GetNumberOfThreads();
    }
+   nThreads = std::max< dip::uint >( std::min( nThreads, filenames.size() ), 1 );
+   // Images are read into `images[ index ]`, and recycled through `freeImages` after `callback` is done with them
+   ImageArray images( filenames.size() );
+   ImageArray freeImages;
+   std::mutex freeImagesMutex;
+   ReadConcurrently( filenames.size(), nThreads, [ & ]( dip::uint, dip::uint index ) {
+      Image image;
+      {
+         std::lock_guard< std::mutex > lock( freeImagesMutex );
+         if( !freeImages.empty() ) {
+            image = std::move( freeImages.back() );
+            freeImages.pop_back();
+         }
+      }
+      DIP_STACK_TRACE_THIS( ImageReadTIFF( image, filenames[ index ] ));
+      images[ index ] = std::move( image );
+   }, [ & ]( dip::uint index ) {
+      Image& image = images[ index ];
+      callback( index, image );
+      // Only recycle the data segment if `callback` didn't take it or keep a reference to it, protect it, or change
+      // its layout. Note that an image that was moved from is still forged, but has a share count of 0.
+      if( image.IsForged() && ( image.ShareCount() == 1 ) && !image.IsExternalData() && !image.IsProtected() &&
+          image.HasNormalStrides() ) {
+         // Strip the properties, such that reading into it is the same as reading into a new image
+         image.ResetColorSpace();
+         image.ResetPixelSize();
+         image.ReshapeTensorAsVector();
+         std::lock_guard< std::mutex > lock( freeImagesMutex );
+         freeImages.push_back( std::move( image ));
+      }
+      image = Image{};
+   }, 2 * nThreads );
+}
+
+class TIFFFrameSource::Reader {
+   public:
+      explicit Reader( String const& filename ) : tiff( filename ) {}
+      TiffFile tiff;
+};
+
+TIFFFrameSource::TIFFFrameSource( String const& filename ) {
+   reader_.reset( new Reader( filename ));
+   filenames_.push_back( reader_->tiff.FileName() );
+   numberOfFrames_ = TIFFNumberOfDirectories( reader_->tiff );
+}
+
+TIFFFrameSource::TIFFFrameSource( StringArray const& filenames ) : filenames_( filenames ), numberOfFrames_( filenames.size() ) {
+   DIP_THROW_IF( filenames.empty(), E::ARRAY_PARAMETER_EMPTY );
+}
+
+TIFFFrameSource::~TIFFFrameSource() = default;
+
+bool TIFFFrameSource::ReadFrame( Image& out ) {
+   if( next_ >= numberOfFrames_ ) {
+      return false;
+   }
+   if( reader_ ) {
+      // The pages of a multi-page file are read in order, there's no need to search for the directory
+      if(( next_ > 0 ) && ( TIFFReadDirectory( reader_->tiff ) == 0 )) {
+         DIP_THROW_RUNTIME( TIFF_DIRECTORY_NOT_FOUND );
+      }
+      DIP_STACK_TRACE_THIS( ReadTIFFPage( out, reader_->tiff, {}, {} ));
+   } else {
+      DIP_STACK_TRACE_THIS( ImageReadTIFF( out, filenames_[ next_ ] ));
+   }
+   ++next_;
+   if( next_ == numberOfFrames_ ) {
+      reader_.reset(); // Close the file
+   }
+   return true;
 }
 
 FileInformation ImageReadTIFFInfo(
@@ -1128,10 +1375,151 @@ bool ImageIsTIFF(
 
 } // namespace dip
 
+#ifdef DIP__ENABLE_DOCTEST
+#include <cstdio>
+#include "doctest.h"
+#include "diplib/iterators.h"
+#include "diplib/testing.h"
+
+DOCTEST_TEST_CASE( "[DIPlib] testing TIFFFrameSource" ) {
+   dip::Image stack{ dip::UnsignedArray{ 21, 13, 6 }, 3, dip::DT_UINT16 };
+   dip::ImageIterator< dip::uint16 > it( stack );
+   dip::uint16 value = 0;
+   do {
+      for( auto& sample : it ) {
+         sample = value++;
+      }
+   } while( ++it );
+   stack.SetColorSpace( "RGB" );
+   auto copyFrames = []( dip::ImageConstRefArray const& window, dip::uint current, dip::Image& out ) {
+      out.Copy( window[ current ].get() );
+   };
+
+   // The pages of a multi-page file
+   dip::ImageWriteTIFF( stack, "test4.tif" );
+   dip::TIFFFrameSource source( "test4.tif" );
+   DOCTEST_CHECK( source.NumberOfFrames() == 6 );
+   dip::Image result;
+   dip::ImageFrameSink sink( result, 6 );
+   dip::ProcessFrameSequence( source, sink, 1, copyFrames );
+   DOCTEST_CHECK( sink.NumberOfFrames() == 6 );
+   DOCTEST_CHECK( dip::testing::CompareImages( stack, result ));
+   dip::Image frame;
+   DOCTEST_CHECK_FALSE( source.ReadFrame( frame ));
+
+   // The first page of each of a series of files
+   dip::StringArray filenames;
+   for( dip::uint ii = 0; ii < 6; ++ii ) {
+      filenames.push_back( "test4_" + std::to_string( ii ) + ".tif" );
+      dip::Image plane = stack.At( dip::Range{}, dip::Range{}, dip::Range{ static_cast< dip::sint >( ii ) } );
+      dip::ImageWriteTIFF( plane.Squeeze(), filenames.back() );
+   }
+   dip::TIFFFrameSource source2( filenames );
+   DOCTEST_CHECK( source2.NumberOfFrames() == 6 );
+   dip::ImageFrameSink sink2( result, 6 );
+   dip::ProcessFrameSequence( source2, sink2, 1, copyFrames );
+   DOCTEST_CHECK( dip::testing::CompareImages( stack, result ));
+
+   // A missing file stops the processing
+   filenames[ 3 ] = "test4_missing.tif";
+   dip::TIFFFrameSource source3( filenames );
+   dip::ImageFrameSink sink3( result, 6 );
+   DOCTEST_CHECK_THROWS( dip::ProcessFrameSequence( source3, sink3, 1, copyFrames ));
+
+   std::remove( "test4.tif" );
+   for( dip::uint ii = 0; ii < 6; ++ii ) {
+      std::remove(( "test4_" + std::to_string( ii ) + ".tif" ).c_str() );
+   }
+}
+
+DOCTEST_TEST_CASE( "[DIPlib] testing concurrent reading of TIFF stacks and series" ) {
+   dip::Image stack{ dip::UnsignedArray{ 64, 50, 10 }, 3, dip::DT_UINT8 };
+   dip::ImageIterator< dip::uint8 > it( stack );
+   dip::uint value = 0;
+   do {
+      for( auto& sample : it ) {
+         sample = static_cast< dip::uint8 >( value++ % 251 );
+      }
+   } while( ++it );
+   stack.SetColorSpace( "RGB" );
+   dip::ImageWriteTIFF( stack, "test5.tif" );
+   dip::StringArray filenames;
+   for( dip::uint ii = 0; ii < 10; ++ii ) {
+      filenames.push_back( "test5_" + std::to_string( ii ) + ".tif" );
+      dip::Image plane = stack.At( dip::Range{}, dip::Range{}, dip::Range{ static_cast< dip::sint >( ii ) } );
+      dip::ImageWriteTIFF( plane.Squeeze(), filenames.back() );
+   }
+
+   dip::uint maxThreads = dip::GetNumberOfThreads();
+   for( dip::uint nThreads : { dip::uint( 1 ), dip::uint( 4 ) } ) {
+      // Multi-page file: forward, reversed and strided
+      dip::SetNumberOfThreads( nThreads );
+      for( dip::Range range : { dip::Range{ 0, -1 }, dip::Range{ -1, 0 }, dip::Range{ 1, -1, 3 }, dip::Range{ -2, 0, 4 } } ) {
+         dip::Image result = dip::ImageReadTIFF( "test5.tif", range );
+         DOCTEST_CHECK( dip::testing::CompareImages( stack.At( dip::Range{}, dip::Range{}, range ), result ));
+      }
+      dip::SetNumberOfThreads( maxThreads );
+
+      // Series of files, into a single image
+      dip::Image result = dip::ImageReadTIFFSeries( filenames, nThreads );
+      DOCTEST_CHECK( dip::testing::CompareImages( stack, result ));
+
+      // Series of files, through the callback. Images kept or protected by the callback are not reused.
+      dip::ImageArray kept;
+      std::vector< dip::uint > indices;
+      dip::ImageReadTIFFSeries( filenames, [ & ]( dip::uint index, dip::Image& image ) {
+         indices.push_back( index );
+         if( index % 3 == 0 ) {
+            kept.push_back( std::move( image ));
+         } else if( index % 3 == 1 ) {
+            image.Protect();
+            kept.push_back( image );
+         } else {
+            kept.push_back( image.Copy() );
+         }
+      }, nThreads );
+      DOCTEST_REQUIRE( indices.size() == 10 );
+      for( dip::uint ii = 0; ii < 10; ++ii ) {
+         DOCTEST_CHECK( indices[ ii ] == ii );
+         dip::Image plane = stack.At( dip::Range{}, dip::Range{}, dip::Range{ static_cast< dip::sint >( ii ) } );
+         DOCTEST_CHECK( dip::testing::CompareImages( plane.Squeeze(), kept[ ii ] ));
+      }
+
+      // A missing file, or an exception in the callback, stops the reading
+      dip::StringArray badFilenames = filenames;
+      badFilenames[ 5 ] = "test5_missing.tif";
+      indices.clear();
+      DOCTEST_CHECK_THROWS( dip::ImageReadTIFFSeries( badFilenames, [ & ]( dip::uint index, dip::Image& ) {
+         indices.push_back( index );
+      }, nThreads ));
+      DOCTEST_CHECK( indices.size() <= 5 ); // Reading stopped at file 5, the images before it were delivered in order
+      for( dip::uint ii = 0; ii < indices.size(); ++ii ) {
+         DOCTEST_CHECK( indices[ ii ] == ii );
+      }
+      DOCTEST_CHECK_THROWS( dip::ImageReadTIFFSeries( badFilenames, nThreads ));
+      indices.clear();
+      DOCTEST_CHECK_THROWS( dip::ImageReadTIFFSeries( filenames, [ & ]( dip::uint index, dip::Image& ) {
+         indices.push_back( index );
+         if( index == 2 ) {
+            DIP_THROW( "Failed processing image" );
+         }
+      }, nThreads ));
+      DOCTEST_CHECK( indices == std::vector< dip::uint >{ 0, 1, 2 } );
+   }
+
+   std::remove( "test5.tif" );
+   for( auto const& filename : filenames ) {
+      std::remove( filename.c_str() );
+   }
+}
+
+#endif // DIP__ENABLE_DOCTEST
+
 #else // DIP__HAS_TIFF
 
 #include "diplib.h"
 #include "diplib/file_io.h"
+#include "diplib/frame_sequence.h"
 
 namespace dip {
 
@@ -1141,7 +1529,11 @@ FileInformation ImageReadTIFF( Image&, String const&, Range ) {
    DIP_THROW( NOT_AVAILABLE );
 }
 
-void ImageReadTIFFSeries( Image&, StringArray const& ) {
+void ImageReadTIFFSeries( Image&, StringArray const&, dip::uint ) {
+   DIP_THROW( NOT_AVAILABLE );
+}
+
+void ImageReadTIFFSeries( StringArray const&, TIFFSeriesCallback const&, dip::uint ) {
    DIP_THROW( NOT_AVAILABLE );
 }
 
@@ -1153,6 +1545,22 @@ bool ImageIsTIFF( String const& ) {
    DIP_THROW( NOT_AVAILABLE );
 }
 
+class TIFFFrameSource::Reader {};
+
+TIFFFrameSource::TIFFFrameSource( String const& ) {
+   DIP_THROW( NOT_AVAILABLE );
+}
+
+TIFFFrameSource::TIFFFrameSource( StringArray const& ) {
+   DIP_THROW( NOT_AVAILABLE );
+}
+
+TIFFFrameSource::~TIFFFrameSource() = default;
+
+bool TIFFFrameSource::ReadFrame( Image& ) {
+   DIP_THROW( NOT_AVAILABLE );
+}
+
 }
 
 #endif // DIP__HAS_TIFF
@@ -20,6 +20,8 @@
 
 #ifdef DIP__HAS_TIFF
 
+#include <mutex>
+
 #include "diplib.h"
 #include "diplib/file_io.h"
 
@@ -36,9 +38,13 @@ static const char* TIFF_WRITE_TAG = "Error writing tag to TIFF file";
 class TiffFile {
    public:
       explicit TiffFile( String const& filename ) {
-         // Set error and warning handlers, these are library-wide!
-         TIFFSetErrorHandler( nullptr );
-         TIFFSetWarningHandler( nullptr );
+         // Set error and warning handlers, these are library-wide! Files can be opened concurrently, so we do
+         // this only once.
+         static std::once_flag handlersSet;
+         std::call_once( handlersSet, [] {
+            TIFFSetErrorHandler( nullptr );
+            TIFFSetWarningHandler( nullptr );
+         } );
          // Open the file for writing
          if( FileHasExtension( filename )) {
             tiff_ = TIFFOpen( filename.c_str(), "w" );
@@ -270,29 +276,19 @@ void WriteTIFFStrips(
    }
 }
 
-} // namespace
-
-void ImageWriteTIFF(
+// Writes the tags and pixel data for the 2D image `image` to the current directory of `tiff`.
+void WriteTIFFPage(
       Image const& image,
-      String const& filename,
-      String const& compression,
+      TiffFile& tiff,
+      uint16 compmode,
       dip::uint jpegLevel
 ) {
-   DIP_THROW_IF( !image.IsForged(), E::IMAGE_NOT_FORGED );
-   DIP_THROW_IF( image.Dimensionality() != 2, E::DIMENSIONALITY_NOT_SUPPORTED );
-   // TODO: Implement writing of 3D images as a stack of 2D images
-
-   // Get image info and quit if we can't write
-   DIP_THROW_IF(( image.Size( 0 ) > std::numeric_limits< uint32 >::max() ) ||
-                ( image.Size( 1 ) > std::numeric_limits< uint32 >::max() ), "Image size too large for TIFF file" );
    uint32 imageWidth = static_cast< uint32 >( image.Size( 0 ));
    uint32 imageLength = static_cast< uint32 >( image.Size( 1 ));
    dip::uint sizeOf = image.DataType().SizeOf();
    uint16 bitsPerSample = 0;
    uint16 sampleFormat = 0;
-   if( image.DataType().IsBinary() ) {
-      DIP_THROW_IF( !image.IsScalar(), E::IMAGE_NOT_SCALAR ); // Binary images should not have multiple samples per pixel
-   } else {
+   if( !image.DataType().IsBinary() ) {
       bitsPerSample = static_cast< uint16 >( sizeOf * 8 );
       switch( image.DataType() ) {
          case DT_UINT8:
@@ -314,10 +310,6 @@ void ImageWriteTIFF(
             break;
       }
    }
-   uint16 compmode = CompressionTranslate( compression );
-
-   // Create the TIFF file and set the tags
-   TiffFile tiff( filename );
 
    if( image.DataType().IsBinary() ) {
       WRITE_TIFF_TAG( tiff, TIFFTAG_PHOTOMETRIC, uint16( PHOTOMETRIC_MINISBLACK ));
@@ -369,10 +361,53 @@ void ImageWriteTIFF(
    TIFFSetField( tiff, TIFFTAG_RESOLUTIONUNIT, uint16( RESUNIT_CENTIMETER ));
 }
 
+} // namespace
+
+void ImageWriteTIFF(
+      Image const& image,
+      String const& filename,
+      String const& compression,
+      dip::uint jpegLevel
+) {
+   DIP_THROW_IF( !image.IsForged(), E::IMAGE_NOT_FORGED );
+   DIP_THROW_IF(( image.Dimensionality() != 2 ) && ( image.Dimensionality() != 3 ), E::DIMENSIONALITY_NOT_SUPPORTED );
+
+   // Get image info and quit if we can't write
+   DIP_THROW_IF(( image.Size( 0 ) > std::numeric_limits< uint32 >::max() ) ||
+                ( image.Size( 1 ) > std::numeric_limits< uint32 >::max() ), "Image size too large for TIFF file" );
+   if( image.DataType().IsBinary() ) {
+      DIP_THROW_IF( !image.IsScalar(), E::IMAGE_NOT_SCALAR ); // Binary images should not have multiple samples per pixel
+   } else {
+      DIP_THROW_IF( image.DataType().IsComplex(), "Data type of image is not compatible with TIFF" );
+   }
+   uint16 compmode = CompressionTranslate( compression );
+
+   // Create the TIFF file
+   TiffFile tiff( filename );
+
+   if( image.Dimensionality() == 2 ) {
+      DIP_STACK_TRACE_THIS( WriteTIFFPage( image, tiff, compmode, jpegLevel ));
+   } else {
+      // A 3D image is written as a multi-page file, one page for each plane along the 3rd dimension
+      dip::uint nPages = image.Size( 2 );
+      DIP_THROW_IF( nPages > std::numeric_limits< uint16 >::max(), "Image size too large for TIFF file" );
+      for( dip::uint ii = 0; ii < nPages; ++ii ) {
+         Image plane = image.At( Range{}, Range{}, Range{ static_cast< dip::sint >( ii ) } );
+         plane.PermuteDimensions( { 0, 1 } ); // removes the singleton 3rd dimension
+         DIP_STACK_TRACE_THIS( WriteTIFFPage( plane, tiff, compmode, jpegLevel ));
+         if(( ii + 1 < nPages ) && ( TIFFWriteDirectory( tiff ) == 0 )) {
+            DIP_THROW_RUNTIME( "Error writing data" );
+         }
+      }
+   }
+}
+
 } // namespace dip
 
 #ifdef DIP__ENABLE_DOCTEST
+#include <cstdio>
 #include "doctest.h"
+#include "diplib/iterators.h"
 #include "diplib/testing.h"
 
 DOCTEST_TEST_CASE( "[DIPlib] testing TIFF file reading and writing" ) {
@@ -400,6 +435,26 @@ DOCTEST_TEST_CASE( "[DIPlib] testing TIFF file reading and writing" ) {
    DOCTEST_CHECK( dip::testing::CompareImages( image, result ));
 }
 
+DOCTEST_TEST_CASE( "[DIPlib] testing writing 3D images as multi-page TIFF files" ) {
+   dip::Image stack{ dip::UnsignedArray{ 30, 20, 5 }, 3, dip::DT_UINT16 };
+   dip::ImageIterator< dip::uint16 > it( stack );
+   dip::uint16 value = 0;
+   do {
+      for( auto& sample : it ) {
+         sample = value++;
+      }
+   } while( ++it );
+   stack.SetColorSpace( "RGB" );
+   dip::ImageWriteTIFF( stack, "test3.tif", "LZW" );
+   DOCTEST_CHECK( dip::ImageReadTIFFInfo( "test3.tif" ).numberOfImages == 5 );
+   dip::Image result = dip::ImageReadTIFF( "test3.tif", dip::Range{ 0, -1 } );
+   DOCTEST_CHECK( dip::testing::CompareImages( stack, result ));
+   result = dip::ImageReadTIFF( "test3.tif", dip::Range{ 2 } );
+   dip::Image plane = stack.At( dip::Range{}, dip::Range{}, dip::Range{ 2 } );
+   DOCTEST_CHECK( dip::testing::CompareImages( plane.Squeeze(), result ));
+   std::remove( "test3.tif" );
+}
+
 #endif // DIP__ENABLE_DOCTEST
 
 #else // DIP__HAS_TIFF
@@ -18,6 +18,8 @@
  * limitations under the License.
  */
 
+#include <cstdint>
+
 #include "diplib.h"
 #include "diplib/random.h"
 #include "diplib/generation.h"
@@ -27,251 +29,271 @@
 
 namespace dip {
 
-// TODO: Is there false sharing in these line filters?
-
 namespace {
-class UniformScanLineFilter : public Framework::ScanLineFilter {
+
+// The noise generators below are counter-based: the random values used for a sample depend only on a key taken
+// from the user's `dip::Random` object and on the linear index of the sample in the image. The output is thus
+// independent of how the Scan framework splits up the image into lines and over threads.
+
+constexpr std::uint64_t goldenGamma = 0x9E3779B97F4A7C15ull;
+
+// The SplitMix64 output function, a bijection with excellent avalanche properties.
+inline std::uint64_t Mix64( std::uint64_t z ) {
+   z = ( z ^ ( z >> 30u )) * 0xBF58476D1CE4E5B9ull;
+   z = ( z ^ ( z >> 27u )) * 0x94D049BB133111EBull;
+   return z ^ ( z >> 31u );
+}
+
+// Takes 64 random bits from `random`, which might produce only 32 bits at the time.
+std::uint64_t DrawKey( Random& random ) {
+   std::uint64_t key = static_cast< std::uint64_t >( random() );
+   if( sizeof( Random::result_type ) < sizeof( std::uint64_t )) {
+      key = ( key << 32u ) ^ static_cast< std::uint64_t >( random() );
+   }
+   return key;
+}
+
+// The random stream for a single sample. The first value is a hash of `key` and `index`. Samplers that need more
+// values (rejection sampling) continue with a SplitMix64 sequence seeded with that value.
+// Satisfies the requirements of a UniformRandomBitGenerator, so it can be used with the `<random>` distributions.
+class SampleRandom {
+   public:
+      using result_type = std::uint64_t;
+      static constexpr result_type min() { return 0; }
+      static constexpr result_type max() { return std::numeric_limits< result_type >::max(); }
+      SampleRandom( std::uint64_t key, std::uint64_t index ) : state_( Mix64( key + index * goldenGamma )) {}
+      result_type operator()() {
+         result_type out = state_;
+         state_ = Mix64( state_ + goldenGamma );
+         return out;
+      }
+   private:
+      std::uint64_t state_;
+};
+
+// Converts 64 random bits to a value in the half-open interval [0,1).
+inline dfloat UnitInterval( std::uint64_t bits ) {
+   return static_cast< dfloat >( bits >> 11u ) * ( 1.0 / 9007199254740992.0 ); // 53 bits
+}
+
+// The ziggurat method for the standard normal distribution (Marsaglia & Tsang, 2000), with 256 layers.
+// Most samples need a single random value, one table lookup and one multiplication.
+class Ziggurat {
+   public:
+      static constexpr dfloat r = 3.6541528853610088; // start of the tail
+      static constexpr dfloat v = 0.00492867323399;   // area of each layer
+
+      Ziggurat() {
+         x_[ 0 ] = v / Density( r );
+         x_[ 1 ] = r;
+         for( dip::uint ii = 1; ii < 255; ++ii ) {
+            x_[ ii + 1 ] = std::sqrt( -2.0 * std::log( v / x_[ ii ] + Density( x_[ ii ] )));
+         }
+         x_[ 256 ] = 0.0;
+         for( dip::uint ii = 0; ii < 257; ++ii ) {
+            f_[ ii ] = Density( x_[ ii ] );
+         }
+      }
+
+      dfloat operator()( SampleRandom& random ) const {
+         while( true ) {
+            std::uint64_t bits = random();
+            dip::uint layer = bits & 0xFFu;                   // the lowest 8 bits select the layer
+            dfloat u = 2.0 * UnitInterval( bits ) - 1.0;       // the highest 53 bits the position within it
+            dfloat x = u * x_[ layer ];
+            if( std::abs( x ) < x_[ layer + 1 ] ) {
+               return x;
+            }
+            if( layer == 0 ) {
+               // Sample from the tail
+               dfloat xx, yy;
+               do {
+                  xx = -std::log( 1.0 - UnitInterval( random() )) / r;
+                  yy = -std::log( 1.0 - UnitInterval( random() ));
+               } while( 2.0 * yy < xx * xx );
+               return u < 0.0 ? -( r + xx ) : r + xx;
+            }
+            if( f_[ layer + 1 ] + ( f_[ layer ] - f_[ layer + 1 ] ) * UnitInterval( random() ) < Density( x )) {
+               return x;
+            }
+         }
+      }
+
+   private:
+      dfloat x_[ 257 ];
+      dfloat f_[ 257 ];
+      static dfloat Density( dfloat x ) { return std::exp( -0.5 * x * x ); }
+};
+
+Ziggurat const& GetZiggurat() {
+   static Ziggurat const ziggurat;
+   return ziggurat;
+}
+
+// Base class for the noise line filters. `Filter` calls `Sample` for each pixel with a `SampleRandom` object
+// initialized for the pixel's linear index. The tensor dimension (if converted to a spatial dimension) is the
+// slowest-varying one in this index.
+template< typename TPI, typename Derived >
+class CounterBasedScanLineFilter : public Framework::ScanLineFilter {
    public:
-      virtual dip::uint GetNumberOfOperations( dip::uint, dip::uint, dip::uint ) override { return 40; }
       virtual void Filter( Framework::ScanLineFilterParameters const& params ) override {
-         dfloat const* in = static_cast< dfloat const* >( params.inBuffer[ 0 ].buffer );
+         TPI const* in = static_cast< TPI const* >( params.inBuffer[ 0 ].buffer );
          dip::sint inStride = params.inBuffer[ 0 ].stride;
          dip::uint const bufferLength = params.bufferLength;
-         dfloat* out = static_cast< dfloat* >( params.outBuffer[ 0 ].buffer );
+         TPI* out = static_cast< TPI* >( params.outBuffer[ 0 ].buffer );
          dip::sint const outStride = params.outBuffer[ 0 ].stride;
-         UniformRandomGenerator& generator = *generatorArray_[ params.thread ];
+         std::uint64_t index = 0;
+         for( dip::uint ii = 0; ii < params.position.size(); ++ii ) {
+            index += static_cast< std::uint64_t >( params.position[ ii ] ) * strides_[ ii ];
+         }
+         std::uint64_t step = strides_[ params.dimension ];
+         Derived const& self = static_cast< Derived const& >( *this );
          for( dip::uint kk = 0; kk < bufferLength; ++kk ) {
-            *out = *in + generator( lowerBound_, upperBound_ );
+            SampleRandom random( key_, index );
+            *out = self.Sample( *in, random );
             in += inStride;
             out += outStride;
+            index += step;
          }
       }
-      virtual void SetNumberOfThreads( dip::uint threads ) override  {
-         generatorArray_.resize( threads );
-         generatorArray_[ 0 ] = std::make_unique< UniformRandomGenerator >( random_ );
-         if( threads > 1 ) {
-            randomArray_.resize( threads - 1, Random( 0 ));
-            for( dip::uint ii = 1; ii < threads; ++ii ) {
-               randomArray_[ ii - 1 ] = random_.Split();
-               generatorArray_[ ii ] = std::make_unique< UniformRandomGenerator >( randomArray_[ ii - 1 ] );
-            }
+   protected:
+      CounterBasedScanLineFilter( Random& random, Image const& in ) : key_( DrawKey( random )) {
+         strides_.resize( in.Dimensionality() + 1 );
+         std::uint64_t stride = 1;
+         for( dip::uint ii = 0; ii < in.Dimensionality(); ++ii ) {
+            strides_[ ii ] = stride;
+            stride *= in.Size( ii );
          }
+         strides_.back() = stride;
+      }
+   private:
+      std::uint64_t key_;
+      std::vector< std::uint64_t > strides_;
+};
+
+// The framework options for the counter-based line filters: coordinates are needed to compute the linear index.
+constexpr Framework::ScanOptions counterBasedScanOptions = Framework::ScanOption::TensorAsSpatialDim + Framework::ScanOption::NeedCoordinates;
+
+class UniformScanLineFilter : public CounterBasedScanLineFilter< dfloat, UniformScanLineFilter > {
+   public:
+      virtual dip::uint GetNumberOfOperations( dip::uint, dip::uint, dip::uint ) override { return 20; }
+      dfloat Sample( dfloat in, SampleRandom& random ) const {
+         return in + lowerBound_ + range_ * UnitInterval( random() );
       }
-      UniformScanLineFilter( Random& random, dfloat lowerBound, dfloat upperBound ) :
-            random_( random ), lowerBound_( lowerBound ), upperBound_( upperBound ) {}
-      // Make the class non copyable (generatorArray_ cannot be copied)
-      UniformScanLineFilter( const UniformScanLineFilter& ) = delete;
-      UniformScanLineFilter& operator=( const UniformScanLineFilter& ) = delete;
+      UniformScanLineFilter( Random& random, Image const& in, dfloat lowerBound, dfloat upperBound ) :
+            CounterBasedScanLineFilter( random, in ), lowerBound_( lowerBound ), range_( upperBound - lowerBound ) {}
    private:
-      Random& random_;
-      std::vector< Random > randomArray_;
-      std::vector< std::unique_ptr< UniformRandomGenerator >> generatorArray_;
       dfloat lowerBound_;
-      dfloat upperBound_;
+      dfloat range_;
 };
+
 } // namespace
 
 void UniformNoise( Image const& in, Image& out, Random& random, dfloat lowerBound, dfloat upperBound ) {
    DIP_THROW_IF( !in.IsForged(), E::IMAGE_NOT_FORGED );
    DIP_THROW_IF( !in.DataType().IsReal(), E::DATA_TYPE_NOT_SUPPORTED );
-   UniformScanLineFilter filter( random, lowerBound, upperBound );
+   UniformScanLineFilter filter( random, in, lowerBound, upperBound );
    DataType dt = in.DataType();
-   Framework::ScanMonadic( in, out, DT_DFLOAT, dt, 1, filter, Framework::ScanOption::TensorAsSpatialDim );
+   Framework::ScanMonadic( in, out, DT_DFLOAT, dt, 1, filter, counterBasedScanOptions );
 }
 
 namespace {
-class GaussianScanLineFilter : public Framework::ScanLineFilter {
+
+class GaussianScanLineFilter : public CounterBasedScanLineFilter< dfloat, GaussianScanLineFilter > {
    public:
-      virtual dip::uint GetNumberOfOperations( dip::uint, dip::uint, dip::uint ) override { return 150; }
-      virtual void Filter( Framework::ScanLineFilterParameters const& params ) override {
-         dfloat const* in = static_cast< dfloat const* >( params.inBuffer[ 0 ].buffer );
-         dip::sint inStride = params.inBuffer[ 0 ].stride;
-         dip::uint const bufferLength = params.bufferLength;
-         dfloat* out = static_cast< dfloat* >( params.outBuffer[ 0 ].buffer );
-         dip::sint const outStride = params.outBuffer[ 0 ].stride;
-         GaussianRandomGenerator& generator = *( generatorArray_[ params.thread ] );
-         for( dip::uint kk = 0; kk < bufferLength; ++kk ) {
-            *out = generator( *in, std_ );
-            in += inStride;
-            out += outStride;
-         }
+      virtual dip::uint GetNumberOfOperations( dip::uint, dip::uint, dip::uint ) override { return 30; }
+      dfloat Sample( dfloat in, SampleRandom& random ) const {
+         return in + std_ * ziggurat_( random );
       }
-      virtual void SetNumberOfThreads( dip::uint threads ) override {
-         generatorArray_.resize( threads );
-         generatorArray_[ 0 ] = std::make_unique< GaussianRandomGenerator >( random_ );
-         if( threads > 1 ) {
-            randomArray_.resize( threads - 1, Random( 0 ));
-            for( dip::uint ii = 1; ii < threads; ++ii ) {
-               randomArray_[ ii - 1 ] = random_.Split();
-               generatorArray_[ ii ] = std::make_unique< GaussianRandomGenerator >( randomArray_[ ii - 1 ] );
-            }
-         }
-      }
-      GaussianScanLineFilter( Random& random, dfloat std ) : random_( random ), std_( std ) {}
-      // Make the class non copyable (generatorArray_ cannot be copied)
-      GaussianScanLineFilter( const GaussianScanLineFilter& ) = delete;
-      GaussianScanLineFilter& operator=( const GaussianScanLineFilter& ) = delete;
+      GaussianScanLineFilter( Random& random, Image const& in, dfloat std ) :
+            CounterBasedScanLineFilter( random, in ), std_( std ), ziggurat_( GetZiggurat() ) {}
    private:
-      Random& random_;
-      std::vector< Random > randomArray_;
-      std::vector< std::unique_ptr< GaussianRandomGenerator >> generatorArray_;
       dfloat std_;
+      Ziggurat const& ziggurat_;
 };
+
 } // namespace
 
 void GaussianNoise( Image const& in, Image& out, Random& random, dfloat variance ) {
    DIP_THROW_IF( !in.IsForged(), E::IMAGE_NOT_FORGED );
    DIP_THROW_IF( !in.DataType().IsReal(), E::DATA_TYPE_NOT_SUPPORTED );
-   GaussianScanLineFilter filter( random, std::sqrt( variance ));
+   GaussianScanLineFilter filter( random, in, std::sqrt( variance ));
    DataType dt = in.DataType();
-   Framework::ScanMonadic( in, out, DT_DFLOAT, dt, 1, filter, Framework::ScanOption::TensorAsSpatialDim );
+   Framework::ScanMonadic( in, out, DT_DFLOAT, dt, 1, filter, counterBasedScanOptions );
 }
 
 namespace {
-class PoissonScanLineFilter : public Framework::ScanLineFilter {
+
+class PoissonScanLineFilter : public CounterBasedScanLineFilter< dfloat, PoissonScanLineFilter > {
    public:
       virtual dip::uint GetNumberOfOperations( dip::uint, dip::uint, dip::uint ) override { return 800; }
-      virtual void Filter( Framework::ScanLineFilterParameters const& params ) override {
-         dfloat const* in = static_cast< dfloat const* >( params.inBuffer[ 0 ].buffer );
-         dip::sint inStride = params.inBuffer[ 0 ].stride;
-         dip::uint const bufferLength = params.bufferLength;
-         dfloat* out = static_cast< dfloat* >( params.outBuffer[ 0 ].buffer );
-         dip::sint const outStride = params.outBuffer[ 0 ].stride;
-         PoissonRandomGenerator& generator = *generatorArray_[ params.thread ];
-         for( dip::uint kk = 0; kk < bufferLength; ++kk ) {
-            *out = static_cast< dfloat >( generator( *in * conversion_ )) / conversion_;
-            in += inStride;
-            out += outStride;
-         }
-      }
-      virtual void SetNumberOfThreads( dip::uint threads ) override {
-         generatorArray_.resize( threads );
-         generatorArray_[ 0 ] = std::make_unique< PoissonRandomGenerator >( random_ );
-         if( threads > 1 ) {
-            randomArray_.resize( threads - 1, Random( 0 ));
-            for( dip::uint ii = 1; ii < threads; ++ii ) {
-               randomArray_[ ii - 1 ] = random_.Split();
-               generatorArray_[ ii ] = std::make_unique< PoissonRandomGenerator >( randomArray_[ ii - 1 ] );
-            }
-         }
+      dfloat Sample( dfloat in, SampleRandom& random ) const {
+         std::poisson_distribution< dip::uint > distribution( in * conversion_ );
+         return static_cast< dfloat >( distribution( random )) / conversion_;
       }
-      PoissonScanLineFilter( Random& random, dfloat conversion ) : random_( random ), conversion_( conversion ) {}
-      // Make the class non copyable (generatorArray_ cannot be copied)
-      PoissonScanLineFilter( const PoissonScanLineFilter& ) = delete;
-      PoissonScanLineFilter& operator=( const PoissonScanLineFilter& ) = delete;
+      PoissonScanLineFilter( Random& random, Image const& in, dfloat conversion ) :
+            CounterBasedScanLineFilter( random, in ), conversion_( conversion ) {}
    private:
-      Random& random_;
-      std::vector< Random > randomArray_;
-      std::vector< std::unique_ptr< PoissonRandomGenerator >> generatorArray_;
       dfloat conversion_;
 };
+
 } // namespace
 
 void PoissonNoise( Image const& in, Image& out, Random& random, dfloat conversion ) {
    DIP_THROW_IF( !in.IsForged(), E::IMAGE_NOT_FORGED );
    DIP_THROW_IF( !in.DataType().IsReal(), E::DATA_TYPE_NOT_SUPPORTED );
-   PoissonScanLineFilter filter( random, conversion );
+   PoissonScanLineFilter filter( random, in, conversion );
    DataType dt = in.DataType();
-   Framework::ScanMonadic( in, out, DT_DFLOAT, dt, 1, filter, Framework::ScanOption::TensorAsSpatialDim );
+   Framework::ScanMonadic( in, out, DT_DFLOAT, dt, 1, filter, counterBasedScanOptions );
 }
 
 namespace {
-class BinaryScanLineFilter : public Framework::ScanLineFilter {
+
+class BinaryScanLineFilter : public CounterBasedScanLineFilter< bin, BinaryScanLineFilter > {
    public:
-      virtual dip::uint GetNumberOfOperations( dip::uint, dip::uint, dip::uint ) override { return 40; }
-      virtual void Filter( Framework::ScanLineFilterParameters const& params ) override {
-         bin const* in = static_cast< bin const* >( params.inBuffer[ 0 ].buffer );
-         dip::sint inStride = params.inBuffer[ 0 ].stride;
-         dip::uint const bufferLength = params.bufferLength;
-         bin* out = static_cast< bin* >( params.outBuffer[ 0 ].buffer );
-         dip::sint const outStride = params.outBuffer[ 0 ].stride;
-         BinaryRandomGenerator& generator = *generatorArray_[ params.thread ];
-         for( dip::uint kk = 0; kk < bufferLength; ++kk ) {
-            *out = generator( *in ? pForeground_ : pBackground_ );
-            in += inStride;
-            out += outStride;
-         }
-      }
-      virtual void SetNumberOfThreads( dip::uint threads ) override {
-         generatorArray_.resize( threads );
-         generatorArray_[ 0 ] = std::make_unique< BinaryRandomGenerator >( random_ );
-         if( threads > 1 ) {
-            randomArray_.resize( threads - 1, Random( 0 ));
-            for( dip::uint ii = 1; ii < threads; ++ii ) {
-               randomArray_[ ii - 1 ] = random_.Split();
-               generatorArray_[ ii ] = std::make_unique< BinaryRandomGenerator >( randomArray_[ ii - 1 ] );
-            }
-         }
+      virtual dip::uint GetNumberOfOperations( dip::uint, dip::uint, dip::uint ) override { return 20; }
+      bin Sample( bin in, SampleRandom& random ) const {
+         return UnitInterval( random() ) < ( in ? pForeground_ : pBackground_ );
       }
-      BinaryScanLineFilter( Random& random, dfloat p10, dfloat p01 ) :
-            random_( random ), pForeground_( 1.0 - p10 ), pBackground_( p01 ) {}
-      // Make the class non copyable (generatorArray_ cannot be copied)
-      BinaryScanLineFilter( const BinaryScanLineFilter& ) = delete;
-      BinaryScanLineFilter& operator=( const BinaryScanLineFilter& ) = delete;
+      BinaryScanLineFilter( Random& random, Image const& in, dfloat p10, dfloat p01 ) :
+            CounterBasedScanLineFilter( random, in ), pForeground_( 1.0 - p10 ), pBackground_( p01 ) {}
    private:
-      Random& random_;
-      std::vector< Random > randomArray_;
-      std::vector< std::unique_ptr< BinaryRandomGenerator >> generatorArray_;
       dfloat pForeground_;
       dfloat pBackground_;
 };
+
 } // namespace
 
 void BinaryNoise( Image const& in, Image& out, Random& random, dfloat p10, dfloat p01 ) {
    DIP_THROW_IF( !in.IsForged(), E::IMAGE_NOT_FORGED );
    DIP_THROW_IF( !in.DataType().IsBinary(), E::IMAGE_NOT_BINARY );
-   BinaryScanLineFilter filter( random, p10, p01 );
-   Framework::ScanMonadic( in, out, DT_BIN, DT_BIN, 1, filter, Framework::ScanOption::TensorAsSpatialDim );
+   BinaryScanLineFilter filter( random, in, p10, p01 );
+   Framework::ScanMonadic( in, out, DT_BIN, DT_BIN, 1, filter, counterBasedScanOptions );
 }
 
 namespace {
-class SaltPepperScanLineFilter : public Framework::ScanLineFilter {
+
+class SaltPepperScanLineFilter : public CounterBasedScanLineFilter< dfloat, SaltPepperScanLineFilter > {
    public:
-      virtual dip::uint GetNumberOfOperations( dip::uint, dip::uint, dip::uint ) override { return 40; }
-      virtual void Filter( Framework::ScanLineFilterParameters const& params ) override {
-         dfloat const* in = static_cast< dfloat const* >( params.inBuffer[ 0 ].buffer );
-         dip::sint inStride = params.inBuffer[ 0 ].stride;
-         dip::uint const bufferLength = params.bufferLength;
-         dfloat* out = static_cast< dfloat* >( params.outBuffer[ 0 ].buffer );
-         dip::sint const outStride = params.outBuffer[ 0 ].stride;
-         UniformRandomGenerator& generator = *generatorArray_[ params.thread ];
-         for( dip::uint kk = 0; kk < bufferLength; ++kk ) {
-            dfloat p = generator( 0.0, 1.0 );
-            if( p < p0_ ) {
-               *out = 0;
-            } else if( p >= p1_ ) {
-               *out = white_;
-            } else {
-               *out = *in;
-            }
-            in += inStride;
-            out += outStride;
+      virtual dip::uint GetNumberOfOperations( dip::uint, dip::uint, dip::uint ) override { return 20; }
+      dfloat Sample( dfloat in, SampleRandom& random ) const {
+         dfloat p = UnitInterval( random() );
+         if( p < p0_ ) {
+            return 0;
          }
-      }
-      virtual void SetNumberOfThreads( dip::uint threads ) override  {
-         generatorArray_.resize( threads );
-         generatorArray_[ 0 ] = std::make_unique< UniformRandomGenerator >( random_ );
-         if( threads > 1 ) {
-            randomArray_.resize( threads - 1, Random( 0 ));
-            for( dip::uint ii = 1; ii < threads; ++ii ) {
-               randomArray_[ ii - 1 ] = random_.Split();
-               generatorArray_[ ii ] = std::make_unique< UniformRandomGenerator >( randomArray_[ ii - 1 ] );
-            }
+         if( p >= p1_ ) {
+            return white_;
          }
+         return in;
       }
-      SaltPepperScanLineFilter( Random& random, dfloat p0, dfloat p1, dfloat white ) :
-            random_( random ), p0_( p0 ), p1_( 1.0 - p1 ), white_( white ) {}
-      // Make the class non copyable (generatorArray_ cannot be copied)
-      SaltPepperScanLineFilter( const SaltPepperScanLineFilter& ) = delete;
-      SaltPepperScanLineFilter& operator=( const SaltPepperScanLineFilter& ) = delete;
+      SaltPepperScanLineFilter( Random& random, Image const& in, dfloat p0, dfloat p1, dfloat white ) :
+            CounterBasedScanLineFilter( random, in ), p0_( p0 ), p1_( 1.0 - p1 ), white_( white ) {}
    private:
-      Random& random_;
-      std::vector< Random > randomArray_;
-      std::vector< std::unique_ptr< UniformRandomGenerator >> generatorArray_;
       dfloat p0_;
       dfloat p1_;
       dfloat white_;
 };
+
 } // namespace
 
 void SaltPepperNoise( Image const& in, Image& out, Random& random, dfloat p0, dfloat p1, dfloat white ) {
@@ -283,9 +305,9 @@ void SaltPepperNoise( Image const& in, Image& out, Random& random, dfloat p0, df
       p0 /= s;
       p1 /= s; // This means the whole image will be black and white noise!
    }
-   SaltPepperScanLineFilter filter( random, p0, p1, white );
+   SaltPepperScanLineFilter filter( random, in, p0, p1, white );
    DataType dt = in.DataType();
-   Framework::ScanMonadic( in, out, DT_DFLOAT, dt, 1, filter, Framework::ScanOption::TensorAsSpatialDim );
+   Framework::ScanMonadic( in, out, DT_DFLOAT, dt, 1, filter, counterBasedScanOptions );
 }
 
 void FillColoredNoise( Image& out, Random& random, dfloat variance, dfloat color ) {
@@ -322,3 +344,35 @@ void FillColoredNoise( Image& out, Random& random, dfloat variance, dfloat color
 }
 
 } // namespace dip
+
+#ifdef DIP__ENABLE_DOCTEST
+#include "doctest.h"
+#include "diplib/multithreading.h"
+#include "diplib/testing.h"
+
+DOCTEST_TEST_CASE("[DIPlib] testing the noise generators") {
+   dip::Image img( { 300, 200 }, 3, dip::DT_SFLOAT );
+   img.Fill( 0 );
+   dip::uint nThreads = dip::GetNumberOfThreads();
+   // The result must not depend on the number of threads
+   dip::SetNumberOfThreads( 1 );
+   dip::Random random1( 42 );
+   dip::Image gauss1 = dip::GaussianNoise( img, random1, 4.0 );
+   dip::Image poisson1 = dip::PoissonNoise( img + 10, random1, 1.0 );
+   dip::SetNumberOfThreads( 4 );
+   dip::Random random4( 42 );
+   dip::Image gauss4 = dip::GaussianNoise( img, random4, 4.0 );
+   dip::Image poisson4 = dip::PoissonNoise( img + 10, random4, 1.0 );
+   dip::SetNumberOfThreads( nThreads );
+   DOCTEST_CHECK( dip::testing::CompareImages( gauss1, gauss4, dip::Option::CompareImagesMode::EXACT ));
+   DOCTEST_CHECK( dip::testing::CompareImages( poisson1, poisson4, dip::Option::CompareImagesMode::EXACT ));
+   // Check the distributions
+   gauss1.TensorToSpatial();
+   poisson1.TensorToSpatial();
+   DOCTEST_CHECK( std::abs( dip::Mean( gauss1 ).As< dip::dfloat >() ) < 0.02 );
+   DOCTEST_CHECK( std::abs( dip::StandardDeviation( gauss1 ).As< dip::dfloat >() - 2.0 ) < 0.02 );
+   DOCTEST_CHECK( std::abs( dip::Mean( poisson1 ).As< dip::dfloat >() - 10.0 ) < 0.05 );
+   DOCTEST_CHECK( std::abs( dip::Variance( poisson1 ).As< dip::dfloat >() - 10.0 ) < 0.2 );
+}
+
+#endif // DIP__ENABLE_DOCTEST
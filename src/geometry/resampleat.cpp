@@ -18,9 +18,13 @@
  * limitations under the License.
  */
 
+#include <array>
+#include <cmath>
+#include <memory>
+
 #include "diplib.h"
 #include "diplib/geometry.h"
-#include "diplib/generic_iterators.h"
+#include "diplib/framework.h"
 #include "diplib/overload.h"
 
 namespace dip {
@@ -31,15 +35,18 @@ enum class Method {
       NEAREST_NEIGHBOR,
       LINEAR,
       CUBIC_ORDER_3,
+      BSPLINE,
 };
 
-Method ParseMethod( String const& method ) {
+Method ParseMethod( String const& method, bool allowBSpline = false ) {
    if( method.empty() || ( method == S::LINEAR )) {
       return Method::LINEAR;
    } else if(( method == "cubic" ) || ( method == S::CUBIC_ORDER_3 )) {
       return Method::CUBIC_ORDER_3;
    } else if(( method == "nn" ) || ( method == S::NEAREST )) {
       return Method::NEAREST_NEIGHBOR;
+   } else if( allowBSpline && ( method == S::BSPLINE )) {
+      return Method::BSPLINE;
    } else {
       DIP_THROW_INVALID_FLAG( method );
    }
@@ -185,6 +192,325 @@ InterpolationFunctionPointer GetInterpFunctionPtr( String const& method, DataTyp
    return function;
 }
 
+//
+// Batched interpolation, used when resampling at many points at once
+//
+
+// The samples along one dimension that contribute to the interpolated value: `offset` is the offset of each sample
+// w.r.t. the image origin, `weight` is its interpolation weight. Out-of-bounds samples are replaced by in-bounds
+// ones according to the boundary condition of the interpolator. Computing these once per point and dimension allows
+// the interpolation itself to be a simple sum of products over a fixed-size neighborhood.
+template< dip::uint Taps >
+struct InterpolationTaps {
+   std::array< dip::sint, Taps > offset;
+   std::array< dfloat, Taps > weight;
+};
+
+// Integer part of `pos`, such that the fractional part is always in [0,1], with the sample to its right within the
+// image if the image has more than one sample. `pos` is assumed to be within the image domain.
+inline dip::uint SplitCoordinate( dfloat& pos, dip::uint size ) {
+   dip::uint ii = static_cast< dip::uint >( pos );
+   if(( ii == size - 1 ) && ( ii > 0 )) {
+      --ii;
+   }
+   pos -= static_cast< dfloat >( ii );
+   return ii;
+}
+
+inline dip::sint NearestNeighborTaps( dfloat pos, dip::sint stride ) {
+   dip::uint ii = static_cast< dip::uint >( pos );
+   if( pos - static_cast< dfloat >( ii ) > 0.5 ) {
+      ++ii;
+   }
+   return static_cast< dip::sint >( ii ) * stride;
+}
+
+inline void LinearTaps( dfloat pos, dip::uint size, dip::sint stride, InterpolationTaps< 2 >& taps ) {
+   dip::uint ii = SplitCoordinate( pos, size );
+   taps.offset[ 0 ] = static_cast< dip::sint >( ii ) * stride;
+   taps.offset[ 1 ] = static_cast< dip::sint >( std::min( ii + 1, size - 1 )) * stride;
+   taps.weight[ 0 ] = 1.0 - pos;
+   taps.weight[ 1 ] = pos;
+}
+
+// Same weights as `ThirdOrderCubicSpline1D`, the image is extended by replicating the edge samples
+inline void ThirdOrderCubicSplineTaps( dfloat pos, dip::uint size, dip::sint stride, InterpolationTaps< 4 >& taps ) {
+   dip::uint ii = SplitCoordinate( pos, size );
+   taps.offset[ 0 ] = static_cast< dip::sint >( ii == 0 ? 0 : ii - 1 ) * stride;
+   taps.offset[ 1 ] = static_cast< dip::sint >( ii ) * stride;
+   taps.offset[ 2 ] = static_cast< dip::sint >( std::min( ii + 1, size - 1 )) * stride;
+   taps.offset[ 3 ] = static_cast< dip::sint >( std::min( ii + 2, size - 1 )) * stride;
+   dfloat pos2 = pos * pos;
+   dfloat pos3 = pos2 * pos;
+   taps.weight[ 0 ] = ( -pos3 + 2.0 * pos2 - pos ) / 2.0;
+   taps.weight[ 1 ] = ( 3.0 * pos3 - 5.0 * pos2 + 2.0) / 2.0;
+   taps.weight[ 2 ] = ( -3.0 * pos3 + 4.0 * pos2 + pos ) / 2.0;
+   taps.weight[ 3 ] = ( pos3 - pos2 ) / 2.0;
+}
+
+// Cubic B-spline basis, applied to the B-spline coefficients (see `BSplineCoefficients`), which are mirrored at
+// the image edges
+inline dip::sint MirrorIndex( dip::sint index, dip::uint size ) {
+   dip::sint last = static_cast< dip::sint >( size ) - 1;
+   if( index < 0 ) {
+      index = -index;
+   } else if( index > last ) {
+      index = 2 * last - index;
+   }
+   return clamp( index, dip::sint( 0 ), last ); // for images with fewer than 3 samples along this dimension
+}
+
+inline void BSplineTaps( dfloat pos, dip::uint size, dip::sint stride, InterpolationTaps< 4 >& taps ) {
+   dip::sint ii = static_cast< dip::sint >( SplitCoordinate( pos, size ));
+   for( dip::sint jj = 0; jj < 4; ++jj ) {
+      taps.offset[ static_cast< dip::uint >( jj ) ] = MirrorIndex( ii + jj - 1, size ) * stride;
+   }
+   dfloat pos2 = pos * pos;
+   dfloat pos3 = pos2 * pos;
+   dfloat neg = 1.0 - pos;
+   taps.weight[ 0 ] = neg * neg * neg / 6.0;
+   taps.weight[ 1 ] = ( 3.0 * pos3 - 6.0 * pos2 + 4.0 ) / 6.0;
+   taps.weight[ 2 ] = ( -3.0 * pos3 + 3.0 * pos2 + 3.0 * pos + 1.0 ) / 6.0;
+   taps.weight[ 3 ] = pos3 / 6.0;
+}
+
+// Interpolates at the point described by `taps`, one element per dimension. The last dimension is the outer loop,
+// the sums are computed in the same order as in `LinearND` and `ThirdOrderCubicSplineND`, so that the results are
+// identical.
+template< dip::uint Taps, typename TPI >
+DoubleType< TPI > InterpolateTaps( TPI const* src, InterpolationTaps< Taps > const* taps, dip::uint dim ) {
+   using TPD = DoubleType< TPI >;
+   InterpolationTaps< Taps > const& tt = taps[ dim ];
+   if( dim == 0 ) {
+      TPD sum = static_cast< TPD >( src[ tt.offset[ 0 ]] ) * tt.weight[ 0 ];
+      for( dip::uint kk = 1; kk < Taps; ++kk ) {
+         sum += static_cast< TPD >( src[ tt.offset[ kk ]] ) * tt.weight[ kk ];
+      }
+      return sum;
+   }
+   if( dim == 1 ) {
+      InterpolationTaps< Taps > const& t0 = taps[ 0 ];
+      TPD sum{};
+      for( dip::uint kk = 0; kk < Taps; ++kk ) {
+         TPI const* line = src + tt.offset[ kk ];
+         TPD value = static_cast< TPD >( line[ t0.offset[ 0 ]] ) * t0.weight[ 0 ];
+         for( dip::uint jj = 1; jj < Taps; ++jj ) {
+            value += static_cast< TPD >( line[ t0.offset[ jj ]] ) * t0.weight[ jj ];
+         }
+         sum = kk == 0 ? value * tt.weight[ 0 ] : sum + value * tt.weight[ kk ];
+      }
+      return sum;
+   }
+   TPD sum = InterpolateTaps( src + tt.offset[ 0 ], taps, dim - 1 ) * tt.weight[ 0 ];
+   for( dip::uint kk = 1; kk < Taps; ++kk ) {
+      sum += InterpolateTaps( src + tt.offset[ kk ], taps, dim - 1 ) * tt.weight[ kk ];
+   }
+   return sum;
+}
+
+// Resamples `in` at the coordinates given by the input buffer, a vector of `nDims` elements per pixel. For nearest
+// neighbor interpolation the output buffer has type `TPI`, otherwise it has type `DoubleType< TPI >`.
+template< typename TPI >
+class ResampleAtLineFilter : public Framework::ScanLineFilter {
+   public:
+      ResampleAtLineFilter( Image const& in, Method method, Image::Pixel const& fill )
+            : in_( static_cast< TPI const* >( in.Origin() )), sizes_( in.Sizes() ), strides_( in.Strides() ),
+              tensorStride_( in.TensorStride() ), tensorElements_( in.TensorElements() ), method_( method ) {
+         bool scalarFill = fill.TensorElements() == 1;
+         for( dip::uint ii = 0; ii < tensorElements_; ++ii ) {
+            Image::Sample sample = fill[ scalarFill ? 0 : ii ];
+            fill_.push_back( sample.As< TPI >() );
+            fillDouble_.push_back( sample.As< DoubleType< TPI >>() );
+         }
+      }
+
+      virtual dip::uint GetNumberOfOperations( dip::uint, dip::uint, dip::uint ) override {
+         dip::uint taps = method_ == Method::NEAREST_NEIGHBOR ? 1 : ( method_ == Method::LINEAR ? 2 : 4 );
+         dip::uint nDims = sizes_.size();
+         dip::uint neighborhood = 1;
+         for( dip::uint ii = 0; ii < nDims; ++ii ) {
+            neighborhood *= taps;
+         }
+         return nDims * 20 + neighborhood * tensorElements_ * 2;
+      }
+
+      virtual void Filter( Framework::ScanLineFilterParameters const& params ) override {
+         switch( method_ ) {
+            case Method::NEAREST_NEIGHBOR:
+               FilterNearestNeighbor( params );
+               break;
+            case Method::LINEAR:
+               FilterInterpolated< 2 >( params, LinearTaps );
+               break;
+            case Method::CUBIC_ORDER_3:
+               FilterInterpolated< 4 >( params, ThirdOrderCubicSplineTaps );
+               break;
+            case Method::BSPLINE:
+               FilterInterpolated< 4 >( params, BSplineTaps );
+               break;
+         }
+      }
+
+   private:
+      TPI const* in_;
+      UnsignedArray sizes_;
+      IntegerArray strides_;
+      dip::sint tensorStride_;
+      dip::uint tensorElements_;
+      Method method_;
+      std::vector< TPI > fill_;
+      std::vector< DoubleType< TPI >> fillDouble_;
+
+      // Returns false if `coords` is outside the image domain (NaN is also outside)
+      bool IsInside( dfloat const* coords, dip::sint coordsTensorStride ) const {
+         for( dip::uint ii = 0; ii < sizes_.size(); ++ii, coords += coordsTensorStride ) {
+            if( !(( *coords >= 0.0 ) && ( *coords <= static_cast< dfloat >( sizes_[ ii ] - 1 )))) {
+               return false;
+            }
+         }
+         return true;
+      }
+
+      void FilterNearestNeighbor( Framework::ScanLineFilterParameters const& params ) {
+         dip::uint nDims = sizes_.size();
+         dfloat const* coords = static_cast< dfloat const* >( params.inBuffer[ 0 ].buffer );
+         dip::sint coordsStride = params.inBuffer[ 0 ].stride;
+         dip::sint coordsTensorStride = params.inBuffer[ 0 ].tensorStride;
+         TPI* out = static_cast< TPI* >( params.outBuffer[ 0 ].buffer );
+         dip::sint outStride = params.outBuffer[ 0 ].stride;
+         dip::sint outTensorStride = params.outBuffer[ 0 ].tensorStride;
+         for( dip::uint ii = 0; ii < params.bufferLength; ++ii, coords += coordsStride, out += outStride ) {
+            TPI* oPtr = out;
+            if( IsInside( coords, coordsTensorStride )) {
+               TPI const* src = in_;
+               dfloat const* cPtr = coords;
+               for( dip::uint jj = 0; jj < nDims; ++jj, cPtr += coordsTensorStride ) {
+                  src += NearestNeighborTaps( *cPtr, strides_[ jj ] );
+               }
+               for( dip::uint jj = 0; jj < tensorElements_; ++jj, src += tensorStride_, oPtr += outTensorStride ) {
+                  *oPtr = *src;
+               }
+            } else {
+               for( dip::uint jj = 0; jj < tensorElements_; ++jj, oPtr += outTensorStride ) {
+                  *oPtr = fill_[ jj ];
+               }
+            }
+         }
+      }
+
+      template< dip::uint Taps, typename TapsFunction >
+      void FilterInterpolated( Framework::ScanLineFilterParameters const& params, TapsFunction tapsFunction ) {
+         using TPD = DoubleType< TPI >;
+         dip::uint nDims = sizes_.size();
+         DimensionArray< InterpolationTaps< Taps >> taps( nDims );
+         dfloat const* coords = static_cast< dfloat const* >( params.inBuffer[ 0 ].buffer );
+         dip::sint coordsStride = params.inBuffer[ 0 ].stride;
+         dip::sint coordsTensorStride = params.inBuffer[ 0 ].tensorStride;
+         TPD* out = static_cast< TPD* >( params.outBuffer[ 0 ].buffer );
+         dip::sint outStride = params.outBuffer[ 0 ].stride;
+         dip::sint outTensorStride = params.outBuffer[ 0 ].tensorStride;
+         for( dip::uint ii = 0; ii < params.bufferLength; ++ii, coords += coordsStride, out += outStride ) {
+            TPD* oPtr = out;
+            if( IsInside( coords, coordsTensorStride )) {
+               dfloat const* cPtr = coords;
+               for( dip::uint jj = 0; jj < nDims; ++jj, cPtr += coordsTensorStride ) {
+                  tapsFunction( *cPtr, sizes_[ jj ], strides_[ jj ], taps[ jj ] );
+               }
+               TPI const* src = in_;
+               for( dip::uint jj = 0; jj < tensorElements_; ++jj, src += tensorStride_, oPtr += outTensorStride ) {
+                  *oPtr = InterpolateTaps( src, taps.data(), nDims - 1 );
+               }
+            } else {
+               for( dip::uint jj = 0; jj < tensorElements_; ++jj, oPtr += outTensorStride ) {
+                  *oPtr = fillDouble_[ jj ];
+               }
+            }
+         }
+      }
+};
+
+// Computes the cubic B-spline coefficients along image lines, such that the B-spline interpolates the samples.
+// The image is mirrored at its edges. This is the recursive filter of Unser et al., "B-spline signal processing",
+// IEEE Transactions on Signal Processing 41(2):821-833, 1993. TPF is dfloat or dcomplex.
+template< typename TPF >
+class BSplineCoefficientsLineFilter : public Framework::SeparableLineFilter {
+   public:
+      virtual dip::uint GetNumberOfOperations( dip::uint lineLength, dip::uint, dip::uint, dip::uint ) override {
+         return lineLength * 6;
+      }
+
+      virtual void Filter( Framework::SeparableLineFilterParameters const& params ) override {
+         TPF const* in = static_cast< TPF const* >( params.inBuffer.buffer );
+         dip::sint inStride = params.inBuffer.stride;
+         TPF* out = static_cast< TPF* >( params.outBuffer.buffer );
+         dip::sint stride = params.outBuffer.stride;
+         dip::uint length = params.inBuffer.length;
+         if( length < 2 ) {
+            out[ 0 ] = in[ 0 ];
+            return;
+         }
+         constexpr dfloat gain = 6.0; // ( 1 - pole ) * ( 1 - 1 / pole )
+         for( dip::uint ii = 0; ii < length; ++ii ) {
+            out[ static_cast< dip::sint >( ii ) * stride ] = in[ static_cast< dip::sint >( ii ) * inStride ] * gain;
+         }
+         dip::sint last = static_cast< dip::sint >( length - 1 ) * stride;
+         // Causal filter
+         out[ 0 ] = CausalInitialValue( out, length, stride );
+         for( dip::sint ii = stride; ii <= last; ii += stride ) {
+            out[ ii ] += pole_ * out[ ii - stride ];
+         }
+         // Anti-causal filter
+         out[ last ] = ( pole_ / ( pole_ * pole_ - 1.0 )) * ( pole_ * out[ last - stride ] + out[ last ] );
+         for( dip::sint ii = last - stride; ii >= 0; ii -= stride ) {
+            out[ ii ] = pole_ * ( out[ ii + stride ] - out[ ii ] );
+         }
+      }
+
+   private:
+      dfloat const pole_ = std::sqrt( 3.0 ) - 2.0;
+
+      TPF CausalInitialValue( TPF const* data, dip::uint length, dip::sint stride ) const {
+         constexpr dfloat tolerance = 1e-12;
+         dip::uint horizon = static_cast< dip::uint >( std::ceil( std::log( tolerance ) / std::log( std::abs( pole_ ))));
+         if( horizon < length ) {
+            // The mirrored part of the line does not contribute significantly
+            TPF sum = data[ 0 ];
+            dfloat zn = pole_;
+            for( dip::uint ii = 1; ii < horizon; ++ii ) {
+               sum += zn * data[ static_cast< dip::sint >( ii ) * stride ];
+               zn *= pole_;
+            }
+            return sum;
+         }
+         // Full sum over the mirrored line
+         dfloat zn = pole_;
+         dfloat iz = 1.0 / pole_;
+         dfloat z2n = std::pow( pole_, static_cast< dfloat >( length - 1 ));
+         TPF sum = data[ 0 ] + z2n * data[ static_cast< dip::sint >( length - 1 ) * stride ];
+         z2n *= z2n * iz;
+         for( dip::uint ii = 1; ii < length - 1; ++ii ) {
+            sum += ( zn + z2n ) * data[ static_cast< dip::sint >( ii ) * stride ];
+            zn *= pole_;
+            z2n *= iz;
+         }
+         return sum / ( 1.0 - zn * zn );
+      }
+};
+
+// Computes the B-spline coefficients for `in`, `out` is of type DT_DFLOAT or DT_DCOMPLEX
+void BSplineCoefficients( Image const& in, Image& out ) {
+   bool isComplex = in.DataType().IsComplex();
+   DataType dt = isComplex ? DT_DCOMPLEX : DT_DFLOAT;
+   std::unique_ptr< Framework::SeparableLineFilter > lineFilter;
+   if( isComplex ) {
+      lineFilter = std::make_unique< BSplineCoefficientsLineFilter< dcomplex >>();
+   } else {
+      lineFilter = std::make_unique< BSplineCoefficientsLineFilter< dfloat >>();
+   }
+   DIP_STACK_TRACE_THIS( Framework::Separable( in, out, dt, dt, {}, { 0 }, {}, *lineFilter,
+                                               Framework::SeparableOption::AsScalarImage ));
+}
+
 } // namespace
 
 void ResampleAt(
@@ -202,30 +528,67 @@ void ResampleAt(
       DIP_THROW_IF( c.size() != nDims, E::ARRAY_PARAMETER_WRONG_LENGTH );
    }
 
+   // Put the coordinates in an image and resample all at once
+   Image map( UnsignedArray{ coordinates.size() }, nDims, DT_DFLOAT );
+   dfloat* mapPtr = static_cast< dfloat* >( map.Origin() );
+   for( auto& c : coordinates ) {
+      for( dip::uint ii = 0; ii < nDims; ++ii ) {
+         mapPtr[ static_cast< dip::sint >( ii ) * map.TensorStride() ] = c[ ii ];
+      }
+      mapPtr += map.Stride( 0 );
+   }
+   DIP_STACK_TRACE_THIS( ResampleAt( c_in, map, out, method ));
+}
+
+void ResampleAt(
+      Image const& c_in,
+      Image const& c_map,
+      Image& out,
+      String const& method,
+      Image::Pixel const& fill
+) {
+   DIP_THROW_IF( !c_in.IsForged() || !c_map.IsForged(), E::IMAGE_NOT_FORGED );
+   DIP_THROW_IF( c_in.DataType().IsBinary(), E::DATA_TYPE_NOT_SUPPORTED );
+   dip::uint nDims = c_in.Dimensionality();
+   DIP_THROW_IF( nDims == 0, E::DIMENSIONALITY_NOT_SUPPORTED );
+   DIP_THROW_IF( !c_map.DataType().IsReal(), E::DATA_TYPE_NOT_SUPPORTED );
+   DIP_THROW_IF( c_map.TensorElements() != nDims, E::NTENSORELEM_DONT_MATCH );
+   DIP_THROW_IF(( fill.TensorElements() != 1 ) && ( fill.TensorElements() != c_in.TensorElements() ), E::NTENSORELEM_DONT_MATCH );
+   Method interpolationMethod;
+   DIP_STACK_TRACE_THIS( interpolationMethod = ParseMethod( method, true ));
+
    // Preserve input
    Image in = c_in.QuickCopy();
+   Image map = c_map.QuickCopy();
    PixelSize pixelSize = c_in.PixelSize();
    String colorSpace = c_in.ColorSpace();
+   Tensor tensor = c_in.Tensor();
+   DataType outType = c_in.DataType();
+   if( out.Aliases( in )) {
+      out.Strip(); // prevent `in` data being overwritten if `out` points to the same region.
+   }
 
-   // Create output
-   UnsignedArray outSize( 1, coordinates.size() );
-   out.ReForge( outSize, in.TensorElements(), in.DataType(), Option::AcceptDataTypeChange::DO_ALLOW );
-   out.SetPixelSize( pixelSize );
-   out.SetColorSpace( colorSpace );
+   // The B-spline is evaluated on its coefficients, computed once for the whole image
+   if( interpolationMethod == Method::BSPLINE ) {
+      Image coefficients;
+      DIP_STACK_TRACE_THIS( BSplineCoefficients( in, coefficients ));
+      in = std::move( coefficients );
+   }
 
-   // Find interpolator
-   InterpolationFunctionPointer function;
-   DIP_STACK_TRACE_THIS( function = GetInterpFunctionPtr( method, in.DataType() ));
+   // Find line filter
+   DataType bufferType = interpolationMethod == Method::NEAREST_NEIGHBOR
+                         ? in.DataType()
+                         : ( in.DataType().IsComplex() ? DT_DCOMPLEX : DT_DFLOAT );
+   std::unique_ptr< Framework::ScanLineFilter > lineFilter;
+   DIP_OVL_NEW_NONBINARY( lineFilter, ResampleAtLineFilter, ( in, interpolationMethod, fill ), in.DataType() );
 
-   // Iterate over coordinates and out
-   GenericImageIterator<> outIt( out );
-   for( auto cIt = coordinates.begin(); cIt != coordinates.end(); ++cIt, ++outIt ) {
-      if( in.IsInside( *cIt ) ) {
-         function( in, *outIt, *cIt );
-      } else {
-         *outIt = 0;
-      }
-   }
+   // Resample
+   ImageConstRefArray inar{ map };
+   ImageRefArray outar{ out };
+   DIP_STACK_TRACE_THIS( Framework::Scan( inar, outar, { DT_DFLOAT }, { bufferType }, { outType }, { tensor.Elements() }, *lineFilter ));
+   out.ReshapeTensor( tensor );
+   out.SetPixelSize( pixelSize );
+   out.SetColorSpace( colorSpace );
 }
 
 Image::Pixel ResampleAt(
@@ -258,3 +621,73 @@ Image::Pixel ResampleAt(
 }
 
 } // namespace dip
+
+#ifdef DIP__ENABLE_DOCTEST
+#include "doctest.h"
+#include "diplib/generation.h"
+#include "diplib/math.h"
+#include "diplib/random.h"
+#include "diplib/statistics.h"
+
+DOCTEST_TEST_CASE("[DIPlib] testing ResampleAt") {
+   dip::Random random( 0 );
+   dip::Image in( { 20, 15, 6 }, 2, dip::DT_UINT8 );
+   in.Fill( 0 );
+   dip::UniformNoise( in, in, random, 0.0, 255.0 );
+   dip::Image map( { 30, 25 }, 3, dip::DT_DFLOAT );
+   map.Fill( 0 );
+   dip::FloatArray upper{ 21.0, 16.0, 7.0 };
+   for( dip::uint ii = 0; ii < 3; ++ii ) {
+      dip::Image coords = map[ ii ];
+      dip::UniformNoise( coords, coords, random, -1.0, upper[ ii ] );
+   }
+   map.At( 0, 0 ) = { 19.0, 14.0, 5.0 }; // exactly on the far edge
+   for( auto method : { "nearest", "linear", "3-cubic" } ) {
+      dip::Image out = dip::ResampleAt( in, map, method );
+      DOCTEST_REQUIRE( out.Sizes() == map.Sizes() );
+      DOCTEST_REQUIRE( out.DataType() == in.DataType() );
+      DOCTEST_REQUIRE( out.TensorElements() == 2 );
+      dip::uint errors = 0;
+      for( dip::uint jj = 0; jj < map.Size( 1 ); ++jj ) {
+         for( dip::uint ii = 0; ii < map.Size( 0 ); ++ii ) {
+            dip::Image::Pixel coords = map.At( ii, jj );
+            dip::FloatArray pos{ coords[ 0 ].As< dip::dfloat >(), coords[ 1 ].As< dip::dfloat >(), coords[ 2 ].As< dip::dfloat >() };
+            dip::Image::Pixel expected = dip::ResampleAt( in, pos, method );
+            errors += !( out.At( ii, jj ) == expected );
+         }
+      }
+      DOCTEST_CHECK( errors == 0 );
+   }
+
+   // Points outside the image get the fill value
+   dip::Image out = dip::ResampleAt( in, map, "linear", { 7, 8 } );
+   DOCTEST_CHECK( out.At( 0, 0 ) == dip::ResampleAt( in, dip::FloatArray{ 19.0, 14.0, 5.0 } ));
+   map.At( 1, 0 ) = { -0.5, 3.0, 3.0 };
+   out = dip::ResampleAt( in, map, "linear", { 7, 8 } );
+   DOCTEST_CHECK( out.At( 1, 0 ) == dip::Image::Pixel{ 7, 8 } );
+
+   // The B-spline interpolates the samples
+   dip::Image fin = dip::Convert( in, dip::DT_SFLOAT );
+   map = dip::CreateCoordinates( in.Sizes(), { "corner" } );
+   out = dip::ResampleAt( fin, map, "bspline" );
+   DOCTEST_CHECK( dip::MaximumAbsoluteError( out, fin ) < 1e-3 );
+
+   // The B-spline approximates a smooth function well
+   dip::Image line( { 60 }, 1, dip::DT_DFLOAT );
+   dip::Image lineMap( { 59 }, 1, dip::DT_DFLOAT );
+   for( dip::uint ii = 0; ii < 60; ++ii ) {
+      line.At( ii ) = std::sin( 0.3 * static_cast< dip::dfloat >( ii ));
+   }
+   for( dip::uint ii = 0; ii < 59; ++ii ) {
+      lineMap.At( ii ) = static_cast< dip::dfloat >( ii ) + 0.25;
+   }
+   out = dip::ResampleAt( line, lineMap, "bspline" );
+   dip::dfloat maxError = 0;
+   for( dip::uint ii = 5; ii < 54; ++ii ) {
+      dip::dfloat expected = std::sin( 0.3 * ( static_cast< dip::dfloat >( ii ) + 0.25 ));
+      maxError = std::max( maxError, std::abs( out.At( ii ).As< dip::dfloat >() - expected ));
+   }
+   DOCTEST_CHECK( maxError < 1e-4 );
+}
+
+#endif // DIP__ENABLE_DOCTEST
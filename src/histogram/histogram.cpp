@@ -20,6 +20,8 @@
 
 #include <chrono> // std::chrono_literals::
 #include <thread> // std::this_thread::
+#include <limits>
+#include <vector>
 #include "diplib.h"
 #include "diplib/histogram.h"
 #include "diplib/statistics.h"
@@ -111,6 +113,41 @@ void CompleteConfiguration( Measurement::IteratorFeature const& featureValues, H
    CompleteConfiguration( configuration, false );
 }
 
+// Adds the histograms `in` to `out`, all have `n` bins. The bins are divided over the threads, each thread adds
+// all histograms for its section of the bins.
+void AddCounts( CountType* out, std::vector< CountType const* > const& in, dip::uint n ) {
+   if( in.empty() ) {
+      return;
+   }
+   dip::uint nThreads = ( n * in.size() < threadingThreshold ) ? 1 : std::min( GetNumberOfThreads(), div_ceil( n, dip::uint( 1024 )));
+   dip::uint chunk = div_ceil( n, nThreads );
+   #pragma omp parallel for schedule( static ) num_threads( static_cast< int >( nThreads ))
+   for( dip::sint tt = 0; tt < static_cast< dip::sint >( nThreads ); ++tt ) {
+      dip::uint start = static_cast< dip::uint >( tt ) * chunk;
+      dip::uint end = std::min( start + chunk, n );
+      for( CountType const* src : in ) {
+         for( dip::uint ii = start; ii < end; ++ii ) {
+            out[ ii ] += src[ ii ];
+         }
+      }
+   }
+}
+
+// Each thread counts into its own copy of the histogram, which it allocates and clears, and which are added
+// together (in parallel) at the end. Multithreading is only worthwhile if this overhead is small compared to
+// `operations`, the work done counting.
+Framework::ScanOptions HistogramScanOptions( dip::uint operations, dip::uint nBins ) {
+   Framework::ScanOptions opts;
+   dip::uint nThreads = GetNumberOfThreads();
+   if( nThreads > 1 ) {
+      dip::uint perThreadOperations = nBins * 3 + 10000;
+      if( operations / nThreads + perThreadOperations + threadingThreshold > operations ) {
+         opts = Framework::ScanOption::NoMultiThreading;
+      }
+   }
+   return opts;
+}
+
 class dip__HistogramBase : public Framework::ScanLineFilter {
    public:
       dip__HistogramBase( Image& image ) : image_( image ) {}
@@ -121,16 +158,27 @@ class dip__HistogramBase : public Framework::ScanLineFilter {
          // We don't forge the images here, the Filter() function should do that so each thread allocates its own
          // data segment. This ensures there's no false sharing.
       }
-      void Reduce() {
+      virtual void Reduce() {
+         // Note: images have normal strides, and all have the same sizes.
+         std::vector< CountType const* > partial;
          for( auto const& img : imageArray_ ) {
-            image_ += img;
+            if( img.IsForged() ) {
+               partial.push_back( static_cast< CountType const* >( img.Origin() ));
+            }
+         }
+         if( !partial.empty() ) {
+            AddCounts( static_cast< CountType* >( image_.Origin() ), partial, image_.NumberOfPixels() );
          }
       }
+      virtual ~dip__HistogramBase() {}
    protected:
       Image& image_;
       ImageArray imageArray_;
 };
 
+// Number of samples for which `dip__ScalarImageHistogram` computes the bins at once.
+constexpr dip::uint blockSize = 256;
+
 template< typename TPI >
 class dip__ScalarImageHistogram : public dip__HistogramBase {
    public:
@@ -146,40 +194,50 @@ class dip__ScalarImageHistogram : public dip__HistogramBase {
          }
          CountType* data = static_cast< CountType* >( image.Origin() );
          // Note: `image_` strides are always normal.
+         bin const* mask = nullptr;
+         dip::sint maskStride = 0;
          if( params.inBuffer.size() > 1 ) {
             // If there's two input buffers, we have a mask image.
-            bin const* mask = static_cast< bin const* >( params.inBuffer[ 1 ].buffer );
-            auto maskStride = params.inBuffer[ 1 ].stride;
-            if( configuration_.excludeOutOfBoundValues ) {
-               for( dip::uint ii = 0; ii < bufferLength; ++ii ) {
-                  if( *mask && ( *in >= configuration_.lowerBound ) && ( *in < configuration_.upperBound )) {
-                     ++data[ detail::FindBin( *in, configuration_.lowerBound, configuration_.binSize, configuration_.nBins ) ];
+            mask = static_cast< bin const* >( params.inBuffer[ 1 ].buffer );
+            maskStride = params.inBuffer[ 1 ].stride;
+         }
+         // The bins are computed for a block of samples at the time, in a loop without branches that the compiler
+         // can vectorize. The counting is done in a separate loop.
+         dip::sint bins[ blockSize ];
+         for( dip::uint start = 0; start < bufferLength; start += blockSize ) {
+            dip::uint n = std::min( blockSize, bufferLength - start );
+            ComputeBins( in, inStride, n, bins );
+            if( mask ) {
+               if( configuration_.excludeOutOfBoundValues ) {
+                  for( dip::uint ii = 0; ii < n; ++ii ) {
+                     if( *mask && ( *in >= configuration_.lowerBound ) && ( *in < configuration_.upperBound )) {
+                        ++data[ bins[ ii ]];
+                     }
+                     in += inStride;
+                     mask += maskStride;
                   }
-                  in += inStride;
-                  mask += maskStride;
+               } else {
+                  for( dip::uint ii = 0; ii < n; ++ii ) {
+                     if( *mask ) {
+                        ++data[ bins[ ii ]];
+                     }
+                     mask += maskStride;
+                  }
+                  in += static_cast< dip::sint >( n ) * inStride;
                }
             } else {
-               for( dip::uint ii = 0; ii < bufferLength; ++ii ) {
-                  if( *mask ) {
-                     ++data[ detail::FindBin( *in, configuration_.lowerBound, configuration_.binSize, configuration_.nBins ) ];
+               if( configuration_.excludeOutOfBoundValues ) {
+                  for( dip::uint ii = 0; ii < n; ++ii ) {
+                     if(( *in >= configuration_.lowerBound ) && ( *in < configuration_.upperBound )) {
+                        ++data[ bins[ ii ]];
+                     }
+                     in += inStride;
                   }
-                  in += inStride;
-                  mask += maskStride;
-               }
-            }
-         } else {
-            // Otherwise we don't.
-            if( configuration_.excludeOutOfBoundValues ) {
-               for( dip::uint ii = 0; ii < bufferLength; ++ii ) {
-                  if(( *in >= configuration_.lowerBound ) && ( *in < configuration_.upperBound )) {
-                     ++data[ detail::FindBin( *in, configuration_.lowerBound, configuration_.binSize, configuration_.nBins ) ];
+               } else {
+                  for( dip::uint ii = 0; ii < n; ++ii ) {
+                     ++data[ bins[ ii ]];
                   }
-                  in += inStride;
-               }
-            } else {
-               for( dip::uint ii = 0; ii < bufferLength; ++ii ) {
-                  ++data[ detail::FindBin( *in, configuration_.lowerBound, configuration_.binSize, configuration_.nBins ) ];
-                  in += inStride;
+                  in += static_cast< dip::sint >( n ) * inStride;
                }
             }
          }
@@ -188,6 +246,107 @@ class dip__ScalarImageHistogram : public dip__HistogramBase {
             dip__HistogramBase( image ), configuration_( configuration ) {}
    private:
       Histogram::Configuration const& configuration_;
+
+      // Identical to `detail::FindBin` for each sample.
+      void ComputeBins( TPI const* in, dip::sint inStride, dip::uint n, dip::sint* bins ) const {
+         dfloat lowerBound = configuration_.lowerBound;
+         dfloat binSize = configuration_.binSize;
+         dfloat maxBin = static_cast< dfloat >( configuration_.nBins - 1 );
+         for( dip::uint ii = 0; ii < n; ++ii ) {
+            dfloat value = ( static_cast< dfloat >( in[ static_cast< dip::sint >( ii ) * inStride ] ) - lowerBound ) / binSize;
+            bins[ ii ] = static_cast< dip::sint >( clamp( value, 0.0, maxBin ));
+         }
+      }
+};
+
+// Histogram for 8-bit and 16-bit integer images. The bin for each possible input value is computed once, in a
+// look-up table. Each thread counts into `nSub` sub-histograms, consecutive samples are counted in different
+// sub-histograms, such that incrementing the same bin repeatedly doesn't need to wait for the previous increment
+// to be written. The sub-histograms have an additional bin at the end, where out-of-bounds values are counted if
+// they are to be excluded.
+template< typename TPI >
+class dip__SmallIntegerHistogram : public dip__HistogramBase {
+   public:
+      static constexpr dip::uint lutSize = dip::uint( 1 ) << ( sizeof( TPI ) * 8 );
+
+      dip__SmallIntegerHistogram( Image& image, Histogram::Configuration const& configuration ) :
+            dip__HistogramBase( image ), nBins_( configuration.nBins ) {
+         lut_.resize( lutSize );
+         for( dip::uint ii = 0; ii < lutSize; ++ii ) {
+            dfloat value = static_cast< dfloat >( static_cast< dip::sint >( ii ) + minValue );
+            if( configuration.excludeOutOfBoundValues &&
+                (( value < configuration.lowerBound ) || ( value >= configuration.upperBound ))) {
+               lut_[ ii ] = nBins_;
+            } else {
+               lut_[ ii ] = static_cast< dip::uint >( detail::FindBin( value, configuration.lowerBound, configuration.binSize, nBins_ ));
+            }
+         }
+      }
+      virtual dip::uint GetNumberOfOperations( dip::uint, dip::uint, dip::uint ) override { return 2; }
+      virtual void SetNumberOfThreads( dip::uint threads ) override {
+         counts_.resize( threads );
+      }
+      virtual void Filter( Framework::ScanLineFilterParameters const& params ) override {
+         TPI const* in = static_cast< TPI const* >( params.inBuffer[ 0 ].buffer );
+         auto bufferLength = params.bufferLength;
+         auto inStride = params.inBuffer[ 0 ].stride;
+         std::vector< CountType >& counts = counts_[ params.thread ];
+         if( counts.empty() ) {
+            counts.resize( nSub * ( nBins_ + 1 ), 0 );
+         }
+         dip::uint subStride = nBins_ + 1;
+         CountType* data = counts.data();
+         if( params.inBuffer.size() > 1 ) {
+            // If there's two input buffers, we have a mask image.
+            bin const* mask = static_cast< bin const* >( params.inBuffer[ 1 ].buffer );
+            auto maskStride = params.inBuffer[ 1 ].stride;
+            for( dip::uint ii = 0; ii < bufferLength; ++ii ) {
+               if( *mask ) {
+                  ++data[( ii % nSub ) * subStride + lut_[ Index( *in ) ]];
+               }
+               in += inStride;
+               mask += maskStride;
+            }
+         } else {
+            CountType* data0 = data;
+            CountType* data1 = data0 + subStride;
+            CountType* data2 = data1 + subStride;
+            CountType* data3 = data2 + subStride;
+            dip::uint ii = 0;
+            for( ; ii + nSub <= bufferLength; ii += nSub ) {
+               ++data0[ lut_[ Index( in[ 0 ] ) ]];
+               ++data1[ lut_[ Index( in[ inStride ] ) ]];
+               ++data2[ lut_[ Index( in[ 2 * inStride ] ) ]];
+               ++data3[ lut_[ Index( in[ 3 * inStride ] ) ]];
+               in += static_cast< dip::sint >( nSub ) * inStride;
+            }
+            for( ; ii < bufferLength; ++ii ) {
+               ++data0[ lut_[ Index( *in ) ]];
+               in += inStride;
+            }
+         }
+      }
+      virtual void Reduce() override {
+         image_.Forge();
+         image_.Fill( 0 );
+         std::vector< CountType const* > partial;
+         for( auto const& counts : counts_ ) {
+            for( dip::uint ii = 0; ii < counts.size(); ii += nBins_ + 1 ) {
+               partial.push_back( counts.data() + ii );
+            }
+         }
+         AddCounts( static_cast< CountType* >( image_.Origin() ), partial, nBins_ );
+      }
+   private:
+      static constexpr dip::uint nSub = 4; // the unrolled loop in `Filter` assumes this value
+      static constexpr dip::sint minValue = static_cast< dip::sint >( std::numeric_limits< TPI >::lowest() );
+      dip::uint nBins_;
+      std::vector< dip::uint > lut_;
+      std::vector< std::vector< CountType >> counts_;
+
+      static dip::uint Index( TPI value ) {
+         return static_cast< dip::uint >( static_cast< dip::sint >( value ) - minValue );
+      }
 };
 
 template< typename TPI >
@@ -306,15 +465,24 @@ void Histogram::ScalarImageHistogram( Image const& input, Image const& mask, His
    data_.SetSizes( { configuration.nBins } );
    data_.SetDataType( DT_COUNT );
    std::unique_ptr< dip__HistogramBase >scanLineFilter;
-   DIP_OVL_NEW_REAL( scanLineFilter, dip__ScalarImageHistogram, ( data_, configuration ), input.DataType() );
-   Framework::ScanOptions opts;
-   if( GetNumberOfThreads() > 1 ) {
-      dip::uint parallelOperations = input.NumberOfPixels() * 6;
-      dip::uint sequentialOperations = ( GetNumberOfThreads() - 1 ) * ( data_.NumberOfPixels() * 2 + 10000 );
-      if( parallelOperations / GetNumberOfThreads() + sequentialOperations + threadingThreshold > parallelOperations ) {
-         opts = Framework::ScanOption::NoMultiThreading; // Turn off multithreading if we'll do a lot of work to reduce.
+   dip::uint operations = 6;
+   // For 8-bit and 16-bit images, we use a look-up table, if the image is large enough to amortize its computation
+   // and we don't have more bins than possible values.
+   dip::uint lutSize = dip::uint( 1 ) << ( input.DataType().SizeOf() * 8 );
+   if(( input.DataType().IsInteger() ) && ( input.DataType().SizeOf() <= 2 ) &&
+      ( input.NumberOfPixels() >= lutSize ) && ( configuration.nBins <= lutSize )) {
+      switch( input.DataType() ) {
+         case DT_UINT8:  scanLineFilter.reset( new dip__SmallIntegerHistogram< uint8 >( data_, configuration )); break;
+         case DT_SINT8:  scanLineFilter.reset( new dip__SmallIntegerHistogram< sint8 >( data_, configuration )); break;
+         case DT_UINT16: scanLineFilter.reset( new dip__SmallIntegerHistogram< uint16 >( data_, configuration )); break;
+         case DT_SINT16: scanLineFilter.reset( new dip__SmallIntegerHistogram< sint16 >( data_, configuration )); break;
+         default: DIP_THROW( E::DATA_TYPE_NOT_SUPPORTED );
       }
+      operations = 2;
+   } else {
+      DIP_OVL_NEW_REAL( scanLineFilter, dip__ScalarImageHistogram, ( data_, configuration ), input.DataType() );
    }
+   Framework::ScanOptions opts = HistogramScanOptions( input.NumberOfPixels() * operations, configuration.nBins );
    DIP_STACK_TRACE_THIS( Framework::ScanSingleInput( input, mask, input.DataType(), *scanLineFilter, opts ));
    scanLineFilter->Reduce();
 }
@@ -334,14 +502,7 @@ void Histogram::TensorImageHistogram( Image const& input, Image const& mask, His
    data_.SetDataType( DT_COUNT );
    std::unique_ptr< dip__HistogramBase >scanLineFilter;
    DIP_OVL_NEW_REAL( scanLineFilter, dip__JointImageHistogram, ( data_, configuration, true ), input.DataType() );
-   Framework::ScanOptions opts;
-   if( GetNumberOfThreads() > 1 ) {
-      dip::uint parallelOperations = input.NumberOfPixels() * ndims * 6;
-      dip::uint sequentialOperations = ( GetNumberOfThreads() - 1 ) * ( data_.NumberOfPixels() * 2 + 10000 );
-      if( parallelOperations / GetNumberOfThreads() + sequentialOperations + threadingThreshold > parallelOperations ) {
-         opts = Framework::ScanOption::NoMultiThreading; // Turn off multithreading if we'll do a lot of work to reduce.
-      }
-   }
+   Framework::ScanOptions opts = HistogramScanOptions( input.NumberOfPixels() * ndims * 6, data_.NumberOfPixels() );
    DIP_STACK_TRACE_THIS( Framework::ScanSingleInput( input, mask, input.DataType(), *scanLineFilter, opts ));
    scanLineFilter->Reduce();
 }
@@ -373,14 +534,7 @@ void Histogram::JointImageHistogram( Image const& input1, Image const& input2, I
       inBufT.push_back( mask.DataType() );
    }
    ImageRefArray outar{};
-   Framework::ScanOptions opts;
-   if( GetNumberOfThreads() > 1 ) {
-      dip::uint parallelOperations = input1.NumberOfPixels() * 2 * 6;
-      dip::uint sequentialOperations = ( GetNumberOfThreads() - 1 ) * ( data_.NumberOfPixels() * 2 + 10000 );
-      if( parallelOperations / GetNumberOfThreads() + sequentialOperations + threadingThreshold > parallelOperations ) {
-         opts = Framework::ScanOption::NoMultiThreading; // Turn off multithreading if we'll do a lot of work to reduce.
-      }
-   }
+   Framework::ScanOptions opts = HistogramScanOptions( input1.NumberOfPixels() * 2 * 6, data_.NumberOfPixels() );
    DIP_STACK_TRACE_THIS( Framework::Scan( inar, outar, inBufT, {}, {}, {}, *scanLineFilter, opts ));
    scanLineFilter->Reduce();
 }
@@ -571,6 +725,7 @@ Histogram& Histogram::Smooth( FloatArray sigma ) {
 #ifdef DIP__ENABLE_DOCTEST
 #include "doctest.h"
 #include "diplib/random.h"
+#include "diplib/testing.h"
 
 DOCTEST_TEST_CASE( "[DIPlib] testing dip::Histogram" ) {
    dip::Image zero( {}, 1, dip::DT_SFLOAT );
@@ -623,6 +778,20 @@ DOCTEST_TEST_CASE( "[DIPlib] testing dip::Histogram" ) {
    DOCTEST_CHECK( halfGaussH.At( 95 ) == 0 );
    DOCTEST_CHECK( halfGaussH.At( 105 ) == gaussH.At( 105 ) );
 
+   // The look-up table for 16-bit images yields the same result as the generic code for floating-point images
+   dip::Image floatImg = dip::Convert( img, dip::DT_SFLOAT );
+   dip::Histogram::Configuration narrowSettings( 1000.0, 3000.0, 64 );
+   narrowSettings.excludeOutOfBoundValues = true;
+   dip::Histogram narrowH( img, mask, narrowSettings );
+   dip::Histogram narrowFloatH( floatImg, mask, narrowSettings );
+   DOCTEST_CHECK( narrowH.Count() == narrowFloatH.Count() );
+   DOCTEST_CHECK( dip::testing::CompareImages( narrowH.GetImage(), narrowFloatH.GetImage() ));
+   narrowSettings.excludeOutOfBoundValues = false;
+   narrowH = dip::Histogram( img, {}, narrowSettings );
+   narrowFloatH = dip::Histogram( floatImg, {}, narrowSettings );
+   DOCTEST_CHECK( narrowH.Count() == img.NumberOfPixels() );
+   DOCTEST_CHECK( dip::testing::CompareImages( narrowH.GetImage(), narrowFloatH.GetImage() ));
+
    dip::Image complexIm( { 75, 25 }, 3, dip::DT_DCOMPLEX );
    DOCTEST_CHECK_THROWS( dip::Histogram{ complexIm } );
 
@@ -24,6 +24,7 @@
 #include "diplib/library/copy_buffer.h"
 #include "diplib/boundary.h"
 #include "diplib/saturated_arithmetic.h"
+#include "multiversion.h"
 
 namespace dip {
 namespace detail {
@@ -42,6 +43,16 @@ static inline void cast_copy( ConstSampleIterator< inT > in, ConstSampleIterator
    }
 }
 
+// The most common case, compiled for each of the instruction sets
+template< class inT, class outT >
+static inline void cast_copy_contiguous( inT const* in, outT* out, dip::uint pixels ) {
+   CallMultiversioned( [ = ]() {
+      for( dip::uint ii = 0; ii < pixels; ++ii ) {
+         out[ ii ] = clamp_cast< outT >( in[ ii ] );
+      }
+   } );
+}
+
 template< typename inT, typename outT >
 static inline void CopyBufferFromTo(
       inT const* inBuffer,
@@ -59,6 +70,8 @@ static inline void CopyBufferFromTo(
       if( inStride == 0 ) {
          //std::cout << "CopyBufferFromTo<inT,outT>, mode 1\n";
          FillBufferFromTo( outBuffer, outStride, 1, pixels, 1, clamp_cast< outT >( *inBuffer ) );
+      } else if(( inStride == 1 ) && ( outStride == 1 )) {
+         cast_copy_contiguous( inBuffer, outBuffer, pixels );
       } else {
          //std::cout << "CopyBufferFromTo<inT,outT>, mode 2\n";
          auto inIt = ConstSampleIterator< inT >( inBuffer, inStride );
@@ -0,0 +1,158 @@
+/*
+ * DIPlib 3.0
+ * This file contains functions to select the instruction set used by multi-versioned functions.
+ *
+ * (c)2026, Cris Luengo.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdlib>
+
+#include "diplib.h"
+#include "diplib/instruction_set.h"
+#include "multiversion.h"
+
+namespace dip {
+
+namespace {
+
+using detail::InstructionSet;
+
+constexpr char const* instructionSetNames[] = { "baseline", "avx2", "avx512" };
+
+String InstructionSetName( InstructionSet instructionSet ) {
+   return instructionSetNames[ static_cast< int >( instructionSet ) ];
+}
+
+bool InstructionSetFromName( String const& name, InstructionSet& instructionSet ) {
+   for( int ii = 0; ii < 3; ++ii ) {
+      if( name == instructionSetNames[ ii ] ) {
+         instructionSet = static_cast< InstructionSet >( ii );
+         return true;
+      }
+   }
+   return false;
+}
+
+// The best instruction set supported by both the processor and this build of the library
+InstructionSet BestInstructionSet() {
+#ifdef DIP__MULTIVERSION
+   __builtin_cpu_init();
+   if( __builtin_cpu_supports( "avx512f" ) && __builtin_cpu_supports( "avx512dq" ) &&
+       __builtin_cpu_supports( "avx512bw" ) && __builtin_cpu_supports( "avx512vl" ) &&
+       __builtin_cpu_supports( "avx2" ) && __builtin_cpu_supports( "fma" )) {
+      return InstructionSet::AVX512;
+   }
+   if( __builtin_cpu_supports( "avx2" ) && __builtin_cpu_supports( "fma" )) {
+      return InstructionSet::AVX2;
+   }
+#endif
+   return InstructionSet::BASELINE;
+}
+
+// The best instruction set, or the one requested through the `DIP_INSTRUCTION_SET` environment variable
+InstructionSet DefaultInstructionSet() {
+   InstructionSet best = BestInstructionSet();
+   char const* env = std::getenv( "DIP_INSTRUCTION_SET" );
+   InstructionSet requested;
+   if( env && InstructionSetFromName( env, requested ) && ( requested <= best )) {
+      return requested;
+   }
+   return best;
+}
+
+InstructionSet activeInstructionSet = DefaultInstructionSet();
+
+} // namespace
+
+namespace detail {
+
+InstructionSet ActiveInstructionSet() {
+   return activeInstructionSet;
+}
+
+} // namespace detail
+
+void SetInstructionSet( String const& instructionSet ) {
+   InstructionSet best = BestInstructionSet();
+   if( instructionSet.empty() ) {
+      activeInstructionSet = best;
+      return;
+   }
+   InstructionSet requested;
+   if( !InstructionSetFromName( instructionSet, requested )) {
+      DIP_THROW_INVALID_FLAG( instructionSet );
+   }
+   DIP_THROW_IF( requested > best, "Instruction set not supported on this machine" );
+   activeInstructionSet = requested;
+}
+
+String GetInstructionSet() {
+   return InstructionSetName( activeInstructionSet );
+}
+
+StringArray SupportedInstructionSets() {
+   StringArray out;
+   InstructionSet best = BestInstructionSet();
+   for( int ii = 0; ii <= static_cast< int >( best ); ++ii ) {
+      out.push_back( instructionSetNames[ ii ] );
+   }
+   return out;
+}
+
+} // namespace dip
+
+
+#ifdef DIP__ENABLE_DOCTEST
+#include "doctest.h"
+#include "diplib/generation.h"
+#include "diplib/linear.h"
+#include "diplib/math.h"
+#include "diplib/morphology.h"
+#include "diplib/statistics.h"
+
+DOCTEST_TEST_CASE("[DIPlib] testing the instruction set selection") {
+   dip::StringArray supported = dip::SupportedInstructionSets();
+   DOCTEST_REQUIRE( !supported.empty() );
+   DOCTEST_CHECK( supported.front() == "baseline" );
+   dip::String current = dip::GetInstructionSet();
+   for( auto const& name : supported ) {
+      dip::SetInstructionSet( name );
+      DOCTEST_CHECK( dip::GetInstructionSet() == name );
+   }
+   DOCTEST_CHECK_THROWS( dip::SetInstructionSet( "foo" ));
+   dip::SetInstructionSet();
+   DOCTEST_CHECK( dip::GetInstructionSet() == supported.back() );
+
+   // The multi-versioned functions produce the same results with each instruction set, up to rounding errors
+   dip::Random random( 0 );
+   dip::Image img{ dip::UnsignedArray{ 203, 101 }, 1, dip::DT_UINT8 };
+   img.Fill( 0 );
+   dip::UniformNoise( img, img, random, 0.0, 255.0 );
+   dip::SetInstructionSet( "baseline" );
+   dip::Image gauss = dip::GaussFIR( img, { 2.0 }, { 0, 1 } );
+   dip::Image dilation = dip::Dilation( img, { 7, "rectangular" } );
+   dip::Image sum = dip::Convert( img, dip::DT_SFLOAT ) + gauss;
+   dip::Image log = dip::Ln( dip::Convert( img, dip::DT_SFLOAT ) + 1 );
+   for( auto const& name : supported ) {
+      dip::SetInstructionSet( name );
+      DOCTEST_CHECK( dip::MaximumAbsoluteError( dip::GaussFIR( img, { 2.0 }, { 0, 1 } ), gauss ) < 1e-3 );
+      DOCTEST_CHECK( dip::MaximumAbsoluteError( dip::Dilation( img, { 7, "rectangular" } ), dilation ) == 0 );
+      DOCTEST_CHECK( dip::MaximumAbsoluteError( dip::Convert( img, dip::DT_SFLOAT ) + gauss, sum ) == 0 );
+      DOCTEST_CHECK( dip::MaximumAbsoluteError( dip::Ln( dip::Convert( img, dip::DT_SFLOAT ) + 1 ), log ) < 1e-5 );
+   }
+   dip::SetInstructionSet( current );
+}
+
+#endif // DIP__ENABLE_DOCTEST
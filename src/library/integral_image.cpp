@@ -0,0 +1,268 @@
+/*
+ * DIPlib 3.0
+ * This file contains the summed-area table (integral image) used by local mean and variance filters.
+ *
+ * (c)2026, Cris Luengo.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cmath>
+#include <map>
+#include <vector>
+
+#include "diplib.h"
+#include "integral_image.h"
+#include "diplib/framework.h"
+#include "diplib/statistics.h"
+
+namespace dip {
+
+std::vector< IntegralImageTerm > IntegralImageTerms( PixelTable const& pixelTable ) {
+   dip::uint nDims = pixelTable.Dimensionality();
+   dip::uint procDim = pixelTable.ProcessingDimension();
+   dip::uint nCorners = 1u << nDims;
+   // The table value at `c` includes all pixels at `c` or below, so the sum over the box from `low` to `high`
+   // (inclusive) combines the table values at `high` and at `low - 1` along each dimension.
+   std::map< std::vector< dip::sint >, dip::sint > corners;
+   std::vector< dip::sint > coords( nDims );
+   for( auto const& run : pixelTable.Runs() ) {
+      for( dip::uint corner = 0; corner < nCorners; ++corner ) {
+         dip::sint sign = 1;
+         for( dip::uint ii = 0; ii < nDims; ++ii ) {
+            if( corner & ( 1u << ii )) {
+               coords[ ii ] = run.coordinates[ ii ];
+               if( ii == procDim ) {
+                  coords[ ii ] += static_cast< dip::sint >( run.length ) - 1;
+               }
+            } else {
+               coords[ ii ] = run.coordinates[ ii ] - 1;
+               sign = -sign;
+            }
+         }
+         corners[ coords ] += sign;
+      }
+   }
+   std::vector< IntegralImageTerm > terms;
+   for( auto const& corner : corners ) {
+      if( corner.second != 0 ) {
+         IntegerArray coordinates( nDims );
+         for( dip::uint ii = 0; ii < nDims; ++ii ) {
+            coordinates[ ii ] = corner.first[ ii ];
+         }
+         terms.push_back( { coordinates, static_cast< dfloat >( corner.second ) } );
+      }
+   }
+   return terms;
+}
+
+bool IntegralImageIsEfficient( Kernel const& kernel, dip::uint nDims ) {
+   // The framework will likely process along the dimension where the kernel is largest, which gives the fewest runs.
+   UnsignedArray sizes = kernel.Sizes( nDims );
+   dip::uint procDim = 0;
+   for( dip::uint ii = 1; ii < nDims; ++ii ) {
+      if( sizes[ ii ] > sizes[ procDim ] ) {
+         procDim = ii;
+      }
+   }
+   PixelTable pixelTable = kernel.PixelTable( nDims, procDim );
+   dip::uint nRuns = pixelTable.Runs().size();
+   dip::uint nTerms = IntegralImageTerms( pixelTable ).size();
+   // Running sums cost two updates per run. The table costs one multiply-add per term, plus its construction:
+   // a copy with boundary extension, and a cumulative sum along each dimension.
+   return nTerms + 2 * nDims + 4 < 2 * nRuns;
+}
+
+IntegralImage::IntegralImage( Image const& in, UnsignedArray const& boundary, BoundaryConditionArray const& bc, bool squares ) {
+   DIP_ASSERT( in.IsForged() );
+   DIP_ASSERT( in.IsScalar() );
+   DIP_ASSERT( in.DataType().IsReal() );
+   dip::uint nDims = in.Dimensionality();
+   UnsignedArray border = boundary;
+   for( auto& b : border ) {
+      ++b;
+   }
+   DIP_START_STACK_TRACE
+      shift_ = Mean( in ).As< dfloat >();
+      if( !std::isfinite( shift_ )) {
+         shift_ = 0.0;
+      }
+      UnsignedArray sizes = in.Sizes();
+      for( dip::uint ii = 0; ii < nDims; ++ii ) {
+         sizes[ ii ] += 2 * border[ ii ];
+      }
+      table_.ReForge( sizes, squares ? 2 : 1, DT_DFLOAT );
+      Image values = table_[ 0 ];
+      values.Protect();
+      ExtendImage( in, values, border, bc );
+      Subtract( values, shift_, values, DT_DFLOAT );
+      if( squares ) {
+         Image squaredValues = table_[ 1 ];
+         squaredValues.Protect();
+         MultiplySampleWise( values, values, squaredValues, DT_DFLOAT );
+      }
+      CumulativeSum( table_, {}, table_ );
+      RangeArray window( nDims );
+      for( dip::uint ii = 0; ii < nDims; ++ii ) {
+         window[ ii ] = Range( static_cast< dip::sint >( border[ ii ] ), static_cast< dip::sint >( border[ ii ] + in.Size( ii ) - 1 ));
+      }
+      table_ = table_.At( window );
+   DIP_END_STACK_TRACE
+}
+
+namespace {
+
+class IntegralImageLineFilter : public Framework::FullLineFilter {
+   public:
+      IntegralImageLineFilter( std::vector< IntegralImageTerm > const& terms, Image const& table, dip::uint nPixels, dfloat shift, IntegralImageStatistic statistic )
+            : nPixels_( static_cast< dfloat >( nPixels )), shift_( shift ), statistic_( statistic ) {
+         offsets_.reserve( terms.size() );
+         weights_.reserve( terms.size() );
+         for( auto const& term : terms ) {
+            offsets_.push_back( Image::Offset( term.coordinates, table.Strides() ));
+            weights_.push_back( term.weight );
+         }
+      }
+      virtual dip::uint GetNumberOfOperations( dip::uint lineLength, dip::uint, dip::uint, dip::uint ) override {
+         return lineLength * offsets_.size() * ( statistic_ == IntegralImageStatistic::VARIANCE ? 4 : 2 );
+      }
+      virtual void Filter( Framework::FullLineFilterParameters const& params ) override {
+         dfloat const* in = static_cast< dfloat const* >( params.inBuffer.buffer );
+         dip::sint inStride = params.inBuffer.stride;
+         dip::sint tensorStride = params.inBuffer.tensorStride;
+         dfloat* out = static_cast< dfloat* >( params.outBuffer.buffer );
+         dip::sint outStride = params.outBuffer.stride;
+         dip::uint length = params.bufferLength;
+         dip::uint nTerms = offsets_.size();
+         if( statistic_ == IntegralImageStatistic::MEAN ) {
+            dfloat norm = 1.0 / nPixels_;
+            for( dip::uint ii = 0; ii < length; ++ii ) {
+               dfloat sum = 0;
+               for( dip::uint jj = 0; jj < nTerms; ++jj ) {
+                  sum += weights_[ jj ] * in[ offsets_[ jj ]];
+               }
+               *out = sum * norm + shift_;
+               in += inStride;
+               out += outStride;
+            }
+         } else {
+            for( dip::uint ii = 0; ii < length; ++ii ) {
+               dfloat sum = 0;
+               dfloat sum2 = 0;
+               for( dip::uint jj = 0; jj < nTerms; ++jj ) {
+                  sum += weights_[ jj ] * in[ offsets_[ jj ]];
+                  sum2 += weights_[ jj ] * in[ offsets_[ jj ] + tensorStride ];
+               }
+               // Same as `dip::FastVarianceAccumulator`, the shift doesn't change the variance. Rounding errors can
+               // yield small negative values where the variance is zero.
+               *out = ( nPixels_ > 1 ) ? std::max(( sum2 - ( sum * sum ) / nPixels_ ) / ( nPixels_ - 1 ), 0.0 ) : 0.0;
+               in += inStride;
+               out += outStride;
+            }
+         }
+      }
+   private:
+      std::vector< dip::sint > offsets_;
+      std::vector< dfloat > weights_;
+      dfloat nPixels_;
+      dfloat shift_;
+      IntegralImageStatistic statistic_;
+};
+
+} // namespace
+
+void IntegralImageFilter(
+      Image const& c_in,
+      Image& out,
+      Kernel const& kernel,
+      BoundaryConditionArray const& bc,
+      DataType outType,
+      IntegralImageStatistic statistic
+) {
+   DIP_ASSERT( c_in.IsForged() );
+   DIP_ASSERT( c_in.DataType().IsReal() );
+   DIP_ASSERT( !kernel.HasWeights() );
+   Image in = c_in.QuickCopy();
+   PixelSize pixelSize = in.PixelSize();
+   String colorSpace = in.ColorSpace();
+   dip::uint nDims = in.Dimensionality();
+   DIP_START_STACK_TRACE
+      UnsignedArray boundary = kernel.Boundary( nDims );
+      PixelTable pixelTable = kernel.PixelTable( nDims, 0 );
+      std::vector< IntegralImageTerm > terms = IntegralImageTerms( pixelTable );
+      if( out.Aliases( in )) {
+         out.Strip(); // we write the output one tensor element at the time
+      }
+      out.ReForge( in.Sizes(), in.TensorElements(), outType, Option::AcceptDataTypeChange::DO_ALLOW );
+      out.ReshapeTensor( in.Tensor() );
+      out.SetPixelSize( pixelSize );
+      if( !colorSpace.empty() ) {
+         out.SetColorSpace( colorSpace );
+      }
+      for( dip::uint ii = 0; ii < in.TensorElements(); ++ii ) {
+         Image inElement = in[ ii ];
+         IntegralImage table( inElement, boundary, bc, statistic == IntegralImageStatistic::VARIANCE );
+         IntegralImageLineFilter lineFilter( terms, table.Table(), pixelTable.NumberOfPixels(), table.Shift(), statistic );
+         Image outElement = out[ ii ];
+         outElement.Protect();
+         Framework::Full( table.Table(), outElement, DT_DFLOAT, DT_DFLOAT, outElement.DataType(), 1, {}, kernel,
+                          lineFilter, Framework::FullOption::BorderAlreadyExpanded );
+      }
+   DIP_END_STACK_TRACE
+}
+
+} // namespace dip
+
+
+#ifdef DIP__ENABLE_DOCTEST
+#include "doctest.h"
+#include "diplib/generation.h"
+#include "diplib/linear.h"
+#include "diplib/math.h"
+#include "diplib/nonlinear.h"
+
+DOCTEST_TEST_CASE("[DIPlib] testing the integral image filters") {
+   dip::Random random( 0 );
+   dip::Image in( { 50, 40 }, 1, dip::DT_UINT16 );
+   in.Fill( 1000 );
+   dip::UniformNoise( in, in, random, 0.0, 60000.0 );
+   dip::BoundaryConditionArray bc{ dip::BoundaryCondition::SYMMETRIC_MIRROR };
+   // A rectangle needs four terms
+   dip::Kernel rectangle( dip::FloatArray{ 15, 9 }, "rectangular" );
+   DOCTEST_CHECK( dip::IntegralImageTerms( rectangle.PixelTable( 2, 0 )).size() == 4 );
+   DOCTEST_CHECK( dip::IntegralImageIsEfficient( rectangle, 2 ));
+   DOCTEST_CHECK( !dip::IntegralImageIsEfficient( dip::Kernel( 3, "rectangular" ), 2 ));
+   // Compare to the separable uniform filter
+   dip::Image out;
+   dip::IntegralImageFilter( in, out, rectangle, bc, dip::DT_DFLOAT, dip::IntegralImageStatistic::MEAN );
+   dip::Image ref = dip::Uniform( dip::Convert( in, dip::DT_DFLOAT ), rectangle, { dip::S::SYMMETRIC_MIRROR } );
+   DOCTEST_CHECK( dip::MaximumAbs( out - ref ).As< dip::dfloat >() < 1e-7 );
+   dip::IntegralImageFilter( in, out, rectangle, bc, dip::DT_DFLOAT, dip::IntegralImageStatistic::VARIANCE );
+   dip::Image x = dip::Convert( in, dip::DT_DFLOAT );
+   dip::dfloat n = 15.0 * 9.0;
+   ref = dip::Uniform( x * x, rectangle, { dip::S::SYMMETRIC_MIRROR } ) - dip::Square( dip::Uniform( x, rectangle, { dip::S::SYMMETRIC_MIRROR } ));
+   ref *= n / ( n - 1 );
+   DOCTEST_CHECK( dip::MaximumAbs( out - ref ).As< dip::dfloat >() < 1e-7 * dip::Maximum( ref ).As< dip::dfloat >() );
+   // Compare to the running sums, which are used for elliptic kernels
+   for( dip::dfloat size : { 15.0, 7.5 } ) {
+      dip::Kernel kernel( size, "elliptic" );
+      dip::IntegralImageFilter( in, out, kernel, bc, dip::DT_DFLOAT, dip::IntegralImageStatistic::MEAN );
+      ref = dip::Uniform( dip::Convert( in, dip::DT_DFLOAT ), kernel, { dip::S::SYMMETRIC_MIRROR } );
+      DOCTEST_CHECK( dip::MaximumAbs( out - ref ).As< dip::dfloat >() < 1e-7 );
+      dip::IntegralImageFilter( in, out, kernel, bc, dip::DT_DFLOAT, dip::IntegralImageStatistic::VARIANCE );
+      ref = dip::VarianceFilter( dip::Convert( in, dip::DT_DFLOAT ), kernel, { dip::S::SYMMETRIC_MIRROR } );
+      DOCTEST_CHECK( dip::MaximumAbs( out - ref ).As< dip::dfloat >() < 1e-7 * dip::Maximum( ref ).As< dip::dfloat >() );
+   }
+}
+
+#endif // DIP__ENABLE_DOCTEST
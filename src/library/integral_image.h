@@ -0,0 +1,93 @@
+/*
+ * DIPlib 3.0
+ * This file contains declarations for the summed-area table (integral image) used by local mean and variance filters.
+ *
+ * (c)2026, Cris Luengo.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DIP_INTEGRAL_IMAGE_H
+#define DIP_INTEGRAL_IMAGE_H
+
+#include <vector>
+
+#include "diplib.h"
+#include "diplib/boundary.h"
+#include "diplib/kernel.h"
+#include "diplib/pixel_table.h"
+
+
+namespace dip {
+
+// The sum of the pixel values within a kernel, expressed as a weighted sum of values of a summed-area table.
+//
+// The pixel table is decomposed into boxes (its runs), the sum over a box is computed from the table values at its
+// 2^nDims corners. Corners shared by adjacent boxes are merged, and cancel out if their weights add up to zero. Thus,
+// a rectangular kernel always needs 2^nDims table values, independently of its size. For other shapes the number
+// of terms depends on the number of corners in the kernel's outline.
+//
+// `coordinates` are relative to the pixel being computed.
+struct IntegralImageTerm {
+   IntegerArray coordinates;
+   dfloat weight;
+};
+std::vector< IntegralImageTerm > IntegralImageTerms( PixelTable const& pixelTable );
+
+// Returns true if computing sums over `kernel` with the summed-area table is expected to be cheaper than
+// updating running sums over the kernel's pixel table runs as it slides along the image line.
+bool IntegralImageIsEfficient( Kernel const& kernel, dip::uint nDims );
+
+// A summed-area table (integral image) of a scalar, real-valued image, optionally with a second table for the squared
+// pixel values. The image is extended by `boundary + 1` pixels along each dimension, using the boundary condition
+// `bc`, before the cumulative sums are computed.
+//
+// Each table value is the sum of all pixel values in the extended image with coordinates equal or smaller than its
+// own along all dimensions. Values are accumulated as double-precision floats, after subtracting the mean of the
+// image (`Shift()`), which keeps the magnitude of the sums small and therefore their rounding errors.
+//
+// `Table()` is a view of the table with the sizes of the input image, which can be indexed outside of its domain
+// up to `boundary + 1` pixels. It has one tensor element, or two if the squares are included.
+class IntegralImage {
+   public:
+      IntegralImage( Image const& in, UnsignedArray const& boundary, BoundaryConditionArray const& bc, bool squares );
+
+      Image const& Table() const { return table_; }
+      dfloat Shift() const { return shift_; }
+
+   private:
+      Image table_;
+      dfloat shift_ = 0.0;
+};
+
+// Which statistic `IntegralImageFilter` computes
+enum class IntegralImageStatistic {
+      MEAN,
+      VARIANCE
+};
+
+// Computes, for each pixel of `in`, the mean or the (sample) variance of the pixel values within `kernel`. The
+// output image has data type `outType`. `in` must be real-valued, and `kernel` must not have weights. Tensor
+// images are processed one tensor element at the time.
+void IntegralImageFilter(
+      Image const& in,
+      Image& out,
+      Kernel const& kernel,
+      BoundaryConditionArray const& bc,
+      DataType outType,
+      IntegralImageStatistic statistic
+);
+
+} // namespace dip
+
+#endif // DIP_INTEGRAL_IMAGE_H
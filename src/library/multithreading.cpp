@@ -37,7 +37,30 @@ void SetNumberOfThreads( dip::uint nThreads ) {
 }
 
 dip::uint GetNumberOfThreads() {
+   if( omp_in_parallel() ) {
+      // The functions that use this value divide the work over the threads they request, but nested parallel
+      // regions run with a single thread.
+      return 1;
+   }
    return maxNumberOfThreads;
 }
 
 } // namespace dip
+
+#ifdef DIP__ENABLE_DOCTEST
+#include "doctest.h"
+
+DOCTEST_TEST_CASE("[DIPlib] testing GetNumberOfThreads within a parallel region") {
+   dip::uint outside = dip::GetNumberOfThreads();
+   DOCTEST_CHECK( outside >= 1 );
+   dip::uint inside = 0;
+   #pragma omp parallel num_threads( 2 )
+   {
+      #pragma omp master
+      inside = dip::GetNumberOfThreads();
+   }
+   DOCTEST_CHECK( inside == 1 );
+   DOCTEST_CHECK( dip::GetNumberOfThreads() == outside );
+}
+
+#endif // DIP__ENABLE_DOCTEST
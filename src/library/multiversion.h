@@ -0,0 +1,91 @@
+/*
+ * DIPlib 3.0
+ * This file contains support for compiling functions for multiple instruction sets.
+ *
+ * (c)2026, Cris Luengo.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DIP_MULTIVERSION_H
+#define DIP_MULTIVERSION_H
+
+#include "diplib.h"
+
+// DIP__MULTIVERSION is defined if we can compile individual functions for instruction sets other than the one
+// the library is compiled for. `DIP__TARGET_AVX2` and `DIP__TARGET_AVX512` are the function attributes that do so.
+#if ( defined( __GNUC__ ) || defined( __clang__ )) && ( defined( __x86_64__ ) || defined( __i386__ ))
+#define DIP__MULTIVERSION
+#define DIP__TARGET_AVX2 __attribute__(( target( "avx2,fma" )))
+#define DIP__TARGET_AVX512 __attribute__(( target( "avx2,fma,avx512f,avx512dq,avx512bw,avx512vl" )))
+#endif
+
+
+namespace dip {
+namespace detail {
+
+// The instruction sets that multi-versioned functions are compiled for, in increasing order.
+enum class InstructionSet {
+      BASELINE,
+      AVX2,
+      AVX512
+};
+
+// The instruction set selected through `dip::SetInstructionSet`, or the best one supported by the processor.
+InstructionSet ActiveInstructionSet();
+
+#ifdef DIP__MULTIVERSION
+
+// `flatten` inlines everything `function` calls into these functions (where the definition is visible), so that
+// all of it is compiled for the target instruction set.
+template< typename F >
+DIP__TARGET_AVX2 __attribute__(( flatten )) void CallAVX2( F const& function ) {
+   function();
+}
+
+template< typename F >
+DIP__TARGET_AVX512 __attribute__(( flatten )) void CallAVX512( F const& function ) {
+   function();
+}
+
+#endif
+
+// Calls `function()`, using code compiled for the active instruction set. Use this in a line filter as
+//
+//     virtual void Filter( Framework::ScanLineFilterParameters const& params ) override {
+//        detail::CallMultiversioned( [ & ]() { FilterLine( params ); } );
+//     }
+//
+// with `FilterLine` doing the actual work. The selection is made for each call, the cost is negligible compared
+// to processing an image line.
+template< typename F >
+inline void CallMultiversioned( F const& function ) {
+#ifdef DIP__MULTIVERSION
+   switch( ActiveInstructionSet() ) {
+      case InstructionSet::AVX512:
+         CallAVX512( function );
+         return;
+      case InstructionSet::AVX2:
+         CallAVX2( function );
+         return;
+      default:
+         break;
+   }
+#endif
+   function();
+}
+
+} // namespace detail
+} // namespace dip
+
+#endif // DIP_MULTIVERSION_H
@@ -26,6 +26,7 @@
 #include "diplib/framework.h"
 #include "diplib/pixel_table.h"
 #include "diplib/overload.h"
+#include "../library/multiversion.h"
 
 namespace dip {
 
@@ -135,6 +136,12 @@ class SeparableConvolutionLineFilter : public Framework::SeparableLineFilter {
    public:
       SeparableConvolutionLineFilter( InternOneDimensionalFilterArray const& filter ) : filter_( filter ) {}
       virtual void Filter( Framework::SeparableLineFilterParameters const& params ) override {
+         detail::CallMultiversioned( [ & ]() { FilterLine( params ); } );
+      }
+   private:
+      InternOneDimensionalFilterArray const& filter_;
+
+      void FilterLine( Framework::SeparableLineFilterParameters const& params ) {
          TPI* in = static_cast< TPI* >( params.inBuffer.buffer );
          dip::uint length = params.inBuffer.length;
          DIP_ASSERT( params.inBuffer.stride == 1 );
@@ -149,6 +156,10 @@ class SeparableConvolutionLineFilter : public Framework::SeparableLineFilter {
          auto filterEnd = filter + dataSize;
          dip::uint origin = filter_[ procDim ].origin;
          in -= origin;
+         if( outStride == 1 ) {
+            FilterContiguous( in, out, length, filter, dataSize, filter_[ procDim ].symmetry );
+            return;
+         }
          switch( filter_[ procDim ].symmetry ) {
             case FilterSymmetry::GENERAL:
                for( dip::uint ii = 0; ii < length; ++ii ) {
@@ -220,8 +231,70 @@ class SeparableConvolutionLineFilter : public Framework::SeparableLineFilter {
                break;
          }
       }
-   private:
-      InternOneDimensionalFilterArray const& filter_;
+
+      // Computes the same as `FilterLine` does, but with the loop over the filter weights outside of the loop over
+      // the pixels, which can then be vectorized. The additions for each output pixel happen in the same order.
+      static void FilterContiguous(
+            TPI const* in,
+            TPI* out,
+            dip::uint length,
+            FloatType< TPI > const* filter,
+            dip::uint dataSize,
+            FilterSymmetry symmetry
+      ) {
+         switch( symmetry ) {
+            case FilterSymmetry::GENERAL:
+               std::fill( out, out + length, TPI( 0 ));
+               for( dip::uint jj = 0; jj < dataSize; ++jj ) {
+                  FloatType< TPI > f = filter[ jj ];
+                  TPI const* in_t = in + jj;
+                  for( dip::uint ii = 0; ii < length; ++ii ) {
+                     out[ ii ] += f * in_t[ ii ];
+                  }
+               }
+               break;
+            case FilterSymmetry::EVEN: // Always an odd-sized filter
+            case FilterSymmetry::ODD:
+               in += dataSize - 1;
+               for( dip::uint ii = 0; ii < length; ++ii ) {
+                  out[ ii ] = *filter * in[ ii ];
+               }
+               for( dip::uint jj = 1; jj < dataSize; ++jj ) {
+                  FloatType< TPI > f = filter[ jj ];
+                  TPI const* in_r = in + jj;
+                  TPI const* in_l = in - jj;
+                  if( symmetry == FilterSymmetry::EVEN ) {
+                     for( dip::uint ii = 0; ii < length; ++ii ) {
+                        out[ ii ] += f * ( in_r[ ii ] + in_l[ ii ] );
+                     }
+                  } else {
+                     for( dip::uint ii = 0; ii < length; ++ii ) {
+                        out[ ii ] += f * ( in_r[ ii ] - in_l[ ii ] );
+                     }
+                  }
+               }
+               break;
+            case FilterSymmetry::D_EVEN: // Always an even-sized filter
+            case FilterSymmetry::D_ODD:
+               in += dataSize - 1;
+               std::fill( out, out + length, TPI( 0 ));
+               for( dip::uint jj = 0; jj < dataSize; ++jj ) {
+                  FloatType< TPI > f = filter[ jj ];
+                  TPI const* in_r = in + jj;
+                  TPI const* in_l = in - jj - 1;
+                  if( symmetry == FilterSymmetry::D_EVEN ) {
+                     for( dip::uint ii = 0; ii < length; ++ii ) {
+                        out[ ii ] += f * ( in_r[ ii ] + in_l[ ii ] );
+                     }
+                  } else {
+                     for( dip::uint ii = 0; ii < length; ++ii ) {
+                        out[ ii ] += f * ( in_r[ ii ] - in_l[ ii ] );
+                     }
+                  }
+               }
+               break;
+         }
+      }
 };
 
 inline bool IsMeaninglessFilter( InternOneDimensionalFilter const& filter ) {
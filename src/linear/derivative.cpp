@@ -18,6 +18,10 @@
  * limitations under the License.
  */
 
+#include <chrono>
+#include <mutex>
+#include <numeric>
+
 #include "diplib.h"
 #include "diplib/linear.h"
 #include "diplib/math.h"
@@ -27,40 +31,201 @@ namespace dip {
 
 namespace {
 
-void GaussDispatch(
-      Image const& in,
-      Image& out,
+enum class GaussMethod { FIR, IIR, FT };
+using GaussMethodArray = DimensionArray< GaussMethod >;
+
+// Half size of the kernel used by `GaussFIR`, see `HalfGaussianSize` in gauss.cpp.
+dfloat GaussFIRHalfSize( dfloat sigma, dip::uint order, dfloat truncation ) {
+   return std::ceil(( truncation + 0.5 * static_cast< dfloat >( order )) * sigma );
+}
+
+// Size of the boundary extension used by `GaussIIR`, see `dip__FillGaussIIRParams` in gaussiir.cpp.
+dfloat GaussIIRBorder( dfloat sigma, dfloat truncation ) {
+   return std::max( 5.0, std::round( sigma * truncation ));
+}
+
+std::mutex gaussCostModelMutex;
+GaussCostModel gaussCostModel;
+
+// Returns the smallest time, in nanoseconds, that `function` takes to run.
+template< typename F >
+dfloat MeasureTime( F const& function ) {
+   dfloat best = std::numeric_limits< dfloat >::max();
+   for( dip::uint ii = 0; ii < 3; ++ii ) {
+      auto start = std::chrono::steady_clock::now();
+      function();
+      auto end = std::chrono::steady_clock::now();
+      best = std::min( best, std::chrono::duration< dfloat, std::nano >( end - start ).count() );
+   }
+   return best;
+}
+
+// Times the three implementations on a small image to estimate the parameters of the cost model.
+// The FIR parameters are derived from two kernel sizes, the IIR and FT costs are relative to their size.
+// `model.iirMinimumSigma` is not modified.
+void MeasureGaussCostModel( GaussCostModel& model ) {
+   constexpr dip::uint size = 256;
+   constexpr dfloat truncation = 3.0;
+   constexpr dfloat smallSigma = 1.0;
+   constexpr dfloat largeSigma = 6.0;
+   Image img( { size, size }, 1, DT_SFLOAT );
+   img.Fill( 1.0 );
+   Image tmp;
+   dfloat nPixels = static_cast< dfloat >( size * size );
+   dfloat tFirSmall = MeasureTime( [ & ]() { GaussFIR( img, tmp, { smallSigma, 0.0 }, { 0 }, {}, truncation ); } );
+   dfloat tFirLarge = MeasureTime( [ & ]() { GaussFIR( img, tmp, { largeSigma, 0.0 }, { 0 }, {}, truncation ); } );
+   dfloat tIir = MeasureTime( [ & ]() { GaussIIR( img, tmp, { largeSigma, 0.0 }, { 0 }, {}, {}, S::DISCRETE_TIME_FIT, truncation ); } );
+   dfloat tFt = MeasureTime( [ & ]() { GaussFT( img, tmp, { largeSigma, largeSigma }, { 0 }, truncation ); } );
+   dfloat tapsSmall = 2.0 * GaussFIRHalfSize( smallSigma, 0, truncation ) + 1.0;
+   dfloat tapsLarge = 2.0 * GaussFIRHalfSize( largeSigma, 0, truncation ) + 1.0;
+   model.firPerTap = std::max( 0.0, tFirLarge - tFirSmall ) / ( nPixels * ( tapsLarge - tapsSmall ));
+   model.firPerPixel = std::max( 0.0, tFirSmall / nPixels - model.firPerTap * tapsSmall );
+   model.iirPerPixel = tIir / ( nPixels * ( 1.0 + 2.0 * GaussIIRBorder( largeSigma, truncation ) / static_cast< dfloat >( size )));
+   model.ftPerPixel = tFt / ( nPixels * 2.0 * std::log2( static_cast< dfloat >( size )));
+}
+
+bool AllPeriodic( StringArray const& boundaryCondition, dip::uint nDims ) {
+   if( boundaryCondition.empty() ) {
+      return false; // The default is not periodic
+   }
+   for( dip::uint ii = 0; ii < nDims; ++ii ) {
+      if( boundaryCondition[ boundaryCondition.size() == 1 ? 0 : ii ] != S::PERIODIC ) {
+         return false;
+      }
+   }
+   return true;
+}
+
+// Chooses the implementation to use along each dimension. Either all elements of the output are `FT`, or
+// each is `FIR` or `IIR`. `sigmas` and `derivativeOrder` must have one element per dimension.
+//
+// The FT method is required if any derivative order is larger than 3, or any sigma is smaller than 0.8.
+// Otherwise the cost model is used to pick the cheapest of FIR or IIR along each dimension (IIR only
+// for sigma larger than `iirMinimumSigma`). The FT method replaces these only if it's cheaper and the boundary condition
+// is periodic along all dimensions, as it is the boundary condition implied by the FT method.
+GaussMethodArray GaussChooseMethods(
+      UnsignedArray const& sizes,
       FloatArray const& sigmas,
       UnsignedArray const& derivativeOrder,
       StringArray const& boundaryCondition,
       dfloat truncation
 ) {
-   // If any( sigmas < 0.8 ) || any( derivativeOrder > 3 )  ==>  FT
-   // Else if any( sigmas > 10 )  ==>  IIR
-   // Else ==>  FIR
-   for( dip::uint ii = 0; ii < derivativeOrder.size(); ++ii ) { // We can't fold this loop in with the next one, the two arrays might be of different size
-      if( derivativeOrder[ ii ] > 3 ) {
-         GaussFT( in, out, sigmas, derivativeOrder, truncation ); // ignores boundaryCondition
-         return;
+   dip::uint nDims = sizes.size();
+   DIP_ASSERT( sigmas.size() == nDims );
+   DIP_ASSERT( derivativeOrder.size() == nDims );
+   GaussMethodArray methods( nDims, GaussMethod::FIR );
+   for( dip::uint ii = 0; ii < nDims; ++ii ) {
+      if(( derivativeOrder[ ii ] > 3 ) || (( sigmas[ ii ] < 0.8 ) && ( sigmas[ ii ] > 0.0 ))) {
+         methods.fill( GaussMethod::FT );
+         return methods;
       }
    }
-   for( dip::uint ii = 0; ii < sigmas.size(); ++ii ) {
-      if(( sigmas[ ii ] < 0.8 ) && ( sigmas[ ii ] > 0.0 )) {
-         GaussFT( in, out, sigmas, derivativeOrder, truncation ); // ignores boundaryCondition
-         return;
+   GaussCostModel model = GetGaussCostModel();
+   dfloat separableCost = 0.0;
+   dfloat ftCost = 0.0;
+   for( dip::uint ii = 0; ii < nDims; ++ii ) {
+      if( sizes[ ii ] <= 1 ) {
+         continue;
       }
+      dfloat size = static_cast< dfloat >( sizes[ ii ] );
+      ftCost += model.ftPerPixel * std::log2( size );
+      if( sigmas[ ii ] <= 0.0 ) {
+         continue;
+      }
+      dfloat taps = 2.0 * GaussFIRHalfSize( sigmas[ ii ], derivativeOrder[ ii ], truncation ) + 1.0;
+      dfloat firCost = model.firPerPixel + model.firPerTap * taps;
+      dfloat iirCost = model.iirPerPixel * ( 1.0 + 2.0 * GaussIIRBorder( sigmas[ ii ], truncation ) / size );
+      if(( sigmas[ ii ] > model.iirMinimumSigma ) && ( iirCost < firCost )) {
+         methods[ ii ] = GaussMethod::IIR;
+         separableCost += iirCost;
+      } else {
+         separableCost += firCost;
+      }
+   }
+   if(( ftCost < separableCost ) && AllPeriodic( boundaryCondition, nDims )) {
+      methods.fill( GaussMethod::FT );
    }
+   return methods;
+}
+
+// Applies a separable Gaussian (derivative) filter, using FIR or IIR along each dimension as given by `methods`.
+// `sigmas` and `order` must have one element per dimension.
+void SeparableGauss(
+      Image const& in,
+      Image& out,
+      FloatArray const& sigmas,
+      UnsignedArray const& order,
+      GaussMethodArray const& methods,
+      StringArray const& boundaryCondition,
+      dfloat truncation
+) {
+   FloatArray firSigmas = sigmas;
+   FloatArray iirSigmas = sigmas;
+   bool anyFir = false;
+   bool anyIir = false;
    for( dip::uint ii = 0; ii < sigmas.size(); ++ii ) {
-      if( sigmas[ ii ] > 10 ) {
-         GaussIIR( in, out, sigmas, derivativeOrder, boundaryCondition, {}, S::DISCRETE_TIME_FIT, truncation );
-         return;
+      if( sigmas[ ii ] > 0.0 ) {
+         if( methods[ ii ] == GaussMethod::IIR ) {
+            firSigmas[ ii ] = 0.0;
+            anyIir = true;
+         } else {
+            iirSigmas[ ii ] = 0.0;
+            anyFir = true;
+         }
       }
    }
-   GaussFIR( in, out, sigmas, derivativeOrder, boundaryCondition, truncation );
+   if( anyIir && anyFir ) {
+      Image tmp;
+      GaussFIR( in, tmp, firSigmas, order, boundaryCondition, truncation );
+      GaussIIR( tmp, out, iirSigmas, order, boundaryCondition, {}, S::DISCRETE_TIME_FIT, truncation );
+   } else if( anyIir ) {
+      GaussIIR( in, out, sigmas, order, boundaryCondition, {}, S::DISCRETE_TIME_FIT, truncation );
+   } else {
+      GaussFIR( in, out, sigmas, order, boundaryCondition, truncation );
+   }
+}
+
+void GaussDispatch(
+      Image const& in,
+      Image& out,
+      FloatArray sigmas,
+      UnsignedArray derivativeOrder,
+      StringArray const& boundaryCondition,
+      dfloat truncation
+) {
+   DIP_THROW_IF( !in.IsForged(), E::IMAGE_NOT_FORGED );
+   dip::uint nDims = in.Dimensionality();
+   DIP_START_STACK_TRACE
+      ArrayUseParameter( sigmas, nDims, 1.0 );
+      ArrayUseParameter( derivativeOrder, nDims, dip::uint( 0 ));
+   DIP_END_STACK_TRACE
+   GaussMethodArray methods = GaussChooseMethods( in.Sizes(), sigmas, derivativeOrder, boundaryCondition, truncation );
+   if( !methods.empty() && ( methods[ 0 ] == GaussMethod::FT )) {
+      GaussFT( in, out, sigmas, derivativeOrder, truncation ); // ignores boundaryCondition
+   } else {
+      SeparableGauss( in, out, sigmas, derivativeOrder, methods, boundaryCondition, truncation );
+   }
 }
 
 } // namespace
 
+GaussCostModel GetGaussCostModel() {
+   std::lock_guard< std::mutex > lock( gaussCostModelMutex );
+   return gaussCostModel;
+}
+
+void SetGaussCostModel( GaussCostModel const& model ) {
+   std::lock_guard< std::mutex > lock( gaussCostModelMutex );
+   gaussCostModel = model;
+}
+
+GaussCostModel CalibrateGaussCostModel() {
+   GaussCostModel model = GetGaussCostModel();
+   DIP_STACK_TRACE_THIS( MeasureGaussCostModel( model )); // Don't hold the lock while timing, it calls `Gauss`
+   SetGaussCostModel( model );
+   return model;
+}
+
 void Gauss(
       Image const& in,
       Image& out,
@@ -141,6 +306,134 @@ UnsignedArray FindGradientDimensions(
    return dims;
 }
 
+// Recursive part of `MultipleDerivatives`. `in` is the result of filtering along dimensions `dims[0]`
+// through `dims[level-1]`, and is shared by the outputs indexed by `subset`.
+void MultipleGaussDerivativesPass(
+      Image const& in,
+      ImageArray& out,
+      std::vector< UnsignedArray > const& orders,
+      std::vector< dip::uint > const& subset,
+      UnsignedArray const& dims,
+      dip::uint level,
+      FloatArray const& sigmas,
+      GaussMethodArray const& methods,
+      StringArray const& boundaryCondition,
+      dfloat truncation
+) {
+   if( level == dims.size() ) {
+      // Can only happen if the same derivative was requested twice
+      for( auto kk : subset ) {
+         out[ kk ].Copy( in );
+      }
+      return;
+   }
+   dip::uint nDims = sigmas.size();
+   if( subset.size() == 1 ) {
+      // Nothing left to share, apply all remaining passes in one go, writing directly into the output
+      dip::uint kk = subset[ 0 ];
+      FloatArray ss( nDims, 0.0 );
+      UnsignedArray oo( nDims, 0 );
+      for( dip::uint ii = level; ii < dims.size(); ++ii ) {
+         ss[ dims[ ii ]] = sigmas[ dims[ ii ]];
+         oo[ dims[ ii ]] = orders[ kk ][ dims[ ii ]];
+      }
+      SeparableGauss( in, out[ kk ], ss, oo, methods, boundaryCondition, truncation );
+      return;
+   }
+   // Group the outputs by the derivative order along this dimension, and filter once for each group
+   dip::uint dim = dims[ level ];
+   FloatArray ss( nDims, 0.0 );
+   ss[ dim ] = sigmas[ dim ];
+   UnsignedArray oo( nDims, 0 );
+   std::vector< bool > done( subset.size(), false );
+   for( dip::uint ii = 0; ii < subset.size(); ++ii ) {
+      if( done[ ii ] ) {
+         continue;
+      }
+      dip::uint order = orders[ subset[ ii ]][ dim ];
+      std::vector< dip::uint > group;
+      for( dip::uint jj = ii; jj < subset.size(); ++jj ) {
+         if( !done[ jj ] && ( orders[ subset[ jj ]][ dim ] == order )) {
+            group.push_back( subset[ jj ] );
+            done[ jj ] = true;
+         }
+      }
+      if( group.size() == 1 ) {
+         MultipleGaussDerivativesPass( in, out, orders, group, dims, level, sigmas, methods, boundaryCondition, truncation );
+      } else {
+         oo[ dim ] = order;
+         Image tmp;
+         SeparableGauss( in, tmp, ss, oo, methods, boundaryCondition, truncation );
+         MultipleGaussDerivativesPass( tmp, out, orders, group, dims, level + 1, sigmas, methods, boundaryCondition, truncation );
+      }
+   }
+}
+
+// Computes the derivatives of `in` given by each of `orders`, writing them to the (forged) images in `out`.
+// `sigmas` must have one element per image dimension.
+//
+// For the separable Gaussian methods (FIR and IIR), passes that several outputs have in common are computed
+// only once. Dimensions are processed one at a time, outputs that need the same 1D filter along all dimensions
+// processed so far share the intermediate result. This forms a tree of partial separable passes. Dimensions
+// where all outputs use the same filter are processed first, so that that result is shared by all outputs.
+// For the other methods, `dip::Derivative` is called for each output.
+void MultipleDerivatives(
+      Image const& in,
+      ImageArray& out,
+      std::vector< UnsignedArray > const& orders,
+      FloatArray const& sigmas,
+      String const& method,
+      StringArray const& boundaryCondition,
+      dfloat truncation
+) {
+   DIP_ASSERT( out.size() == orders.size() );
+   bool shared = false;
+   dip::uint nDims = in.Dimensionality();
+   GaussMethodArray gaussMethods( nDims, GaussMethod::FIR );
+   if(( method == S::BEST ) || ( method == "gauss" )) {
+      // Choose the methods for the largest order along each dimension, so that all outputs can share them
+      UnsignedArray maxOrder( nDims, 0 );
+      for( auto const& order : orders ) {
+         for( dip::uint ii = 0; ii < nDims; ++ii ) {
+            maxOrder[ ii ] = std::max( maxOrder[ ii ], order[ ii ] );
+         }
+      }
+      gaussMethods = GaussChooseMethods( in.Sizes(), sigmas, maxOrder, boundaryCondition, truncation );
+      shared = gaussMethods.empty() || ( gaussMethods[ 0 ] != GaussMethod::FT );
+   } else if(( method == "gaussFIR" ) || ( method == "gaussfir" )) {
+      shared = true;
+   } else if(( method == "gaussIIR" ) || ( method == "gaussiir" )) {
+      shared = true;
+      gaussMethods.fill( GaussMethod::IIR );
+   }
+   if( !shared || ( out.size() == 1 )) {
+      for( dip::uint ii = 0; ii < out.size(); ++ii ) {
+         Derivative( in, out[ ii ], orders[ ii ], sigmas, method, boundaryCondition, truncation );
+      }
+      return;
+   }
+   // Find the dimensions to process, and sort them by number of distinct orders along them
+   UnsignedArray dims;
+   UnsignedArray nDistinct;
+   for( dip::uint ii = 0; ii < nDims; ++ii ) {
+      if(( sigmas[ ii ] > 0.0 ) && ( in.Size( ii ) > 1 )) {
+         std::vector< dip::uint > distinct;
+         for( auto const& order : orders ) {
+            if( std::find( distinct.begin(), distinct.end(), order[ ii ] ) == distinct.end() ) {
+               distinct.push_back( order[ ii ] );
+            }
+         }
+         dims.push_back( ii );
+         nDistinct.push_back( distinct.size() );
+      }
+   }
+   UnsignedArray index = nDistinct.sorted_indices(); // stable sort
+   dims = dims.permute( index );
+   std::vector< dip::uint > subset( out.size() );
+   std::iota( subset.begin(), subset.end(), 0 );
+   MultipleGaussDerivativesPass( in, out, orders, subset, dims, 0, sigmas, gaussMethods, boundaryCondition, truncation );
+}
+
 } // namespace
 
 void Gradient(
@@ -164,14 +457,15 @@ void Gradient(
       out.Strip();
    }
    out.ReForge( in.Sizes(), nDims, DataType::SuggestFlex( in.DataType() ));
-   UnsignedArray order( in.Dimensionality(), 0 );
+   std::vector< UnsignedArray > orders( nDims, UnsignedArray( in.Dimensionality(), 0 ));
+   ImageArray outs;
    auto it = ImageTensorIterator( out );
    for( dip::uint ii = 0; ii < nDims; ++ii ) {
-      order[ dims[ ii ]] = 1;
-      DIP_STACK_TRACE_THIS( Derivative( in, *it, order, sigmas, method, boundaryCondition, truncation ));
-      order[ dims[ ii ]] = 0;
+      orders[ ii ][ dims[ ii ]] = 1;
+      outs.push_back( *it );
       ++it;
    }
+   DIP_STACK_TRACE_THIS( MultipleDerivatives( in, outs, orders, sigmas, method, boundaryCondition, truncation ));
    out.SetPixelSize( pxsz );
 }
 
@@ -355,23 +649,29 @@ void Hessian (
    out.ReForge( in.Sizes(), tensor.Elements(), DataType::SuggestFlex( in.DataType() ));
    out.ReshapeTensor( tensor );
    UnsignedArray order( in.Dimensionality(), 0 );
-   auto it = ImageTensorIterator( out );
+   std::vector< UnsignedArray > orders;
+   orders.reserve( tensor.Elements() );
    for( dip::uint ii = 0; ii < nDims; ++ii ) { // Symmetric matrix stores diagonal elements first
       order[ dims[ ii ]] = 2;
-      DIP_STACK_TRACE_THIS( Derivative( in, *it, order, sigmas, method, boundaryCondition, truncation ));
+      orders.push_back( order );
       order[ dims[ ii ]] = 0;
-      ++it;
    }
    for( dip::uint jj = 1; jj < nDims; ++jj ) { // Elements above diagonal stored column-wise
       for( dip::uint ii = 0; ii < jj; ++ii ) {
          order[ dims[ ii ]] = 1;
          order[ dims[ jj ]] = 1;
-         DIP_STACK_TRACE_THIS( Derivative( in, *it, order, sigmas, method, boundaryCondition, truncation ));
+         orders.push_back( order );
          order[ dims[ ii ]] = 0;
          order[ dims[ jj ]] = 0;
-         ++it;
       }
    }
+   ImageArray outs;
+   auto it = ImageTensorIterator( out );
+   for( dip::uint ii = 0; ii < orders.size(); ++ii ) {
+      outs.push_back( *it );
+      ++it;
+   }
+   DIP_STACK_TRACE_THIS( MultipleDerivatives( in, outs, orders, sigmas, method, boundaryCondition, truncation ));
    out.SetPixelSize( pxsz );
 }
 
@@ -564,3 +864,58 @@ void NormalizedDifferentialConvolution(
 }
 
 } // namespace dip
+
+#ifdef DIP__ENABLE_DOCTEST
+#include "doctest.h"
+#include "diplib/generation.h"
+#include "diplib/testing.h"
+
+DOCTEST_TEST_CASE("[DIPlib] testing the shared passes in dip::Gradient and dip::Hessian") {
+   dip::Image img{ dip::UnsignedArray{ 40, 30, 20 }, 1, dip::DT_SFLOAT };
+   img.Fill( 0.0 );
+   dip::Random random( 0 );
+   dip::GaussianNoise( img, img, random );
+   for( auto method : { "gaussFIR", "gaussIIR" } ) {
+      dip::Image H = dip::Hessian( img, { 2.0 }, method );
+      DOCTEST_CHECK( H.TensorShape() == dip::Tensor::Shape::SYMMETRIC_MATRIX );
+      DOCTEST_REQUIRE( H.TensorElements() == 6 );
+      DOCTEST_CHECK( dip::testing::CompareImages( H[ 0 ], dip::Derivative( img, { 2, 0, 0 }, { 2.0 }, method ), 1e-5 ));
+      DOCTEST_CHECK( dip::testing::CompareImages( H[ dip::UnsignedArray{ 2, 2 } ], dip::Derivative( img, { 0, 0, 2 }, { 2.0 }, method ), 1e-5 ));
+      DOCTEST_CHECK( dip::testing::CompareImages( H[ dip::UnsignedArray{ 0, 1 } ], dip::Derivative( img, { 1, 1, 0 }, { 2.0 }, method ), 1e-5 ));
+      DOCTEST_CHECK( dip::testing::CompareImages( H[ dip::UnsignedArray{ 1, 2 } ], dip::Derivative( img, { 0, 1, 1 }, { 2.0 }, method ), 1e-5 ));
+      dip::Image g = dip::Gradient( img, { 2.0 }, method, {}, { true, false, true } );
+      DOCTEST_REQUIRE( g.TensorElements() == 2 );
+      DOCTEST_CHECK( dip::testing::CompareImages( g[ 0 ], dip::Derivative( img, { 1, 0, 0 }, { 2.0 }, method ), 1e-5 ));
+      DOCTEST_CHECK( dip::testing::CompareImages( g[ 1 ], dip::Derivative( img, { 0, 0, 1 }, { 2.0 }, method ), 1e-5 ));
+   }
+}
+
+DOCTEST_TEST_CASE("[DIPlib] testing the choice of method in dip::Gauss") {
+   dip::Image img{ dip::UnsignedArray{ 64, 48 }, 1, dip::DT_SFLOAT };
+   img.Fill( 0.0 );
+   dip::Random random( 0 );
+   dip::GaussianNoise( img, img, random );
+   dip::GaussCostModel previous = dip::GetGaussCostModel();
+   dip::SetGaussCostModel( dip::GaussCostModel{} );
+   // FIR along the first dimension (small sigma), IIR along the second (large sigma)
+   dip::Image best = dip::Gauss( img, { 1.0, 12.0 }, { 0, 1 } );
+   dip::Image mixed = dip::GaussIIR( dip::GaussFIR( img, { 1.0, 0.0 }, { 0, 1 } ), { 0.0, 12.0 }, { 0, 1 } );
+   DOCTEST_CHECK( dip::testing::CompareImages( best, mixed ));
+   // Up to sigma 10, the default model always picks FIR
+   best = dip::Gauss( img, { 10.0, 10.0 }, { 0, 1 } );
+   DOCTEST_CHECK( dip::testing::CompareImages( best, dip::GaussFIR( img, { 10.0, 10.0 }, { 0, 1 } )));
+   // Small sigma requires FT
+   best = dip::Gauss( img, { 0.5, 1.0 } );
+   DOCTEST_CHECK( dip::testing::CompareImages( best, dip::GaussFT( img, { 0.5, 1.0 } )));
+   // Large sigma and periodic boundary condition: FT is cheaper
+   best = dip::Gauss( img, { 20.0, 20.0 }, { 0 }, dip::S::BEST, { dip::S::PERIODIC } );
+   DOCTEST_CHECK( dip::testing::CompareImages( best, dip::GaussFT( img, { 20.0, 20.0 } )));
+   // Calibration only happens when requested, and doesn't change the minimum sigma for IIR
+   dip::GaussCostModel calibrated = dip::CalibrateGaussCostModel();
+   DOCTEST_CHECK( calibrated.iirPerPixel > 0.0 );
+   DOCTEST_CHECK( calibrated.iirMinimumSigma == dip::GaussCostModel{}.iirMinimumSigma );
+   DOCTEST_CHECK( dip::GetGaussCostModel().iirPerPixel == calibrated.iirPerPixel );
+   dip::SetGaussCostModel( previous );
+}
+
+#endif // DIP__ENABLE_DOCTEST
@@ -23,6 +23,7 @@
 #include "diplib/framework.h"
 #include "diplib/pixel_table.h"
 #include "diplib/overload.h"
+#include "../library/integral_image.h"
 
 namespace dip {
 
@@ -154,6 +155,8 @@ void Uniform(
       BoundaryConditionArray bc = StringArrayToBoundaryConditionArray( boundaryCondition );
       if( kernel.IsRectangular() ) {
          RectangularUniform(in, out, kernel.Sizes( in.Dimensionality() ), bc );
+      } else if( in.DataType().IsReal() && IntegralImageIsEfficient( kernel, in.Dimensionality() )) {
+         IntegralImageFilter( in, out, kernel, bc, DataType::SuggestFlex( in.DataType() ), IntegralImageStatistic::MEAN );
       } else {
          PixelTableUniform( in, out, kernel, bc );
       }
@@ -22,9 +22,29 @@
 #include "diplib/framework.h"
 #include "diplib/overload.h"
 #include "diplib/saturated_arithmetic.h"
+#include "../library/multiversion.h"
 
 namespace dip {
 
+namespace {
+
+// A dyadic scan line filter compiled for each of the instruction sets, for the simplest, most common operators
+template< typename TPI, typename F >
+class MultiversionDyadicLineFilter : public Framework::VariadicScanLineFilter< 2, TPI, F > {
+   public:
+      using Framework::VariadicScanLineFilter< 2, TPI, F >::VariadicScanLineFilter;
+      virtual void Filter( Framework::ScanLineFilterParameters const& params ) override {
+         detail::CallMultiversioned( [ & ]() { Framework::VariadicScanLineFilter< 2, TPI, F >::Filter( params ); } );
+      }
+};
+
+template< typename TPI, typename F >
+inline std::unique_ptr< Framework::ScanLineFilter > NewMultiversionDyadicLineFilter( F const& func ) {
+   return static_cast< std::unique_ptr< Framework::ScanLineFilter >>( new MultiversionDyadicLineFilter< TPI, F >( func ));
+}
+
+} // namespace
+
 //
 void Add(
       Image const& lhs,
@@ -33,7 +53,7 @@ void Add(
       DataType dt
 ) {
    std::unique_ptr< Framework::ScanLineFilter >scanLineFilter;
-   DIP_OVL_CALL_ASSIGN_ALL( scanLineFilter, Framework::NewDyadicScanLineFilter, (
+   DIP_OVL_CALL_ASSIGN_ALL( scanLineFilter, NewMultiversionDyadicLineFilter, (
          []( auto its ) { return dip::saturated_add( *its[ 0 ], *its[ 1 ] ); }
    ), dt );
    DIP_STACK_TRACE_THIS( Framework::ScanDyadic( lhs, rhs, out, dt, dt, *scanLineFilter ));
@@ -47,7 +67,7 @@ void Subtract(
       DataType dt
 ) {
    std::unique_ptr< Framework::ScanLineFilter >scanLineFilter;
-   DIP_OVL_CALL_ASSIGN_ALL( scanLineFilter, Framework::NewDyadicScanLineFilter, (
+   DIP_OVL_CALL_ASSIGN_ALL( scanLineFilter, NewMultiversionDyadicLineFilter, (
          []( auto its ) { return dip::saturated_sub( *its[ 0 ], *its[ 1 ] ); }
    ), dt );
    DIP_STACK_TRACE_THIS( Framework::ScanDyadic( lhs, rhs, out, dt, dt, *scanLineFilter ));
@@ -224,7 +244,7 @@ void MultiplySampleWise(
       DataType dt
 ) {
    std::unique_ptr< Framework::ScanLineFilter >scanLineFilter;
-   DIP_OVL_CALL_ASSIGN_ALL( scanLineFilter, Framework::NewDyadicScanLineFilter, (
+   DIP_OVL_CALL_ASSIGN_ALL( scanLineFilter, NewMultiversionDyadicLineFilter, (
          []( auto its ) { return dip::saturated_mul( *its[ 0 ], *its[ 1 ] ); }
    ), dt );
    DIP_STACK_TRACE_THIS( Framework::ScanDyadic( lhs, rhs, out, dt, dt, *scanLineFilter ));
@@ -255,7 +275,7 @@ void Divide(
       DataType dt
 ) {
    std::unique_ptr< Framework::ScanLineFilter >scanLineFilter;
-   DIP_OVL_CALL_ASSIGN_ALL( scanLineFilter, Framework::NewDyadicScanLineFilter, (
+   DIP_OVL_CALL_ASSIGN_ALL( scanLineFilter, NewMultiversionDyadicLineFilter, (
          []( auto its ) { return dip::saturated_div( *its[ 0 ], *its[ 1 ] ); }
    ), dt );
    DIP_STACK_TRACE_THIS( Framework::ScanDyadic( lhs, rhs, out, dt, dt, *scanLineFilter ));
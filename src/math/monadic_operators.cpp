@@ -25,6 +25,8 @@
 #include "diplib/framework.h"
 #include "diplib/overload.h"
 
+#include "vectorized_math.h"
+
 namespace dip {
 
 namespace {
@@ -73,6 +75,37 @@ inline std::unique_ptr< Framework::ScanLineFilter > NewBinScanLineFilter( F cons
    return static_cast< std::unique_ptr< Framework::ScanLineFilter >>( new BinScanLineFilter< TPI, F >( func ));
 }
 
+// Computes a monadic operator through a vectorized kernel (see `vectorized_math.h`) for scalar buffers with
+// contiguous samples, which is what the Scan framework gives us in most cases. Other buffers are handled by the
+// same generic filter used by the other monadic operators.
+template< typename TPI, typename F >
+class MathKernelScanLineFilter : public Framework::ScanLineFilter {
+   public:
+      MathKernelScanLineFilter( F const& func, dip::uint cost, detail::MathKernelFunction< TPI > kernel )
+            : generic_( func, cost ), kernel_( kernel ) {}
+      virtual dip::uint GetNumberOfOperations( dip::uint nInput, dip::uint nOutput, dip::uint nTensorElements ) override {
+         return generic_.GetNumberOfOperations( nInput, nOutput, nTensorElements );
+      }
+      virtual void Filter( Framework::ScanLineFilterParameters const& params ) override {
+         if(( params.inBuffer[ 0 ].stride == 1 ) && ( params.outBuffer[ 0 ].stride == 1 ) && ( params.outBuffer[ 0 ].tensorLength == 1 )) {
+            kernel_( static_cast< TPI const* >( params.inBuffer[ 0 ].buffer ), static_cast< TPI* >( params.outBuffer[ 0 ].buffer ), params.bufferLength );
+         } else {
+            generic_.Filter( params );
+         }
+      }
+   private:
+      Framework::VariadicScanLineFilter< 1, TPI, F > generic_;
+      detail::MathKernelFunction< TPI > kernel_;
+};
+
+template< typename TPI, typename F >
+inline std::unique_ptr< Framework::ScanLineFilter > NewMathKernelScanLineFilter( F const& func, dip::uint cost, detail::MathKernel kernel ) {
+   auto kernelFunction = detail::GetMathKernel< TPI >( kernel );
+   if( !kernelFunction ) {
+      return Framework::NewMonadicScanLineFilter< TPI >( func, cost );
+   }
+   return static_cast< std::unique_ptr< Framework::ScanLineFilter >>( new MathKernelScanLineFilter< TPI, F >( func, cost, kernelFunction ));
+}
 
 } // namespace
 
@@ -98,6 +131,26 @@ inline std::unique_ptr< Framework::ScanLineFilter > NewBinScanLineFilter( F cons
             Framework::ScanOption::NoSingletonExpansion + Framework::ScanOption::TensorAsSpatialDim )); \
    }
 
+#define DIP__MONADIC_OPERATOR_FLEX_WITH_KERNEL( functionName_, functionLambda_, inputDomain_, cost_, kernel_ ) \
+   void functionName_( Image const& in, Image& out ) { \
+      DIP_THROW_IF( !in.DataType().IsA( inputDomain_ ), E::DATA_TYPE_NOT_SUPPORTED ); \
+      DataType dtype = DataType::SuggestFlex( in.DataType() ); \
+      std::unique_ptr <Framework::ScanLineFilter> scanLineFilter; \
+      DIP_OVL_CALL_ASSIGN_FLEX( scanLineFilter, NewMathKernelScanLineFilter, ( functionLambda_, cost_, detail::MathKernel::kernel_ ), dtype ); \
+      DIP_STACK_TRACE_THIS( Framework::ScanMonadic( in, out, dtype, dtype, in.TensorElements(), *scanLineFilter, \
+            Framework::ScanOption::NoSingletonExpansion + Framework::ScanOption::TensorAsSpatialDim )); \
+   }
+
+#define DIP__MONADIC_OPERATOR_FLOAT_WITH_KERNEL( functionName_, functionLambda_, inputDomain_, cost_, kernel_ ) \
+   void functionName_( Image const& in, Image& out ) { \
+      DIP_THROW_IF( !in.DataType().IsA( inputDomain_ ), E::DATA_TYPE_NOT_SUPPORTED ); \
+      DataType dtype = DataType::SuggestFloat( in.DataType() ); \
+      std::unique_ptr <Framework::ScanLineFilter> scanLineFilter; \
+      DIP_OVL_CALL_ASSIGN_FLOAT( scanLineFilter, NewMathKernelScanLineFilter, ( functionLambda_, cost_, detail::MathKernel::kernel_ ), dtype ); \
+      DIP_STACK_TRACE_THIS( Framework::ScanMonadic( in, out, dtype, dtype, in.TensorElements(), *scanLineFilter, \
+            Framework::ScanOption::NoSingletonExpansion + Framework::ScanOption::TensorAsSpatialDim )); \
+   }
+
 #define DIP__MONADIC_OPERATOR_FLOAT_WITH_PARAM( functionName_, paramType_, paramName_, functionLambda_, inputDomain_, cost_ ) \
    void functionName_( Image const& in, Image& out, paramType_ paramName_ ) { \
       DIP_THROW_IF( !in.DataType().IsA( inputDomain_ ), E::DATA_TYPE_NOT_SUPPORTED ); \
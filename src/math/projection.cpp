@@ -24,6 +24,7 @@
 #include "diplib/overload.h"
 #include "diplib/iterators.h"
 #include "diplib/library/copy_buffer.h"
+#include "diplib/multithreading.h"
 
 namespace dip {
 
@@ -146,31 +147,7 @@ void ProjectionScan(
    // Can we treat the images as if they were 1D?
    // TODO: This is an opportunity for improving performance if the non-processing dimensions in in, mask and out have the same layout and simple stride
 
-   // TODO: Determine the number of threads we'll be using. The size of the data has an influence. As is the number of sub-images that we can generate
-   function.SetNumberOfThreads( 1 );
-
-   // TODO: Start threads, each thread makes its own temp image.
-   dip::uint thread = 0;
-
-   // Create view over input image, that spans the processing dimensions
-   Image tempIn;
-   tempIn.CopyProperties( input );
-   tempIn.SetSizes( procSizes );
-   tempIn.dip__SetOrigin( input.Origin() );
-   tempIn.Squeeze(); // we want to make sure that function.Project() won't be looping over singleton dimensions
-   // TODO: instead of Squeeze, do a FlattenAsMuchAsPossible. But Mask must be flattened in the same way.
-   // Create view over mask image, identically to input
-   Image tempMask;
-   if( hasMask ) {
-      tempMask.CopyProperties( mask );
-      tempMask.SetSizes( procSizes );
-      tempMask.dip__SetOrigin( mask.Origin() );
-      tempMask.Squeeze(); // keep in sync with tempIn.
-   }
-   // Create view over output image that doesn't contain the processing dimensions or other singleton dimensions
-   Image tempOut;
-   tempOut.CopyProperties( output );
-   // Squeeze tempOut, but keep inStride, maskStride, outStride and outSizes in sync
+   // Squeeze the output dimensions, keeping inStride, maskStride, outStride and outSizes in sync
    IntegerArray inStride = input.Strides();
    IntegerArray maskStride( nDims );
    if( hasMask ) {
@@ -192,60 +169,145 @@ void ProjectionScan(
    outStride.resize( jj );
    outSizes.resize( jj );
    nDims = jj;
-   tempOut.SetSizes( outSizes );
-   tempOut.dip__SetOrigin( output.Origin() );
-   // Create a temporary output buffer, to collect a single sample in the data type requested by the calling function
-   bool useOutputBuffer = false;
-   Image outBuffer;
-   if( output.DataType() != outImageType ) {
-      // We need a temporary space for the output sample also, because `function.Project` expects `outImageType`.
-      outBuffer.SetDataType( outImageType );
-      outBuffer.Forge(); // By default it's a single sample.
-      useOutputBuffer = true;
-   }
-
-   // Iterate over the pixels in the output image. For each, we create a view in the input image.
-   UnsignedArray position( nDims, 0 );
-   for( ;; ) {
 
-      // Do the thing
-      if( useOutputBuffer ) {
-         function.Project( tempIn, tempMask, outBuffer.Origin(), thread );
-         // Copy data from output buffer to output image
-         detail::CopyBuffer( outBuffer.Origin(), outBuffer.DataType(), 1, 1,
-                             tempOut.Origin(), tempOut.DataType(), 1, 1, 1, 1 );
-      } else {
-         function.Project( tempIn, tempMask, tempOut.Origin(), thread );
+   // Determine the number of threads we'll be using. Each thread processes a contiguous set of output pixels.
+   // Starting threads is only worth while if the input image is large enough.
+   dip::uint nOut = outSizes.product();
+   dip::uint nThreads = 1;
+   if(( nOut > 1 ) && ( input.NumberOfPixels() >= threadingThreshold )) {
+      nThreads = std::min( GetNumberOfThreads(), nOut );
+   }
+   dip::uint nOutPerThread = div_ceil( nOut, nThreads );
+   DIP_STACK_TRACE_THIS( function.SetNumberOfThreads( nThreads ));
+
+   // Start threads, each thread makes its own temp images
+   AssertionError assertionError;
+   ParameterError parameterError;
+   RunTimeError runTimeError;
+   Error error;
+   #pragma omp parallel num_threads( static_cast< int >( nThreads ))
+   try {
+      dip::uint thread = static_cast< dip::uint >( omp_get_thread_num());
+      dip::uint first = thread * nOutPerThread;
+      dip::uint last = std::min( first + nOutPerThread, nOut );
+
+      // Create view over input image, that spans the processing dimensions
+      Image tempIn;
+      tempIn.CopyProperties( input );
+      tempIn.SetSizes( procSizes );
+      tempIn.dip__SetOrigin( input.Origin() );
+      tempIn.Squeeze(); // we want to make sure that function.Project() won't be looping over singleton dimensions
+      // TODO: instead of Squeeze, do a FlattenAsMuchAsPossible. But Mask must be flattened in the same way.
+      // Create view over mask image, identically to input
+      Image tempMask;
+      if( hasMask ) {
+         tempMask.CopyProperties( mask );
+         tempMask.SetSizes( procSizes );
+         tempMask.dip__SetOrigin( mask.Origin() );
+         tempMask.Squeeze(); // keep in sync with tempIn.
+      }
+      // Create view over output image that doesn't contain the processing dimensions or other singleton dimensions
+      Image tempOut;
+      tempOut.CopyProperties( output );
+      tempOut.SetSizes( outSizes );
+      tempOut.dip__SetOrigin( output.Origin() );
+      // Create a temporary output buffer, to collect a single sample in the data type requested by the calling function
+      bool useOutputBuffer = false;
+      Image outBuffer;
+      if( output.DataType() != outImageType ) {
+         // We need a temporary space for the output sample also, because `function.Project` expects `outImageType`.
+         outBuffer.SetDataType( outImageType );
+         outBuffer.Forge(); // By default it's a single sample.
+         useOutputBuffer = true;
       }
 
-      // Next output pixel
-      dip::uint dd;
-      for( dd = 0; dd < nDims; dd++ ) {
-         ++position[ dd ];
-         tempIn.dip__ShiftOrigin( inStride[ dd ]);
+      // Move the views to the first output pixel for this thread
+      UnsignedArray position( nDims, 0 );
+      dip::uint index = first;
+      for( dip::uint dd = 0; dd < nDims; ++dd ) {
+         position[ dd ] = index % outSizes[ dd ];
+         index /= outSizes[ dd ];
+         dip::sint pos = static_cast< dip::sint >( position[ dd ] );
+         tempIn.dip__ShiftOrigin( inStride[ dd ] * pos );
          if( hasMask ) {
-            tempMask.dip__ShiftOrigin( maskStride[ dd ]);
+            tempMask.dip__ShiftOrigin( maskStride[ dd ] * pos );
          }
-         tempOut.dip__ShiftOrigin( outStride[ dd ]);
-         // Check whether we reached the last pixel of the line
-         if( position[ dd ] != outSizes[ dd ] ) {
-            break;
+         tempOut.dip__ShiftOrigin( outStride[ dd ] * pos );
+      }
+
+      // Iterate over the pixels in the output image. For each, we create a view in the input image.
+      for( dip::uint kk = first; kk < last; ++kk ) {
+
+         // Do the thing
+         if( useOutputBuffer ) {
+            function.Project( tempIn, tempMask, outBuffer.Origin(), thread );
+            // Copy data from output buffer to output image
+            detail::CopyBuffer( outBuffer.Origin(), outBuffer.DataType(), 1, 1,
+                                tempOut.Origin(), tempOut.DataType(), 1, 1, 1, 1 );
+         } else {
+            function.Project( tempIn, tempMask, tempOut.Origin(), thread );
          }
-         // Rewind along this dimension
-         tempIn.dip__ShiftOrigin( -inStride[ dd ] * static_cast< dip::sint >( position[ dd ] ));
-         if( hasMask ) {
-            tempMask.dip__ShiftOrigin( -maskStride[ dd ] * static_cast< dip::sint >( position[ dd ] ));
+
+         // Next output pixel
+         for( dip::uint dd = 0; dd < nDims; dd++ ) {
+            ++position[ dd ];
+            tempIn.dip__ShiftOrigin( inStride[ dd ] );
+            if( hasMask ) {
+               tempMask.dip__ShiftOrigin( maskStride[ dd ] );
+            }
+            tempOut.dip__ShiftOrigin( outStride[ dd ] );
+            // Check whether we reached the last pixel of the line
+            if( position[ dd ] != outSizes[ dd ] ) {
+               break;
+            }
+            // Rewind along this dimension
+            tempIn.dip__ShiftOrigin( -inStride[ dd ] * static_cast< dip::sint >( position[ dd ] ));
+            if( hasMask ) {
+               tempMask.dip__ShiftOrigin( -maskStride[ dd ] * static_cast< dip::sint >( position[ dd ] ));
+            }
+            tempOut.dip__ShiftOrigin( -outStride[ dd ] * static_cast< dip::sint >( position[ dd ] ));
+            position[ dd ] = 0;
+            // Continue loop to increment along next dimension
          }
-         tempOut.dip__ShiftOrigin( -outStride[ dd ] * static_cast< dip::sint >( position[ dd ] ));
-         position[ dd ] = 0;
-         // Continue loop to increment along next dimension
       }
-      if( dd == nDims ) {
-         break;            // We're done!
+   } catch( dip::AssertionError const& e ) {
+      if( !assertionError.IsSet() ) {
+         assertionError = e;
+         DIP_ADD_STACK_TRACE( assertionError );
+      }
+   } catch( dip::ParameterError const& e ) {
+      if( !parameterError.IsSet() ) {
+         parameterError = e;
+         DIP_ADD_STACK_TRACE( parameterError );
+      }
+   } catch( dip::RunTimeError const& e ) {
+      if( !runTimeError.IsSet() ) {
+         runTimeError = e;
+         DIP_ADD_STACK_TRACE( runTimeError );
+      }
+   } catch( dip::Error const& e ) {
+      if( !error.IsSet() ) {
+         error = e;
+         DIP_ADD_STACK_TRACE( error );
+      }
+   } catch( std::exception const& stde ) {
+      if( !runTimeError.IsSet() ) {
+         runTimeError = dip::RunTimeError( stde.what() );
+         DIP_ADD_STACK_TRACE( runTimeError );
       }
    }
-
-   // TODO: End threads.
+   if( assertionError.IsSet() ) {
+      throw assertionError;
+   }
+   if( parameterError.IsSet() ) {
+      throw parameterError;
+   }
+   if( runTimeError.IsSet() ) {
+      throw runTimeError;
+   }
+   if( error.IsSet() ) {
+      throw error;
+   }
 }
 
 } // namespace
@@ -1242,6 +1304,7 @@ void PositionPercentile(
 
 #ifdef DIP__ENABLE_DOCTEST
 #include "doctest.h"
+#include "diplib/testing.h"
 
 DOCTEST_TEST_CASE("[DIPlib] testing the projection functions") {
    // We mostly test that the ProjectionScan framework works appropriately.
@@ -1300,6 +1363,24 @@ DOCTEST_TEST_CASE("[DIPlib] testing the projection functions") {
    DOCTEST_CHECK( out.TensorElements() == 1 );
    DOCTEST_CHECK( out.As< dip::dfloat >() == doctest::Approx(
          std::atan2( std::sin( 1 ), std::cos( 1 ) + ( 3 * 4 * 2 - 1 ))));
+
+   // A large image is processed in multiple threads, with the same result as in a single thread
+   img = dip::Image{ dip::UnsignedArray{ 200, 150, 5 }, 1, dip::DT_UINT16 };
+   dip::ImageIterator< dip::uint16 > it( img );
+   dip::uint16 value = 0;
+   do {
+      *it = value;
+      value = static_cast< dip::uint16 >(( value * 7 + 13 ) % 1009 );
+   } while( ++it );
+   ps = { false, true, true };
+   dip::uint nThreads = dip::GetNumberOfThreads();
+   dip::SetNumberOfThreads( 4 );
+   out = dip::Percentile( img, {}, 30.0, ps );
+   dip::SetNumberOfThreads( 1 );
+   dip::Image ref = dip::Percentile( img, {}, 30.0, ps );
+   dip::SetNumberOfThreads( nThreads );
+   DOCTEST_CHECK( out.Size( 0 ) == 200 );
+   DOCTEST_CHECK( dip::testing::CompareImages( out, ref ));
 }
 
 #endif // DIP__ENABLE_DOCTEST
@@ -18,295 +18,361 @@
  * limitations under the License.
  */
 
+#include <vector>
+
 #include "diplib.h"
 #include "diplib/statistics.h"
 #include "diplib/framework.h"
 #include "diplib/overload.h"
-#include "diplib/iterators.h"
+#include "diplib/multithreading.h"
 
 namespace dip {
 
-namespace {
+RadialBinning::RadialBinning(
+      UnsignedArray const& sizes,
+      dfloat binSize,
+      String const& maxRadius,
+      FloatArray center    // taken by copy so we can modify
+) : binSize_( binSize ) {
+   // TODO: handle 'process' array parameter
+   // Process all dimensions until this is passed as parameter and handled properly.
+   dip::uint nDims = sizes.size();
+   DIP_THROW_IF( nDims <= 1, "Radial projection is not meaningful in less than 2 dimensions" );
+   DIP_THROW_IF( binSize <= 0, "Bin size must be larger than 0" );
+   Image tmp;
+   tmp.SetSizes( sizes );
 
-class RadialProjectionScanFunction {
-   public:
-      // Initialize the output image.
-      virtual void InitializeOutputImage() = 0;
-      // Set number of threads. The output per thread is prepared here.
-      virtual void SetNumberOfThreads( dip::uint threads ) = 0;
-      // The filter to be applied to each sub-image. (currently called only once for the whole image)
-      virtual void Project( Image const& in, Image const& mask, dip::uint thread ) = 0;
-      // Reduce the outputs of all threads to a single output.
-      virtual void Reduce() {}
-      // A virtual destructor guarantees that we can destroy a derived class by a pointer to base
-      virtual ~RadialProjectionScanFunction() {}
-};
+   // Prepare center
+   if( center.empty() ) {
+      // Use default center
+      center = tmp.GetCenter();
+   } else {
+      // Verify center dimensionality
+      DIP_THROW_IF( center.size() != nDims, "Center has wrong dimensionality" );
+      // Verify that the center is inside the image
+      DIP_THROW_IF( !tmp.IsInside( center ), "Center is outside image" );
+   }
 
-template< typename TPI, typename TPO >
-class ProjectionRadialBase : public RadialProjectionScanFunction {
-   public:
-      ProjectionRadialBase( Image& out, dfloat binSize, FloatArray center ) : out_( out ), binSize_( binSize ), center_( std::move( center )) {}
+   // TODO: Create support for using physical pixel sizes to compute the radius. Allows integrating over ellipses.
 
-      virtual void Project( Image const& in, Image const& mask, dip::uint thread ) override {
+   // Determine radius
+   dfloat radius;
+   if( maxRadius == S::INNERRADIUS ) {
+      radius = std::numeric_limits< dfloat >::max();
+      // Find minimum size of dims to be processed
+      // TODO: handle 'process' array
+      for( dip::uint iDim = 0; iDim < nDims; ++iDim ) {
+         // Since the filter center might not be in the image's center,
+         // check both [0, center] and [center, size-1]
+         radius = std::min( radius, center[ iDim ] );
+         radius = std::min( radius, static_cast< dfloat >( sizes[ iDim ] - 1 ) - center[ iDim ] );
+      }
+      DIP_ASSERT( radius >= 0.0 );
+   } else if ( maxRadius == S::OUTERRADIUS ) {
+      // Find the maximum diagonal
+      radius = 0.0;
+      for( dip::uint iDim = 0; iDim < nDims; ++iDim ) {
+         dfloat dimMax = std::max( center[ iDim ], static_cast< dfloat >( sizes[ iDim ] - 1 ) - center[ iDim ] );
+         radius += dimMax * dimMax;
+      }
+      radius = std::sqrt( radius );
+   } else {
+      DIP_THROW( "Invalid maxRadius mode" );
+   }
+   nBins_ = static_cast< dip::uint >( radius / binSize ) + 1;
+   DIP_THROW_IF( nBins_ >= std::numeric_limits< uint32 >::max(), "Too many bins" );
+   center_ = std::move( center );
+
+   // Compute the bin index for each pixel. Pixels outside the maximum radius get index `nBins_`.
+   binIndex_.ReForge( sizes, 1, DT_UINT32 );
+   DIP_ASSERT( binIndex_.HasNormalStrides() );
+   uint32* ptr = static_cast< uint32* >( binIndex_.Origin() );
+   UnsignedArray coords( nDims, 0 );
+   dip::uint nLines = binIndex_.NumberOfPixels() / sizes[ 0 ];
+   for( dip::uint line = 0; line < nLines; ++line ) {
+      // Squared distance from the center in all dimensions except the first one
+      dfloat partialSqrDist = 0;
+      for( dip::uint ii = 1; ii < nDims; ++ii ) {
+         dfloat dist = static_cast< dfloat >( coords[ ii ] ) - center_[ ii ];
+         partialSqrDist += dist * dist;
+      }
+      for( dip::uint x = 0; x < sizes[ 0 ]; ++x, ++ptr ) {
+         dfloat dist = static_cast< dfloat >( x ) - center_[ 0 ];
+         dip::uint bin = static_cast< dip::uint >( std::sqrt( partialSqrDist + dist * dist ) / binSize_ );
+         *ptr = static_cast< uint32 >( std::min( bin, nBins_ ));
+      }
+      for( dip::uint ii = 1; ii < nDims; ++ii ) {
+         if( ++coords[ ii ] < sizes[ ii ] ) {
+            break;
+         }
+         coords[ ii ] = 0;
+      }
+   }
+}
 
-         // Obtain local output image
-         // The output of thread 0 is stored in out_; the output of the other threads is stored in outPerThread_
-         Image& out = thread == 0 ? out_ : outPerThread_[ thread - 1 ];
+namespace {
 
-         dip::uint procDim = Framework::OptimalProcessingDim( in );
-         dip::uint inTensorLength = in.TensorElements();
+enum class RadialStatistic { SUM, MEAN, MINIMUM, MAXIMUM };
 
-         DIP_ASSERT( out.DataType() == DataType( TPO{} ));
-         DIP_ASSERT( inTensorLength <= out.TensorElements() );
-         DIP_ASSERT( out.Dimensionality() == 1 );
+// Which of the partial results to accumulate in the single pass over the image
+struct RadialAccumulators {
+   bool sum = false;
+   bool count = false;
+   bool minimum = false;
+   bool maximum = false;
+};
 
-         TPO* pout = static_cast< TPO* >( out.Origin() );
-         dip::sint stride = out.Stride( 0 );
-         dip::sint tStride = out.TensorStride();
-         dip::sint bins = static_cast< dip::sint >( out.Size( 0 ));
-
-         if( mask.IsForged() ) {
-
-            JointImageIterator< TPI, bin > itMaskedLine( { in, mask }, procDim );   // Iterate over image lines
-            do {
-               // Compute squared distance from pixel to origin in all dimensions except the processing dim
-               dfloat sqrDist = GetPartialSquaredDist( itMaskedLine.Coordinates(), procDim );
-
-               ConstLineIterator< TPI > itPixel = itMaskedLine.template GetConstLineIterator< 0 >();
-               ConstLineIterator< bin > itMaskPixel = itMaskedLine.template GetConstLineIterator< 1 >();
-               do {
-                  if( *itMaskPixel ) { // Masked?
-                     // Get bin index
-                     dip::sint binIndex = GetBinIndex( itPixel.Coordinate(), procDim, sqrDist );
-                     // Verify that the bin is within range (for the INNERRADIUS option, not all pixels are processed)
-                     if( binIndex < bins ) {
-                        ProcessPixel( itPixel.begin(), { pout + binIndex * stride, tStride }, inTensorLength );
-                     }
-                  }
-               } while( ++itPixel, ++itMaskPixel );
-            } while( ++itMaskedLine );
-
-         } else {
-
-            ImageIterator< TPI > itLine( in, procDim );   // Iterate over image lines
-            do {
-               // Compute squared distance from pixel to origin in all dimensions except the processing dim
-               dfloat sqrDist = GetPartialSquaredDist( itLine.Coordinates(), procDim );
-
-               // Iterate over the pixels in the image line
-               ConstLineIterator< TPI > itPixel = itLine.GetConstLineIterator();
-               do {
-                  // Get bin index
-                  dip::sint binIndex = GetBinIndex( itPixel.Coordinate(), procDim, sqrDist );
-                  // Verify that the bin is within range (for the INNERRADIUS option, not all pixels are processed)
-                  if( binIndex < bins ) {
-                     ProcessPixel( itPixel.begin(), { pout + binIndex * stride, tStride }, inTensorLength );
-                  }
-               } while( ++itPixel );
-            } while( ++itLine );
+// Partial results for each bin, accumulated by a single thread. Minimum and maximum are not defined for complex
+// values, the `HasExtrema` tag selects the implementation.
+using HasExtrema = std::true_type;
+using NoExtrema = std::false_type;
 
-         }
+template< typename TPI >
+struct RadialPartialBins {
+   using TPS = DoubleType< TPI >;
+   std::vector< TPS > sums;
+   std::vector< dip::uint > counts;
+   std::vector< TPI > minima;
+   std::vector< TPI > maxima;
+   bool initialized = false;
+
+   void Initialize( dip::uint nBins, dip::uint nTensor, RadialAccumulators const& acc, HasExtrema ) {
+      Initialize( nBins, nTensor, acc, NoExtrema{} );
+      if( acc.minimum ) {
+         minima.resize( nBins * nTensor, std::numeric_limits< TPI >::max() );
       }
-
-      // Set number of threads. The output per thread is prepared here
-      virtual void SetNumberOfThreads( dip::uint threads ) override {
-         // Force output image (once) and initialize
-         InitializeOutputImage();
-         // Allocate space for output values. Start at 1, because thread 0 is stored in image_.
-         for( dip::uint ii = 1; ii < threads; ++ii ) {
-            outPerThread_.emplace_back( out_.Copy() );  // makes a deep copy.
-         }
-         // We don't forge the images here, the Filter() function should do that so each thread allocates its own
-         // data segment. This ensures there's no false sharing.
+      if( acc.maximum ) {
+         maxima.resize( nBins * nTensor, std::numeric_limits< TPI >::lowest() );
+      }
+   }
+   void Initialize( dip::uint nBins, dip::uint nTensor, RadialAccumulators const& acc, NoExtrema ) {
+      if( acc.sum ) {
+         sums.resize( nBins * nTensor, TPS( 0 ));
+      }
+      if( acc.count ) {
+         counts.resize( nBins, 0 );
       }
+      initialized = true;
+   }
 
-   protected:
-      Image& out_;   // Output image for thread 0
-      ImageArray outPerThread_;  // Only non-empty when num threads > 1
-      dfloat binSize_;  // Bin size of the radial statistics output
-      FloatArray center_;// Convert to the following to include scaling: TransformationArray transformation_;
-
-      // Process one pixel
-      virtual void ProcessPixel( ConstSampleIterator< TPI > pIn, SampleIterator< TPO > pOut, dip::uint inTensorLength ) = 0;
-
-      // Compute squared distance from pixel to origin in all dimensions except one: the processing dim
-      dfloat GetPartialSquaredDist( UnsignedArray const& lineOriginCoords, dip::uint dimToSkip ) const {
-         dfloat sqrDist = 0;
-         for( dip::uint ii = 0; ii < center_.size(); ++ii ) {
-            if( ii != dimToSkip ) {
-               dfloat dist = static_cast< dfloat >(lineOriginCoords[ ii ]) - center_[ ii ];
-               sqrDist += dist * dist;
-            }
-         }
-         return sqrDist;
+   void UpdateExtrema( dip::uint index, TPI value, HasExtrema ) {
+      if( !minima.empty() && ( value < minima[ index ] )) {
+         minima[ index ] = value;
+      }
+      if( !maxima.empty() && ( value > maxima[ index ] )) {
+         maxima[ index ] = value;
       }
+   }
+   void UpdateExtrema( dip::uint, TPI, NoExtrema ) {}
 
-      dip::sint GetBinIndex( dip::uint procDimCoordinate, dip::uint procDim, dfloat partialSqrDist ) const {
-         dfloat dist = static_cast< dfloat >( procDimCoordinate ) - center_[ procDim ];
-         dfloat radius = std::sqrt( partialSqrDist + dist * dist );
-         return floor_cast( radius / binSize_ );
+   void Add( RadialPartialBins const& other, HasExtrema ) {
+      Add( other, NoExtrema{} );
+      for( dip::uint ii = 0; ii < minima.size(); ++ii ) {
+         minima[ ii ] = std::min( minima[ ii ], other.minima[ ii ] );
+      }
+      for( dip::uint ii = 0; ii < maxima.size(); ++ii ) {
+         maxima[ ii ] = std::max( maxima[ ii ], other.maxima[ ii ] );
       }
+   }
+   void Add( RadialPartialBins const& other, NoExtrema ) {
+      for( dip::uint ii = 0; ii < sums.size(); ++ii ) {
+         sums[ ii ] += other.sums[ ii ];
+      }
+      for( dip::uint ii = 0; ii < counts.size(); ++ii ) {
+         counts[ ii ] += other.counts[ ii ];
+      }
+   }
+};
 
+class RadialProjectionLineFilterBase : public Framework::ScanLineFilter {
+   public:
+      // Combines the partial results of all threads
+      virtual void Reduce() = 0;
+      // Writes `statistic` to `out`, a forged 1D image with one pixel per bin, and the right data type
+      virtual void Write( RadialStatistic statistic, Image& out ) const = 0;
 };
 
-// Radial sum filter
-template< typename TPI, typename TPO = DoubleType< TPI >>
-class ProjectionRadialSum : public ProjectionRadialBase< TPI, TPO > {
+// The line filter takes three input images: the image to project, the bin index image, and (optionally) the mask.
+// All requested statistics are computed in this single pass. Each thread accumulates into its own partial bins.
+template< typename TPI >
+class RadialProjectionLineFilter : public RadialProjectionLineFilterBase {
    public:
-      ProjectionRadialSum( Image& out, dfloat binSize, FloatArray const& center ) :
-            ProjectionRadialBase< TPI, TPO >( out, binSize, center ) {}
+      using TPS = DoubleType< TPI >;
+      using ExtremaTag = std::integral_constant< bool, !std::is_same< TPS, dcomplex >::value >;
 
-      virtual void InitializeOutputImage() override {
-         // Initialize with zeros
-         out_.Fill( 0 );
-      }
+      RadialProjectionLineFilter( dip::uint nBins, dip::uint nTensor, RadialAccumulators const& acc ) :
+            nBins_( nBins ), nTensor_( nTensor ), acc_( acc ) {}
 
-      virtual void Reduce() override {
-         // Take sum of all images
-         for( auto const& out : outPerThread_ ) {
-            out_ += out;
-         }
-      }
-   protected:
-      virtual void ProcessPixel( ConstSampleIterator< TPI > pIn, SampleIterator< TPO > pOut, dip::uint inTensorLength ) override {
-         for( dip::uint iT = 0; iT < inTensorLength; ++iT, ++pIn, ++pOut ) {
-            *pOut += *pIn;
-         }
+      virtual dip::uint GetNumberOfOperations( dip::uint, dip::uint, dip::uint ) override {
+         return 4 + 2 * nTensor_;
       }
 
-      using ProjectionRadialBase< TPI, TPO >::outPerThread_;
-      using ProjectionRadialBase< TPI, TPO >::out_;
-};
-
-// Radial mean filter
-template< typename TPI, typename TPO = DoubleType< TPI >>
-class ProjectionRadialMean : public ProjectionRadialSum< TPI, TPO > {
-   public:
-      ProjectionRadialMean( Image& out, dfloat binSize, FloatArray const& center ) :
-            ProjectionRadialSum< TPI, TPO >( out, binSize, center ) {}
+      virtual void SetNumberOfThreads( dip::uint threads ) override {
+         partial_.resize( threads );
+      }
 
-      virtual void Reduce() override {
-         // Take sum of all images
-         for( auto const& out : outPerThread_ ) {
-            out_ += out;
+      virtual void Filter( Framework::ScanLineFilterParameters const& params ) override {
+         RadialPartialBins< TPI >& bins = partial_[ params.thread ];
+         if( !bins.initialized ) {
+            // Each thread allocates its own partial bins, there's no false sharing.
+            bins.Initialize( nBins_, nTensor_, acc_, ExtremaTag{} );
          }
-         // The last sample in each pixel contains the bin count.
-         // Divide the other tensor elements by the last one to obtain the mean.
-         ImageIterator< TPO > itOut( out_ );
-         int ii = 0;
-         do {
-            TPO count = *( --itOut.cend() );
-            ++ii;
-            if( ii == 20 ) {
-               ii = 0;
+         dip::uint bufferLength = params.bufferLength;
+         TPI const* in = static_cast< TPI const* >( params.inBuffer[ 0 ].buffer );
+         dip::sint inStride = params.inBuffer[ 0 ].stride;
+         dip::sint tensorStride = params.inBuffer[ 0 ].tensorStride;
+         uint32 const* index = static_cast< uint32 const* >( params.inBuffer[ 1 ].buffer );
+         dip::sint indexStride = params.inBuffer[ 1 ].stride;
+         bin const* mask = nullptr;
+         dip::sint maskStride = 0;
+         if( params.inBuffer.size() > 2 ) {
+            mask = static_cast< bin const* >( params.inBuffer[ 2 ].buffer );
+            maskStride = params.inBuffer[ 2 ].stride;
+         }
+         for( dip::uint ii = 0; ii < bufferLength; ++ii, in += inStride, index += indexStride, mask += maskStride ) {
+            // Pixels beyond the maximum radius have a bin index equal to `nBins_`
+            dip::uint binIndex = *index;
+            if(( binIndex >= nBins_ ) || ( mask && !*mask )) {
+               continue;
+            }
+            if( acc_.count ) {
+               ++bins.counts[ binIndex ];
             }
-            if( count != 0.0 ) {
-               // Store the mean
-               for( auto itSample = itOut.begin(); itSample != --itOut.end(); ++itSample ) {
-                  *itSample /= count;
+            dip::uint offset = binIndex * nTensor_;
+            TPI const* pin = in;
+            for( dip::uint jj = 0; jj < nTensor_; ++jj, pin += tensorStride ) {
+               if( acc_.sum ) {
+                  bins.sums[ offset + jj ] += static_cast< TPS >( *pin );
                }
-            } else {
-               // The bin is empty: store zero
-               std::fill( itOut.begin(), --itOut.end(), 0.0 );
+               bins.UpdateExtrema( offset + jj, *pin, ExtremaTag{} );
             }
-         } while( ++itOut );
-      }
-
-   protected:
-      virtual void ProcessPixel( ConstSampleIterator< TPI > pIn, SampleIterator< TPO > pOut, dip::uint inTensorLength ) override {
-         for( dip::uint iT = 0; iT < inTensorLength; ++iT, ++pIn, ++pOut ) {
-            *pOut += *pIn;
          }
-         // The output pixel contains an extra tensor element to store the bin count
-         *pOut += 1.0;   // If the output sample type is complex, the bin count is in the real part
-      }
-
-      using ProjectionRadialSum< TPI, TPO >::outPerThread_;
-      using ProjectionRadialSum< TPI, TPO >::out_;
-};
-
-// Radial min/max filter template
-// `CompareOp` is the compare operation: std::less or std::greater
-template< typename TPI, typename CompareOp >
-class ProjectionRadialMinMax : public ProjectionRadialBase< TPI, TPI > {
-   public:
-      // `limitInitVal` is the initialization value of the variable that tracks the limit value
-      // For finding a minimum value, initialize with std::numeric_limits< TPI >::max(),
-      // for finding a maximum value, initialize with std::numeric_limits< TPI >::lowest().
-      ProjectionRadialMinMax( Image& out, dfloat binSize, FloatArray const& center, TPI limitInitVal ) :
-            ProjectionRadialBase< TPI, TPI >( out, binSize, center ), limitInitVal_( limitInitVal ) {}
-
-      virtual void InitializeOutputImage() override {
-         // Initialize with limitInitVal_
-         out_.Fill( limitInitVal_ );
       }
 
       virtual void Reduce() override {
-         // Take limit of all images
-         //TODO: does it help to use Supremum() and Infimum() here?
-         for( dip::uint iOut = 0; iOut < outPerThread_.size(); ++iOut ) {
-            JointImageIterator< TPI, TPI > itOut( { out_, outPerThread_[ iOut ] } );
-            do {
-               if( compareOp_( itOut.template Sample< 1 >(), itOut.template Sample< 0 >() )) {
-                  itOut.template Sample< 0 >() = itOut.template Sample< 1 >();
+         if( partial_.empty() ) {
+            partial_.resize( 1 );
+         }
+         for( dip::uint ii = 1; ii < partial_.size(); ++ii ) {
+            if( partial_[ ii ].initialized ) {
+               if( partial_[ 0 ].initialized ) {
+                  partial_[ 0 ].Add( partial_[ ii ], ExtremaTag{} );
+               } else {
+                  std::swap( partial_[ 0 ], partial_[ ii ] );
                }
-            } while( ++itOut );
+            }
+         }
+         if( !partial_[ 0 ].initialized ) {
+            partial_[ 0 ].Initialize( nBins_, nTensor_, acc_, ExtremaTag{} ); // There were no pixels to process
          }
       }
 
-   protected:
-      virtual void ProcessPixel( ConstSampleIterator< TPI > pIn, SampleIterator< TPI > pOut, dip::uint tensorLength ) override {
-         for( dip::uint iT = 0; iT < tensorLength; ++iT, ++pIn, ++pOut ) {
-            if( compareOp_( *pIn, *pOut ))
-               *pOut = *pIn;
+      virtual void Write( RadialStatistic statistic, Image& out ) const override {
+         RadialPartialBins< TPI > const& bins = partial_[ 0 ];
+         switch( statistic ) {
+            case RadialStatistic::SUM:
+               CopyBins( bins.sums, out );
+               break;
+            case RadialStatistic::MEAN: {
+               std::vector< TPS > means( bins.sums.size() );
+               for( dip::uint ii = 0; ii < nBins_; ++ii ) {
+                  if( bins.counts[ ii ] > 0 ) {
+                     for( dip::uint jj = 0; jj < nTensor_; ++jj ) {
+                        means[ ii * nTensor_ + jj ] = bins.sums[ ii * nTensor_ + jj ] / static_cast< dfloat >( bins.counts[ ii ] );
+                     }
+                  } // else: the bin is empty, leave zero
+               }
+               CopyBins( means, out );
+               break;
+            }
+            case RadialStatistic::MINIMUM:
+               CopyBins( bins.minima, out );
+               break;
+            case RadialStatistic::MAXIMUM:
+               CopyBins( bins.maxima, out );
+               break;
          }
       }
 
-      TPI limitInitVal_;
-      CompareOp compareOp_;   // Compare functor
-      using ProjectionRadialBase< TPI, TPI >::outPerThread_;
-      using ProjectionRadialBase< TPI, TPI >::out_;
-};
-
-// Radial min filter
-template< typename TPI >
-class ProjectionRadialMin: public ProjectionRadialMinMax< TPI, std::less< TPI >> {
-   public:
-      ProjectionRadialMin( Image& out, dfloat binSize, FloatArray const& center ):
-            ProjectionRadialMinMax< TPI, std::less< TPI >>( out, binSize, center, std::numeric_limits< TPI >::max() ) {}
-};
-
-// Radial max filter
-template< typename TPI >
-class ProjectionRadialMax : public ProjectionRadialMinMax< TPI, std::greater< TPI >> {
-   public:
-      ProjectionRadialMax( Image& out, dfloat binSize, FloatArray const& center ) :
-            ProjectionRadialMinMax< TPI, std::greater< TPI >>( out, binSize, center, std::numeric_limits< TPI >::lowest() ) {}
+   private:
+      dip::uint nBins_;
+      dip::uint nTensor_;
+      RadialAccumulators acc_;
+      std::vector< RadialPartialBins< TPI >> partial_;
+
+      // Copies `values` to `out`, whose sample type is `T`
+      template< typename T >
+      static void CopyBins( std::vector< T > const& values, Image& out ) {
+         DIP_ASSERT( out.DataType() == DataType( T{} ));
+         DIP_ASSERT( values.size() == out.NumberOfPixels() * out.TensorElements() );
+         T* ptr = static_cast< T* >( out.Origin() );
+         dip::sint stride = out.Stride( 0 );
+         dip::sint tensorStride = out.TensorStride();
+         dip::uint nTensor = out.TensorElements();
+         auto it = values.begin();
+         for( dip::uint ii = 0; ii < out.Size( 0 ); ++ii, ptr += stride ) {
+            T* tptr = ptr;
+            for( dip::uint jj = 0; jj < nTensor; ++jj, tptr += tensorStride, ++it ) {
+               *tptr = *it;
+            }
+         }
+      }
 };
 
-enum class RadialProjectionType { sum, mean, min, max, };
+RadialStatistic ParseRadialStatistic( String const& statistic ) {
+   if( statistic == S::SUM ) {
+      return RadialStatistic::SUM;
+   }
+   if( statistic == S::MEAN ) {
+      return RadialStatistic::MEAN;
+   }
+   if( statistic == S::MINIMUM ) {
+      return RadialStatistic::MINIMUM;
+   }
+   if( statistic == S::MAXIMUM ) {
+      return RadialStatistic::MAXIMUM;
+   }
+   DIP_THROW_INVALID_FLAG( statistic );
+}
 
-// RadialSum and RadialMean can be done for DIP__OVL__ALL. Output type: either DFLOAT or DCOMPLEX
-// RadialMin and RadialMax can be done for DIP__OVL__NONCOMPLEX. Output type: same as input type
+} // namespace
 
-void RadialProjectionScan(
-      RadialProjectionType type,
+void RadialBinning::Project(
       Image const& c_in,
       Image const& c_mask,
-      Image& out,
-      dfloat binSize,
-      String const& maxRadius,
-      FloatArray center    // taken by copy so we can modify
-) {
+      ImageRefArray& out,
+      StringArray const& statistics
+) const {
    DIP_THROW_IF( !c_in.IsForged(), E::IMAGE_NOT_FORGED );
-
-   // TODO: handle 'process' array parameter
-   // Process all dimensions until this is passed as parameter and handled properly.
-   BooleanArray process( c_in.Dimensionality(), true );
-   DIP_THROW_IF( process.count() <= 1, "Radial projection is not meaningful in less than 2 dimensions" );
-   DIP_THROW_IF( binSize <= 0, "Bin size must be larger than 0" );
+   DIP_THROW_IF( c_in.Sizes() != binIndex_.Sizes(), E::SIZES_DONT_MATCH );
+   DIP_THROW_IF( out.size() != statistics.size(), E::ARRAY_SIZES_DONT_MATCH );
+
+   // Find out what to accumulate
+   std::vector< RadialStatistic > stats( statistics.size() );
+   RadialAccumulators acc;
+   for( dip::uint ii = 0; ii < statistics.size(); ++ii ) {
+      DIP_STACK_TRACE_THIS( stats[ ii ] = ParseRadialStatistic( statistics[ ii ] ));
+      switch( stats[ ii ] ) {
+         case RadialStatistic::SUM:
+            acc.sum = true;
+            break;
+         case RadialStatistic::MEAN:
+            acc.sum = true;
+            acc.count = true;
+            break;
+         case RadialStatistic::MINIMUM:
+            acc.minimum = true;
+            break;
+         case RadialStatistic::MAXIMUM:
+            acc.maximum = true;
+            break;
+      }
+   }
+   DIP_THROW_IF(( acc.minimum || acc.maximum ) && c_in.DataType().IsComplex(), E::DATA_TYPE_NOT_SUPPORTED );
 
    // Prepare input references and input buffer types
+   ImageConstRefArray inar{ c_in, binIndex_ };
+   DataTypeArray inBufferTypes{ c_in.DataType(), DT_UINT32 };
    Image mask;
    if( c_mask.IsForged() ) {
       // If we have a mask, add it to the input array after possible singleton expansion
@@ -315,99 +381,54 @@ void RadialProjectionScan(
          mask.CheckIsMask( c_in.Sizes(), Option::AllowSingletonExpansion::DO_ALLOW, Option::ThrowException::DO_THROW );
          mask.ExpandSingletonDimensions( c_in.Sizes() );
       DIP_END_STACK_TRACE
+      inar.emplace_back( mask );
+      inBufferTypes.push_back( DT_BIN );
    }
 
-   // Prepare center
-   if( center.empty() ) {
-      // Use default center
-      center = c_in.GetCenter();
-   } else {
-      // Verify center dimensionality
-      DIP_THROW_IF( center.size() != c_in.Dimensionality(), "Center has wrong dimensionality" );
-      // Verify that the center is inside the image
-      DIP_THROW_IF( !c_in.IsInside( center ), "Center is outside image" );
-   }
-
-   // TODO: Create support for using physical pixel sizes to compute the radius. Allows integrating over ellipses.
-   //       Probably involves replacing ProjectionRadialBase::center_ by a TransformationArray member.
-
-   // Determine radius
-   dfloat radius;
-   if( maxRadius == S::INNERRADIUS ) {
-      radius = std::numeric_limits< dfloat >::max();
-      // Find minimum size of dims to be processed
-      // TODO: handle 'process' array
-      for( dip::uint iDim = 0; iDim < c_in.Dimensionality(); ++iDim ) {
-         // Since the filter center might not be in the image's center,
-         // check both [0, center] and [center, size-1]
-         radius = std::min( radius, center[ iDim ] );
-         radius = std::min( radius, static_cast< dfloat >( c_in.Size( iDim ) - 1 ) - center[ iDim ] );
-      }
-      DIP_ASSERT( radius >= 0.0 );
-   } else if ( maxRadius == S::OUTERRADIUS ) {
-      // Find the maximum diagonal
-      radius = 0.0;
-      for( dip::uint iDim = 0; iDim < c_in.Dimensionality(); ++iDim ) {
-         dfloat dimMax = std::max( center[ iDim ], static_cast< dfloat >( c_in.Size( iDim ) - 1 ) - center[ iDim ] );
-         radius += dimMax * dimMax;
-      }
-      radius = std::sqrt( radius );
-   } else {
-      DIP_THROW( "Invalid maxRadius mode" );
-   }
-   dip::uint numBins = static_cast< dip::uint >( radius / binSize ) + 1;
-
-   // Make copy of input image header. This separates it from the output image, so we don't change it
+   // Make copy of input image header. This separates it from the output images, so we don't change it
    // when reforging `out`.
    Image in = c_in;
-
-   // Create output image
-   DataType dt = in.DataType();
-   if(( type == RadialProjectionType::sum ) || ( type == RadialProjectionType::mean )) {
-      // Output type is dfloat or dcomplex.
-      dt = DataType::SuggestDouble( in.DataType() );
-   }
-   dip::uint nTensorElements = in.TensorElements();
-   if( type == RadialProjectionType::mean ) {
-      // Allocate an extra tensor element to store the bin count
-      ++nTensorElements;
-   }
-   out.ReForge( { numBins }, nTensorElements, dt );
-
-   // Create projection scan function object, depending on the radial filter type
-   std::unique_ptr< RadialProjectionScanFunction > lineFilter;
-   if( type == RadialProjectionType::sum ) {
-      DIP_OVL_NEW_ALL( lineFilter, ProjectionRadialSum, ( out, binSize, center ), c_in.DataType() );
-   } else if( type == RadialProjectionType::mean ) {
-      DIP_OVL_NEW_ALL( lineFilter, ProjectionRadialMean, ( out, binSize, center ), c_in.DataType() );
-   } else if( type == RadialProjectionType::min ) {
-      DIP_OVL_NEW_NONCOMPLEX( lineFilter, ProjectionRadialMin, ( out, binSize, center ), c_in.DataType() );
-   } else if( type == RadialProjectionType::max ) {
-      DIP_OVL_NEW_NONCOMPLEX( lineFilter, ProjectionRadialMax, ( out, binSize, center ), c_in.DataType() );
-   } else {
-      DIP_THROW( "Unknown projection type" );
+   dip::uint nTensor = in.TensorElements();
+
+   // Each thread allocates, initializes and merges its own partial bins. Multithreading is only worthwhile if
+   // this overhead is small compared to the work done accumulating.
+   Framework::ScanOptions opts;
+   dip::uint nThreads = GetNumberOfThreads();
+   if( nThreads > 1 ) {
+      dip::uint operations = in.NumberOfPixels() * ( 4 + 2 * nTensor );
+      dip::uint perThreadOperations = nBins_ * nTensor * 4 + 10000;
+      if( operations / nThreads + perThreadOperations + threadingThreshold > operations ) {
+         opts = Framework::ScanOption::NoMultiThreading;
+      }
    }
 
-   // Call projection scan function object
+   // Accumulate
+   std::unique_ptr< RadialProjectionLineFilterBase > lineFilter;
+   DIP_OVL_NEW_ALL( lineFilter, RadialProjectionLineFilter, ( nBins_, nTensor, acc ), in.DataType() );
+   ImageRefArray outar{};
    DIP_START_STACK_TRACE
-      lineFilter->SetNumberOfThreads( 1 );
-      lineFilter->Project( in, mask, 0 );
-      // Call Reduce() to merge the per-thread results
-      lineFilter->Reduce(); // In the case of `RadialProjectionType::mean`, this does more than reduce!
+      Framework::Scan( inar, outar, inBufferTypes, {}, {}, {}, *lineFilter, opts );
+      lineFilter->Reduce();
    DIP_END_STACK_TRACE
 
-   if( type == RadialProjectionType::mean ) {
-      // `out` was created with a column vector tensor (default shape). Strip the last tensor element.
-      out.dip__SetTensorSizes( in.TensorElements() );
+   // Write output images
+   for( dip::uint ii = 0; ii < stats.size(); ++ii ) {
+      DataType dt = in.DataType();
+      if(( stats[ ii ] == RadialStatistic::SUM ) || ( stats[ ii ] == RadialStatistic::MEAN )) {
+         // Output type is dfloat or dcomplex.
+         dt = DataType::SuggestDouble( dt );
+      }
+      Image& img = out[ ii ].get();
+      DIP_START_STACK_TRACE
+         img.ReForge( { nBins_ }, nTensor, dt );
+         lineFilter->Write( stats[ ii ], img );
+         // After processing, reshape the output tensor to the input tensor shape
+         img.ReshapeTensor( in.Tensor() );
+         img.CopyNonDataProperties( in );
+      DIP_END_STACK_TRACE
    }
-
-   // After processing, reshape the output tensor to the input tensor shape
-   out.ReshapeTensor( in.Tensor() );
-   out.CopyNonDataProperties( in );
 }
 
-} // namespace
-
 void RadialSum(
       Image const& in,
       Image const& mask,
@@ -416,7 +437,11 @@ void RadialSum(
       String const& maxRadius,
       FloatArray const& center
 ) {
-   RadialProjectionScan( RadialProjectionType::sum, in, mask, out, binSize, maxRadius, center );
+   DIP_THROW_IF( !in.IsForged(), E::IMAGE_NOT_FORGED );
+   DIP_START_STACK_TRACE
+      RadialBinning binning( in.Sizes(), binSize, maxRadius, center );
+      binning.Sum( in, mask, out );
+   DIP_END_STACK_TRACE
 }
 
 void RadialMean(
@@ -427,7 +452,11 @@ void RadialMean(
       String const& maxRadius,
       FloatArray const& center
 ) {
-   RadialProjectionScan( RadialProjectionType::mean, in, mask, out, binSize, maxRadius, center );
+   DIP_THROW_IF( !in.IsForged(), E::IMAGE_NOT_FORGED );
+   DIP_START_STACK_TRACE
+      RadialBinning binning( in.Sizes(), binSize, maxRadius, center );
+      binning.Mean( in, mask, out );
+   DIP_END_STACK_TRACE
 }
 
 void RadialMinimum(
@@ -438,7 +467,11 @@ void RadialMinimum(
       String const& maxRadius,
       FloatArray const& center
 ) {
-   RadialProjectionScan( RadialProjectionType::min, in, mask, out, binSize, maxRadius, center );
+   DIP_THROW_IF( !in.IsForged(), E::IMAGE_NOT_FORGED );
+   DIP_START_STACK_TRACE
+      RadialBinning binning( in.Sizes(), binSize, maxRadius, center );
+      binning.Minimum( in, mask, out );
+   DIP_END_STACK_TRACE
 }
 
 void RadialMaximum(
@@ -449,7 +482,70 @@ void RadialMaximum(
       String const& maxRadius,
       FloatArray const& center
 ) {
-   RadialProjectionScan( RadialProjectionType::max, in, mask, out, binSize, maxRadius, center );
+   DIP_THROW_IF( !in.IsForged(), E::IMAGE_NOT_FORGED );
+   DIP_START_STACK_TRACE
+      RadialBinning binning( in.Sizes(), binSize, maxRadius, center );
+      binning.Maximum( in, mask, out );
+   DIP_END_STACK_TRACE
 }
 
 } // namespace dip
+
+#ifdef DIP__ENABLE_DOCTEST
+#include "doctest.h"
+#include "diplib/generation.h"
+#include "diplib/math.h"
+
+DOCTEST_TEST_CASE("[DIPlib] testing the radial projections") {
+   dip::Image in( { 31, 20 }, 2, dip::DT_SFLOAT );
+   in.Fill( 0 );
+   dip::Random random( 0 );
+   dip::UniformNoise( in, in, random );
+   dip::RadialBinning binning( in.Sizes(), 1.5, dip::S::INNERRADIUS );
+   DOCTEST_REQUIRE( binning.NumberOfBins() == 7 ); // inner radius is 9, 9/1.5 + 1 = 7
+
+   // Compute all statistics in one pass, and compare to a direct computation
+   dip::Image sum, mean, minimum, maximum;
+   dip::ImageRefArray outar{ sum, mean, minimum, maximum };
+   binning.Project( in, {}, outar, { "sum", "mean", "minimum", "maximum" } );
+   DOCTEST_REQUIRE( sum.Size( 0 ) == 7 );
+   DOCTEST_CHECK( sum.DataType() == dip::DT_DFLOAT );
+   DOCTEST_CHECK( minimum.DataType() == dip::DT_SFLOAT );
+   DOCTEST_CHECK( sum.TensorElements() == 2 );
+   for( dip::uint bin = 0; bin < 7; ++bin ) {
+      dip::dfloat s0 = 0, s1 = 0, min1 = 1e6, max0 = -1e6;
+      dip::uint n = 0;
+      for( dip::uint y = 0; y < 20; ++y ) {
+         for( dip::uint x = 0; x < 31; ++x ) {
+            dip::dfloat r = std::hypot( static_cast< dip::dfloat >( x ) - 15, static_cast< dip::dfloat >( y ) - 10 );
+            if( static_cast< dip::uint >( r / 1.5 ) == bin ) {
+               dip::Image::Pixel p = in.At( x, y );
+               s0 += p[ 0 ].As< dip::dfloat >();
+               s1 += p[ 1 ].As< dip::dfloat >();
+               min1 = std::min( min1, p[ 1 ].As< dip::dfloat >() );
+               max0 = std::max( max0, p[ 0 ].As< dip::dfloat >() );
+               ++n;
+            }
+         }
+      }
+      DOCTEST_CHECK( sum.At( bin )[ 0 ].As< dip::dfloat >() == doctest::Approx( s0 ));
+      DOCTEST_CHECK( sum.At( bin )[ 1 ].As< dip::dfloat >() == doctest::Approx( s1 ));
+      DOCTEST_CHECK( mean.At( bin )[ 1 ].As< dip::dfloat >() == doctest::Approx( s1 / static_cast< dip::dfloat >( n )));
+      DOCTEST_CHECK( minimum.At( bin )[ 1 ].As< dip::dfloat >() == min1 );
+      DOCTEST_CHECK( maximum.At( bin )[ 0 ].As< dip::dfloat >() == max0 );
+   }
+
+   // The individual functions yield the same result
+   dip::Image sum2 = dip::RadialSum( in, {}, 1.5, dip::S::INNERRADIUS );
+   dip::Image maximum2 = dip::RadialMaximum( in, {}, 1.5, dip::S::INNERRADIUS );
+   DOCTEST_CHECK( dip::Count( dip::AnyTensorElement( sum2 != sum )) == 0 );
+   DOCTEST_CHECK( dip::Count( dip::AnyTensorElement( maximum2 != maximum )) == 0 );
+
+   // With a mask
+   dip::Image mask = in[ 0 ] > 0.5;
+   dip::Image meanMasked = binning.Mean( in, mask );
+   dip::Image mask0 = meanMasked[ 0 ] > 0.5;
+   DOCTEST_CHECK( dip::Count( mask0 ) == 7 );
+}
+
+#endif // DIP__ENABLE_DOCTEST
@@ -21,6 +21,7 @@
 #include "diplib/framework.h"
 #include "diplib/overload.h"
 #include "diplib/iterators.h"
+#include "../support/symmetric_eigensolver.h"
 
 namespace dip {
 
@@ -152,6 +153,119 @@ std::unique_ptr< Framework::ScanLineFilter > NewTensorTriadicScanLineFilter( F c
    return static_cast< std::unique_ptr< Framework::ScanLineFilter >>( new TensorTriadicScanLineFilter< TPI, TPO, F >( func, cost ));
 }
 
+// What `SmallSymmetricEigenLineFilter` writes to its output image(s)
+enum class SymmetricEigenOutput {
+      EIGENVALUES,
+      DECOMPOSITION,    // eigenvalues and eigenvectors
+      LARGEST_VECTOR,
+      SMALLEST_VECTOR
+};
+
+// Eigen-decomposition of 2x2 or 3x3 symmetric matrices. Reads the unique tensor elements directly from the input
+// buffer (don't use `ExpandTensorInBuffer`), and computes in `TPF` (`sfloat` or `dfloat`) without allocating memory.
+template< typename TPF, dip::uint N >
+class SmallSymmetricEigenLineFilter : public Framework::ScanLineFilter {
+   public:
+      SmallSymmetricEigenLineFilter( SymmetricEigenOutput output ) : output_( output ) {}
+      virtual dip::uint GetNumberOfOperations( dip::uint, dip::uint, dip::uint ) override {
+         dip::uint cost = N == 2 ? 30 : 150;
+         return output_ == SymmetricEigenOutput::EIGENVALUES ? cost : 2 * cost;
+      }
+      virtual void Filter( Framework::ScanLineFilterParameters const& params ) override {
+         dip::uint const bufferLength = params.bufferLength;
+         TPF const* in = static_cast< TPF const* >( params.inBuffer[ 0 ].buffer );
+         dip::sint const inStride = params.inBuffer[ 0 ].stride;
+         dip::sint const inTensorStride = params.inBuffer[ 0 ].tensorStride;
+         DIP_ASSERT( params.inBuffer[ 0 ].tensorLength == N * ( N + 1 ) / 2 );
+         TPF* out = static_cast< TPF* >( params.outBuffer[ 0 ].buffer );
+         dip::sint const outStride = params.outBuffer[ 0 ].stride;
+         dip::sint const outTensorStride = params.outBuffer[ 0 ].tensorStride;
+         TPF* vectorsOut = nullptr;
+         dip::sint vectorsStride = 0;
+         dip::sint vectorsTensorStride = 0;
+         if( output_ == SymmetricEigenOutput::DECOMPOSITION ) {
+            vectorsOut = static_cast< TPF* >( params.outBuffer[ 1 ].buffer );
+            vectorsStride = params.outBuffer[ 1 ].stride;
+            vectorsTensorStride = params.outBuffer[ 1 ].tensorStride;
+         }
+         bool const needVectors = output_ != SymmetricEigenOutput::EIGENVALUES;
+         TPF lambdas[ N ];
+         TPF vectors[ N * N ];
+         for( dip::uint ii = 0; ii < bufferLength; ++ii, in += inStride, out += outStride ) {
+            Decompose( in, inTensorStride, lambdas, needVectors ? vectors : nullptr );
+            switch( output_ ) {
+               case SymmetricEigenOutput::EIGENVALUES:
+                  Write( lambdas, N, out, outTensorStride );
+                  break;
+               case SymmetricEigenOutput::DECOMPOSITION:
+                  Write( lambdas, N, out, outTensorStride );
+                  Write( vectors, N * N, vectorsOut, vectorsTensorStride );
+                  vectorsOut += vectorsStride;
+                  break;
+               case SymmetricEigenOutput::LARGEST_VECTOR:
+                  Write( vectors, N, out, outTensorStride );
+                  break;
+               case SymmetricEigenOutput::SMALLEST_VECTOR:
+                  Write( vectors + ( N - 1 ) * N, N, out, outTensorStride );
+                  break;
+            }
+         }
+      }
+   private:
+      SymmetricEigenOutput output_;
+
+      // Tensor elements are stored as xx, yy, xy (2D) or xx, yy, zz, xy, xz, yz (3D)
+      static void Decompose( TPF const* in, dip::sint ts, TPF* lambdas, TPF* vectors ) {
+         if( N == 2 ) {
+            symmetric_eigensolver::Decompose2( in[ 0 ], in[ ts ], in[ 2 * ts ], lambdas, vectors );
+         } else {
+            symmetric_eigensolver::Decompose3( in[ 0 ], in[ ts ], in[ 2 * ts ], in[ 3 * ts ], in[ 4 * ts ], in[ 5 * ts ], lambdas, vectors );
+         }
+      }
+
+      static void Write( TPF const* values, dip::uint n, TPF* out, dip::sint tensorStride ) {
+         for( dip::uint jj = 0; jj < n; ++jj, out += tensorStride ) {
+            *out = values[ jj ];
+         }
+      }
+};
+
+// Computes the requested eigen-decomposition output(s) with `SmallSymmetricEigenLineFilter` if `in` is a real-valued
+// symmetric 2x2 or 3x3 tensor image. Returns false, without doing anything, for other images.
+bool SmallSymmetricEigen( Image const& in, ImageRefArray& outar, SymmetricEigenOutput output ) {
+   if(( in.TensorShape() != Tensor::Shape::SYMMETRIC_MATRIX ) || ( in.DataType().IsComplex() )) {
+      return false;
+   }
+   dip::uint n = in.TensorRows();
+   if(( n != 2 ) && ( n != 3 )) {
+      return false;
+   }
+   DataType outtype = DataType::SuggestFlex( in.DataType() );
+   // Single-precision images are processed in single precision
+   DataType buffertype = outtype == DT_SFLOAT ? DT_SFLOAT : DT_DFLOAT;
+   std::unique_ptr< Framework::ScanLineFilter > scanLineFilter;
+   if( buffertype == DT_SFLOAT ) {
+      if( n == 2 ) {
+         scanLineFilter.reset( new SmallSymmetricEigenLineFilter< sfloat, 2 >( output ));
+      } else {
+         scanLineFilter.reset( new SmallSymmetricEigenLineFilter< sfloat, 3 >( output ));
+      }
+   } else {
+      if( n == 2 ) {
+         scanLineFilter.reset( new SmallSymmetricEigenLineFilter< dfloat, 2 >( output ));
+      } else {
+         scanLineFilter.reset( new SmallSymmetricEigenLineFilter< dfloat, 3 >( output ));
+      }
+   }
+   if( output == SymmetricEigenOutput::DECOMPOSITION ) {
+      DIP_STACK_TRACE_THIS( Framework::Scan( { in }, outar, { buffertype }, { buffertype, buffertype }, { outtype, outtype },
+                                             { n, n * n }, *scanLineFilter ));
+   } else {
+      DIP_STACK_TRACE_THIS( Framework::Scan( { in }, outar, { buffertype }, { buffertype }, { outtype }, { n }, *scanLineFilter ));
+   }
+   return true;
+}
+
 void SortTensorElements( Image& out ) {
    if( !out.IsScalar() ) {
       DataType outtype = out.DataType();
@@ -491,6 +605,12 @@ void Eigenvalues( Image const& in, Image& out ) {
          DIP_STACK_TRACE_THIS( SortTensorElements( out ));
       }
    } else {
+      ImageRefArray outar{ out };
+      bool done;
+      DIP_STACK_TRACE_THIS( done = SmallSymmetricEigen( in, outar, SymmetricEigenOutput::EIGENVALUES ));
+      if( done ) {
+         return;
+      }
       dip::uint n = in.TensorRows();
       DataType intype = in.DataType();
       DataType inbuffertype;
@@ -518,7 +638,6 @@ void Eigenvalues( Image const& in, Image& out ) {
          }
          outtype = DataType::SuggestComplex( intype );
       }
-      ImageRefArray outar{ out };
       DIP_STACK_TRACE_THIS( Framework::Scan( { in }, outar, { inbuffertype }, { outbuffertype }, { outtype }, { n }, *scanLineFilter,
                                              Framework::ScanOption::ExpandTensorInBuffer ));
    }
@@ -536,6 +655,14 @@ void EigenDecomposition( Image const& in, Image& out, Image& eigenvectors ) {
       //Identity( in, eigenvectors );
       // TODO: the `eigenvectors` have to be sorted in the same way as `out`.
    } else {
+      ImageRefArray outar{ out, eigenvectors };
+      bool done;
+      DIP_STACK_TRACE_THIS( done = SmallSymmetricEigen( in, outar, SymmetricEigenOutput::DECOMPOSITION ));
+      if( done ) {
+         eigenvectors.ReshapeTensor( in.TensorRows(), in.TensorRows() );
+         out.ReshapeTensorAsDiagonal();
+         return;
+      }
       dip::uint n = in.TensorRows();
       DataType intype = in.DataType();
       DataType inbuffertype;
@@ -563,7 +690,6 @@ void EigenDecomposition( Image const& in, Image& out, Image& eigenvectors ) {
          }
          outtype = DataType::SuggestComplex( intype );
       }
-      ImageRefArray outar{ out, eigenvectors };
       DIP_STACK_TRACE_THIS( Framework::Scan( { in }, outar, { inbuffertype }, { outbuffertype, outbuffertype }, { outtype, outtype },
                                              { n, n * n }, *scanLineFilter, Framework::ScanOption::ExpandTensorInBuffer ));
       eigenvectors.ReshapeTensor( n, n );
@@ -575,13 +701,18 @@ void LargestEigenVector( Image const& in, Image& out ) {
    DIP_THROW_IF( !in.IsForged(), E::IMAGE_NOT_FORGED );
    DIP_THROW_IF( in.TensorShape() != Tensor::Shape::SYMMETRIC_MATRIX, "The image is not a symmetric matrix" );
    DIP_THROW_IF( !in.DataType().IsReal(), E::DATA_TYPE_NOT_SUPPORTED );
+   ImageRefArray outar{ out };
+   bool done;
+   DIP_STACK_TRACE_THIS( done = SmallSymmetricEigen( in, outar, SymmetricEigenOutput::LARGEST_VECTOR ));
+   if( done ) {
+      return;
+   }
    dip::uint n = in.TensorRows();
    DataType dataType = DataType::SuggestFlex( in.DataType() );
    std::unique_ptr< Framework::ScanLineFilter > scanLineFilter;
    scanLineFilter = NewTensorMonadicScanLineFilter< dfloat, dfloat >(
          [ n ]( auto const& pin, auto const& pout ) { LargestEigenVector( n, pin, pout ); }, 600 * n // cost of decomposition???
    );
-   ImageRefArray outar{ out };
    DIP_STACK_TRACE_THIS( Framework::Scan( { in }, outar, { DT_DFLOAT }, { DT_DFLOAT }, { dataType },
                                           { n }, *scanLineFilter, Framework::ScanOption::ExpandTensorInBuffer ));
 }
@@ -590,13 +721,18 @@ void SmallestEigenVector( Image const& in, Image& out ) {
    DIP_THROW_IF( !in.IsForged(), E::IMAGE_NOT_FORGED );
    DIP_THROW_IF( in.TensorShape() != Tensor::Shape::SYMMETRIC_MATRIX, "The image is not a symmetric matrix" );
    DIP_THROW_IF( !in.DataType().IsReal(), E::DATA_TYPE_NOT_SUPPORTED );
+   ImageRefArray outar{ out };
+   bool done;
+   DIP_STACK_TRACE_THIS( done = SmallSymmetricEigen( in, outar, SymmetricEigenOutput::SMALLEST_VECTOR ));
+   if( done ) {
+      return;
+   }
    dip::uint n = in.TensorRows();
    DataType dataType = DataType::SuggestFlex( in.DataType() );
    std::unique_ptr< Framework::ScanLineFilter > scanLineFilter;
    scanLineFilter = NewTensorMonadicScanLineFilter< dfloat, dfloat >(
          [ n ]( auto const& pin, auto const& pout ) { SmallestEigenVector( n, pin, pout ); }, 600 * n // cost of decomposition???
    );
-   ImageRefArray outar{ out };
    DIP_STACK_TRACE_THIS( Framework::Scan( { in }, outar, { DT_DFLOAT }, { DT_DFLOAT }, { dataType },
                                           { n }, *scanLineFilter, Framework::ScanOption::ExpandTensorInBuffer ));
 }
@@ -879,3 +1015,52 @@ void MeanTensorElement( Image const& in, Image& out ) {
 }
 
 } // namespace dip
+
+
+#ifdef DIP__ENABLE_DOCTEST
+#include "doctest.h"
+#include "diplib/statistics.h"
+
+DOCTEST_TEST_CASE("[DIPlib] testing the eigen-decomposition of small symmetric tensor images") {
+   for( dip::uint n = 2; n <= 3; ++n ) {
+      for( dip::DataType dt : { dip::DT_SINT16, dip::DT_SFLOAT } ) {
+         // Integer-valued matrices, packed as xx, yy, xy or xx, yy, zz, xy, xz, yz
+         dip::uint nElements = n * ( n + 1 ) / 2;
+         dip::Image in( { 50 }, nElements, dt );
+         in.ReshapeTensor( dip::Tensor( dip::Tensor::Shape::SYMMETRIC_MATRIX, n, n ));
+         for( dip::uint ii = 0; ii < 50; ++ii ) {
+            for( dip::uint jj = 0; jj < nElements; ++jj ) {
+               in.At( ii )[ jj ] = static_cast< dip::sint >(( ii * 7 + jj * 13 + ii * jj * 5 ) % 41 ) - 20;
+            }
+         }
+         dip::Image lambdas, vectors;
+         dip::EigenDecomposition( in, lambdas, vectors );
+         DOCTEST_CHECK( lambdas.DataType() == dip::DT_SFLOAT );
+         DOCTEST_CHECK( vectors.DataType() == dip::DT_SFLOAT );
+         DOCTEST_CHECK( lambdas.TensorShape() == dip::Tensor::Shape::DIAGONAL_MATRIX );
+         DOCTEST_CHECK( vectors.TensorRows() == n );
+         DOCTEST_CHECK( vectors.TensorColumns() == n );
+         dip::Image reference = dip::Eigenvalues( dip::Convert( in, dip::DT_DFLOAT ));
+         DOCTEST_CHECK( dip::MaximumAbsoluteError( dip::Eigenvalues( in ), reference ) < 1e-4 );
+         lambdas.ReshapeTensorAsVector();
+         DOCTEST_CHECK( dip::MaximumAbsoluteError( lambdas, reference ) < 1e-4 );
+         // A v == lambda v
+         for( dip::uint ii = 0; ii < 50; ++ii ) {
+            dip::Image::Pixel matrix = in.At( ii );
+            dip::Image::Pixel v = vectors.At( ii );
+            for( dip::uint kk = 0; kk < n; ++kk ) {
+               dip::dfloat lambda = lambdas.At( ii )[ kk ].As< dip::dfloat >();
+               for( dip::uint jj = 0; jj < n; ++jj ) {
+                  dip::dfloat Av = 0;
+                  for( dip::uint ll = 0; ll < n; ++ll ) {
+                     Av += matrix[ { jj, ll } ].As< dip::dfloat >() * v[ { ll, kk } ].As< dip::dfloat >();
+                  }
+                  DOCTEST_CHECK( Av == doctest::Approx( lambda * v[ { jj, kk } ].As< dip::dfloat >() ).epsilon( 1e-4 ).scale( 40 ));
+               }
+            }
+         }
+      }
+   }
+}
+
+#endif // DIP__ENABLE_DOCTEST
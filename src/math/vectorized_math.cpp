@@ -0,0 +1,621 @@
+/*
+ * DIPlib 3.0
+ * This file contains the vectorized kernels used by the monadic math operators.
+ *
+ * (c)2026, Cris Luengo.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// NOTE: This file is compiled with `-fno-math-errno -fno-trapping-math` (see `src/CMakeLists.txt`), without these
+// GCC does not vectorize `std::sqrt` nor the selects in the functions below.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include "diplib.h"
+#include "vectorized_math.h"
+#include "../library/multiversion.h"
+
+#if defined( __GNUC__ ) || defined( __clang__ )
+#define DIP__KERNEL_INLINE inline __attribute__(( always_inline ))
+#else
+#define DIP__KERNEL_INLINE inline
+#endif
+
+namespace dip {
+namespace detail {
+
+namespace {
+
+//
+// Bit manipulation of floating-point values
+//
+
+template< typename T >
+struct FloatBits;
+
+template<>
+struct FloatBits< sfloat > {
+   using Int = std::int32_t;
+   using UInt = std::uint32_t;
+   static constexpr int mantissaBits = 23;
+   static constexpr Int bias = 127;
+   static constexpr UInt mantissaMask = 0x007FFFFFu;
+   static constexpr UInt sqrtHalf = 0x3F3504F3u;                  // sqrt(0.5)
+   static constexpr sfloat roundingConstant = 12582912.0f;         // 1.5 * 2^23
+   static constexpr sfloat twoToMantissaBits = 8388608.0f;         // 2^23
+};
+
+template<>
+struct FloatBits< dfloat > {
+   using Int = std::int64_t;
+   using UInt = std::uint64_t;
+   static constexpr int mantissaBits = 52;
+   static constexpr Int bias = 1023;
+   static constexpr UInt mantissaMask = 0x000FFFFFFFFFFFFFull;
+   static constexpr UInt sqrtHalf = 0x3FE6A09E667F3BCDull;         // sqrt(0.5)
+   static constexpr dfloat roundingConstant = 6755399441055744.0;  // 1.5 * 2^52
+   static constexpr dfloat twoToMantissaBits = 4503599627370496.0; // 2^52
+};
+
+template< typename T >
+DIP__KERNEL_INLINE typename FloatBits< T >::UInt ToBits( T value ) {
+   typename FloatBits< T >::UInt bits;
+   std::memcpy( &bits, &value, sizeof( T ));
+   return bits;
+}
+
+template< typename T >
+DIP__KERNEL_INLINE T FromBits( typename FloatBits< T >::UInt bits ) {
+   T value;
+   std::memcpy( &value, &bits, sizeof( T ));
+   return value;
+}
+
+// Rounds to the nearest integer, for |value| < 2^(mantissaBits-1). Unlike `std::round`, this vectorizes on
+// every instruction set.
+template< typename T >
+DIP__KERNEL_INLINE T RoundToInteger( T value ) {
+   return ( value + FloatBits< T >::roundingConstant ) - FloatBits< T >::roundingConstant;
+}
+
+// The integer value of `value`, which must be a floating-point representation of an integer with
+// |value| < 2^(mantissaBits-1). Integer to floating-point conversion does not vectorize for 64-bit integers.
+template< typename T >
+DIP__KERNEL_INLINE typename FloatBits< T >::Int ToInteger( T value ) {
+   return static_cast< typename FloatBits< T >::Int >(
+         ToBits( value + FloatBits< T >::roundingConstant ) - ToBits( FloatBits< T >::roundingConstant ));
+}
+
+// 2^n, for n in the range of normal numbers
+template< typename T >
+DIP__KERNEL_INLINE T PowerOfTwo( typename FloatBits< T >::Int n ) {
+   return FromBits< T >( static_cast< typename FloatBits< T >::UInt >( n + FloatBits< T >::bias ) << FloatBits< T >::mantissaBits );
+}
+
+// p * 2^n, where `n` is an integer value stored as a floating-point number. The power of two is applied in two
+// halves, such that each of them is a normal number even if the result is subnormal, or overflows.
+template< typename T >
+DIP__KERNEL_INLINE T ScaleByPowerOfTwo( T p, T n ) {
+   auto n1 = ToInteger( RoundToInteger( n * T( 0.5 )));
+   auto n2 = ToInteger( n ) - n1;
+   return p * PowerOfTwo< T >( n1 ) * PowerOfTwo< T >( n2 );
+}
+
+// c[ 0 ] + c[ 1 ] * x + c[ 2 ] * x^2 + ...
+template< typename T, std::size_t N >
+DIP__KERNEL_INLINE T Polynomial( T x, T const ( &c )[ N ] ) {
+   T result = c[ N - 1 ];
+   for( std::size_t ii = N - 1; ii > 0; --ii ) {
+      result = result * x + c[ ii - 1 ];
+   }
+   return result;
+}
+
+// Sum of c[ ii ] * T_ii( x ), with T_ii the Chebyshev polynomials of the first kind (Clenshaw's algorithm)
+template< typename T, std::size_t N >
+DIP__KERNEL_INLINE T ChebyshevSeries( T x, T const ( &c )[ N ] ) {
+   T b1 = 0;
+   T b2 = 0;
+   for( std::size_t ii = N - 1; ii > 0; --ii ) {
+      T tmp = T( 2 ) * x * b1 - b2 + c[ ii ];
+      b2 = b1;
+      b1 = tmp;
+   }
+   return x * b1 - b2 + c[ 0 ];
+}
+
+//
+// Exponential functions
+//
+
+// e^z for |z| <= ln(2)/2: Taylor series truncated where the next term is below the rounding error
+DIP__KERNEL_INLINE sfloat ExpPolynomial( sfloat z ) {
+   static constexpr sfloat c[] = {
+         1.0f, 1.0f, 0.5f, 0.16666666666666666f, 0.041666666666666664f, 0.008333333333333333f,
+         0.001388888888888889f, 0.0001984126984126984f
+   };
+   return Polynomial( z, c );
+}
+DIP__KERNEL_INLINE dfloat ExpPolynomial( dfloat z ) {
+   static constexpr dfloat c[] = {
+         1.0, 1.0, 0.5, 0.16666666666666666, 0.041666666666666664, 0.008333333333333333,
+         0.001388888888888889, 0.0001984126984126984, 2.48015873015873e-05, 2.7557319223985893e-06,
+         2.755731922398589e-07, 2.505210838544172e-08, 2.08767569878681e-09, 1.6059043836821613e-10
+   };
+   return Polynomial( z, c );
+}
+
+// b^x = 2^n * e^(r * ln(b)), with n = round(x * log2(b)) and r = x - n * logb(2). `logb2High` has enough trailing
+// zero bits in its mantissa for `n * logb2High` to be exact. `x` is clamped to [lowest, highest], a range just
+// wider than the one that produces a finite, non-zero result.
+template< typename T >
+DIP__KERNEL_INLINE T ExpBase( T x, T log2b, T logb2High, T logb2Low, T lnb, T lowest, T highest ) {
+   x = x < lowest ? lowest : x;
+   x = x > highest ? highest : x;
+   T n = RoundToInteger( x * log2b );
+   T r = ( x - n * logb2High ) - n * logb2Low;
+   return ScaleByPowerOfTwo( ExpPolynomial( r * lnb ), n );
+}
+
+DIP__KERNEL_INLINE sfloat Exp( sfloat x ) {
+   return ExpBase( x, 1.4426950408889634f, 0.693145751953125f, 1.4286068203094173e-06f, 1.0f, -104.0f, 89.0f );
+}
+DIP__KERNEL_INLINE dfloat Exp( dfloat x ) {
+   return ExpBase( x, 1.4426950408889634, 0.6931471806019545, -4.2009150726810846e-11, 1.0, -746.0, 710.0 );
+}
+
+DIP__KERNEL_INLINE sfloat Exp2( sfloat x ) {
+   return ExpBase( x, 1.0f, 1.0f, 0.0f, 0.6931471805599453f, -151.0f, 129.0f );
+}
+DIP__KERNEL_INLINE dfloat Exp2( dfloat x ) {
+   return ExpBase( x, 1.0, 1.0, 0.0, 0.6931471805599453, -1076.0, 1025.0 );
+}
+
+DIP__KERNEL_INLINE sfloat Exp10( sfloat x ) {
+   return ExpBase( x, 3.321928094887362f, 0.30103302001953125f, -3.0243555500547862e-06f, 2.302585092994046f, -46.0f, 39.0f );
+}
+DIP__KERNEL_INLINE dfloat Exp10( dfloat x ) {
+   return ExpBase( x, 3.321928094887362, 0.3010299956658855, -1.9043128467164274e-12, 2.302585092994046, -324.0, 309.0 );
+}
+
+//
+// Logarithms
+//
+
+// (log((1+s)/(1-s)) - 2s) / s = R(s^2) for |s| < 0.1716: Taylor series
+DIP__KERNEL_INLINE sfloat LogPolynomial( sfloat z ) {
+   static constexpr sfloat c[] = {
+         0.6666666666666666f, 0.4f, 0.2857142857142857f, 0.2222222222222222f, 0.18181818181818182f
+   };
+   return z * Polynomial( z, c );
+}
+DIP__KERNEL_INLINE dfloat LogPolynomial( dfloat z ) {
+   static constexpr dfloat c[] = {
+         0.6666666666666666, 0.4, 0.2857142857142857, 0.2222222222222222, 0.18181818181818182,
+         0.15384615384615385, 0.13333333333333333, 0.11764705882352941, 0.10526315789473684, 0.09523809523809523
+   };
+   return z * Polynomial( z, c );
+}
+
+// Writes x = 2^k * (1+f), with 1+f in [sqrt(1/2),sqrt(2)), and returns log(1+f) = f - hfsq + s * (hfsq + R(s^2))
+// as `f` and `tail = hfsq - s * (hfsq + R(s^2))`, so that log(1+f) = f - tail. This is the method of FDLIBM's log.
+// The result is meaningless for non-positive or non-finite `x`.
+template< typename T >
+DIP__KERNEL_INLINE void LogReduce( T x, T& k, T& f, T& tail ) {
+   using UInt = typename FloatBits< T >::UInt;
+   constexpr int mantissaBits = FloatBits< T >::mantissaBits;
+   // Scale subnormal values into the range of normal numbers
+   bool subnormal = x < std::numeric_limits< T >::min();
+   x = subnormal ? x * FloatBits< T >::twoToMantissaBits : x;
+   T offset = subnormal ? T( -mantissaBits ) : T( 0 );
+   // Adding this constant makes the exponent one larger if the mantissa is at least sqrt(1/2)
+   UInt bits = ToBits( x ) + ( ToBits( T( 1 )) - FloatBits< T >::sqrtHalf );
+   // The exponent is converted to floating-point by putting it in the mantissa of 2^mantissaBits
+   k = FromBits< T >(( bits >> mantissaBits ) | ToBits( FloatBits< T >::twoToMantissaBits ))
+       - ( FloatBits< T >::twoToMantissaBits + T( FloatBits< T >::bias )) + offset;
+   f = FromBits< T >(( bits & FloatBits< T >::mantissaMask ) + FloatBits< T >::sqrtHalf ) - T( 1 );
+   T s = f / ( T( 2 ) + f );
+   T hfsq = T( 0.5 ) * f * f;
+   tail = hfsq - s * ( hfsq + LogPolynomial( s * s ));
+}
+
+// Results for special values: NaN for negative `x` and NaN, -infinity for 0, and infinity for infinity
+template< typename T >
+DIP__KERNEL_INLINE T LogSpecialValues( T x, T result ) {
+   result = x == std::numeric_limits< T >::infinity() ? x : result;
+   result = x == T( 0 ) ? -std::numeric_limits< T >::infinity() : result;
+   result = ( x < T( 0 )) || ( x != x ) ? std::numeric_limits< T >::quiet_NaN() : result;
+   return result;
+}
+
+// log(x) = k * ln(2) + f - tail, with ln(2) split into a high part such that `k * ln2High` is exact,
+// and a low part that is added to the smaller terms first.
+template< typename T >
+DIP__KERNEL_INLINE T LogBase( T x, T logb2High, T logb2Low, T logbe ) {
+   T k, f, tail;
+   LogReduce( x, k, f, tail );
+   T result = logbe == T( 1 )
+              ? k * logb2High - (( tail - k * logb2Low ) - f )
+              : k * logb2High + (( f - tail ) * logbe + k * logb2Low );
+   return LogSpecialValues( x, result );
+}
+
+DIP__KERNEL_INLINE sfloat Ln( sfloat x ) {
+   return LogBase( x, 0.693145751953125f, 1.4286068203094173e-06f, 1.0f );
+}
+DIP__KERNEL_INLINE dfloat Ln( dfloat x ) {
+   return LogBase( x, 0.6931471806019545, -4.2009150726810846e-11, 1.0 );
+}
+
+DIP__KERNEL_INLINE sfloat Log2( sfloat x ) {
+   return LogBase( x, 1.0f, 0.0f, 1.4426950408889634f );
+}
+DIP__KERNEL_INLINE dfloat Log2( dfloat x ) {
+   return LogBase( x, 1.0, 0.0, 1.4426950408889634 );
+}
+
+DIP__KERNEL_INLINE sfloat Log10( sfloat x ) {
+   return LogBase( x, 0.30103302001953125f, -3.0243555500547862e-06f, 0.4342944819032518f );
+}
+DIP__KERNEL_INLINE dfloat Log10( dfloat x ) {
+   return LogBase( x, 0.3010299956658855, -1.9043128467164274e-12, 0.4342944819032518 );
+}
+
+//
+// Trigonometric functions
+//
+
+// pi/2 split in three parts, the first two have 30 significant bits
+constexpr dfloat piOver2High = 1.5707963276654482;
+constexpr dfloat piOver2Middle = -8.705515692000731e-10;
+constexpr dfloat piOver2Low = -3.50343439808993e-19;
+
+// Arguments larger than this (in magnitude) are passed to the standard library. Below it, `n * piOver2High`
+// and `n * piOver2Middle` are exact.
+constexpr dfloat trigonometricLimit = 1.0e6;
+
+// sin(r) and cos(r) for |r| <= pi/4: Taylor series. The `sfloat` kernels compute these in double precision,
+// but need fewer terms.
+template< bool forSfloat >
+DIP__KERNEL_INLINE dfloat SinPolynomial( dfloat r ) {
+   static constexpr dfloat c[] = {
+         -0.16666666666666666, 0.008333333333333333, -0.0001984126984126984, 2.7557319223985893e-06,
+         -2.505210838544172e-08, 1.6059043836821613e-10, -7.647163731819816e-13, 2.8114572543455206e-15
+   };
+   static constexpr dfloat cs[] = {
+         -0.16666666666666666, 0.008333333333333333, -0.0001984126984126984, 2.7557319223985893e-06,
+         -2.505210838544172e-08
+   };
+   dfloat r2 = r * r;
+   return r + r * r2 * ( forSfloat ? Polynomial( r2, cs ) : Polynomial( r2, c ));
+}
+template< bool forSfloat >
+DIP__KERNEL_INLINE dfloat CosPolynomial( dfloat r ) {
+   static constexpr dfloat c[] = {
+         0.041666666666666664, -0.001388888888888889, 2.48015873015873e-05, -2.755731922398589e-07,
+         2.08767569878681e-09, -1.1470745597729725e-11, 4.779477332387385e-14, -1.5619206968586225e-16
+   };
+   static constexpr dfloat cs[] = {
+         0.041666666666666664, -0.001388888888888889, 2.48015873015873e-05, -2.755731922398589e-07,
+         2.08767569878681e-09
+   };
+   dfloat r2 = r * r;
+   dfloat hr2 = 0.5 * r2;
+   dfloat w = 1.0 - hr2;
+   // `( 1 - w ) - hr2` recovers the rounding error in `w`
+   return w + ((( 1.0 - w ) - hr2 ) + r2 * r2 * ( forSfloat ? Polynomial( r2, cs ) : Polynomial( r2, c )));
+}
+
+// sin(x) (`quadrantOffset` = 0) or cos(x) (`quadrantOffset` = 1), for |x| <= trigonometricLimit. The argument is
+// reduced to r = x - n * pi/2, using pi/2 split in three parts (Cody-Waite reduction).
+template< bool forSfloat >
+DIP__KERNEL_INLINE dfloat SinCos( dfloat x, std::int64_t quadrantOffset ) {
+   dfloat n = RoundToInteger( x * 0.6366197723675814 );
+   dfloat r = (( x - n * piOver2High ) - n * piOver2Middle ) - n * piOver2Low;
+   std::int64_t quadrant = ToInteger( n ) + quadrantOffset;
+   dfloat s = SinPolynomial< forSfloat >( r );
+   dfloat c = CosPolynomial< forSfloat >( r );
+   dfloat result = ( quadrant & 1 ) ? c : s;
+   return ( quadrant & 2 ) ? -result : result;
+}
+
+DIP__KERNEL_INLINE sfloat Sin( sfloat x ) {
+   return static_cast< sfloat >( SinCos< true >( x, 0 ));
+}
+DIP__KERNEL_INLINE dfloat Sin( dfloat x ) {
+   return SinCos< false >( x, 0 );
+}
+
+DIP__KERNEL_INLINE sfloat Cos( sfloat x ) {
+   return static_cast< sfloat >( SinCos< true >( x, 1 ));
+}
+DIP__KERNEL_INLINE dfloat Cos( dfloat x ) {
+   return SinCos< false >( x, 1 );
+}
+
+// The standard library functions, for arguments outside of the range of the kernels above
+template< typename T >
+T StdSin( T x ) {
+   return std::sin( x );
+}
+template< typename T >
+T StdCos( T x ) {
+   return std::cos( x );
+}
+
+//
+// Error function, only for `sfloat`, computed in double precision
+//
+
+// erf(x) for |x| < 1: Taylor series
+DIP__KERNEL_INLINE dfloat ErfSmall( dfloat x ) {
+   static constexpr dfloat c[] = {
+         1.1283791670955126, -0.37612638903183754, 0.11283791670955126, -0.026866170645131252,
+         0.005223977625442188, -0.0008548327023450853, 0.00012055332981789664, -1.492565035840625e-05,
+         1.6462114365889248e-06, -1.6365844691234924e-07, 1.4807192815879218e-08, -1.2290555301717928e-09
+   };
+   return x * Polynomial( x * x, c );
+}
+
+// erfc(x) for 1 <= x <= 10.1 (beyond which erfc(x) rounds to 0 in single precision). With u = 1/x,
+// erfc(x) = e^(-x^2) * u * S(u), where S is smooth on [1/10.1, 1], and approximated by a Chebyshev series.
+DIP__KERNEL_INLINE dfloat ErfcLarge( dfloat x ) {
+   static constexpr dfloat c[] = {
+         0.4989282886648611, -0.06940852667523331, -0.003969240688591325, 0.002448171089202942,
+         -0.00044869103893001257, 2.5410417194866502e-05, 1.2350476625132844e-05, -5.158017994014678e-06,
+         1.0782137755343473e-06, -8.716292070414327e-08, -3.3148736438909156e-08, 1.831025951024743e-08,
+         -5.063362618074052e-09, 7.999757070767491e-10, 2.855314750070824e-11
+   };
+   constexpr dfloat uMin = 1.0 / 10.1;
+   x = x < 1.0 ? 1.0 : x;
+   x = x > 10.1 ? 10.1 : x;
+   dfloat u = 1.0 / x;
+   dfloat t = ( 2.0 * u - ( uMin + 1.0 )) / ( 1.0 - uMin );
+   return Exp( -x * x ) * u * ChebyshevSeries( t, c );
+}
+
+DIP__KERNEL_INLINE sfloat Erf( sfloat xf ) {
+   dfloat x = xf;
+   dfloat ax = std::abs( x );
+   dfloat result = ax < 1.0 ? ErfSmall( ax ) : 1.0 - ErfcLarge( ax );
+   return static_cast< sfloat >( std::copysign( result, x ));
+}
+
+DIP__KERNEL_INLINE sfloat Erfc( sfloat xf ) {
+   dfloat x = xf;
+   dfloat ax = std::abs( x );
+   dfloat large = ErfcLarge( ax );
+   dfloat result = x >= 1.0 ? large : ( x > -1.0 ? 1.0 - std::copysign( ErfSmall( ax ), x ) : 2.0 - large );
+   return static_cast< sfloat >( result );
+}
+
+//
+// Square root: vectorizes directly (with `-fno-math-errno`)
+//
+
+template< typename T >
+DIP__KERNEL_INLINE T Sqrt( T x ) {
+   return std::sqrt( x );
+}
+
+//
+// The loops, compiled for each of the instruction sets
+//
+
+template< typename T, T ( *F )( T ) >
+DIP__KERNEL_INLINE void ApplyKernel( T const* in, T* out, dip::uint n ) {
+   #pragma omp simd
+   for( dip::uint ii = 0; ii < n; ++ii ) {
+      out[ ii ] = F( in[ ii ] );
+   }
+}
+
+// As `ApplyKernel`, but samples larger than `trigonometricLimit` in magnitude, infinities and NaNs are recomputed
+// by `G`. The input is processed in blocks that are copied to a local buffer, such that the input values are
+// available after `out` (which can be `in`) has been written to.
+template< typename T, T ( *F )( T ), T ( *G )( T ) >
+DIP__KERNEL_INLINE void ApplyKernelWithFallback( T const* in, T* out, dip::uint n ) {
+   constexpr dip::uint blockSize = 256;
+   T buffer[ blockSize ];
+   for( dip::uint start = 0; start < n; start += blockSize ) {
+      dip::uint length = std::min( blockSize, n - start );
+      std::copy( in + start, in + start + length, buffer );
+      ApplyKernel< T, F >( buffer, out + start, length );
+      for( dip::uint ii = 0; ii < length; ++ii ) {
+         if( !( std::abs( buffer[ ii ] ) <= T( trigonometricLimit ))) {
+            out[ start + ii ] = G( buffer[ ii ] );
+         }
+      }
+   }
+}
+
+#define DIP__DEFINE_KERNEL_LOOPS( suffix_, attribute_ ) \
+   template< typename T, T ( *F )( T ) > \
+   attribute_ void Kernel##suffix_( T const* in, T* out, dip::uint n ) { \
+      ApplyKernel< T, F >( in, out, n ); \
+   } \
+   template< typename T, T ( *F )( T ), T ( *G )( T ) > \
+   attribute_ void KernelWithFallback##suffix_( T const* in, T* out, dip::uint n ) { \
+      ApplyKernelWithFallback< T, F, G >( in, out, n ); \
+   }
+
+DIP__DEFINE_KERNEL_LOOPS( Default, )
+#ifdef DIP__MULTIVERSION
+DIP__DEFINE_KERNEL_LOOPS( AVX2, DIP__TARGET_AVX2 )
+DIP__DEFINE_KERNEL_LOOPS( AVX512, DIP__TARGET_AVX512 )
+#endif
+
+#undef DIP__DEFINE_KERNEL_LOOPS
+
+//
+// Selecting the kernel
+//
+
+template< typename T, T ( *F )( T ) >
+MathKernelFunction< T > SelectKernel() {
+#ifdef DIP__MULTIVERSION
+   switch( ActiveInstructionSet() ) {
+      case InstructionSet::AVX512:
+         return &KernelAVX512< T, F >;
+      case InstructionSet::AVX2:
+         return &KernelAVX2< T, F >;
+      default:
+         break;
+   }
+#endif
+   return &KernelDefault< T, F >;
+}
+
+template< typename T, T ( *F )( T ), T ( *G )( T ) >
+MathKernelFunction< T > SelectKernelWithFallback() {
+#ifdef DIP__MULTIVERSION
+   switch( ActiveInstructionSet() ) {
+      case InstructionSet::AVX512:
+         return &KernelWithFallbackAVX512< T, F, G >;
+      case InstructionSet::AVX2:
+         return &KernelWithFallbackAVX2< T, F, G >;
+      default:
+         break;
+   }
+#endif
+   return &KernelWithFallbackDefault< T, F, G >;
+}
+
+template< typename T >
+MathKernelFunction< T > SelectCommonKernel( MathKernel kernel ) {
+   switch( kernel ) {
+      case MathKernel::SQRT:
+         return SelectKernel< T, Sqrt< T >>();
+      case MathKernel::EXP:
+         return SelectKernel< T, Exp >();
+      case MathKernel::EXP2:
+         return SelectKernel< T, Exp2 >();
+      case MathKernel::EXP10:
+         return SelectKernel< T, Exp10 >();
+      case MathKernel::LN:
+         return SelectKernel< T, Ln >();
+      case MathKernel::LOG2:
+         return SelectKernel< T, Log2 >();
+      case MathKernel::LOG10:
+         return SelectKernel< T, Log10 >();
+      case MathKernel::SIN:
+         return SelectKernelWithFallback< T, Sin, StdSin< T >>();
+      case MathKernel::COS:
+         return SelectKernelWithFallback< T, Cos, StdCos< T >>();
+      default:
+         return nullptr;
+   }
+}
+
+} // namespace
+
+template<>
+MathKernelFunction< sfloat > GetMathKernel< sfloat >( MathKernel kernel ) {
+   switch( kernel ) {
+      case MathKernel::ERF:
+         return SelectKernel< sfloat, Erf >();
+      case MathKernel::ERFC:
+         return SelectKernel< sfloat, Erfc >();
+      default:
+         return SelectCommonKernel< sfloat >( kernel );
+   }
+}
+
+template<>
+MathKernelFunction< dfloat > GetMathKernel< dfloat >( MathKernel kernel ) {
+   return SelectCommonKernel< dfloat >( kernel );
+}
+
+} // namespace detail
+} // namespace dip
+
+#ifdef DIP__ENABLE_DOCTEST
+#include "doctest.h"
+#include "diplib/math.h"
+#include "diplib/generation.h"
+
+namespace {
+
+// Compares the kernel to `reference` on `N` samples in [first, last] and on a set of special values. The error is
+// relative to the magnitude of the result, or relative to 1 if `absolute` is set.
+template< typename T, typename F >
+bool KernelMatches( dip::detail::MathKernel kernel, F reference, T first, T last, bool absolute = false ) {
+   constexpr dip::uint N = 1001;
+   std::vector< T > in( N );
+   for( dip::uint ii = 0; ii < N; ++ii ) {
+      in[ ii ] = first + ( last - first ) * static_cast< T >( ii ) / static_cast< T >( N - 1 );
+   }
+   in.push_back( std::numeric_limits< T >::infinity() );
+   in.push_back( -std::numeric_limits< T >::infinity() );
+   in.push_back( std::numeric_limits< T >::quiet_NaN() );
+   in.push_back( T( 0 ));
+   in.push_back( T( -1 ));
+   std::vector< T > out( in.size() );
+   dip::detail::GetMathKernel< T >( kernel )( in.data(), out.data(), in.size() );
+   T tolerance = 3 * std::numeric_limits< T >::epsilon();
+   for( dip::uint ii = 0; ii < in.size(); ++ii ) {
+      T expected = static_cast< T >( reference( in[ ii ] ));
+      if( std::isnan( expected ) || std::isinf( expected )) {
+         if( !( std::isnan( expected ) && std::isnan( out[ ii ] )) && ( expected != out[ ii ] )) {
+            return false;
+         }
+      } else if( std::abs( out[ ii ] - expected ) > tolerance * ( absolute ? T( 1 ) : std::abs( expected ))) {
+         return false;
+      }
+   }
+   return true;
+}
+
+template< typename T >
+void TestKernels() {
+   using dip::detail::MathKernel;
+   DOCTEST_CHECK( KernelMatches< T >( MathKernel::SQRT, []( T x ) { return std::sqrt( x ); }, 0, 1000 ));
+   DOCTEST_CHECK( KernelMatches< T >( MathKernel::EXP, []( T x ) { return std::exp( x ); }, -80, 80 ));
+   DOCTEST_CHECK( KernelMatches< T >( MathKernel::EXP2, []( T x ) { return std::exp2( x ); }, -120, 120 ));
+   DOCTEST_CHECK( KernelMatches< T >( MathKernel::EXP10, []( T x ) { return std::pow( T( 10 ), x ); }, -35, 35 ));
+   DOCTEST_CHECK( KernelMatches< T >( MathKernel::LN, []( T x ) { return std::log( x ); }, T( 1e-30 ), 1e6 ));
+   DOCTEST_CHECK( KernelMatches< T >( MathKernel::LOG2, []( T x ) { return std::log2( x ); }, T( 1e-30 ), 1e6 ));
+   DOCTEST_CHECK( KernelMatches< T >( MathKernel::LOG10, []( T x ) { return std::log10( x ); }, T( 1e-30 ), 1e6 ));
+   DOCTEST_CHECK( KernelMatches< T >( MathKernel::SIN, []( T x ) { return std::sin( x ); }, -1e7, 1e7, true ));
+   DOCTEST_CHECK( KernelMatches< T >( MathKernel::COS, []( T x ) { return std::cos( x ); }, -100, 100, true ));
+}
+
+} // namespace
+
+DOCTEST_TEST_CASE("[DIPlib] testing the vectorized math kernels") {
+   TestKernels< dip::sfloat >();
+   TestKernels< dip::dfloat >();
+   DOCTEST_CHECK( KernelMatches< dip::sfloat >( dip::detail::MathKernel::ERF, []( dip::sfloat x ) { return std::erf( x ); }, -6, 6, true ));
+   DOCTEST_CHECK( KernelMatches< dip::sfloat >( dip::detail::MathKernel::ERFC, []( dip::sfloat x ) { return std::erfc( x ); }, -6, 9 ));
+   DOCTEST_CHECK( !dip::detail::GetMathKernel< dip::dfloat >( dip::detail::MathKernel::ERF ));
+
+   // The monadic operators use the kernels on contiguous lines, and the generic code elsewhere
+   dip::Image img{ dip::UnsignedArray{ 50, 40 }, 1, dip::DT_SFLOAT };
+   dip::FillXCoordinate( img, { "corner" } );
+   img += 1;
+   dip::Image out = dip::Log2( img );
+   DOCTEST_CHECK( out.At( 7, 3 ).As< dip::sfloat >() == doctest::Approx( 3.0 ));
+   dip::Image view = img;
+   view.Mirror( { true, false } );
+   view.PermuteDimensions( { 1, 0 } );
+   out = dip::Exp( view );
+   DOCTEST_CHECK( out.At( 3, 42 ).As< dip::sfloat >() == doctest::Approx( std::exp( 8.0 )));
+}
+
+#endif // DIP__ENABLE_DOCTEST
@@ -0,0 +1,70 @@
+/*
+ * DIPlib 3.0
+ * This file contains declarations for the vectorized kernels used by the monadic math operators.
+ *
+ * (c)2026, Cris Luengo.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DIP_VECTORIZED_MATH_H
+#define DIP_VECTORIZED_MATH_H
+
+#include "diplib.h"
+
+
+namespace dip {
+namespace detail {
+
+// The functions for which a vectorized kernel exists
+enum class MathKernel {
+      SQRT,
+      EXP,
+      EXP2,
+      EXP10,
+      LN,
+      LOG2,
+      LOG10,
+      SIN,
+      COS,
+      ERF,
+      ERFC
+};
+
+// A kernel computes its function for `n` consecutive samples starting at `in`, and writes the results to `out`.
+// `out` can point to the same buffer as `in`.
+//
+// The kernels evaluate polynomial approximations, written such that the compiler can vectorize the loop over the
+// samples. Each kernel is compiled for a few instruction sets (SSE2, AVX2+FMA and AVX-512 on x86), `GetMathKernel`
+// returns the version for the instruction set selected through `dip::SetInstructionSet`. Results can therefore
+// differ in the last bit between machines, and from the corresponding function in the standard library. For finite
+// inputs, the error is below 2.5 ULP (units in the last place); special values (infinities, NaN, zero, negative
+// input to logarithms) give the same result as the standard library.
+template< typename T >
+using MathKernelFunction = void ( * )( T const* in, T* out, dip::uint n );
+
+// Returns the kernel for `kernel` and sample type `T`, or `nullptr` if there is none. There are kernels for `sfloat`
+// and `dfloat`, except for `ERF` and `ERFC` which are only implemented for `sfloat`.
+template< typename T >
+MathKernelFunction< T > GetMathKernel( MathKernel /*kernel*/ ) {
+   return nullptr;
+}
+template<>
+MathKernelFunction< sfloat > GetMathKernel< sfloat >( MathKernel kernel );
+template<>
+MathKernelFunction< dfloat > GetMathKernel< dfloat >( MathKernel kernel );
+
+} // namespace detail
+} // namespace dip
+
+#endif // DIP_VECTORIZED_MATH_H
@@ -23,9 +23,9 @@ namespace dip {
 namespace Feature {
 
 
-class FeatureCenter : public LineBased {
+class FeatureCenter : public ObjectIndexLineBased {
    public:
-      FeatureCenter() : LineBased( { "Center", "Coordinates of the geometric mean of the object", false } ) {};
+      FeatureCenter() : ObjectIndexLineBased( { "Center", "Coordinates of the geometric mean of the object", false } ) {};
 
       virtual ValueInformationArray Initialize( Image const& label, Image const&, dip::uint nObjects ) override {
          nD_ = label.Dimensionality();
@@ -47,36 +47,28 @@ class FeatureCenter : public LineBased {
          return out;
       }
 
-      virtual void ScanLine(
-            LineIterator <uint32> label,
+      virtual void ScanObjectIndices(
+            LineIterator <uint32> objectIndex,
             LineIterator <dfloat>,
             UnsignedArray coordinates,
-            dip::uint dimension,
-            ObjectIdToIndexMap const& objectIndices
+            dip::uint dimension
       ) override {
-         // If new objectID is equal to previous one, we don't to fetch the data pointer again
-         uint32 objectID = 0;
+         // If the object index is equal to the previous one, we don't need to compute the data pointer again
+         uint32 index = NO_OBJECT;
          dfloat* data = nullptr;
          do {
-            if( *label > 0 ) {
-               if( *label != objectID ) {
-                  objectID = *label;
-                  auto it = objectIndices.find( objectID );
-                  if( it == objectIndices.end() ) {
-                     data = nullptr;
-                  } else {
-                     data = &( data_[ it->second * ( nD_ + 1 ) ] );
-                  }
+            if( *objectIndex != NO_OBJECT ) {
+               if( *objectIndex != index ) {
+                  index = *objectIndex;
+                  data = &( data_[ index * ( nD_ + 1 ) ] );
                }
-               if( data ) {
-                  for( dip::uint ii = 0; ii < nD_; ii++ ) {
-                     data[ ii ] += static_cast< dfloat >( coordinates[ ii ] );
-                  }
-                  ++( data[ nD_ ] );
+               for( dip::uint ii = 0; ii < nD_; ii++ ) {
+                  data[ ii ] += static_cast< dfloat >( coordinates[ ii ] );
                }
+               ++( data[ nD_ ] );
             }
             ++coordinates[ dimension ];
-         } while( ++label );
+         } while( ++objectIndex );
       }
 
       virtual void Finish( dip::uint objectIndex, Measurement::ValueIterator output ) override {
@@ -24,9 +24,9 @@ namespace dip {
 namespace Feature {
 
 
-class FeatureDirectionalStatistics : public LineBased {
+class FeatureDirectionalStatistics : public ObjectIndexLineBased {
    public:
-      FeatureDirectionalStatistics() : LineBased( { "DirectionalStatistics", "Directional mean and standard deviation of object intensity", true } ) {};
+      FeatureDirectionalStatistics() : ObjectIndexLineBased( { "DirectionalStatistics", "Directional mean and standard deviation of object intensity", true } ) {};
 
       virtual ValueInformationArray Initialize( Image const& /*label*/, Image const& grey, dip::uint nObjects ) override {
          DIP_THROW_IF( !grey.IsScalar(), E::IMAGE_NOT_SCALAR );
@@ -38,33 +38,25 @@ class FeatureDirectionalStatistics : public LineBased {
          return out;
       }
 
-      virtual void ScanLine(
-            LineIterator <uint32> label,
+      virtual void ScanObjectIndices(
+            LineIterator <uint32> objectIndex,
             LineIterator <dfloat> grey,
             UnsignedArray /*coordinates*/,
-            dip::uint /*dimension*/,
-            ObjectIdToIndexMap const& objectIndices
+            dip::uint /*dimension*/
       ) override {
-         // If new objectID is equal to previous one, we don't to fetch the data pointer again
-         uint32 objectID = 0;
+         // If the object index is equal to the previous one, we don't need to compute the data pointer again
+         uint32 index = NO_OBJECT;
          DirectionalStatisticsAccumulator* data = nullptr;
          do {
-            if( *label > 0 ) {
-               if( *label != objectID ) {
-                  objectID = *label;
-                  auto it = objectIndices.find( objectID );
-                  if( it == objectIndices.end() ) {
-                     data = nullptr;
-                  } else {
-                     data = &( data_[ it->second ] );
-                  }
-               }
-               if( data ) {
-                  data->Push( *grey );
+            if( *objectIndex != NO_OBJECT ) {
+               if( *objectIndex != index ) {
+                  index = *objectIndex;
+                  data = &( data_[ index ] );
                }
+               data->Push( *grey );
             }
             ++grey;
-         } while( ++label );
+         } while( ++objectIndex );
       }
 
       virtual void Finish( dip::uint objectIndex, Measurement::ValueIterator output ) override {
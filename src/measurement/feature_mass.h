@@ -23,9 +23,9 @@ namespace dip {
 namespace Feature {
 
 
-class FeatureMass : public LineBased {
+class FeatureMass : public ObjectIndexLineBased {
    public:
-      FeatureMass() : LineBased( { "Mass", "Mass of object (sum of object intensity)", true } ) {};
+      FeatureMass() : ObjectIndexLineBased( { "Mass", "Mass of object (sum of object intensity)", true } ) {};
 
       virtual ValueInformationArray Initialize( Image const& /*label*/, Image const& grey, dip::uint nObjects ) override {
          nTensor_ = grey.TensorElements();
@@ -42,35 +42,27 @@ class FeatureMass : public LineBased {
          return out;
       }
 
-      virtual void ScanLine(
-            LineIterator <uint32> label,
+      virtual void ScanObjectIndices(
+            LineIterator <uint32> objectIndex,
             LineIterator <dfloat> grey,
             UnsignedArray /*coordinates*/,
-            dip::uint /*dimension*/,
-            ObjectIdToIndexMap const& objectIndices
+            dip::uint /*dimension*/
       ) override {
-         // If new objectID is equal to previous one, we don't to fetch the data pointer again
-         uint32 objectID = 0;
+         // If the object index is equal to the previous one, we don't need to compute the data pointer again
+         uint32 index = NO_OBJECT;
          dfloat* data = nullptr;
          do {
-            if( *label > 0 ) {
-               if( *label != objectID ) {
-                  objectID = *label;
-                  auto it = objectIndices.find( objectID );
-                  if( it == objectIndices.end() ) {
-                     data = nullptr;
-                  } else {
-                     data = &( data_[ it->second ] );
-                  }
+            if( *objectIndex != NO_OBJECT ) {
+               if( *objectIndex != index ) {
+                  index = *objectIndex;
+                  data = &( data_[ index ] );
                }
-               if( data ) {
-                  for( dip::uint ii = 0; ii < nTensor_; ++ii ) {
-                     data[ ii ] += grey[ ii ];
-                  }
+               for( dip::uint ii = 0; ii < nTensor_; ++ii ) {
+                  data[ ii ] += grey[ ii ];
                }
             }
             ++grey;
-         } while( ++label );
+         } while( ++objectIndex );
       }
 
       virtual void Finish( dip::uint objectIndex, Measurement::ValueIterator output ) override {
@@ -23,9 +23,9 @@ namespace dip {
 namespace Feature {
 
 
-class FeatureMaximum : public LineBased {
+class FeatureMaximum : public ObjectIndexLineBased {
    public:
-      FeatureMaximum() : LineBased( { "Maximum", "Maximum coordinates of the object", false } ) {};
+      FeatureMaximum() : ObjectIndexLineBased( { "Maximum", "Maximum coordinates of the object", false } ) {};
 
       virtual ValueInformationArray Initialize( Image const& label, Image const&, dip::uint nObjects ) override {
          nD_ = label.Dimensionality();
@@ -47,37 +47,29 @@ class FeatureMaximum : public LineBased {
          return out;
       }
 
-      virtual void ScanLine(
-            LineIterator <uint32> label,
+      virtual void ScanObjectIndices(
+            LineIterator <uint32> objectIndex,
             LineIterator <dfloat>, // unused
             UnsignedArray coordinates,
-            dip::uint dimension,
-            ObjectIdToIndexMap const& objectIndices
+            dip::uint dimension
       ) override {
-         // If new objectID is equal to previous one, we don't need to fetch the data pointer again
-         uint32 objectID = 0;
+         // If the object index is equal to the previous one, we don't need to compute the data pointer again
+         uint32 index = NO_OBJECT;
          dip::uint* data = nullptr;
          do {
-            if( *label > 0 ) {
-               if( *label != objectID ) {
-                  objectID = *label;
-                  auto it = objectIndices.find( objectID );
-                  if( it == objectIndices.end() ) {
-                     data = nullptr;
-                  } else {
-                     data = &( data_[ it->second * nD_ ] );
-                     for( dip::uint ii = 0; ii < nD_; ii++ ) {
-                        data[ ii ] = std::max( data[ ii ], coordinates[ ii ] );
-                     }
+            if( *objectIndex != NO_OBJECT ) {
+               if( *objectIndex != index ) {
+                  index = *objectIndex;
+                  data = &( data_[ index * nD_ ] );
+                  for( dip::uint ii = 0; ii < nD_; ii++ ) {
+                     data[ ii ] = std::max( data[ ii ], coordinates[ ii ] );
                   }
                } else {
-                  if( data ) {
-                     data[ dimension ] = std::max( data[ dimension ], coordinates[ dimension ] );
-                  }
+                  data[ dimension ] = std::max( data[ dimension ], coordinates[ dimension ] );
                }
             }
             ++coordinates[ dimension ];
-         } while( ++label );
+         } while( ++objectIndex );
       }
 
       virtual void Finish( dip::uint objectIndex, Measurement::ValueIterator output ) override {
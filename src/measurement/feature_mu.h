@@ -23,9 +23,9 @@ namespace dip {
 namespace Feature {
 
 
-class FeatureMu : public LineBased {
+class FeatureMu : public ObjectIndexLineBased {
    public:
-      FeatureMu() : LineBased( { "Mu", "Elements of the inertia tensor", false } ) {};
+      FeatureMu() : ObjectIndexLineBased( { "Mu", "Elements of the inertia tensor", false } ) {};
 
       virtual ValueInformationArray Initialize( Image const& label, Image const&, dip::uint nObjects ) override {
          nD_ = label.Dimensionality();
@@ -64,34 +64,26 @@ class FeatureMu : public LineBased {
          return out;
       }
 
-      virtual void ScanLine(
-            LineIterator <uint32> label,
+      virtual void ScanObjectIndices(
+            LineIterator <uint32> objectIndex,
             LineIterator <dfloat>,
             UnsignedArray coordinates,
-            dip::uint dimension,
-            ObjectIdToIndexMap const& objectIndices
+            dip::uint dimension
       ) override {
-         // If new objectID is equal to previous one, we don't to fetch the data pointer again
-         uint32 objectID = 0;
+         // If the object index is equal to the previous one, we don't need to compute the data pointer again
+         uint32 index = NO_OBJECT;
          MomentAccumulator* data = nullptr;
          FloatArray pos{ coordinates };
          do {
-            if( *label > 0 ) {
-               if( *label != objectID ) {
-                  objectID = *label;
-                  auto it = objectIndices.find( objectID );
-                  if( it == objectIndices.end() ) {
-                     data = nullptr;
-                  } else {
-                     data = &( data_[ it->second ] );
-                  }
-               }
-               if( data ) {
-                  data->Push( pos, 1.0 );
+            if( *objectIndex != NO_OBJECT ) {
+               if( *objectIndex != index ) {
+                  index = *objectIndex;
+                  data = &( data_[ index ] );
                }
+               data->Push( pos, 1.0 );
             }
             ++pos[ dimension ];
-         } while( ++label );
+         } while( ++objectIndex );
       }
 
       virtual void Finish( dip::uint objectIndex, Measurement::ValueIterator output ) override {
@@ -0,0 +1,64 @@
+/*
+ * DIPlib 3.0
+ * This file defines the base class for the line-based measurement features that use object indices
+ *
+ * (c)2026, Cris Luengo.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+namespace dip {
+namespace Feature {
+
+
+// The built-in line-based features implement `ScanObjectIndices`, which the `dip::MeasurementTool` calls.
+// `ScanLine` is implemented here in terms of it, for code that calls features directly through the
+// `dip::Feature::LineBased` interface.
+class ObjectIndexLineBased : public LineBased {
+   public:
+      explicit ObjectIndexLineBased( Information const& information ) : LineBased( information ) {};
+
+      virtual bool UsesObjectIndices() const override { return true; }
+
+      virtual void ScanLine(
+            LineIterator< uint32 > label,
+            LineIterator< dfloat > grey,
+            UnsignedArray coordinates,
+            dip::uint dimension,
+            ObjectIdToIndexMap const& objectIndices
+      ) override {
+         objectIndexBuffer_.resize( label.Length() - label.Coordinate() );
+         uint32 previousLabel = 0;
+         uint32 index = NO_OBJECT;
+         auto out = objectIndexBuffer_.begin();
+         do {
+            if( *label != previousLabel ) {
+               previousLabel = *label;
+               auto it = objectIndices.find( previousLabel );
+               index = ( it == objectIndices.end() ) ? NO_OBJECT : static_cast< uint32 >( it->second );
+            }
+            *out = index;
+            ++out;
+         } while( ++label );
+         LineIterator< uint32 > objectIndex( objectIndexBuffer_.data(), objectIndexBuffer_.size(), 1 );
+         ScanObjectIndices( objectIndex, grey, std::move( coordinates ), dimension );
+      }
+
+   private:
+      std::vector< uint32 > objectIndexBuffer_;
+};
+
+
+} // namespace feature
+} // namespace dip
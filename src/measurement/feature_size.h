@@ -23,9 +23,9 @@ namespace dip {
 namespace Feature {
 
 
-class FeatureSize : public LineBased {
+class FeatureSize : public ObjectIndexLineBased {
    public:
-      FeatureSize() : LineBased( { "Size", "Number of object pixels", false } ) {};
+      FeatureSize() : ObjectIndexLineBased( { "Size", "Number of object pixels", false } ) {};
 
       virtual ValueInformationArray Initialize( Image const& label, Image const&, dip::uint nObjects ) override {
          data_.clear();
@@ -59,32 +59,24 @@ class FeatureSize : public LineBased {
          return out;
       }
 
-      virtual void ScanLine(
-            LineIterator <uint32> label,
+      virtual void ScanObjectIndices(
+            LineIterator <uint32> objectIndex,
             LineIterator <dfloat>, // unused
             UnsignedArray, // unused
-            dip::uint, // unused
-            ObjectIdToIndexMap const& objectIndices
+            dip::uint // unused
       ) override {
-         // If new objectID is equal to previous one, we don't need to fetch the data pointer again
-         uint32 objectID = 0;
+         // If the object index is equal to the previous one, we don't need to compute the data pointer again
+         uint32 index = NO_OBJECT;
          dip::uint* data = nullptr;
          do {
-            if( *label > 0 ) {
-               if( *label != objectID ) {
-                  objectID = *label;
-                  auto it = objectIndices.find( objectID );
-                  if( it == objectIndices.end() ) {
-                     data = nullptr;
-                  } else {
-                     data = &( data_[ it->second ] );
-                  }
-               }
-               if( data ) {
-                  ++( *data );
+            if( *objectIndex != NO_OBJECT ) {
+               if( *objectIndex != index ) {
+                  index = *objectIndex;
+                  data = &( data_[ index ] );
                }
+               ++( *data );
             }
-         } while( ++label );
+         } while( ++objectIndex );
       }
 
       virtual void Finish( dip::uint objectIndex, Measurement::ValueIterator output ) override {
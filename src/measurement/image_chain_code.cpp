@@ -19,13 +19,15 @@
  */
 
 #include <array>
-#include <map>
+#include <vector>
 
 #include "diplib.h"
 #include "diplib/chain_code.h"
 #include "diplib/regions.h"
 #include "diplib/overload.h"
 
+#include "object_id_to_index_table.h"
+
 namespace dip {
 
 // We need storage for these tables, as we take pointers to them.
@@ -34,9 +36,6 @@ constexpr VertexInteger ChainCode::deltas8[8];
 
 namespace {
 
-struct ObjectData { dip::uint index; bool done; };
-using ObjectIdList = std::map< dip::uint, ObjectData >; // key is the objectID (label)
-
 template< typename TPI >
 static ChainCode dip__OneChainCode(
       void const* data_ptr,
@@ -97,14 +96,15 @@ static ChainCode dip__OneChainCode(
 template< typename TPI >
 static ChainCodeArray dip__ChainCodes(
       Image const& labels,
-      ObjectIdList& objectIDs,
-      dip::uint nObjects, // potentially different from the number of entries in objectIDs, if there were repeated elements in the original list.
+      ObjectIdToIndexTable const& objectIndices,
+      dip::uint nObjects, // potentially larger than the number of distinct object IDs, if there were repeated elements in the original list.
       dip::uint connectivity,
       ChainCode::CodeTable const& codeTable
 ) {
    DIP_ASSERT( labels.DataType() == DataType( TPI( 0 ) ) );
    TPI* data = static_cast< TPI* >( labels.Origin() );
    ChainCodeArray ccArray( nObjects );  // output array
+   std::vector< bool > done( nObjects, false );
    VertexInteger dims = { static_cast< dip::sint >( labels.Size( 0 ) - 1 ), static_cast< dip::sint >( labels.Size( 1 ) - 1 ) }; // our local copy of `dims` now contains the largest coordinates
    IntegerArray const& strides = labels.Strides();
 
@@ -119,10 +119,10 @@ static ChainCodeArray dip__ChainCodes(
          dip::uint newlabel = data[ pos ];
          if( ( newlabel != 0 ) && ( newlabel != label ) ) {
             // Check whether newlabel is start of not processed object
-            auto it = objectIDs.find( newlabel );
-            if( ( it != objectIDs.end() ) && !it->second.done ) {
-               it->second.done = true;
-               index = it->second.index;
+            uint32 newIndex = objectIndices[ newlabel ];
+            if(( newIndex != ObjectIdToIndexTable::NOT_FOUND ) && !done[ newIndex ] ) {
+               done[ newIndex ] = true;
+               index = newIndex;
                label = newlabel;
                process = true;
             }
@@ -151,26 +151,19 @@ ChainCodeArray GetImageChainCodes(
    // Initialize freeman codes
    ChainCode::CodeTable codeTable = ChainCode::PrepareCodeTable( connectivity, labels.Strides() );
 
-   // Create a map for the object IDs
-   ObjectIdList objectIdList;
-   dip::uint nObjects;
+   // Create a look-up table for the object IDs
+   UnsignedArray allObjectIDs;
    if( objectIDs.empty() ) {
-      UnsignedArray allObjectIDs = GetObjectLabels( labels, Image(), S::EXCLUDE );
-      for( dip::uint ii = 0; ii < allObjectIDs.size(); ++ii ) {
-         objectIdList.emplace( allObjectIDs[ ii ], ObjectData{ ii, false } );
-      }
-      nObjects = allObjectIDs.size();
-   } else {
-      for( dip::uint ii = 0; ii < objectIDs.size(); ++ii ) {
-         objectIdList.emplace( objectIDs[ ii ], ObjectData{ ii, false } );
-      }
-      nObjects = objectIDs.size();
+      allObjectIDs = GetObjectLabels( labels, Image(), S::EXCLUDE );
    }
+   UnsignedArray const& ids = objectIDs.empty() ? allObjectIDs : objectIDs;
+   ObjectIdToIndexTable objectIndices( ids );
+   dip::uint nObjects = ids.size();
 
    // Get the chain code for each label
    ChainCodeArray ccArray;
    DIP_OVL_CALL_ASSIGN_UINT( ccArray,
-                             dip__ChainCodes, ( labels, objectIdList, nObjects, connectivity, codeTable ),
+                             dip__ChainCodes, ( labels, objectIndices, nObjects, connectivity, codeTable ),
                              labels.DataType() );
    return ccArray;
 }
@@ -25,8 +25,11 @@
 #include "diplib/framework.h"
 #include "diplib/regions.h"
 
+#include "object_id_to_index_table.h"
+
 // FEATURES:
 // Size
+#include "feature_object_index_line_based.h"
 #include "feature_size.h"
 #include "feature_solid_area.h"
 #include "feature_minimum.h"
@@ -123,6 +126,8 @@ MeasurementTool::MeasurementTool() {
    Register( new Feature::FeatureGreyDimensionsEllipsoid );
 }
 
+void Feature::LineBased::ScanObjectIndices( LineIterator< uint32 >, LineIterator< dfloat >, UnsignedArray, dip::uint ) {}
+
 using LineBasedFeatureArray = std::vector< Feature::LineBased* >;
 using FeatureArray = std::vector< Feature::Base* >;
 
@@ -131,15 +136,30 @@ namespace {
 
 // dip::Framework::ScanFilter function, not overloaded because the Feature::LineBased::ScanLine functions
 // that we call here are not overloaded.
+// For features that use object indices, the object index for each pixel is looked up once, for all features,
+// only when the label changes along the line. Other features get the label line and the object ID map.
 class MeasureLineFilter : public Framework::ScanLineFilter {
    public:
       // not defining GetNumberOfOperations(), always called in a single thread
       virtual void Filter( Framework::ScanLineFilterParameters const& params ) override {
-         LineIterator< uint32 > label(
-               static_cast< uint32* >( params.inBuffer[ 0 ].buffer ),
-               0, params.bufferLength, params.inBuffer[ 0 ].stride,
-               params.inBuffer[ 0 ].tensorLength, params.inBuffer[ 0 ].tensorStride
-         );
+         uint32* label = static_cast< uint32* >( params.inBuffer[ 0 ].buffer );
+         dip::sint labelStride = params.inBuffer[ 0 ].stride;
+         dip::uint const bufferLength = params.bufferLength;
+         LineIterator< uint32 > objectIndex;
+         if( anyUsesObjectIndices_ ) {
+            objectIndexBuffer_.resize( bufferLength );
+            uint32 const* plabel = label;
+            uint32 previousLabel = 0;
+            uint32 index = Feature::LineBased::NO_OBJECT;
+            for( dip::uint ii = 0; ii < bufferLength; ++ii, plabel += labelStride ) {
+               if( *plabel != previousLabel ) {
+                  previousLabel = *plabel;
+                  index = previousLabel == 0 ? Feature::LineBased::NO_OBJECT : objectIndexTable_[ previousLabel ];
+               }
+               objectIndexBuffer_[ ii ] = index;
+            }
+            objectIndex = LineIterator< uint32 >( objectIndexBuffer_.data(), bufferLength, 1 );
+         }
          LineIterator< dfloat > grey;
          if( params.inBuffer.size() > 1 ) {
             grey = LineIterator< dfloat >(
@@ -149,19 +169,36 @@ class MeasureLineFilter : public Framework::ScanLineFilter {
             );
          }
 
-         for( auto const& feature : features ) {
+         for( auto const& feature : features_ ) {
             // NOTE! params.dimension here works as long as params.tensorToSpatial is false.
             // As is now, MeasurementTool::Measure only works with scalar images, so we don't need to test here.
-            feature->ScanLine( label, grey, params.position, params.dimension, objectIndices );
+            if( feature->UsesObjectIndices() ) {
+               feature->ScanObjectIndices( objectIndex, grey, params.position, params.dimension );
+            } else {
+               LineIterator< uint32 > labelIt( label, bufferLength, labelStride );
+               feature->ScanLine( labelIt, grey, params.position, params.dimension, objectIndices_ );
+            }
+         }
+      }
+      MeasureLineFilter(
+            LineBasedFeatureArray const& features,
+            ObjectIdToIndexMap const& objectIndices,
+            ObjectIdToIndexTable const& objectIndexTable
+      ) : features_( features ), objectIndices_( objectIndices ), objectIndexTable_( objectIndexTable ) {
+         for( auto const& feature : features_ ) {
+            anyUsesObjectIndices_ |= feature->UsesObjectIndices();
          }
       }
-      MeasureLineFilter( LineBasedFeatureArray const& features, ObjectIdToIndexMap const& objectIndices ) :
-            features( features ), objectIndices( objectIndices ) {}
    private:
-      LineBasedFeatureArray const& features;
-      ObjectIdToIndexMap const& objectIndices;
+      LineBasedFeatureArray const& features_;
+      ObjectIdToIndexMap const& objectIndices_;
+      ObjectIdToIndexTable const& objectIndexTable_;
+      bool anyUsesObjectIndices_ = false;
+      std::vector< uint32 > objectIndexBuffer_;
 };
 
+static_assert( ObjectIdToIndexTable::NOT_FOUND == Feature::LineBased::NO_OBJECT, "Object index sentinel values must match" );
+
 } // namespace
 
 Measurement MeasurementTool::Measure(
@@ -265,8 +302,9 @@ Measurement MeasurementTool::Measure(
       }
       ImageRefArray outar{};
 
-      // Do the scan, which calls dip::Feature::LineBased::ScanLine()
-      MeasureLineFilter functor{ lineBasedFeatures, measurement.ObjectIndices() };
+      // Do the scan, which calls dip::Feature::LineBased::ScanLine() or dip::Feature::LineBased::ScanObjectIndices()
+      ObjectIdToIndexTable objectIndexTable( measurement.Objects() );
+      MeasureLineFilter functor{ lineBasedFeatures, measurement.ObjectIndices(), objectIndexTable };
       Framework::Scan( inar, outar, inBufT, {}, {}, {}, functor,
             Framework::ScanOption::NoMultiThreading + Framework::ScanOption::NeedCoordinates );
 
@@ -341,3 +379,70 @@ Measurement MeasurementTool::Measure(
 }
 
 } // namespace dip
+
+
+#ifdef DIP__ENABLE_DOCTEST
+#include "doctest.h"
+
+namespace {
+
+// A feature that implements only `ScanLine`, as features written against the original interface do.
+class FeatureLabelLineSize : public dip::Feature::LineBased {
+   public:
+      FeatureLabelLineSize() : LineBased( { "LabelLineSize", "Number of object pixels", false } ) {};
+      virtual dip::Feature::ValueInformationArray Initialize( dip::Image const&, dip::Image const&, dip::uint nObjects ) override {
+         data_.assign( nObjects, 0 );
+         return dip::Feature::ValueInformationArray( 1 );
+      }
+      virtual void ScanLine(
+            dip::LineIterator< dip::uint32 > label,
+            dip::LineIterator< dip::dfloat >,
+            dip::UnsignedArray,
+            dip::uint,
+            dip::ObjectIdToIndexMap const& objectIndices
+      ) override {
+         do {
+            auto it = objectIndices.find( *label );
+            if( it != objectIndices.end() ) {
+               ++data_[ it->second ];
+            }
+         } while( ++label );
+      }
+      virtual void Finish( dip::uint objectIndex, dip::Measurement::ValueIterator output ) override {
+         *output = static_cast< dip::dfloat >( data_[ objectIndex ] );
+      }
+   private:
+      std::vector< dip::uint > data_;
+};
+
+} // namespace
+
+DOCTEST_TEST_CASE("[DIPlib] testing line-based features with label lines and object indices") {
+   dip::Image label{ dip::UnsignedArray{ 20, 15 }, 1, dip::DT_UINT32 };
+   label.Fill( 0 );
+   label.At( dip::Range{ 2, 8 }, dip::Range{ 1, 4 } ).Fill( 3 );
+   label.At( dip::Range{ 10, 18 }, dip::Range{ 6, 13 } ).Fill( 7 );
+   label.At( dip::Range{ 0, 4 }, dip::Range{ 10, 14 } ).Fill( 1000000 );
+   dip::MeasurementTool tool;
+   tool.Register( new FeatureLabelLineSize );
+   // Both paths in the same measurement, and a subset of the objects
+   dip::Measurement msr = tool.Measure( label, {}, { "LabelLineSize", "Size" }, { 7, 1000000 } );
+   DOCTEST_REQUIRE( msr.NumberOfObjects() == 2 );
+   DOCTEST_CHECK( msr[ "LabelLineSize" ][ 7 ][ 0 ] == 72 );
+   DOCTEST_CHECK( msr[ "LabelLineSize" ][ 1000000 ][ 0 ] == 25 );
+   DOCTEST_CHECK( msr[ "Size" ][ 7 ][ 0 ] == 72 );
+   DOCTEST_CHECK( msr[ "Size" ][ 1000000 ][ 0 ] == 25 );
+   // The built-in features also implement `ScanLine`
+   dip::Feature::FeatureSize size;
+   size.Initialize( label, {}, 2 );
+   dip::ObjectIdToIndexMap objectIndices{ { 7, 0 }, { 1000000, 1 } };
+   dip::uint32 line[] = { 0, 7, 7, 3, 1000000, 7, 0 };
+   size.ScanLine( dip::LineIterator< dip::uint32 >( line, 7, 1 ), {}, { 0, 0 }, 0, objectIndices );
+   dip::dfloat result = 0;
+   size.Finish( 0, &result );
+   DOCTEST_CHECK( result == 3 );
+   size.Finish( 1, &result );
+   DOCTEST_CHECK( result == 1 );
+}
+
+#endif // DIP__ENABLE_DOCTEST
@@ -0,0 +1,64 @@
+/*
+ * DIPlib 3.0
+ * This file contains the out-of-line definitions for the object ID to index look-up table
+ *
+ * (c)2026, Cris Luengo.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "diplib.h"
+#include "object_id_to_index_table.h"
+
+namespace dip {
+
+constexpr uint32 ObjectIdToIndexTable::NOT_FOUND;
+
+} // namespace dip
+
+
+#ifdef DIP__ENABLE_DOCTEST
+#include "doctest.h"
+
+DOCTEST_TEST_CASE("[DIPlib] testing the object ID to index look-up table") {
+   // Dense table
+   dip::ObjectIdToIndexTable dense( { 5, 3, 2000, 3, 8 } );
+   DOCTEST_CHECK( dense[ 5 ] == 0 );
+   DOCTEST_CHECK( dense[ 3 ] == 1 ); // repeated ID maps to first occurrence
+   DOCTEST_CHECK( dense[ 2000 ] == 2 );
+   DOCTEST_CHECK( dense[ 8 ] == 4 );
+   DOCTEST_CHECK( dense[ 0 ] == dip::ObjectIdToIndexTable::NOT_FOUND );
+   DOCTEST_CHECK( dense[ 4 ] == dip::ObjectIdToIndexTable::NOT_FOUND );
+   DOCTEST_CHECK( dense[ 1999 ] == dip::ObjectIdToIndexTable::NOT_FOUND );
+   DOCTEST_CHECK( dense[ 100000 ] == dip::ObjectIdToIndexTable::NOT_FOUND );
+   // Sparse IDs: paged table
+   dip::UnsignedArray ids( 10 );
+   for( dip::uint ii = 0; ii < ids.size(); ++ii ) {
+      ids[ ii ] = ( ids.size() - ii ) * 1000000;
+   }
+   dip::ObjectIdToIndexTable paged( ids );
+   for( dip::uint ii = 0; ii < ids.size(); ++ii ) {
+      DOCTEST_CHECK( paged[ ids[ ii ]] == ii );
+      DOCTEST_CHECK( paged[ ids[ ii ] + 1 ] == dip::ObjectIdToIndexTable::NOT_FOUND );
+   }
+   // IDs too large for a table: sorted list
+   ids.push_back( std::numeric_limits< dip::uint >::max() - 1 );
+   dip::ObjectIdToIndexTable sparse( ids );
+   for( dip::uint ii = 0; ii < ids.size(); ++ii ) {
+      DOCTEST_CHECK( sparse[ ids[ ii ]] == ii );
+      DOCTEST_CHECK( sparse[ ids[ ii ] + 1 ] == dip::ObjectIdToIndexTable::NOT_FOUND );
+   }
+   DOCTEST_CHECK( sparse[ 0 ] == dip::ObjectIdToIndexTable::NOT_FOUND );
+}
+
+#endif // DIP__ENABLE_DOCTEST
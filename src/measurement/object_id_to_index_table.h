@@ -0,0 +1,141 @@
+/*
+ * DIPlib 3.0
+ * This file defines a look-up table that maps object IDs to object indices
+ *
+ * (c)2026, Cris Luengo.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DIP_OBJECT_ID_TO_INDEX_TABLE_H
+#define DIP_OBJECT_ID_TO_INDEX_TABLE_H
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include "diplib.h"
+
+
+namespace dip {
+
+// Maps object IDs (labels) to object indices, for fast look-up while scanning a labeled image. This replaces
+// the look-up in the `dip::ObjectIdToIndexMap` (a `std::map`) in the inner loops.
+//
+// The representation is chosen from the number of objects and the largest object ID, before anything is
+// allocated. The memory budget is 16 entries per object, but at least `maxDenseSize` entries:
+//  - If the largest object ID fits in the budget, a dense table indexed by object ID is used.
+//  - Otherwise, the object IDs are divided into pages of `pageSize` consecutive values, and only pages that
+//    contain at least one of the object IDs are allocated. This is used if the directory of pages and the
+//    allocated pages together fit in the budget.
+//  - Otherwise (e.g. very few objects with very large IDs), a sorted list of object IDs is searched.
+//
+// The object index is the position of the ID in the array given to the constructor. Repeated IDs in that array
+// map to the index of their first occurrence.
+class ObjectIdToIndexTable {
+   public:
+      // Value returned for object IDs not in the table.
+      static constexpr uint32 NOT_FOUND = std::numeric_limits< uint32 >::max();
+
+      explicit ObjectIdToIndexTable( UnsignedArray const& objectIDs ) {
+         dip::uint nObjects = objectIDs.size();
+         DIP_THROW_IF( nObjects >= NOT_FOUND, "Too many objects" );
+         dip::uint maxID = 0;
+         for( auto id : objectIDs ) {
+            maxID = std::max( maxID, id );
+         }
+         dip::uint budget = std::max( 16 * nObjects, maxDenseSize );
+         if( maxID < budget ) {
+            mode_ = Mode::DENSE;
+            table_.resize( maxID + 1, NOT_FOUND );
+            for( dip::uint ii = nObjects; ii > 0; ) { // backwards, so that the first occurrence wins
+               --ii;
+               table_[ objectIDs[ ii ]] = static_cast< uint32 >( ii );
+            }
+            return;
+         }
+         dip::uint directorySize = ( maxID >> pageBits ) + 1;
+         if( directorySize < budget ) {
+            // Count the pages needed, the directory is only allocated if they fit in the budget
+            std::vector< dip::uint > pages( nObjects );
+            for( dip::uint ii = 0; ii < nObjects; ++ii ) {
+               pages[ ii ] = objectIDs[ ii ] >> pageBits;
+            }
+            std::sort( pages.begin(), pages.end() );
+            dip::uint nPages = static_cast< dip::uint >( std::unique( pages.begin(), pages.end() ) - pages.begin() );
+            if( directorySize + nPages * pageSize <= budget ) {
+               mode_ = Mode::PAGED;
+               directory_.resize( directorySize, NOT_FOUND );
+               for( dip::uint ii = 0; ii < nPages; ++ii ) {
+                  directory_[ pages[ ii ]] = static_cast< uint32 >( ii * pageSize );
+               }
+               table_.resize( nPages * pageSize, NOT_FOUND );
+               for( dip::uint ii = nObjects; ii > 0; ) { // backwards, so that the first occurrence wins
+                  --ii;
+                  table_[ directory_[ objectIDs[ ii ] >> pageBits ] + ( objectIDs[ ii ] & pageMask ) ] = static_cast< uint32 >( ii );
+               }
+               return;
+            }
+         }
+         mode_ = Mode::SORTED;
+         sorted_.resize( nObjects );
+         for( dip::uint ii = 0; ii < nObjects; ++ii ) {
+            sorted_[ ii ] = { objectIDs[ ii ], static_cast< uint32 >( ii ) };
+         }
+         std::stable_sort( sorted_.begin(), sorted_.end(), []( IdIndex const& a, IdIndex const& b ) { return a.id < b.id; } );
+      }
+
+      // Returns the object index for `objectID`, or `NOT_FOUND`.
+      uint32 operator[]( dip::uint objectID ) const {
+         switch( mode_ ) {
+            case Mode::DENSE:
+               return objectID < table_.size() ? table_[ objectID ] : NOT_FOUND;
+            case Mode::PAGED: {
+               dip::uint page = objectID >> pageBits;
+               if(( page >= directory_.size() ) || ( directory_[ page ] == NOT_FOUND )) {
+                  return NOT_FOUND;
+               }
+               return table_[ directory_[ page ] + ( objectID & pageMask ) ];
+            }
+            default: { // Mode::SORTED
+               auto it = std::lower_bound( sorted_.begin(), sorted_.end(), objectID, []( IdIndex const& a, dip::uint id ) { return a.id < id; } );
+               if(( it == sorted_.end() ) || ( it->id != objectID )) {
+                  return NOT_FOUND;
+               }
+               return it->index;
+            }
+         }
+      }
+
+   private:
+      static constexpr dip::uint pageBits = 10;
+      static constexpr dip::uint pageSize = 1u << pageBits;
+      static constexpr dip::uint pageMask = pageSize - 1;
+      static constexpr dip::uint maxDenseSize = 1u << 20; // a 4 MB table is always OK
+
+      enum class Mode { DENSE, PAGED, SORTED };
+
+      struct IdIndex {
+         dip::uint id;
+         uint32 index;
+      };
+
+      Mode mode_;
+      std::vector< uint32 > directory_; // offset into `table_` for each page, or `NOT_FOUND`
+      std::vector< uint32 > table_;     // object indices, dense or in pages
+      std::vector< IdIndex > sorted_;   // used instead of the above if the object IDs are too sparse
+};
+
+} // namespace dip
+
+#endif // DIP_OBJECT_ID_TO_INDEX_TABLE_H
@@ -26,6 +26,7 @@
 #include "diplib/framework.h"
 #include "diplib/overload.h"
 #include "diplib/library/copy_buffer.h"
+#include "../library/multiversion.h"
 
 namespace dip {
 
@@ -72,6 +73,10 @@ class DilationErosionLineFilter : public Framework::SeparableLineFilter {
          return lineLength * 6; // 3 comparisons, 3 iterations
       }
       virtual void Filter( Framework::SeparableLineFilterParameters const& params ) override {
+         CallMultiversioned( [ & ]() { FilterLine( params ); } );
+      }
+   private:
+      void FilterLine( Framework::SeparableLineFilterParameters const& params ) {
          TPI* in = static_cast< TPI* >( params.inBuffer.buffer );
          dip::uint length = params.inBuffer.length;
          dip::sint inStride = params.inBuffer.stride;
@@ -288,7 +293,7 @@ class DilationErosionLineFilter : public Framework::SeparableLineFilter {
             }
          }
       }
-   private:
+
       UnsignedArray const& filterLengths_;
       bool mirror_;
       dip::uint maxSize_;
@@ -28,15 +28,36 @@
 #include "diplib/framework.h"
 #include "diplib/overload.h"
 #include "diplib/pixel_table.h"
+#include "diplib/multithreading.h"
 
 namespace dip {
 
 namespace {
 
+// Computes one Perona-Malik update for the pixel at `in`. The neighbors are given by `offsets`. Both the line
+// filter and the temporally blocked implementation call this function, so that they produce identical results.
+template< typename F >
+inline sfloat PeronaMalikUpdate( F const& g, sfloat lambda, sfloat const* in, std::vector< dip::sint > const& offsets ) {
+   sfloat delta = 0;
+   for( auto offset : offsets ) {
+      sfloat diff = in[ offset ] - in[ 0 ];
+      delta += g( diff ) * diff;
+   }
+   return *in + lambda * delta;
+}
+
+// Sorts the neighbor offsets such that the order in which the terms are summed does not depend on the processing
+// dimension: by increasing stride, with the negative offset before the positive one.
+inline void SortNeighborOffsets( std::vector< dip::sint >& offsets ) {
+   std::sort( offsets.begin(), offsets.end(), []( dip::sint a, dip::sint b ) {
+      return ( std::abs( a ) < std::abs( b )) || (( std::abs( a ) == std::abs( b )) && ( a < b ));
+   } );
+}
+
 template< typename F >
 class PeronaMalikLineFilter : public Framework::FullLineFilter {
    public:
-      PeronaMalikLineFilter( F g, dip::uint cost, sfloat lambda ) : g_( std::move( g )), cost_( cost ), lambda_( lambda ) {}
+      PeronaMalikLineFilter( F const& g, dip::uint cost, sfloat lambda ) : g_( g ), cost_( cost ), lambda_( lambda ) {}
       virtual dip::uint GetNumberOfOperations( dip::uint lineLength, dip::uint, dip::uint, dip::uint ) override {
          return cost_ * lineLength;
       }
@@ -47,40 +68,254 @@ class PeronaMalikLineFilter : public Framework::FullLineFilter {
          dip::sint outStride = params.outBuffer.stride;
          dip::uint length = params.bufferLength;
          dip::uint nDims = params.pixelTable.Dimensionality();
-         std::vector< PixelTableOffsets::PixelRun > pixelTableRuns = params.pixelTable.Runs(); // copy!
+         std::vector< PixelTableOffsets::PixelRun > const& pixelTableRuns = params.pixelTable.Runs();
          // The pixel table has `(nDims-1)*2+1` runs of length 1, and 1 run of length 3:
          DIP_ASSERT( pixelTableRuns.size() == ( nDims - 1 ) * 2 + 1 );
-         for( dip::uint ii = 0; ii < ( nDims - 1 ) * 2 + 1; ++ii ) {
-            if( pixelTableRuns[ ii ].length == 3 ) {
-               //DIP_ASSERT( pixelTableRuns[ ii ].offset == -inStride );
-               pixelTableRuns[ ii ].length = 1; // the run should have a length of 1
-               pixelTableRuns.push_back( { -pixelTableRuns[ ii ].offset, 1 } ); // add another run of length one to the other side
-            //} else {
-               //DIP_ASSERT( pixelTableRuns[ ii ].length == 1 );
+         std::vector< dip::sint > offsets;
+         offsets.reserve( nDims * 2 );
+         for( auto const& run : pixelTableRuns ) {
+            if( run.length == 3 ) {
+               offsets.push_back( run.offset ); // the run should have a length of 1
+               offsets.push_back( -run.offset ); // add another run of length one to the other side
+            } else if( run.offset != 0 ) {
+               offsets.push_back( run.offset );
             }
          }
-         //DIP_ASSERT( pixelTableRuns.size() == nDims * 2 );
-         // Now the pixel table has `2*nDims` runs, one for each neighbor. The `offset` is the address of the neighbor.
+         // Now we have `2*nDims` offsets, one for each neighbor.
+         SortNeighborOffsets( offsets );
          for( dip::uint ii = 0; ii < length; ++ii ) {
-            sfloat delta = 0;
-            for( auto run : pixelTableRuns ) {
-               sfloat diff = in[ run.offset ] - in[ 0 ];
-               delta += g_( diff ) * diff;
-            }
-            *out = *in + lambda_ * delta;
+            *out = PeronaMalikUpdate( g_, lambda_, in, offsets );
             in += inStride;
             out += outStride;
          }
       }
    private:
-      F g_;
+      F const& g_;
       dip::uint cost_;
       sfloat lambda_;
 };
 
+// Number of iterations computed per tile in the temporally blocked implementation, and the number of pixels in the
+// tile buffer we aim for (two buffers of this size should fit comfortably in the L2 cache).
+constexpr dip::uint peronaMalikBlockIterations2D = 8;
+constexpr dip::uint peronaMalikBlockIterationsND = 4;
+constexpr dip::uint peronaMalikTileBufferSize = 32768;
+
+// Calls `function( offset, length )` for each line along dimension 0 within the box [`lower`,`upper`) of a
+// buffer with normal strides `strides`. Coordinates are w.r.t. the buffer's origin.
+template< typename Function >
+void ForEachLineInBox( IntegerArray const& lower, IntegerArray const& upper, IntegerArray const& strides, Function function ) {
+   dip::uint nDims = lower.size();
+   for( dip::uint ii = 0; ii < nDims; ++ii ) {
+      if( lower[ ii ] >= upper[ ii ] ) {
+         return;
+      }
+   }
+   IntegerArray pos = lower;
+   dip::uint length = static_cast< dip::uint >( upper[ 0 ] - lower[ 0 ] );
+   while( true ) {
+      dip::sint offset = 0;
+      for( dip::uint ii = 0; ii < nDims; ++ii ) {
+         offset += pos[ ii ] * strides[ ii ];
+      }
+      function( offset, length );
+      dip::uint dd = 1;
+      for( ; dd < nDims; ++dd ) {
+         ++pos[ dd ];
+         if( pos[ dd ] < upper[ dd ] ) {
+            break;
+         }
+         pos[ dd ] = lower[ dd ];
+      }
+      if( dd == nDims ) {
+         break;
+      }
+   }
+}
+
+// Applies `iterations` Perona-Malik iterations to `in`, writing the result to `out`. The image is divided into
+// tiles. For each tile, a buffer that includes a halo of `iterations` pixels is processed for all iterations,
+// then the central part is written to `out`. In each iteration, the computed region shrinks by one pixel
+// (except at the image boundary), such that the central part always contains correct values. Tiles are
+// processed in parallel.
+// `in` and `out` are SFLOAT images that do not alias each other. The boundary condition is "add zeros".
+template< typename F >
+void PeronaMalikTemporalBlock(
+      Image const& in,
+      Image& out,
+      dip::uint iterations,
+      F const& g,
+      dip::uint cost,
+      sfloat lambda
+) {
+   UnsignedArray const& sizes = in.Sizes();
+   dip::uint nDims = sizes.size();
+   dip::sint halo = static_cast< dip::sint >( iterations );
+   // Determine the tile sizes
+   dip::uint edge = static_cast< dip::uint >( std::pow( static_cast< dfloat >( peronaMalikTileBufferSize ), 1.0 / static_cast< dfloat >( nDims )));
+   edge = std::max( edge, 2 * iterations + 4 ) - 2 * iterations;
+   UnsignedArray tileSizes( nDims );
+   UnsignedArray nTiles( nDims );
+   dip::uint totalTiles = 1;
+   for( dip::uint ii = 0; ii < nDims; ++ii ) {
+      tileSizes[ ii ] = std::min( edge, sizes[ ii ] );
+      nTiles[ ii ] = div_ceil( sizes[ ii ], tileSizes[ ii ] );
+      totalTiles *= nTiles[ ii ];
+   }
+   // Determine the number of threads
+   dip::uint nThreads = std::min( GetNumberOfThreads(), totalTiles );
+   if( in.NumberOfPixels() * cost * iterations < threadingThreshold ) {
+      nThreads = 1;
+   }
+   sfloat const* inOrigin = static_cast< sfloat const* >( in.Origin() );
+   IntegerArray const& inStrides = in.Strides();
+   sfloat* outOrigin = static_cast< sfloat* >( out.Origin() );
+   IntegerArray const& outStrides = out.Strides();
+
+   #pragma omp parallel num_threads( static_cast< int >( nThreads ))
+   {
+      std::vector< sfloat > buffer1;
+      std::vector< sfloat > buffer2;
+      IntegerArray tileLower( nDims );
+      IntegerArray tileUpper( nDims );
+      IntegerArray bufferLower( nDims );
+      IntegerArray bufferSizes( nDims );
+      IntegerArray bufferStrides( nDims );
+      IntegerArray lower( nDims );
+      IntegerArray upper( nDims );
+      std::vector< dip::sint > offsets( nDims * 2 );
+      #pragma omp for schedule( dynamic )
+      for( dip::sint tile = 0; tile < static_cast< dip::sint >( totalTiles ); ++tile ) {
+         // Find the tile's box, and the buffer's box, which has an extra row of zeros at the image boundary
+         dip::uint index = static_cast< dip::uint >( tile );
+         dip::uint bufferSize = 1;
+         for( dip::uint ii = 0; ii < nDims; ++ii ) {
+            dip::sint size = static_cast< dip::sint >( sizes[ ii ] );
+            tileLower[ ii ] = static_cast< dip::sint >(( index % nTiles[ ii ] ) * tileSizes[ ii ] );
+            tileUpper[ ii ] = std::min( tileLower[ ii ] + static_cast< dip::sint >( tileSizes[ ii ] ), size );
+            index /= nTiles[ ii ];
+            bufferLower[ ii ] = std::max( tileLower[ ii ] - halo, dip::sint( -1 ));
+            bufferSizes[ ii ] = std::min( tileUpper[ ii ] + halo, size + 1 ) - bufferLower[ ii ];
+            bufferStrides[ ii ] = static_cast< dip::sint >( bufferSize );
+            bufferSize *= static_cast< dip::uint >( bufferSizes[ ii ] );
+         }
+         for( dip::uint ii = 0; ii < nDims; ++ii ) {
+            offsets[ 2 * ii ] = -bufferStrides[ ii ];
+            offsets[ 2 * ii + 1 ] = bufferStrides[ ii ];
+         }
+         SortNeighborOffsets( offsets );
+         // Copy the input into the buffer, pixels outside the image are 0
+         buffer1.assign( bufferSize, 0.0f );
+         for( dip::uint ii = 0; ii < nDims; ++ii ) {
+            lower[ ii ] = std::max( -bufferLower[ ii ], dip::sint( 0 ));
+            upper[ ii ] = std::min( static_cast< dip::sint >( sizes[ ii ] ) - bufferLower[ ii ], bufferSizes[ ii ] );
+         }
+         ForEachLineInBox( lower, upper, bufferStrides, [ & ]( dip::sint offset, dip::uint length ) {
+            dip::sint inOffset = 0;
+            dip::sint bufferOffset = offset;
+            for( dip::uint ii = nDims - 1; ii > 0; --ii ) {
+               inOffset += ( bufferOffset / bufferStrides[ ii ] + bufferLower[ ii ] ) * inStrides[ ii ];
+               bufferOffset %= bufferStrides[ ii ];
+            }
+            inOffset += ( bufferOffset + bufferLower[ 0 ] ) * inStrides[ 0 ];
+            sfloat const* inPtr = inOrigin + inOffset;
+            sfloat* bufPtr = buffer1.data() + offset;
+            for( dip::uint jj = 0; jj < length; ++jj, inPtr += inStrides[ 0 ] ) {
+               bufPtr[ jj ] = *inPtr;
+            }
+         } );
+         buffer2 = buffer1;
+         // Iterate
+         for( dip::sint iter = 1; iter <= halo; ++iter ) {
+            for( dip::uint ii = 0; ii < nDims; ++ii ) {
+               // At the image boundary we compute all pixels, elsewhere we shrink the region by one pixel every iteration.
+               lower[ ii ] = bufferLower[ ii ] < 0 ? 1 : iter;
+               upper[ ii ] = bufferLower[ ii ] + bufferSizes[ ii ] > static_cast< dip::sint >( sizes[ ii ] )
+                             ? bufferSizes[ ii ] - 1 : bufferSizes[ ii ] - iter;
+            }
+            sfloat const* src = buffer1.data();
+            sfloat* dest = buffer2.data();
+            ForEachLineInBox( lower, upper, bufferStrides, [ & ]( dip::sint offset, dip::uint length ) {
+               for( dip::uint jj = 0; jj < length; ++jj ) {
+                  dest[ offset + static_cast< dip::sint >( jj ) ] = PeronaMalikUpdate( g, lambda, src + offset + static_cast< dip::sint >( jj ), offsets );
+               }
+            } );
+            buffer1.swap( buffer2 );
+         }
+         // Copy the central part of the buffer to the output
+         for( dip::uint ii = 0; ii < nDims; ++ii ) {
+            lower[ ii ] = tileLower[ ii ] - bufferLower[ ii ];
+            upper[ ii ] = tileUpper[ ii ] - bufferLower[ ii ];
+         }
+         ForEachLineInBox( lower, upper, bufferStrides, [ & ]( dip::sint offset, dip::uint length ) {
+            dip::sint outOffset = 0;
+            dip::sint bufferOffset = offset;
+            for( dip::uint ii = nDims - 1; ii > 0; --ii ) {
+               outOffset += ( bufferOffset / bufferStrides[ ii ] + bufferLower[ ii ] ) * outStrides[ ii ];
+               bufferOffset %= bufferStrides[ ii ];
+            }
+            outOffset += ( bufferOffset + bufferLower[ 0 ] ) * outStrides[ 0 ];
+            sfloat* outPtr = outOrigin + outOffset;
+            sfloat const* bufPtr = buffer1.data() + offset;
+            for( dip::uint jj = 0; jj < length; ++jj, outPtr += outStrides[ 0 ] ) {
+               *outPtr = bufPtr[ jj ];
+            }
+         } );
+      }
+   }
+}
+
 template< typename F >
-inline std::unique_ptr< Framework::FullLineFilter > NewPeronaMalikLineFilter( F g, dip::uint cost, sfloat lambda ) {
-   return static_cast< std::unique_ptr< Framework::FullLineFilter >>( new PeronaMalikLineFilter< F >( std::move( g ), cost, lambda ));
+void PeronaMalikIterations(
+      Image const& c_in,
+      Image& out,
+      dip::uint iterations,
+      F const& g,
+      dip::uint cost,
+      sfloat lambda
+) {
+   if( iterations == 1 ) {
+      // A single iteration is applied through the full framework.
+      PeronaMalikLineFilter< F > lineFilter( g, cost, lambda );
+      BoundaryConditionArray bc( c_in.Dimensionality(), BoundaryCondition::ADD_ZEROS );
+      Kernel kernel( Kernel::ShapeCode::DIAMOND, { 3 } );
+      Framework::Full( c_in, out, DT_SFLOAT, DT_SFLOAT, DT_SFLOAT, 1, bc, kernel, lineFilter, Framework::FullOption::AsScalarImage );
+      return;
+   }
+   // Multiple iterations are computed in blocks of `blockIterations` iterations, each block is a pass over
+   // the image, ping-ponging between `out` and `tmp`.
+   Image in = c_in.QuickCopy();
+   if(( in.DataType() != DT_SFLOAT ) || in.Aliases( out )) {
+      in = Image();
+      in.Copy( c_in );
+      in.Convert( DT_SFLOAT );
+   }
+   PixelSize pixelSize = c_in.PixelSize();
+   out.ReForge( in, DT_SFLOAT, Option::AcceptDataTypeChange::DO_ALLOW );
+   Image result;
+   if( out.DataType() == DT_SFLOAT ) {
+      result = out.QuickCopy();
+   } else {
+      result.ReForge( in, DT_SFLOAT ); // `out` is protected with a different data type
+   }
+   dip::uint blockIterations = in.Dimensionality() <= 2 ? peronaMalikBlockIterations2D : peronaMalikBlockIterationsND;
+   dip::uint nBlocks = div_ceil( iterations, blockIterations );
+   Image tmp;
+   if( nBlocks > 1 ) {
+      tmp.ReForge( in, DT_SFLOAT );
+   }
+   Image const* src = &in;
+   for( dip::uint ii = 0; ii < nBlocks; ++ii ) {
+      // The last block writes to `result`
+      Image& dest = (( nBlocks - 1 - ii ) & 1 ) ? tmp : result;
+      dip::uint blockSize = std::min( blockIterations, iterations - ii * blockIterations );
+      PeronaMalikTemporalBlock( *src, dest, blockSize, g, cost, lambda );
+      src = &dest;
+   }
+   if( !out.IsIdenticalView( result )) {
+      out.Copy( result );
+   }
+   out.SetPixelSize( pixelSize );
 }
 
 } // namespace
@@ -100,35 +335,24 @@ void PeronaMalikDiffusion(
    DIP_THROW_IF( K <= 0.0, E::PARAMETER_OUT_OF_RANGE );
    DIP_THROW_IF(( lambda <= 0.0 ) || ( lambda > 1.0 ), E::PARAMETER_OUT_OF_RANGE );
 
-   // Create a line filter for the scan framework that applies `g`.
-   std::unique_ptr< Framework::FullLineFilter > lineFilter;
+   // Apply the iterations with the selected `g`.
    sfloat fK = static_cast< sfloat >( K );
+   sfloat fL = static_cast< sfloat >( lambda );
    if( g == "Gauss" ) {
-      lineFilter = NewPeronaMalikLineFilter(
-            [ fK ]( sfloat v ) { v /= fK; return std::exp( -v * v ); },
-            20, static_cast< sfloat >( lambda ));
+      auto func = [ fK ]( sfloat v ) { v /= fK; return std::exp( -v * v ); };
+      DIP_STACK_TRACE_THIS( PeronaMalikIterations( in, out, iterations, func, 20, fL ));
    } else if( g == "quadratic") {
-      lineFilter = NewPeronaMalikLineFilter(
-            [ fK ]( sfloat v ) { v /= fK; return 1.0f / ( 1.0f + ( v * v )); },
-            4, static_cast< sfloat >( lambda ));
+      auto func = [ fK ]( sfloat v ) { v /= fK; return 1.0f / ( 1.0f + ( v * v )); };
+      DIP_STACK_TRACE_THIS( PeronaMalikIterations( in, out, iterations, func, 4, fL ));
    } else if( g == "exponential") {
-      lineFilter = NewPeronaMalikLineFilter(
-            [ fK ]( sfloat v ) { v /= fK; return std::exp( -std::abs( v )); },
-            20, static_cast< sfloat >( lambda ));
+      auto func = [ fK ]( sfloat v ) { v /= fK; return std::exp( -std::abs( v )); };
+      DIP_STACK_TRACE_THIS( PeronaMalikIterations( in, out, iterations, func, 20, fL ));
    } else if( g == "Tukey") {
-      lineFilter = NewPeronaMalikLineFilter(
-            [ fK ]( sfloat v ) { v /= fK; return std::abs( v ) < 1.0f ? ( 1 - ( v * v )) * ( 1 - ( v * v )) : 0.0f; },
-            6, static_cast< sfloat >( lambda ));
+      auto func = [ fK ]( sfloat v ) { v /= fK; return std::abs( v ) < 1.0f ? ( 1 - ( v * v )) * ( 1 - ( v * v )) : 0.0f; };
+      DIP_STACK_TRACE_THIS( PeronaMalikIterations( in, out, iterations, func, 6, fL ));
    } else {
       DIP_THROW_INVALID_FLAG( g );
    }
-
-   // Each iteration is applied to `out`.
-   BoundaryConditionArray bc( in.Dimensionality(), BoundaryCondition::ADD_ZEROS );
-   Kernel kernel( Kernel::ShapeCode::DIAMOND, { 3 } );
-   for( dip::uint ii = 0; ii < iterations; ++ii ) {
-      Framework::Full( ii == 0 ? in : out, out, DT_SFLOAT, DT_SFLOAT, DT_SFLOAT, 1, bc, kernel, *lineFilter, Framework::FullOption::AsScalarImage );
-   }
 }
 
 namespace {
@@ -358,3 +582,25 @@ void CoherenceEnhancingDiffusion(
 }
 
 } // namespace dip
+
+#ifdef DIP__ENABLE_DOCTEST
+#include "doctest.h"
+#include "diplib/generation.h"
+#include "diplib/testing.h"
+
+DOCTEST_TEST_CASE("[DIPlib] testing the temporally blocked dip::PeronaMalikDiffusion") {
+   dip::Random random( 0 );
+   for( auto const& sizes : { dip::UnsignedArray{ 300, 200 }, dip::UnsignedArray{ 50, 40, 30 } } ) {
+      dip::Image img{ sizes, 1, dip::DT_SFLOAT };
+      img.Fill( 50.0 );
+      dip::UniformNoise( img, img, random, 0.0, 100.0 );
+      dip::Image blocked = dip::PeronaMalikDiffusion( img, 11, 10.0, 0.2, "quadratic" );
+      dip::Image iterated = img.Copy();
+      for( dip::uint ii = 0; ii < 11; ++ii ) {
+         iterated = dip::PeronaMalikDiffusion( iterated, 1, 10.0, 0.2, "quadratic" );
+      }
+      DOCTEST_CHECK( dip::testing::CompareImages( blocked, iterated ));
+   }
+}
+
+#endif // DIP__ENABLE_DOCTEST
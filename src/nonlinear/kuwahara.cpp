@@ -23,7 +23,6 @@
 #include "diplib/linear.h"
 #include "diplib/math.h"
 #include "diplib/framework.h"
-#include "diplib/generic_iterators.h"
 #include "diplib/pixel_table.h"
 #include "diplib/overload.h"
 
@@ -31,70 +30,227 @@ namespace dip {
 
 namespace {
 
-struct SelectionLineFilterParameters {
-   void const* inBuffer;
-   dfloat const* controlBuffer;
-   void* outBuffer;
-   dip::sint inStride;
-   dip::sint inTensorStride; // == 1
-   dip::sint controlStride;
-   dip::sint outStride;
-   dip::sint outTensorStride;
-   dip::uint tensorLength;
-   dip::uint bufferLength;
-   std::vector< dip::sint > const& pixelTableOffsets;
-   std::vector< dfloat > const& pixelTableWeights;
-   dfloat threshold;
-   bool minimum;
-};
-
-class SelectionLineFilterBase {
-   public:
-      virtual void Filter( SelectionLineFilterParameters const& params ) = 0;
-};
+// Kernels with shorter pixel table runs on average are processed by brute force. Experimentally determined.
+constexpr dip::uint minimumAverageRunLength = 8;
 
 template< typename TPI >
-class SelectionLineFilter : public SelectionLineFilterBase {
+class SelectionLineFilter : public Framework::FullLineFilter {
    public:
-      virtual void Filter( SelectionLineFilterParameters const& params ) override {
-         TPI const* in = static_cast< TPI const* >( params.inBuffer );
-         dfloat const* control = params.controlBuffer;
-         TPI* out = static_cast< TPI* >( params.outBuffer );
-         // For each pixel on the line:
-         for( dip::uint ii = 0; ii < params.bufferLength; ++ii ) {
-            // Iterate over the pixel table and find optimal offset
-            auto it = params.pixelTableOffsets.begin();
-            auto d = params.pixelTableWeights.begin();
-            dfloat centerValue = *control;
-            dfloat bestValue = params.minimum ? std::numeric_limits< dfloat >::max() : std::numeric_limits< dfloat >::lowest();
-            dfloat bestDistance = std::numeric_limits< dfloat >::max();
-            dip::sint bestOffset = 0;
-            do {
-               dfloat value = control[ *it ];
-               if(( params.minimum ? ( value < bestValue ) : ( value > bestValue )) ||
-                     (( value == bestValue ) && ( *d < bestDistance ))) {
-                  bestValue = value;
-                  bestDistance = *d;
-                  bestOffset = *it;
+      // `in` is the input image with its boundary already extended, the framework takes care of `control`.
+      SelectionLineFilter( Image const& in, Kernel const& kernel, dfloat threshold, bool minimum )
+            : in_( in ), kernel_( kernel ), threshold_( threshold ), minimum_( minimum ) {}
+      virtual dip::uint GetNumberOfOperations( dip::uint lineLength, dip::uint nTensorElements, dip::uint nKernelPixels, dip::uint nRuns ) override {
+         dip::uint averageRunLength = div_ceil( nKernelPixels, nRuns );
+         if( averageRunLength < minimumAverageRunLength ) {
+            return lineLength * ( nKernelPixels * 4 + nRuns + nTensorElements );
+         }
+         return lineLength * ( nRuns * 8 + nTensorElements );
+      }
+      virtual void SetNumberOfThreads( dip::uint threads, PixelTableOffsets const& pixelTable ) override {
+         // The framework's pixel table indexes into the `control` buffer. We build the same table for `in`, with
+         // the distances to the origin as weights. The two tables list the pixels in the same order.
+         PixelTable inTable = kernel_.PixelTable( in_.Dimensionality(), pixelTable.ProcessingDimension() );
+         inTable.AddDistanceToOriginAsWeights();
+         PixelTableOffsets inTableOffsets = inTable.Prepare( in_ );
+         DIP_ASSERT( inTableOffsets.Runs().size() == pixelTable.Runs().size() );
+         inOffsets_ = inTableOffsets.Offsets();
+         weights_ = inTableOffsets.Weights();
+         inStride_ = in_.Stride( pixelTable.ProcessingDimension() );
+         dip::uint averageRunLength = div_ceil( pixelTable.NumberOfPixels(), pixelTable.Runs().size() );
+         bruteForce_ = averageRunLength < minimumAverageRunLength;
+         if( bruteForce_ ) {
+            offsets_ = pixelTable.Offsets();
+         } else {
+            // Each run gets a circular buffer with a power of two size, at least as large as the run.
+            dip::uint nRuns = pixelTable.Runs().size();
+            runs_.resize( nRuns );
+            dip::uint firstPixel = 0;
+            dip::uint bufferSize = 0;
+            for( dip::uint ii = 0; ii < nRuns; ++ii ) {
+               RunInfo& run = runs_[ ii ];
+               run.controlOffset = pixelTable.Runs()[ ii ].offset;
+               run.inOffset = inTableOffsets.Runs()[ ii ].offset;
+               run.length = pixelTable.Runs()[ ii ].length;
+               run.firstPixel = firstPixel;
+               firstPixel += run.length;
+               dip::uint size = 1;
+               while( size < run.length ) {
+                  size <<= 1;
                }
-               ++it;
-               ++d;
-            } while( it != params.pixelTableOffsets.end() );
-            if( params.minimum ? bestValue + params.threshold < centerValue
-                               : bestValue - params.threshold > centerValue ) {
-               bestOffset *= static_cast< dip::sint >( params.tensorLength );
-            } else {
-               bestOffset = 0;
+               run.bufferStart = bufferSize;
+               run.bufferMask = size - 1;
+               bufferSize += size;
             }
-            // Copy the tensor at that offset over the the output
-            out[ 0 ] = in[ bestOffset ];
-            for( dip::sint jj = 1; jj < static_cast< dip::sint >( params.tensorLength ); ++jj ) {
-               out[ jj * params.outTensorStride ] = in[ bestOffset + jj * params.inTensorStride ];
+            buffers_.resize( threads );
+            for( auto& buffer : buffers_ ) {
+               buffer.elements.resize( bufferSize );
+               buffer.queues.resize( nRuns );
             }
-            // Next pixel
-            in += params.inStride;
-            control += params.controlStride;
-            out += params.outStride;
+         }
+      }
+      virtual void Filter( Framework::FullLineFilterParameters const& params ) override {
+         dfloat const* control = static_cast< dfloat const* >( params.inBuffer.buffer );
+         dip::sint controlStride = params.inBuffer.stride;
+         TPI const* in = static_cast< TPI const* >( in_.Pointer( params.position ));
+         dip::sint inTensorStride = in_.TensorStride();
+         TPI* out = static_cast< TPI* >( params.outBuffer.buffer );
+         dip::sint outStride = params.outBuffer.stride;
+         dip::sint outTensorStride = params.outBuffer.tensorStride;
+         dip::uint tensorLength = params.outBuffer.tensorLength;
+         dip::uint length = params.bufferLength;
+         if( bruteForce_ ) {
+            for( dip::uint ii = 0; ii < length; ++ii ) {
+               // Iterate over the pixel table and find optimal offset
+               dfloat bestValue = minimum_ ? std::numeric_limits< dfloat >::max() : std::numeric_limits< dfloat >::lowest();
+               dfloat bestDistance = std::numeric_limits< dfloat >::max();
+               dip::uint bestIndex = offsets_.size(); // none found
+               for( dip::uint jj = 0; jj < offsets_.size(); ++jj ) {
+                  dfloat value = control[ offsets_[ jj ]];
+                  if(( minimum_ ? ( value < bestValue ) : ( value > bestValue )) ||
+                     (( value == bestValue ) && ( weights_[ jj ] < bestDistance ))) {
+                     bestValue = value;
+                     bestDistance = weights_[ jj ];
+                     bestIndex = jj;
+                  }
+               }
+               dip::sint bestOffset = 0;
+               if(( bestIndex < offsets_.size() ) && Selected( bestValue, *control )) {
+                  bestOffset = inOffsets_[ bestIndex ];
+               }
+               CopyTensor( in + bestOffset, inTensorStride, out, outTensorStride, tensorLength );
+               in += inStride_;
+               control += controlStride;
+               out += outStride;
+            }
+            return;
+         }
+         // Each run of the pixel table slides along the line as a 1D window. The extremum of the control image
+         // within each run is tracked with a monotonic queue, so that the cost per pixel depends on the number of
+         // runs rather than the number of pixels in the kernel. The queue keeps equal values, so that its leading
+         // elements are all the pixels in the run with the best value. Among these we find the one closest to the
+         // origin, which yields exactly the same result as the brute force method.
+         // Position `pos` in a run refers to `control[ run.controlOffset + pos * controlStride ]`, with `control`
+         // pointing at the first pixel of the line; the window for pixel `ii` covers positions `ii` through
+         // `ii + run.length - 1`.
+         RunBuffers& buffers = buffers_[ params.thread ];
+         QueueElement* elements = buffers.elements.data();
+         RunQueue* queues = buffers.queues.data();
+         dip::uint nRuns = runs_.size();
+         for( dip::uint rr = 0; rr < nRuns; ++rr ) {
+            RunInfo const& run = runs_[ rr ];
+            QueueElement* queue = elements + run.bufferStart;
+            dip::uint tail = 0;
+            for( dip::uint pos = 0; pos + 1 < run.length; ++pos ) {
+               Push( queue, run.bufferMask, 0, tail, Key( control[ run.controlOffset + static_cast< dip::sint >( pos ) * controlStride ] ), pos );
+            }
+            queues[ rr ].head = 0;
+            queues[ rr ].tail = tail;
+         }
+         dfloat const* lineStart = control;
+         for( dip::uint ii = 0; ii < length; ++ii ) {
+            // Slide the windows and find the best value over all runs
+            dfloat bestKey = std::numeric_limits< dfloat >::infinity();
+            for( dip::uint rr = 0; rr < nRuns; ++rr ) {
+               RunInfo const& run = runs_[ rr ];
+               QueueElement* queue = elements + run.bufferStart;
+               dip::uint mask = run.bufferMask;
+               dip::uint head = queues[ rr ].head;
+               dip::uint tail = queues[ rr ].tail;
+               // The window moves one pixel, at most one position drops out. The queue is only empty for runs
+               // of length 1, the element read in that case is not used.
+               head += ( head != tail ) & ( queue[ head & mask ].position < ii );
+               dip::uint pos = ii + run.length - 1;
+               Push( queue, mask, head, tail, Key( lineStart[ run.controlOffset + static_cast< dip::sint >( pos ) * controlStride ] ), pos );
+               bestKey = std::min( bestKey, queue[ head & mask ].key );
+               queues[ rr ].head = head;
+               queues[ rr ].tail = tail;
+            }
+            dip::sint bestOffset = 0;
+            if(( bestKey != std::numeric_limits< dfloat >::infinity() ) && Selected( minimum_ ? bestKey : -bestKey, *control )) {
+               // Among the pixels with the best value, find the first one closest to the origin
+               dfloat bestDistance = std::numeric_limits< dfloat >::max();
+               for( dip::uint rr = 0; rr < nRuns; ++rr ) {
+                  RunInfo const& run = runs_[ rr ];
+                  QueueElement const* queue = elements + run.bufferStart;
+                  for( dip::uint jj = queues[ rr ].head; ( jj != queues[ rr ].tail ) && ( queue[ jj & run.bufferMask ].key == bestKey ); ++jj ) {
+                     dip::uint pos = queue[ jj & run.bufferMask ].position - ii;
+                     dfloat distance = weights_[ run.firstPixel + pos ];
+                     if( distance < bestDistance ) {
+                        bestDistance = distance;
+                        bestOffset = run.inOffset + static_cast< dip::sint >( pos ) * inStride_;
+                     }
+                  }
+               }
+            }
+            CopyTensor( in + bestOffset, inTensorStride, out, outTensorStride, tensorLength );
+            in += inStride_;
+            control += controlStride;
+            out += outStride;
+         }
+      }
+   private:
+      // Pixel table run, as used by the incremental method
+      struct RunInfo {
+         dip::sint controlOffset;   // offset of the first pixel in the run, in the `control` buffer
+         dip::sint inOffset;        // offset of the first pixel in the run, in `in`
+         dip::uint length;          // length of the run
+         dip::uint firstPixel;      // index into `weights_` of the first pixel in the run
+         dip::uint bufferStart;     // offset into `RunBuffers::elements` of the run's circular buffer
+         dip::uint bufferMask;      // size of the run's circular buffer minus one (the size is a power of two)
+      };
+      // A monotonic queue is stored in a circular buffer of these
+      struct QueueElement {
+         dfloat key;
+         dip::uint position;
+      };
+      struct RunQueue {
+         dip::uint head;
+         dip::uint tail;
+      };
+      // Per-thread buffers for the incremental method
+      struct RunBuffers {
+         std::vector< QueueElement > elements;
+         std::vector< RunQueue > queues;
+      };
+
+      Image const& in_;
+      Kernel const& kernel_;
+      dfloat threshold_;
+      bool minimum_;
+      bool bruteForce_ = true;
+      std::vector< dip::sint > inOffsets_;
+      std::vector< dfloat > weights_;
+      dip::sint inStride_ = 0;
+      std::vector< dip::sint > offsets_;        // for the brute force method
+      std::vector< RunInfo > runs_;             // for the incremental method
+      std::vector< RunBuffers > buffers_;
+
+      bool Selected( dfloat bestValue, dfloat centerValue ) const {
+         return minimum_ ? bestValue + threshold_ < centerValue
+                         : bestValue - threshold_ > centerValue;
+      }
+
+      // The key is minimized. Values that the brute force method would never select map to infinity.
+      dfloat Key( dfloat value ) const {
+         if( minimum_ ) {
+            return value <= std::numeric_limits< dfloat >::max() ? value : std::numeric_limits< dfloat >::infinity();
+         }
+         return value >= std::numeric_limits< dfloat >::lowest() ? -value : std::numeric_limits< dfloat >::infinity();
+      }
+
+      // Adds an element at the back of the queue, removing larger elements before it
+      static void Push( QueueElement* queue, dip::uint mask, dip::uint head, dip::uint& tail, dfloat key, dip::uint position ) {
+         while(( tail != head ) && ( queue[ ( tail - 1 ) & mask ].key > key )) {
+            --tail;
+         }
+         queue[ tail & mask ] = { key, position };
+         ++tail;
+      }
+
+      static void CopyTensor( TPI const* in, dip::sint inTensorStride, TPI* out, dip::sint outTensorStride, dip::uint tensorLength ) {
+         out[ 0 ] = in[ 0 ];
+         for( dip::sint jj = 1; jj < static_cast< dip::sint >( tensorLength ); ++jj ) {
+            out[ jj * outTensorStride ] = in[ jj * inTensorStride ];
          }
       }
 };
@@ -103,97 +259,39 @@ class SelectionLineFilter : public SelectionLineFilterBase {
 
 void SelectionFilter(
       Image const& c_in,
-      Image const& c_control,
+      Image const& control,
       Image& out,
       Kernel const& kernel,
       dfloat threshold,
       String const& mode,
       StringArray const& boundaryCondition
 ) {
-   // We are not using a framework here, because this is the only pixel table filter that uses two input images.
-   // So we've copied things over from Framework::Full, and changed (simplified) them a bit. There's no multi-threading
-   // here yet.
-   // TODO: add multithreading.
-
-   DIP_THROW_IF( !c_in.IsForged() || !c_control.IsForged(), E::IMAGE_NOT_FORGED );
-   DIP_THROW_IF( c_in.Sizes() != c_control.Sizes(), E::SIZES_DONT_MATCH );
-   DIP_THROW_IF( !c_control.IsScalar(), E::IMAGE_NOT_SCALAR );
-   DIP_THROW_IF( !c_control.DataType().IsReal(), E::DATA_TYPE_NOT_SUPPORTED );
+   DIP_THROW_IF( !c_in.IsForged() || !control.IsForged(), E::IMAGE_NOT_FORGED );
+   DIP_THROW_IF( c_in.Sizes() != control.Sizes(), E::SIZES_DONT_MATCH );
+   DIP_THROW_IF( !control.IsScalar(), E::IMAGE_NOT_SCALAR );
+   DIP_THROW_IF( !control.DataType().IsReal(), E::DATA_TYPE_NOT_SUPPORTED );
    DIP_THROW_IF( kernel.HasWeights(), E::KERNEL_NOT_BINARY );
    bool minimum;
    DIP_STACK_TRACE_THIS( minimum = BooleanFromString( mode, S::MINIMUM, S::MAXIMUM ));
 
-   // Determine boundary sizes
-   UnsignedArray kernelSizes;
-   DIP_STACK_TRACE_THIS( kernelSizes = kernel.Sizes( c_in.Dimensionality() ));
-   UnsignedArray boundary = kernel.Boundary( c_in.Dimensionality() );
-
-   // Copy input images with boundary extension
+   // The framework handles the `control` image, we read the pixel values from `in` at the selected offsets.
+   // `in` is copied with boundary extension here, which also means that `out` can alias `c_in`.
+   BoundaryConditionArray bc;
+   DIP_STACK_TRACE_THIS( bc = StringArrayToBoundaryConditionArray( boundaryCondition ));
    Image in;
-   Image control;
-   control.SetDataType( DT_DFLOAT );
-   control.Protect();
    DIP_START_STACK_TRACE
-      BoundaryConditionArray bc = StringArrayToBoundaryConditionArray( boundaryCondition );
+      UnsignedArray boundary = kernel.Boundary( c_in.Dimensionality() );
       ExtendImage( c_in, in, boundary, bc, Option::ExtendImage::Masked );
-      ExtendImage( c_control, control, boundary, bc, Option::ExtendImage::Masked );
    DIP_END_STACK_TRACE
-#ifdef DIP__ENABLE_ASSERT
-   // We have created a new `in` and `control`, so we expect normal strides here. Let's make sure this is the case!
-   DIP_ASSERT( in.TensorStride() == 1 );
-   for( dip::uint ii = 0; ii < in.Dimensionality(); ++ii ) {
-      DIP_ASSERT( in.Stride( ii ) == control.Stride( ii ) * static_cast< dip::sint >( in.TensorElements() ));
-   }
-#endif
 
-   // Adjust output if necessary (and possible)
-   // NOTE: Don't use c_in any more from here on. It has possibly been reforged!
-   DIP_START_STACK_TRACE
-      out.ReForge( in.Sizes(), in.TensorElements(), in.DataType(), Option::AcceptDataTypeChange::DONT_ALLOW );
-      out.ReshapeTensor( in.Tensor() );
-      out.SetPixelSize( in.PixelSize() );
-      if( in.IsColor() ) {
-         out.SetColorSpace( in.ColorSpace() );
-      }
-   DIP_END_STACK_TRACE
-   DIP_ASSERT( in.DataType() == out.DataType() );
-
-   // Create a pixel table suitable to be applied to `input`
-   dip::uint processingDim = Framework::OptimalProcessingDim( in, kernelSizes );
-   PixelTable pixelTable;
-   DIP_STACK_TRACE_THIS( pixelTable = kernel.PixelTable( in.Dimensionality(), processingDim ));
-   pixelTable.AddDistanceToOriginAsWeights();
-   PixelTableOffsets pixelTableOffsets = pixelTable.Prepare( control ); // offsets are for the `control` image, multiply by `in.TensorElements()` to get offsets into `in`.
-
-   // Get the line filter of the right type
-   std::unique_ptr< SelectionLineFilterBase > lineFilter;
-   DIP_OVL_NEW_ALL( lineFilter, SelectionLineFilter, (), in.DataType() );
-
-   // Loop over all image lines
-   SelectionLineFilterParameters params = {
-         nullptr,
-         nullptr,
-         nullptr,
-         in.Stride( processingDim ),
-         in.TensorStride(),
-         control.Stride( processingDim ),
-         out.Stride( processingDim ),
-         out.TensorStride(),
-         in.TensorElements(),
-         in.Size( processingDim ),
-         pixelTableOffsets.Offsets(),
-         pixelTableOffsets.Weights(),
-         threshold,
-         minimum
-   };
-   GenericJointImageIterator< 3 > it( { in, control, out }, processingDim );
-   it.OptimizeAndFlatten();
-   do {
-      params.inBuffer = in.Pointer( it.Offset< 0 >() );
-      params.controlBuffer = static_cast< dfloat* >( control.Pointer( it.Offset< 1 >() ));
-      params.outBuffer = out.Pointer( it.Offset< 2 >() );
-      DIP_STACK_TRACE_THIS( lineFilter->Filter( params ));
-   } while( ++it );
+   std::unique_ptr< Framework::FullLineFilter > lineFilter;
+   DIP_OVL_NEW_ALL( lineFilter, SelectionLineFilter, ( in, kernel, threshold, minimum ), in.DataType() );
+   DIP_STACK_TRACE_THIS( Framework::Full( control, out, DT_DFLOAT, in.DataType(), in.DataType(), in.TensorElements(), bc, kernel, *lineFilter ));
+   out.ReshapeTensor( in.Tensor() );
+   out.SetPixelSize( in.PixelSize() );
+   if( in.IsColor() ) {
+      out.SetColorSpace( in.ColorSpace() );
+   }
 }
 
 void Kuwahara(
@@ -215,3 +313,44 @@ void Kuwahara(
 }
 
 } // namespace dip
+
+
+#ifdef DIP__ENABLE_DOCTEST
+#include "doctest.h"
+#include "diplib/generation.h"
+#include "diplib/morphology.h"
+#include "diplib/statistics.h"
+
+DOCTEST_TEST_CASE("[DIPlib] testing dip::SelectionFilter") {
+   // A kernel with short runs is processed by brute force, one with long runs incrementally
+   dip::Random random( 0 );
+   dip::Image in( { 60, 45 }, 1, dip::DT_SFLOAT );
+   in.Fill( 0 );
+   dip::UniformNoise( in, in, random, 0.0, 100.0 );
+   for( dip::dfloat size : { 3.0, 21.0 } ) {
+      dip::Image out = dip::SelectionFilter( in, in, { size, "rectangular" }, 0.0, dip::S::MINIMUM, { dip::S::ADD_MAX_VALUE } );
+      dip::Image ref = dip::Erosion( in, { size, "rectangular" }, { dip::S::ADD_MAX_VALUE } );
+      DOCTEST_CHECK( dip::Count( out != ref ) == 0 );
+      out = dip::SelectionFilter( in, in, { size, "rectangular" }, 0.0, dip::S::MAXIMUM, { dip::S::ADD_MIN_VALUE } );
+      ref = dip::Dilation( in, { size, "rectangular" }, { dip::S::ADD_MIN_VALUE } );
+      DOCTEST_CHECK( dip::Count( out != ref ) == 0 );
+   }
+   // Ties are solved by picking the pixel closest to the origin
+   dip::Image value( { 11, 11 }, 1, dip::DT_UINT16 );
+   dip::FillXCoordinate( value, { "corner" } );
+   dip::Image control( { 11, 11 }, 1, dip::DT_SFLOAT );
+   control.Fill( 5 );
+   control.At( 8, 5 ) = 1;
+   control.At( 3, 5 ) = 1;
+   control.At( 2, 5 ) = 1;
+   for( dip::String shape : { "diamond", "rectangular" } ) {
+      dip::Image out = dip::SelectionFilter( value, control, { 9, shape } );
+      DOCTEST_CHECK( out.At( 5, 5 ) == 3 );
+      DOCTEST_CHECK( out.At( 5, 4 ) == 3 );
+      DOCTEST_CHECK( out.At( 6, 5 ) == 8 );
+      out = dip::SelectionFilter( value, control, { 9, shape }, 5.0 );
+      DOCTEST_CHECK( out.At( 5, 5 ) == 5 );
+   }
+}
+
+#endif // DIP__ENABLE_DOCTEST
@@ -0,0 +1,244 @@
+/*
+ * DIPlib 3.0
+ * This file contains the definition of the temporal filter for frame sequences.
+ *
+ * (c)2026, Cris Luengo.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+
+#include "diplib.h"
+#include "diplib/frame_sequence.h"
+#include "diplib/framework.h"
+#include "diplib/overload.h"
+
+namespace dip {
+
+namespace {
+
+enum class TemporalMethod {
+      MEAN,
+      MINIMUM,
+      MAXIMUM,
+      PERCENTILE
+};
+
+// Takes all frames in the temporal window as input images, computes one output frame.
+// `current` is the index of the input to subtract the filter result from, if `difference`.
+template< typename TPI >
+class TemporalFilterLineFilter : public Framework::ScanLineFilter {
+   public:
+      TemporalFilterLineFilter( TemporalMethod method, dfloat percentile, bool difference, dip::uint current ) :
+            method_( method ), percentile_( percentile ), difference_( difference ), current_( current ) {}
+      virtual void SetNumberOfThreads( dip::uint threads ) override {
+         buffers_.resize( threads );
+      }
+      virtual dip::uint GetNumberOfOperations( dip::uint nInput, dip::uint, dip::uint ) override {
+         if( method_ == TemporalMethod::PERCENTILE ) {
+            return nInput + 3 * nInput * static_cast< dip::uint >( std::round( std::log( nInput + 1 )));
+         }
+         return nInput;
+      }
+      virtual void Filter( Framework::ScanLineFilterParameters const& params ) override {
+         dip::uint const N = params.inBuffer.size();
+         dip::uint const bufferLength = params.bufferLength;
+         TPI* out = static_cast< TPI* >( params.outBuffer[ 0 ].buffer );
+         dip::sint const outStride = params.outBuffer[ 0 ].stride;
+         if( method_ == TemporalMethod::PERCENTILE ) {
+            std::vector< TPI const* > in( N );
+            for( dip::uint ii = 0; ii < N; ++ii ) {
+               in[ ii ] = static_cast< TPI const* >( params.inBuffer[ ii ].buffer );
+            }
+            std::vector< TPI >& buffer = buffers_[ params.thread ];
+            buffer.resize( N );
+            auto ourGuy = buffer.begin() + round_cast( static_cast< dfloat >( N - 1 ) * percentile_ / 100.0 );
+            for( dip::uint kk = 0; kk < bufferLength; ++kk ) {
+               for( dip::uint ii = 0; ii < N; ++ii ) {
+                  buffer[ ii ] = *in[ ii ];
+                  in[ ii ] += params.inBuffer[ ii ].stride;
+               }
+               std::nth_element( buffer.begin(), ourGuy, buffer.end() );
+               *out = *ourGuy;
+               out += outStride;
+            }
+         } else {
+            // Loop over the frames in the outer loop, so we walk along each input line only once
+            TPI const* in = static_cast< TPI const* >( params.inBuffer[ 0 ].buffer );
+            dip::sint inStride = params.inBuffer[ 0 ].stride;
+            TPI* optr = out;
+            for( dip::uint kk = 0; kk < bufferLength; ++kk, in += inStride, optr += outStride ) {
+               *optr = *in;
+            }
+            for( dip::uint ii = 1; ii < N; ++ii ) {
+               in = static_cast< TPI const* >( params.inBuffer[ ii ].buffer );
+               inStride = params.inBuffer[ ii ].stride;
+               optr = out;
+               switch( method_ ) {
+                  case TemporalMethod::MEAN:
+                     for( dip::uint kk = 0; kk < bufferLength; ++kk, in += inStride, optr += outStride ) {
+                        *optr += *in;
+                     }
+                     break;
+                  case TemporalMethod::MINIMUM:
+                     for( dip::uint kk = 0; kk < bufferLength; ++kk, in += inStride, optr += outStride ) {
+                        *optr = std::min( *optr, *in );
+                     }
+                     break;
+                  default: // TemporalMethod::MAXIMUM
+                     for( dip::uint kk = 0; kk < bufferLength; ++kk, in += inStride, optr += outStride ) {
+                        *optr = std::max( *optr, *in );
+                     }
+                     break;
+               }
+            }
+            if( method_ == TemporalMethod::MEAN ) {
+               TPI const norm = static_cast< TPI >( 1.0 / static_cast< dfloat >( N ));
+               optr = out;
+               for( dip::uint kk = 0; kk < bufferLength; ++kk, optr += outStride ) {
+                  *optr *= norm;
+               }
+            }
+         }
+         if( difference_ ) {
+            TPI const* in = static_cast< TPI const* >( params.inBuffer[ current_ ].buffer );
+            dip::sint const inStride = params.inBuffer[ current_ ].stride;
+            out = static_cast< TPI* >( params.outBuffer[ 0 ].buffer );
+            for( dip::uint kk = 0; kk < bufferLength; ++kk, in += inStride, out += outStride ) {
+               *out = *in - *out;
+            }
+         }
+      }
+   private:
+      TemporalMethod method_;
+      dfloat percentile_;
+      bool difference_;
+      dip::uint current_;
+      std::vector< std::vector< TPI >> buffers_;
+};
+
+} // namespace
+
+void TemporalFilter(
+      FrameSource& source,
+      FrameSink& sink,
+      dip::uint windowLength,
+      String const& method,
+      String const& output,
+      dfloat percentile,
+      dip::uint queueLength
+) {
+   TemporalMethod temporalMethod;
+   if( method == "mean" ) {
+      temporalMethod = TemporalMethod::MEAN;
+   } else if( method == "median" ) {
+      temporalMethod = TemporalMethod::PERCENTILE;
+      percentile = 50.0;
+   } else if( method == "minimum" ) {
+      temporalMethod = TemporalMethod::MINIMUM;
+   } else if( method == "maximum" ) {
+      temporalMethod = TemporalMethod::MAXIMUM;
+   } else if( method == "percentile" ) {
+      DIP_THROW_IF(( percentile < 0.0 ) || ( percentile > 100.0 ), E::PARAMETER_OUT_OF_RANGE );
+      if( percentile == 0.0 ) {
+         temporalMethod = TemporalMethod::MINIMUM;
+      } else if( percentile == 100.0 ) {
+         temporalMethod = TemporalMethod::MAXIMUM;
+      } else {
+         temporalMethod = TemporalMethod::PERCENTILE;
+      }
+   } else {
+      DIP_THROW_INVALID_FLAG( method );
+   }
+   bool difference;
+   DIP_STACK_TRACE_THIS( difference = BooleanFromString( output, "difference", "filtered" ));
+   auto function = [ & ]( ImageConstRefArray const& window, dip::uint current, Image& out ) {
+      Image const& frame = window[ current ].get();
+      DIP_THROW_IF( !frame.IsForged(), E::IMAGE_NOT_FORGED );
+      DIP_THROW_IF( !frame.DataType().IsReal(), E::DATA_TYPE_NOT_SUPPORTED );
+      for( auto const& other : window ) {
+         DIP_THROW_IF( other.get().Sizes() != frame.Sizes(), E::SIZES_DONT_MATCH );
+         DIP_THROW_IF( other.get().TensorElements() != frame.TensorElements(), E::NTENSORELEM_DONT_MATCH );
+      }
+      DataType dataType = frame.DataType();
+      if( difference || ( temporalMethod == TemporalMethod::MEAN )) {
+         dataType = DataType::SuggestFloat( dataType );
+      }
+      std::unique_ptr< Framework::ScanLineFilter > lineFilter;
+      DIP_OVL_NEW_REAL( lineFilter, TemporalFilterLineFilter, ( temporalMethod, percentile, difference, current ), dataType );
+      ImageRefArray outar{ out };
+      DataTypeArray bufferTypes( window.size(), dataType );
+      Framework::Scan( window, outar, bufferTypes, { dataType }, { dataType }, { 1 }, *lineFilter,
+                       Framework::ScanOption::TensorAsSpatialDim + Framework::ScanOption::NoSingletonExpansion );
+   };
+   DIP_STACK_TRACE_THIS( ProcessFrameSequence( source, sink, windowLength, function, queueLength ));
+}
+
+} // namespace dip
+
+
+#ifdef DIP__ENABLE_DOCTEST
+#include "doctest.h"
+#include "diplib/generation.h"
+#include "diplib/math.h"
+#include "diplib/statistics.h"
+#include "diplib/testing.h"
+
+DOCTEST_TEST_CASE("[DIPlib] testing the temporal filter") {
+   dip::Image stack{ dip::UnsignedArray{ 37, 23, 11 }, 1, dip::DT_UINT16 };
+   stack.Fill( 0 );
+   dip::Random random( 0 );
+   dip::UniformNoise( stack, stack, random, 0.0, 1000.0 );
+   dip::uint windowLength = 4;
+   for( auto method : { "mean", "median", "minimum", "maximum" } ) {
+      dip::ImageFrameSource source( stack );
+      dip::Image result;
+      dip::ImageFrameSink sink( result, 11 );
+      dip::TemporalFilter( source, sink, windowLength, method, "difference" );
+      DOCTEST_REQUIRE( sink.NumberOfFrames() == 11 );
+      DOCTEST_CHECK( result.DataType() == dip::DT_SFLOAT );
+      dip::uint before = windowLength / 2;
+      dip::uint after = ( windowLength - 1 ) / 2;
+      for( dip::uint tt = 0; tt < 11; ++tt ) {
+         dip::uint first = tt < before ? 0 : tt - before;
+         dip::uint last = std::min< dip::uint >( tt + after, 10 );
+         dip::Image window = stack.At( dip::Range{}, dip::Range{}, dip::Range{ static_cast< dip::sint >( first ), static_cast< dip::sint >( last ) } );
+         dip::BooleanArray process{ false, false, true };
+         dip::Image expected;
+         if( method == dip::String( "mean" )) {
+            expected = dip::Mean( window, {}, "", process );
+         } else if( method == dip::String( "median" )) {
+            expected = dip::Median( window, {}, process );
+         } else if( method == dip::String( "minimum" )) {
+            expected = dip::Minimum( window, {}, process );
+         } else {
+            expected = dip::Maximum( window, {}, process );
+         }
+         expected = dip::Convert( stack.At( dip::Range{}, dip::Range{}, dip::Range{ static_cast< dip::sint >( tt ) } ), dip::DT_SFLOAT ) - expected;
+         dip::Image frame = result.At( dip::Range{}, dip::Range{}, dip::Range{ static_cast< dip::sint >( tt ) } );
+         DOCTEST_CHECK( dip::MaximumAbsoluteError( frame, expected ) < 1e-3 );
+      }
+   }
+   // Filtered output keeps the data type for order statistics
+   dip::ImageFrameSource source( stack );
+   dip::Image result;
+   dip::ImageFrameSink sink( result, 11 );
+   dip::TemporalFilter( source, sink, 3, "percentile", "filtered", 100.0 );
+   DOCTEST_CHECK( result.DataType() == dip::DT_UINT16 );
+   DOCTEST_CHECK( result.Sizes() == stack.Sizes() );
+   DOCTEST_CHECK( dip::testing::CompareImages( dip::Maximum( stack.At( dip::Range{}, dip::Range{}, dip::Range{ 0, 1 } ), {}, { false, false, true } ),
+                                               result.At( dip::Range{}, dip::Range{}, dip::Range{ 0 } )));
+}
+
+#endif // DIP__ENABLE_DOCTEST
@@ -24,6 +24,7 @@
 #include "diplib/pixel_table.h"
 #include "diplib/overload.h"
 #include "diplib/accumulators.h"
+#include "../library/integral_image.h"
 
 namespace dip {
 
@@ -76,6 +77,10 @@ void VarianceFilter(
    DIP_START_STACK_TRACE
       BoundaryConditionArray bc = StringArrayToBoundaryConditionArray( boundaryCondition );
       DataType dtype = DataType::SuggestFlex( in.DataType() );
+      if( in.DataType().IsReal() && IntegralImageIsEfficient( kernel, in.Dimensionality() )) {
+         IntegralImageFilter( in, out, kernel, bc, dtype, IntegralImageStatistic::VARIANCE );
+         return;
+      }
       std::unique_ptr< Framework::FullLineFilter > lineFilter;
       DIP_OVL_NEW_FLOAT( lineFilter, VarianceLineFilter, (), dtype );
       Framework::Full( in, out, dtype, dtype, dtype, 1, bc, kernel, *lineFilter, Framework::FullOption::AsScalarImage );
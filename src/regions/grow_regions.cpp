@@ -18,14 +18,20 @@
  * limitations under the License.
  */
 
-#include <queue>
+#include <vector>
+#include <cmath>
+#include <algorithm>
 
 #include "diplib.h"
 #include "diplib/regions.h"
 #include "diplib/distance.h"
 #include "diplib/morphology.h"
 #include "diplib/border.h"
+#include "diplib/generation.h"
+#include "diplib/statistics.h"
+#include "diplib/iterators.h"
 #include "diplib/overload.h"
+#include "diplib/multithreading.h"
 #include "../binary/binary_support.h"
 
 namespace dip {
@@ -34,8 +40,55 @@ namespace {
 
 constexpr uint8 MASK = 1; // must be 1
 constexpr uint8 BORDER = 2;
+constexpr uint8 FRONTIER = 4;
 
-using FifoQueue = std::queue< dip::sint >;
+template< typename TPI >
+struct Claim {
+   dip::sint offset;
+   TPI label;
+};
+
+// Frontier pixel `front` has found an unlabeled neighbor `candidate`. The candidate is claimed by the first of its
+// neighbors (in the order of `neighborhood`) that is in the frontier, such that exactly one frontier pixel
+// processes it, independently of how the frontier is divided over the threads. If `front` is that pixel, this
+// function returns true, and `label` is set to the smallest label among the frontier pixels around `candidate`.
+template< typename TPI >
+bool ClaimCandidate(
+      TPI const* label,
+      uint8 const* flags,
+      dip::sint candidate,
+      dip::sint front,
+      UnsignedArray const& sizes,
+      NeighborList const& neighborhood,
+      IntegerArray const& offsets,
+      CoordinatesComputer const& coordComputer,
+      TPI& out
+) {
+   bool isBorder = flags[ candidate ] & BORDER;
+   UnsignedArray coords;
+   if( isBorder ) {
+      coords = coordComputer( candidate );
+   }
+   bool found = false;
+   auto oit = offsets.begin();
+   for( auto nit = neighborhood.begin(); nit != neighborhood.end(); ++nit, ++oit ) {
+      if( !isBorder || nit.IsInImage( coords, sizes )) {
+         dip::sint neigh = candidate + *oit;
+         if( flags[ neigh ] & FRONTIER ) {
+            if( !found ) {
+               if( neigh != front ) {
+                  return false;
+               }
+               found = true;
+               out = label[ neigh ];
+            } else {
+               out = std::min( out, label[ neigh ] );
+            }
+         }
+      }
+   }
+   return found;
+}
 
 template< typename TPI >
 void dip__GrowRegions(
@@ -52,10 +105,10 @@ void dip__GrowRegions(
    uint8* flags = static_cast< uint8* >( im_flags.Origin() );
    UnsignedArray const& sizes = im_label.Sizes();
 
-   // The queue
-   FifoQueue Q;
+   // The frontier: pixels labeled in the previous iteration, these are marked with the FRONTIER flag
+   std::vector< dip::sint > frontier;
 
-   // Put all background pixels that have a foreground neighbor in the queue
+   // Put all foreground pixels that have a background neighbor in the frontier
    DIP_START_STACK_TRACE
    ImageIterator< TPI > it( im_label );
    it.OptimizeAndFlatten();
@@ -65,13 +118,13 @@ void dip__GrowRegions(
          // This is a foreground pixel within the mask
          if( flags[ offset ] & BORDER ) {
             // We're in a boundary pixel, not all neighbors will be available
-            //UnsignedArray const& coords = it.Coordinates();
             UnsignedArray coords = coordComputer( offset ); // Need to compute these because we called `it.Optimize()`
             auto oit = offsets0.begin();
             for( auto nit = neighborhood0.begin(); nit != neighborhood0.end(); ++nit, ++oit ) {
                if( nit.IsInImage( coords, sizes )) {
                   if( label[ offset + *oit ] == 0 ) {
-                     Q.push( offset );
+                     frontier.push_back( offset );
+                     flags[ offset ] |= FRONTIER;
                      break;
                   }
                }
@@ -80,7 +133,8 @@ void dip__GrowRegions(
             // No need to test for out-of-bounds reads
             for( auto o : offsets0 ) {
                if( label[ offset + o ] == 0 ) {
-                  Q.push( offset );
+                  frontier.push_back( offset );
+                  flags[ offset ] |= FRONTIER;
                   break;
                }
             }
@@ -90,11 +144,14 @@ void dip__GrowRegions(
    } while( ++it );
    DIP_END_STACK_TRACE
 
+   // Each thread collects the pixels it claims in its own list
+   std::vector< std::vector< Claim< TPI >>> claims( GetNumberOfThreads() );
+
    // Do `iterations` loops
    for( dip::uint ii = 0; ii < iterations; ++ii ) {
 
       // Number of elements to process
-      dip::uint count = Q.size();
+      dip::uint count = frontier.size();
       if( count == 0 ) {
          break; // We're done propagating
       }
@@ -103,31 +160,140 @@ void dip__GrowRegions(
       NeighborList const& neighborhood = ( ii & 1 ) == 1 ? neighborhood1 : neighborhood0;
       IntegerArray const& offsets = ( ii & 1 ) == 1 ? offsets1 : offsets0;
 
-      // Iterate over all elements currently in the queue
-      for( dip::uint jj = 0; jj < count; ++jj ) {
+      // Claiming a neighbor examines the neighbors of that neighbor
+      dip::uint nThreads = 1;
+      if( count * offsets.size() * offsets.size() >= threadingThreshold ) {
+         nThreads = std::min( claims.size(), count );
+      }
+
+      for( auto& threadClaims : claims ) {
+         threadClaims.clear();
+      }
+
+      // The frontier pixels are divided over the threads. First each thread finds the unlabeled neighbors it
+      // claims, without modifying the image. Once all threads are done, each writes the labels it found. Thus,
+      // the result does not depend on the order in which pixels are processed, nor on the number of threads.
+      #pragma omp parallel num_threads( static_cast< int >( nThreads ))
+      {
+         std::vector< Claim< TPI >>& threadClaims = claims[ static_cast< dip::uint >( omp_get_thread_num() ) ];
+         #pragma omp for schedule( static )
+         for( dip::sint jj = 0; jj < static_cast< dip::sint >( count ); ++jj ) {
+            dip::sint offset = frontier[ static_cast< dip::uint >( jj ) ];
+            bool isBorder = flags[ offset ] & BORDER;
+            UnsignedArray coords;
+            if( isBorder ) {
+               coords = coordComputer( offset );
+            }
+            auto oit = offsets.begin();
+            for( auto nit = neighborhood.begin(); nit != neighborhood.end(); ++nit, ++oit ) {
+               if( !isBorder || nit.IsInImage( coords, sizes )) {
+                  dip::sint neigh = offset + *oit;
+                  TPI ll;
+                  if(( flags[ neigh ] & MASK ) && ( label[ neigh ] == 0 ) &&
+                     ClaimCandidate( label, flags, neigh, offset, sizes, neighborhood, offsets, coordComputer, ll )) {
+                     threadClaims.push_back( { neigh, ll } );
+                  }
+               }
+            }
+         }
+         // Implicit barrier: all claims have been made
+         for( auto const& claim : threadClaims ) {
+            label[ claim.offset ] = claim.label;
+            flags[ claim.offset ] |= FRONTIER;
+         }
+         #pragma omp for schedule( static )
+         for( dip::sint jj = 0; jj < static_cast< dip::sint >( count ); ++jj ) {
+            flags[ frontier[ static_cast< dip::uint >( jj ) ]] &= static_cast< uint8 >( ~FRONTIER );
+         }
+      }
+
+      // The newly labeled pixels form the next frontier
+      frontier.clear();
+      for( auto const& threadClaims : claims ) {
+         for( auto const& claim : threadClaims ) {
+            frontier.push_back( claim.offset );
+         }
+      }
+   }
+}
+
+constexpr uint8 FINISHED = 8;
+
+// The largest step cost for which `GrowRegionsWeighted` uses a bucket queue
+constexpr dip::uint maxBucketQueueStep = 65535;
+
+// Region growing in order of grey-weighted distance, with integer step costs `steps[ ii ] * grey[ neighbor ]`.
+// The pending pixels are kept in a circular array of `nBuckets` FIFO queues, one per distance, as all pending
+// distances are within `nBuckets - 1` of the current one. A pixel takes the label of the neighbor from which it
+// is first reached with its final distance.
+template< typename TPI >
+void dip__GrowRegionsBucketQueue(
+      Image const& im_grey,
+      Image& im_label,
+      Image& im_distance,
+      Image& im_flags,
+      NeighborList const& neighborhood,
+      IntegerArray const& offsets,
+      std::vector< dip::uint > const& steps,
+      dip::uint nBuckets,
+      CoordinatesComputer const& coordComputer
+) {
+   TPI const* grey = static_cast< TPI const* >( im_grey.Origin() );
+   LabelType* label = static_cast< LabelType* >( im_label.Origin() );
+   dfloat* distance = static_cast< dfloat* >( im_distance.Origin() );
+   uint8* flags = static_cast< uint8* >( im_flags.Origin() );
+   UnsignedArray const& sizes = im_grey.Sizes();
+
+   std::vector< std::vector< dip::sint >> buckets( nBuckets );
+   dip::uint pending = 0;
 
-         // Get front pixel from the queue
-         dip::sint offset = Q.front();
-         Q.pop();
-         TPI ll = label[ offset ];
+   // Put all seed pixels within the mask in the first bucket
+   ImageIterator< LabelType > it( im_label );
+   it.OptimizeAndFlatten();
+   do {
+      dip::sint offset = it.Offset();
+      if(( flags[ offset ] & MASK ) && label[ offset ] ) {
+         distance[ offset ] = 0;
+         buckets[ 0 ].push_back( offset );
+         ++pending;
+      }
+   } while( ++it );
+
+   // Process the buckets in order of distance
+   for( dip::uint dist = 0; pending > 0; ++dist ) {
+      std::vector< dip::sint >& bucket = buckets[ dist % nBuckets ];
+      // A step with zero cost adds pixels to the bucket we're processing, so don't use iterators here
+      for( dip::uint jj = 0; jj < bucket.size(); ++jj ) {
+         dip::sint offset = bucket[ jj ];
+         --pending;
+         if( flags[ offset ] & FINISHED ) {
+            continue; // This pixel was queued again with a smaller distance, and is already processed
+         }
+         flags[ offset ] |= FINISHED;
+         LabelType ll = label[ offset ];
          bool isBorder = flags[ offset ] & BORDER;
          UnsignedArray coords;
          if( isBorder ) {
             coords = coordComputer( offset );
          }
-
-         // Propagate label to all neighbours which are not yet processed
          auto oit = offsets.begin();
-         for( auto nit = neighborhood.begin(); nit != neighborhood.end(); ++nit, ++oit ) {
+         auto sit = steps.begin();
+         for( auto nit = neighborhood.begin(); nit != neighborhood.end(); ++nit, ++oit, ++sit ) {
             if( !isBorder || nit.IsInImage( coords, sizes )) {
                dip::sint neigh = offset + *oit;
-               if(( flags[ neigh ] & MASK ) && label[ neigh ] == 0 ) {
-                  label[ neigh ] = ll;
-                  Q.push( neigh );
+               if(( flags[ neigh ] & ( MASK | FINISHED )) == MASK ) {
+                  dip::uint value = dist + *sit * static_cast< dip::uint >( grey[ neigh ] );
+                  if( static_cast< dfloat >( value ) < distance[ neigh ] ) {
+                     distance[ neigh ] = static_cast< dfloat >( value );
+                     label[ neigh ] = ll;
+                     buckets[ value % nBuckets ].push_back( neigh );
+                     ++pending;
+                  }
                }
             }
          }
       }
+      bucket.clear();
    }
 }
 
@@ -211,19 +377,184 @@ void GrowRegions(
 
 void GrowRegionsWeighted(
       Image const& label,
-      Image const& grey,
-      Image const& mask,
+      Image const& c_grey,
+      Image const& c_mask,
       Image& out,
-      Metric const& metric
+      Metric const& c_metric
 ) {
+   DIP_THROW_IF( !label.IsForged() || !c_grey.IsForged(), E::IMAGE_NOT_FORGED );
+   DIP_THROW_IF( !label.IsScalar() || !c_grey.IsScalar(), E::IMAGE_NOT_SCALAR );
+   DIP_THROW_IF( !label.DataType().IsUInt(), E::DATA_TYPE_NOT_SUPPORTED );
+   DIP_THROW_IF( label.Sizes() != c_grey.Sizes(), E::SIZES_DONT_MATCH );
+
+   // If all step costs are small integers, we can use a bucket queue instead of a priority queue
+   if( c_grey.DataType().IsUInt() && !c_grey.HasSingletonDimension() ) {
+      dip::uint nDims = c_grey.Dimensionality();
+      // Same pixel size logic as in `dip::GreyWeightedDistanceTransform`
+      PixelSize pixelSize = c_grey.PixelSize();
+      if( !pixelSize.IsDefined() ) {
+         pixelSize = label.PixelSize();
+      }
+      Metric metric = c_metric;
+      if( !metric.HasPixelSize() ) {
+         metric.SetPixelSize( pixelSize );
+      }
+      NeighborList neighborhood( metric, nDims );
+      std::vector< dip::uint > steps;
+      bool quantizable = true;
+      for( auto d : neighborhood.CopyDistances< dfloat >() ) {
+         if(( d < 1.0 ) || ( d > static_cast< dfloat >( maxBucketQueueStep )) || ( std::round( d ) != d )) {
+            quantizable = false;
+            break;
+         }
+         steps.push_back( static_cast< dip::uint >( d ));
+      }
+      dip::uint maxStep = 0;
+      if( quantizable ) {
+         dip::uint maxGrey = Maximum( c_grey ).As< dip::uint >();
+         dip::uint maxDistance = *std::max_element( steps.begin(), steps.end() );
+         quantizable = maxGrey <= maxBucketQueueStep / maxDistance;
+         maxStep = maxGrey * maxDistance;
+      }
+      if( quantizable ) {
+         // Check mask, expand mask singleton dimensions if necessary
+         Image mask;
+         if( c_mask.IsForged() ) {
+            mask = c_mask.QuickCopy();
+            DIP_START_STACK_TRACE
+               mask.CheckIsMask( c_grey.Sizes(), Option::AllowSingletonExpansion::DO_ALLOW, Option::ThrowException::DO_THROW );
+               mask.ExpandSingletonDimensions( c_grey.Sizes() );
+            DIP_END_STACK_TRACE
+         }
+
+         // We must have contiguous data if we want to create other images with the same strides as `grey`
+         Image grey = c_grey.QuickCopy();
+         grey.ForceContiguousData();
+
+         // Create temporary images
+         Image labels;
+         labels.SetStrides( grey.Strides() );
+         labels.SetSizes( grey.Sizes() );
+         labels.SetDataType( DT_LABEL );
+         labels.Forge();
+         DIP_ASSERT( labels.Strides() == grey.Strides() );
+         DIP_STACK_TRACE_THIS( labels.Copy( label ));
+
+         Image distance;
+         distance.SetStrides( grey.Strides() );
+         distance.SetSizes( grey.Sizes() );
+         distance.SetDataType( DT_DFLOAT ); // represents the integer distances exactly
+         distance.Forge();
+         DIP_ASSERT( distance.Strides() == grey.Strides() );
+         distance.Fill( std::numeric_limits< dfloat >::infinity() );
+
+         Image flags;
+         flags.SetStrides( grey.Strides() );
+         flags.SetSizes( grey.Sizes() );
+         flags.SetDataType( DT_UINT8 );
+         flags.Forge();
+         DIP_ASSERT( flags.Strides() == grey.Strides() );
+         flags.Fill( MASK );
+         SetBorder( flags, { MASK | BORDER }, neighborhood.Border() );
+         if( mask.IsForged() ) {
+            JointImageIterator< uint8, dip::bin > it( { flags, mask } );
+            it.OptimizeAndFlatten( 1 );
+            do {
+               if( !it.Sample< 1 >() ) {
+                  it.Sample< 0 >() &= static_cast< uint8 >( ~MASK );
+               }
+            } while( ++it );
+         }
+
+         IntegerArray offsets = neighborhood.ComputeOffsets( grey.Strides() );
+         CoordinatesComputer coordComputer = grey.OffsetToCoordinatesComputer();
+         DIP_OVL_CALL_UINT( dip__GrowRegionsBucketQueue, ( grey, labels, distance, flags, neighborhood, offsets,
+                                                           steps, maxStep + 1, coordComputer ), grey.DataType() );
+         out = labels;
+         out.SetPixelSize( pixelSize );
+         return;
+      }
+   }
+
    // Compute grey-weighted distance transform
    Image binary = label == 0;
    Image distance;
-   DIP_STACK_TRACE_THIS( GreyWeightedDistanceTransform( grey, binary, mask, distance, metric ));
+   DIP_STACK_TRACE_THIS( GreyWeightedDistanceTransform( c_grey, binary, c_mask, distance, c_metric ));
    binary.Strip();
 
    // Grow regions
-   DIP_STACK_TRACE_THIS( SeededWatershed( distance, label, mask, out, 1, -1, 0, { S::NOGAPS } )); // maxDepth = -1: disables region merging
+   DIP_STACK_TRACE_THIS( SeededWatershed( distance, label, c_mask, out, 1, -1, 0, { S::NOGAPS } )); // maxDepth = -1: disables region merging
 }
 
 } // namespace dip
+
+#ifdef DIP__ENABLE_DOCTEST
+#include "doctest.h"
+#include "diplib/math.h"
+#include "diplib/random.h"
+
+DOCTEST_TEST_CASE("[DIPlib] testing the GrowRegions function") {
+   // Two regions meeting halfway: the tie goes to the smaller label
+   dip::Image label( { 11, 3 }, 1, dip::DT_UINT8 );
+   label.Fill( 0 );
+   label.At( 0, 1 ) = 2;
+   label.At( 10, 1 ) = 1;
+   dip::Image out = dip::GrowRegions( label, {}, 1 );
+   DOCTEST_CHECK( out.At( 4, 1 ) == 2 );
+   DOCTEST_CHECK( out.At( 5, 1 ) == 1 );
+   DOCTEST_CHECK( out.At( 6, 1 ) == 1 );
+   DOCTEST_CHECK( out.At( 5, 0 ) == 1 );
+
+   // A limited number of iterations
+   label = dip::Image( { 64, 64 }, 1, dip::DT_UINT8 );
+   label.Fill( 0 );
+   label.At( 32, 32 ) = 1;
+   out = dip::GrowRegions( label, {}, 2, 3 );
+   DOCTEST_CHECK( dip::Count( out > 0 ) == 49 );
+
+   // The result does not depend on the number of threads
+   dip::Random random( 0 );
+   dip::Image noise( { 512, 512 }, 1, dip::DT_SFLOAT );
+   noise.Fill( 0 );
+   dip::UniformNoise( noise, noise, random );
+   dip::Image mask = noise < 0.8;
+   label = dip::Image( { 512, 512 }, 1, dip::DT_UINT16 );
+   label.Fill( 0 );
+   for( dip::uint ii = 0; ii < 200; ++ii ) {
+      label.At( ( ii * 97 ) % 512, ( ii * 61 ) % 512 ) = ii % 50 + 1;
+   }
+   dip::uint nThreads = dip::GetNumberOfThreads();
+   dip::SetNumberOfThreads( 1 );
+   dip::Image out1 = dip::GrowRegions( label, mask, -1 );
+   dip::SetNumberOfThreads( nThreads );
+   dip::Image outN = dip::GrowRegions( label, mask, -1 );
+   DOCTEST_CHECK( dip::Count( out1 != outN ) == 0 );
+   DOCTEST_CHECK( dip::Count( out1 > 0 ) > 0 );
+}
+
+DOCTEST_TEST_CASE("[DIPlib] testing the GrowRegionsWeighted function") {
+   dip::Image label( { 20, 9 }, 1, dip::DT_UINT8 );
+   label.Fill( 0 );
+   label.At( 2, 4 ) = 1;
+   label.At( 17, 4 ) = 2;
+   dip::Image grey( { 20, 9 }, 1, dip::DT_UINT8 );
+   grey.Fill( 1 );
+   // Integer weights and distances: uses the bucket queue
+   dip::Image out = dip::GrowRegionsWeighted( label, grey, {}, { dip::S::CONNECTED, 1 } );
+   DOCTEST_CHECK( out.DataType() == dip::DT_LABEL );
+   DOCTEST_CHECK( out.At( 9, 4 ) == 1 );
+   DOCTEST_CHECK( out.At( 10, 0 ) == 2 );
+   // Floating-point weights: uses the grey-weighted distance transform
+   dip::Image ref = dip::GrowRegionsWeighted( label, dip::Convert( grey, dip::DT_SFLOAT ), {}, { dip::S::CONNECTED, 1 } );
+   DOCTEST_CHECK( dip::Count( out != ref ) == 0 );
+   // An expensive wall with a gap at the bottom: region 1 reaches around it further than region 2
+   grey.At( dip::Range{ 12 }, dip::Range{ 0, 7 } ).Fill( 100 );
+   out = dip::GrowRegionsWeighted( label, grey, {}, { dip::S::CONNECTED, 1 } );
+   DOCTEST_CHECK( out.At( 12, 8 ) == 2 );
+   DOCTEST_CHECK( out.At( 11, 0 ) == 1 );
+   DOCTEST_CHECK( out.At( 13, 0 ) == 2 );
+   ref = dip::GrowRegionsWeighted( label, dip::Convert( grey, dip::DT_SFLOAT ), {}, { dip::S::CONNECTED, 1 } );
+   DOCTEST_CHECK( dip::Count( out != ref ) == 0 );
+}
+
+#endif // DIP__ENABLE_DOCTEST
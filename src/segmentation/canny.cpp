@@ -18,15 +18,497 @@
  * limitations under the License.
  */
 
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <memory>
+
 #include "diplib.h"
 #include "diplib/segmentation.h"
 #include "diplib/linear.h"
 #include "diplib/nonlinear.h"
 #include "diplib/statistics.h"
 #include "diplib/binary.h"
+#include "diplib/overload.h"
+#include "diplib/multithreading.h"
 
 namespace dip {
 
+namespace {
+
+// --- Fused implementation for 2D images ---
+//
+// The gradient, the non-maximum suppression and the collection of edge candidates (pixels with a non-zero NMS
+// value) are computed in a single pass over the image, in bands of rows that are processed in parallel. Each
+// band reads the input rows it needs (plus a halo for the Gaussian filters), so that the intermediate images
+// never exist at full size. The hysteresis threshold is computed with a union-find over the candidate pixels only.
+// The results are identical to the generic implementation when it uses the FIR Gaussian filters, up to rounding
+// errors in the gradient.
+
+constexpr dip::sint cannyBandHeight = 64;
+
+// Index into [0,n) for index `ii` outside of it, as the default boundary condition (symmetric mirror) does
+// when expanding a buffer (see `ExpandBufferMirror` in copy_buffer.cpp). `n` is at least 2.
+dip::sint MirrorIndex( dip::sint ii, dip::sint n ) {
+   dip::sint period = 2 * ( n - 1 );
+   ii %= period;
+   if( ii < 0 ) {
+      ii += period;
+   }
+   return ii < n ? ii : period - ii;
+}
+
+// Half of a Gaussian kernel, `kernel[ r ]` is the weight at distance `r`. These are the same weights
+// `dip::GaussFIR` uses with the default truncation.
+template< typename TPF >
+std::vector< TPF > MakeCannyKernel( dfloat sigma, dip::uint order ) {
+   dip::uint halfSize = static_cast< dip::uint >( std::ceil(( 3.0 + 0.5 * static_cast< dfloat >( order )) * sigma ));
+   std::vector< dfloat > weights( halfSize + 1 );
+   dfloat factor = -1.0 / ( 2.0 * sigma * sigma );
+   dfloat normalization = 0;
+   if( order == 0 ) {
+      weights[ 0 ] = 1.0;
+      for( dip::uint rr = 1; rr <= halfSize; ++rr ) {
+         dfloat rad = static_cast< dfloat >( rr );
+         weights[ rr ] = std::exp( factor * ( rad * rad ));
+         normalization += weights[ rr ];
+      }
+      normalization = 1.0 / ( normalization * 2 + 1 );
+   } else {
+      weights[ 0 ] = 0.0;
+      for( dip::uint rr = 1; rr <= halfSize; ++rr ) {
+         dfloat rad = static_cast< dfloat >( rr );
+         weights[ rr ] = rad * std::exp( factor * ( rad * rad ));
+         normalization += rad * weights[ rr ];
+      }
+      normalization = 1.0 / ( 2.0 * normalization );
+   }
+   std::vector< TPF > kernel( halfSize + 1 );
+   for( dip::uint rr = 0; rr <= halfSize; ++rr ) {
+      kernel[ rr ] = static_cast< TPF >( weights[ rr ] * normalization );
+   }
+   return kernel;
+}
+
+template< typename TPF >
+struct CannyKernels {
+   std::vector< TPF > smoothX;
+   std::vector< TPF > derivativeX;
+   std::vector< TPF > smoothY;
+   std::vector< TPF > derivativeY;
+   dip::sint BorderX() const { return static_cast< dip::sint >( std::max( smoothX.size(), derivativeX.size() )) - 1; }
+   dip::sint BorderY() const { return static_cast< dip::sint >( std::max( smoothY.size(), derivativeY.size() )) - 1; }
+};
+
+// Work buffers for one thread
+template< typename TPF >
+struct CannyBuffers {
+   std::vector< TPF > input;      // input rows, including the halo
+   std::vector< TPF > smooth;     // smoothed along y, with a halo along x
+   std::vector< TPF > derivative; // derivative along y, with a halo along x
+   std::vector< TPF > gx;         // gradient, one row for each row of `gm`
+   std::vector< TPF > gy;
+   std::vector< TPF > gm;         // gradient magnitude for the band and one row above and below it
+
+   // Allocates the buffers for the largest band, so that `CannyBand` doesn't need to allocate
+   void Allocate( dip::uint width, dip::sint height, dip::sint bandHeight, CannyKernels< TPF > const& kernels ) {
+      dip::uint nRows = static_cast< dip::uint >( std::min( bandHeight + 2, height ));
+      dip::uint nInputRows = nRows + 2 * static_cast< dip::uint >( kernels.BorderY() );
+      dip::uint extWidth = width + 2 * static_cast< dip::uint >( kernels.BorderX() );
+      input.resize( nInputRows * width );
+      smooth.resize( extWidth );
+      derivative.resize( extWidth );
+      gx.resize( nRows * width );
+      gy.resize( nRows * width );
+      gm.resize( nRows * width );
+   }
+};
+
+// Computes the NMS for rows [y0,y1) and writes it into `nms` (which has contiguous rows of `width` pixels).
+// Adds the indices of the pixels with a non-zero value to `candidates`, in increasing order.
+template< typename TPI, typename TPF >
+void CannyBand(
+      TPI const* in,
+      dip::sint inStrideX,
+      dip::sint inStrideY,
+      dip::sint width,
+      dip::sint height,
+      CannyKernels< TPF > const& kernels,
+      dip::sint y0,
+      dip::sint y1,
+      CannyBuffers< TPF >& buffers,
+      TPF* nms,
+      std::vector< dip::uint32 >& candidates
+) {
+   dip::sint borderX = kernels.BorderX();
+   dip::sint borderY = kernels.BorderY();
+   // The gradient magnitude is needed for one more row above and below the band
+   dip::sint ya = std::max( y0 - 1, dip::sint( 0 ));
+   dip::sint yb = std::min( y1 + 1, height );
+   dip::sint nRows = yb - ya;
+   dip::uint uWidth = static_cast< dip::uint >( width );
+   // Read input rows, converting to the float type
+   dip::sint nInputRows = nRows + 2 * borderY;
+   buffers.input.resize( static_cast< dip::uint >( nInputRows ) * uWidth );
+   for( dip::sint rr = 0; rr < nInputRows; ++rr ) {
+      dip::sint yy = ya - borderY + rr;
+      if(( yy < 0 ) || ( yy >= height )) {
+         yy = MirrorIndex( yy, height );
+      }
+      TPI const* src = in + yy * inStrideY;
+      TPF* dest = buffers.input.data() + static_cast< dip::uint >( rr ) * uWidth;
+      for( dip::sint xx = 0; xx < width; ++xx, src += inStrideX ) {
+         dest[ xx ] = static_cast< TPF >( *src );
+      }
+   }
+   // Gradient, one row at a time. The loops over the kernel taps are outside the loops over the pixels, so that
+   // the latter can be vectorized.
+   dip::uint extWidth = uWidth + 2 * static_cast< dip::uint >( borderX );
+   buffers.smooth.resize( extWidth );
+   buffers.derivative.resize( extWidth );
+   buffers.gx.resize( static_cast< dip::uint >( nRows ) * uWidth );
+   buffers.gy.resize( static_cast< dip::uint >( nRows ) * uWidth );
+   buffers.gm.resize( static_cast< dip::uint >( nRows ) * uWidth );
+   TPF* smooth = buffers.smooth.data() + borderX;
+   TPF* derivative = buffers.derivative.data() + borderX;
+   for( dip::sint rr = 0; rr < nRows; ++rr ) {
+      TPF const* center = buffers.input.data() + static_cast< dip::uint >( rr + borderY ) * uWidth;
+      // Along y
+      TPF weight = kernels.smoothY[ 0 ];
+      for( dip::sint xx = 0; xx < width; ++xx ) {
+         smooth[ xx ] = weight * center[ xx ];
+         derivative[ xx ] = 0;
+      }
+      for( dip::uint kk = 1; kk < kernels.smoothY.size(); ++kk ) {
+         TPF const* above = center - kk * uWidth;
+         TPF const* below = center + kk * uWidth;
+         weight = kernels.smoothY[ kk ];
+         for( dip::sint xx = 0; xx < width; ++xx ) {
+            smooth[ xx ] += weight * ( above[ xx ] + below[ xx ] );
+         }
+      }
+      for( dip::uint kk = 1; kk < kernels.derivativeY.size(); ++kk ) {
+         TPF const* above = center - kk * uWidth;
+         TPF const* below = center + kk * uWidth;
+         weight = kernels.derivativeY[ kk ];
+         for( dip::sint xx = 0; xx < width; ++xx ) {
+            derivative[ xx ] += weight * ( below[ xx ] - above[ xx ] );
+         }
+      }
+      // Extend the lines along x
+      for( dip::sint xx = 1; xx <= borderX; ++xx ) {
+         smooth[ -xx ] = smooth[ MirrorIndex( -xx, width ) ];
+         derivative[ -xx ] = derivative[ MirrorIndex( -xx, width ) ];
+         smooth[ width - 1 + xx ] = smooth[ MirrorIndex( width - 1 + xx, width ) ];
+         derivative[ width - 1 + xx ] = derivative[ MirrorIndex( width - 1 + xx, width ) ];
+      }
+      // Along x
+      TPF* gx = buffers.gx.data() + static_cast< dip::uint >( rr ) * uWidth;
+      TPF* gy = buffers.gy.data() + static_cast< dip::uint >( rr ) * uWidth;
+      TPF* gm = buffers.gm.data() + static_cast< dip::uint >( rr ) * uWidth;
+      weight = kernels.smoothX[ 0 ];
+      for( dip::sint xx = 0; xx < width; ++xx ) {
+         gx[ xx ] = 0;
+         gy[ xx ] = weight * derivative[ xx ];
+      }
+      for( dip::sint kk = 1; kk < static_cast< dip::sint >( kernels.derivativeX.size() ); ++kk ) {
+         weight = kernels.derivativeX[ static_cast< dip::uint >( kk ) ];
+         for( dip::sint xx = 0; xx < width; ++xx ) {
+            gx[ xx ] += weight * ( smooth[ xx + kk ] - smooth[ xx - kk ] );
+         }
+      }
+      for( dip::sint kk = 1; kk < static_cast< dip::sint >( kernels.smoothX.size() ); ++kk ) {
+         weight = kernels.smoothX[ static_cast< dip::uint >( kk ) ];
+         for( dip::sint xx = 0; xx < width; ++xx ) {
+            gy[ xx ] += weight * ( derivative[ xx + kk ] + derivative[ xx - kk ] );
+         }
+      }
+      for( dip::sint xx = 0; xx < width; ++xx ) {
+         gm[ xx ] = std::sqrt( gx[ xx ] * gx[ xx ] + gy[ xx ] * gy[ xx ] );
+      }
+   }
+   // Non-maximum suppression with interpolation, as in `dip::NonMaximumSuppression`
+   for( dip::sint yy = y0; yy < y1; ++yy ) {
+      TPF* out = nms + static_cast< dip::uint >( yy ) * uWidth;
+      if(( yy == 0 ) || ( yy == height - 1 )) {
+         std::fill( out, out + width, TPF( 0 ));
+         continue;
+      }
+      dip::uint offset = static_cast< dip::uint >( yy - ya ) * uWidth;
+      TPF const* pgm = buffers.gm.data() + offset;
+      TPF const* pgx = buffers.gx.data() + offset;
+      TPF const* pgy = buffers.gy.data() + offset;
+      dip::sint up = -width;
+      dip::sint down = width;
+      out[ 0 ] = 0;
+      for( dip::sint xx = 1; xx < width - 1; ++xx ) {
+         TPF value = pgm[ xx ];
+         out[ xx ] = 0;
+         if( value > 0 ) {
+            TPF dx = pgx[ xx ];
+            TPF dy = pgy[ xx ];
+            TPF absdx = std::abs( dx );
+            TPF absdy = std::abs( dy );
+            bool sameSign = std::signbit( dx ) == std::signbit( dy );
+            TPF delta, mag1, mag2, mag3, mag4;
+            if( absdy > absdx ) {
+               delta = absdx / absdy;
+               mag2 = pgm[ xx + up ];
+               mag4 = pgm[ xx + down ];
+               if( sameSign ) {
+                  mag1 = pgm[ xx + up - 1 ];
+                  mag3 = pgm[ xx + down + 1 ];
+               } else {
+                  mag1 = pgm[ xx + up + 1 ];
+                  mag3 = pgm[ xx + down - 1 ];
+               }
+            } else {
+               delta = absdy / absdx;
+               mag2 = pgm[ xx + 1 ];
+               mag4 = pgm[ xx - 1 ];
+               if( sameSign ) {
+                  mag1 = pgm[ xx + down + 1 ];
+                  mag3 = pgm[ xx + up - 1 ];
+               } else {
+                  mag1 = pgm[ xx + up + 1 ];
+                  mag3 = pgm[ xx + down - 1 ];
+               }
+            }
+            TPF m1 = delta * mag1 + ( 1 - delta ) * mag2;
+            TPF m2 = delta * mag3 + ( 1 - delta ) * mag4;
+            if((( value > m1 ) && ( value >= m2 )) || (( value >= m1 ) && ( value > m2 ))) {
+               out[ xx ] = value;
+               candidates.push_back( static_cast< dip::uint32 >( static_cast< dip::uint >( yy ) * uWidth + static_cast< dip::uint >( xx )));
+            }
+         }
+      }
+      out[ width - 1 ] = 0;
+   }
+}
+
+// Computes the percentile of `count` values, of which `values` are the non-zero ones (all positive) and the
+// remainder are zero, in the same way as `dip::Percentile`. Reorders `values`.
+template< typename TPF >
+dfloat CannyPercentile( std::vector< TPF >& values, dip::uint count, dfloat percentile ) {
+   DIP_THROW_IF(( percentile < 0.0 ) || ( percentile > 100.0 ), E::PARAMETER_OUT_OF_RANGE );
+   if( count == 0 ) {
+      return 0.0;
+   }
+   dip::uint zeros = count - values.size();
+   if( percentile == 0.0 ) {
+      return zeros > 0 ? 0.0 : static_cast< dfloat >( *std::min_element( values.begin(), values.end() ));
+   }
+   if( percentile == 100.0 ) {
+      return values.empty() ? 0.0 : static_cast< dfloat >( *std::max_element( values.begin(), values.end() ));
+   }
+   dip::uint rank = static_cast< dip::uint >( round_cast( static_cast< dfloat >( count - 1 ) * percentile / 100.0 ));
+   if( rank < zeros ) {
+      return 0.0;
+   }
+   auto ourGuy = values.begin() + static_cast< dip::sint >( rank - zeros );
+   std::nth_element( values.begin(), ourGuy, values.end() );
+   return static_cast< dfloat >( *ourGuy );
+}
+
+// Union-find over the weak pixels. `parent` has an element for each pixel, but only those for weak pixels are
+// used. A root is its own parent, and has the `cannyStrong` flag set if its tree contains a strong pixel.
+constexpr dip::uint32 cannyStrong = 0x80000000u;
+constexpr dip::uint32 cannyIndex = 0x7FFFFFFFu;
+
+dip::uint32 CannyFindRoot( dip::uint32* parent, dip::uint32 node ) {
+   while(( parent[ node ] & cannyIndex ) != node ) {
+      dip::uint32 next = parent[ node ];           // not a root, so no flag
+      parent[ node ] = parent[ next ] & cannyIndex; // path halving
+      node = parent[ node ];
+   }
+   return node;
+}
+
+// Doesn't modify `parent`, so can be called in parallel
+dip::uint32 CannyFindRootConst( dip::uint32 const* parent, dip::uint32 node ) {
+   while(( parent[ node ] & cannyIndex ) != node ) {
+      node = parent[ node ];
+   }
+   return node;
+}
+
+void CannyUnion( dip::uint32* parent, dip::uint32 node1, dip::uint32 node2 ) {
+   node1 = CannyFindRoot( parent, node1 );
+   node2 = CannyFindRoot( parent, node2 );
+   if( node1 == node2 ) {
+      return;
+   }
+   if( node2 < node1 ) {
+      std::swap( node1, node2 );
+   }
+   parent[ node1 ] |= parent[ node2 ] & cannyStrong;
+   parent[ node2 ] = node1;
+}
+
+template< typename TPI >
+void FusedCanny(
+      Image const& in,
+      Image& out,
+      FloatArray const& sigmas,
+      dfloat lower,
+      dfloat upper,
+      String const& selection
+) {
+   using TPF = FloatType< TPI >;
+   dip::sint width = static_cast< dip::sint >( in.Size( 0 ));
+   dip::sint height = static_cast< dip::sint >( in.Size( 1 ));
+   dip::uint uWidth = in.Size( 0 );
+   dip::uint nPixels = in.NumberOfPixels();
+   PixelSize pixelSize = in.PixelSize();
+   CannyKernels< TPF > kernels;
+   kernels.smoothX = MakeCannyKernel< TPF >( sigmas[ 0 ], 0 );
+   kernels.derivativeX = MakeCannyKernel< TPF >( sigmas[ 0 ], 1 );
+   kernels.smoothY = MakeCannyKernel< TPF >( sigmas[ 1 ], 0 );
+   kernels.derivativeY = MakeCannyKernel< TPF >( sigmas[ 1 ], 1 );
+
+   // Gradient and NMS, one band of rows at the time
+   Image nmsImage( in.Sizes(), 1, DataType( TPF( 0 )));
+   nmsImage.SetPixelSize( pixelSize );
+   DIP_ASSERT( nmsImage.HasNormalStrides() );
+   TPF* nms = static_cast< TPF* >( nmsImage.Origin() );
+   dip::uint nBands = div_ceil( in.Size( 1 ), static_cast< dip::uint >( cannyBandHeight ));
+   std::vector< std::vector< dip::uint32 >> candidates( nBands );
+   dip::uint operations = nPixels * ( 2 * ( kernels.smoothX.size() + kernels.derivativeX.size() +
+                                            kernels.smoothY.size() + kernels.derivativeY.size() ) + 20 );
+   dip::uint nThreads = operations < threadingThreshold ? 1 : std::min( GetNumberOfThreads(), nBands );
+   TPI const* pin = static_cast< TPI const* >( in.Origin() );
+   dip::sint inStrideX = in.Stride( 0 );
+   dip::sint inStrideY = in.Stride( 1 );
+   // One set of work buffers per thread, allocated here so that no memory is allocated in the parallel region
+   std::vector< CannyBuffers< TPF >> buffers( nThreads );
+   for( auto& b : buffers ) {
+      b.Allocate( uWidth, height, cannyBandHeight, kernels );
+   }
+   #pragma omp parallel for schedule( dynamic ) num_threads( static_cast< int >( nThreads ))
+   for( dip::sint band = 0; band < static_cast< dip::sint >( nBands ); ++band ) {
+      dip::uint thread = static_cast< dip::uint >( omp_get_thread_num() );
+      dip::sint y0 = band * cannyBandHeight;
+      dip::sint y1 = std::min( y0 + cannyBandHeight, height );
+      CannyBand( pin, inStrideX, inStrideY, width, height, kernels, y0, y1, buffers[ thread ], nms,
+                 candidates[ static_cast< dip::uint >( band ) ] );
+   }
+
+   // Thresholds
+   dfloat t1 = upper;
+   dfloat t2 = lower;
+   if( selection != "absolute" ) {
+      std::vector< TPF > values;
+      for( auto const& list : candidates ) {
+         for( dip::uint32 index : list ) {
+            values.push_back( nms[ index ] );
+         }
+      }
+      if( selection == S::ALL ) {
+         t1 = CannyPercentile( values, nPixels, upper * 100 );
+         if( t1 == 0 ) {
+            t1 = 1e-6; // Same as in the generic implementation
+         }
+      } else { // selection == "nonzero"
+         t1 = CannyPercentile( values, values.size(), upper * 100 );
+      }
+      t2 = lower * t1;
+   }
+   if( t2 <= 0 ) {
+      // All pixels are weak, the candidates don't help us here
+      HysteresisThreshold( nmsImage, out, t2, t1 );
+      return;
+   }
+
+   // Hysteresis threshold: union-find over the weak pixels, with 8-connectivity. Each band is joined independently,
+   // then the bands are joined along their common edge. Weak pixels are never on the image edge.
+   std::unique_ptr< dip::uint32[] > parentArray( new dip::uint32[ nPixels ] );
+   dip::uint32* parent = parentArray.get();
+   dip::uint32 upperLeft = static_cast< dip::uint32 >( uWidth + 1 );
+   dip::uint32 upperRight = static_cast< dip::uint32 >( uWidth - 1 );
+   #pragma omp parallel for schedule( dynamic ) num_threads( static_cast< int >( nThreads ))
+   for( dip::sint band = 0; band < static_cast< dip::sint >( nBands ); ++band ) {
+      dip::uint32 bandStart = static_cast< dip::uint32 >( static_cast< dip::uint >( band * cannyBandHeight ) * uWidth );
+      for( dip::uint32 index : candidates[ static_cast< dip::uint >( band ) ] ) {
+         dfloat value = static_cast< dfloat >( nms[ index ] );
+         if( value < t2 ) {
+            continue;
+         }
+         parent[ index ] = index | ( value >= t1 ? cannyStrong : 0u );
+         if( static_cast< dfloat >( nms[ index - 1 ] ) >= t2 ) {
+            CannyUnion( parent, index, index - 1 );
+         }
+         if( index >= bandStart + uWidth ) {
+            for( dip::uint32 neighbor = index - upperLeft; neighbor <= index - upperRight; ++neighbor ) {
+               if( static_cast< dfloat >( nms[ neighbor ] ) >= t2 ) {
+                  CannyUnion( parent, index, neighbor );
+               }
+            }
+         }
+      }
+   }
+   for( dip::uint band = 1; band < nBands; ++band ) {
+      dip::uint32 rowEnd = static_cast< dip::uint32 >(( band * static_cast< dip::uint >( cannyBandHeight ) + 1 ) * uWidth );
+      for( dip::uint32 index : candidates[ band ] ) {
+         if( index >= rowEnd ) {
+            break;
+         }
+         if( static_cast< dfloat >( nms[ index ] ) < t2 ) {
+            continue;
+         }
+         for( dip::uint32 neighbor = index - upperLeft; neighbor <= index - upperRight; ++neighbor ) {
+            if( static_cast< dfloat >( nms[ neighbor ] ) >= t2 ) {
+               CannyUnion( parent, index, neighbor );
+            }
+         }
+      }
+   }
+
+   // The output contains the weak pixels connected to a strong one
+   out.ReForge( nmsImage.Sizes(), 1, DT_BIN );
+   out.Fill( false );
+   out.SetPixelSize( pixelSize );
+   bin* pout = static_cast< bin* >( out.Origin() );
+   dip::sint outStrideX = out.Stride( 0 );
+   dip::sint outStrideY = out.Stride( 1 );
+   #pragma omp parallel for schedule( dynamic ) num_threads( static_cast< int >( nThreads ))
+   for( dip::sint band = 0; band < static_cast< dip::sint >( nBands ); ++band ) {
+      for( dip::uint32 index : candidates[ static_cast< dip::uint >( band ) ] ) {
+         if( static_cast< dfloat >( nms[ index ] ) < t2 ) {
+            continue;
+         }
+         if( parent[ CannyFindRootConst( parent, index ) ] & cannyStrong ) {
+            dip::sint xx = static_cast< dip::sint >( index % uWidth );
+            dip::sint yy = static_cast< dip::sint >( index / uWidth );
+            pout[ xx * outStrideX + yy * outStrideY ] = true;
+         }
+      }
+   }
+}
+
+// The fused implementation always computes the gradient with FIR filters. We use it only where `dip::Gradient`
+// would choose the FIR implementation too (see `dip::GaussCostModel`).
+bool UseFusedCanny( Image const& in, FloatArray const& sigmas ) {
+   if(( in.Dimensionality() != 2 ) || ( in.Size( 0 ) < 3 ) || ( in.Size( 1 ) < 3 ) ||
+      ( in.NumberOfPixels() > cannyIndex )) {
+      return false;
+   }
+   GaussCostModel model = GetGaussCostModel();
+   for( dfloat sigma : sigmas ) {
+      if( sigma < 0.8 ) {
+         return false;
+      }
+      if( sigma > model.iirMinimumSigma ) {
+         dfloat taps = 2.0 * std::ceil( 3.5 * sigma ) + 1.0;
+         if( model.firPerPixel + model.firPerTap * taps > model.iirPerPixel ) {
+            return false;
+         }
+      }
+   }
+   return true;
+}
+
+} // namespace
+
 void Canny(
       Image const& in,
       Image& out,
@@ -39,6 +521,15 @@ void Canny(
    DIP_THROW_IF( !in.IsScalar(), E::IMAGE_NOT_SCALAR );
    DIP_THROW_IF( !in.DataType().IsReal(), E::DATA_TYPE_NOT_SUPPORTED );
    DIP_START_STACK_TRACE
+      FloatArray fusedSigmas = sigmas;
+      if( in.Dimensionality() == 2 ) {
+         ArrayUseParameter( fusedSigmas, 2, 1.0 );
+      }
+      if(( selection == S::ALL || selection == "nonzero" || selection == "absolute" ) && UseFusedCanny( in, fusedSigmas )) {
+         DIP_OVL_CALL_REAL( FusedCanny, ( in, out, fusedSigmas, lower, upper, selection ), in.DataType() );
+         EuclideanSkeleton( out, out );
+         return;
+      }
       Image gradient = Gradient( in, sigmas, S::BEST );
       NonMaximumSuppression( {}, gradient, {}, out, S::INTERPOLATE ); // use interpolation in 2D, for higher dims it's always "round"
       dfloat t1 = upper;
@@ -64,3 +555,54 @@ void Canny(
 }
 
 } // namespace dip
+
+
+#ifdef DIP__ENABLE_DOCTEST
+#include "doctest.h"
+#include "diplib/generation.h"
+#include "diplib/math.h"
+
+DOCTEST_TEST_CASE("[DIPlib] testing the fused Canny implementation") {
+   // Compare to the generic implementation with the FIR Gaussian filters
+   auto genericCanny = []( dip::Image const& in, dip::dfloat lower, dip::dfloat upper, dip::String const& selection ) {
+      dip::Image out = dip::NonMaximumSuppression( {}, dip::Gradient( in, { 1.2 }, "gaussfir" ), {}, dip::S::INTERPOLATE );
+      dip::dfloat t1 = upper;
+      dip::dfloat t2 = lower;
+      if( selection == dip::S::ALL ) {
+         t1 = dip::Percentile( out, {}, upper * 100 ).As< dip::dfloat >();
+         t2 = lower * t1;
+      } else if( selection == "nonzero" ) {
+         t1 = dip::Percentile( out, out > 0, upper * 100 ).As< dip::dfloat >();
+         t2 = lower * t1;
+      }
+      dip::HysteresisThreshold( out, out, t2, t1 );
+      dip::EuclideanSkeleton( out, out );
+      return out;
+   };
+   dip::Random random( 0 );
+   dip::Image img{ dip::UnsignedArray{ 160, 150 }, 1, dip::DT_SFLOAT };
+   img.Fill( 0 );
+   dip::UniformNoise( img, img, random, 0.0, 255.0 );
+   img = dip::Gauss( img, { 2.0 } );
+   dip::Image fused = dip::Canny( img, { 1.2 }, 0.5, 0.9, dip::S::ALL );
+   DOCTEST_CHECK( dip::Count( fused ) > 1000 );
+   DOCTEST_CHECK( dip::Count( fused != genericCanny( img, 0.5, 0.9, dip::S::ALL )) == 0 );
+   fused = dip::Canny( img, { 1.2 }, 2.0, 4.0, "absolute" );
+   DOCTEST_CHECK( dip::Count( fused != genericCanny( img, 2.0, 4.0, "absolute" )) == 0 );
+   fused = dip::Canny( img, { 1.2 }, 0.5, 0.9, "nonzero" );
+   DOCTEST_CHECK( dip::Count( fused ) > 1000 );
+   DOCTEST_CHECK( dip::Count( fused != genericCanny( img, 0.5, 0.9, "nonzero" )) == 0 );
+   // An integer input
+   dip::Image intImg = dip::Convert( img, dip::DT_UINT8 );
+   fused = dip::Canny( intImg, { 1.2 }, 0.5, 0.9, dip::S::ALL );
+   DOCTEST_CHECK( dip::Count( fused ) > 1000 );
+   DOCTEST_CHECK( dip::Count( fused != genericCanny( intImg, 0.5, 0.9, dip::S::ALL )) == 0 );
+   fused = dip::Canny( intImg, { 1.2 }, 0.5, 0.9, "nonzero" );
+   DOCTEST_CHECK( dip::Count( fused != genericCanny( intImg, 0.5, 0.9, "nonzero" )) == 0 );
+   // A non-contiguous input, with a band boundary in the middle of the edges
+   img = img.At( dip::Range{ 0, -1, 2 }, dip::Range{ -1, 0 } );
+   fused = dip::Canny( img, { 1.2 }, 0.5, 0.9, dip::S::ALL );
+   DOCTEST_CHECK( dip::Count( fused != genericCanny( img, 0.5, 0.9, dip::S::ALL )) == 0 );
+}
+
+#endif // DIP__ENABLE_DOCTEST
@@ -23,6 +23,7 @@
 #include "diplib/framework.h"
 #include "diplib/overload.h"
 #include "diplib/random.h"
+#include "diplib/multithreading.h"
 
 namespace dip {
 
@@ -30,14 +31,22 @@ namespace {
 
 struct Cluster {
    FloatArray mean;
-   FloatArray newMean;
-   dfloat norm = 0.0;
    LabelType label = 0;
-   explicit Cluster( dip::uint nDim ) : mean( nDim, 0.0 ), newMean( nDim, 0.0 ) {}
+   explicit Cluster( dip::uint nDim ) : mean( nDim, 0.0 ) {}
 };
 
 using ClusterArray = std::vector< Cluster >;
 
+// Accumulates the weighted sum of coordinates of the pixels assigned to a cluster. Each chunk of the image
+// has its own array of accumulators.
+struct ClusterAccumulator {
+   FloatArray sum;
+   dfloat norm = 0.0;
+   explicit ClusterAccumulator( dip::uint nDim ) : sum( nDim, 0.0 ) {}
+};
+
+using ClusterAccumulatorArray = std::vector< ClusterAccumulator >;
+
 template< typename TPI >
 class dip__Clustering : public Framework::ScanLineFilter {
    public:
@@ -57,8 +66,11 @@ class dip__Clustering : public Framework::ScanLineFilter {
          DIP_ASSERT(( out == nullptr ) ^ ( in == nullptr )); // make sure one and only one is nullptr
          dip::uint bufferLength = params.bufferLength;
          dip::uint scanDim = params.dimension;
-         auto& pos = params.position;
+         UnsignedArray pos = params.position;
          dip::uint nDims = pos.size();
+         if( !origin_.empty() ) {
+            pos += origin_;
+         }
          // Initialise the cluster array
          std::vector< dfloat > distCache( clusters_.size(), 0.0 );
          for( dip::uint ii = 0; ii < clusters_.size(); ++ii ) {
@@ -88,20 +100,32 @@ class dip__Clustering : public Framework::ScanLineFilter {
                out += outStride;
             } else {
                // Update the new mean of nearest mean
+               ClusterAccumulator& acc = ( *accumulators_ )[ nearest ];
                for( dip::uint ii = 0; ii < nDims; ++ii ) {
-                  clusters_[ nearest ].newMean[ ii ] += *in * static_cast< dfloat >( pos[ ii ] );
+                  acc.sum[ ii ] += *in * static_cast< dfloat >( pos[ ii ] );
                }
-               clusters_[ nearest ].newMean[ scanDim ] += static_cast< dfloat >( *in ) * static_cast< dfloat >( xx );
-               clusters_[ nearest ].norm += *in;
+               acc.sum[ scanDim ] += static_cast< dfloat >( *in ) * static_cast< dfloat >( xx );
+               acc.norm += *in;
                in += inStride;
             }
          }
       }
-      dip__Clustering( ClusterArray& clusters ) : clusters_( clusters ) {}
+      // Writes labels
+      dip__Clustering( ClusterArray const& clusters ) : clusters_( clusters ) {}
+      // Accumulates into `accumulators`; `origin` is the coordinates of the first pixel of the chunk processed
+      dip__Clustering( ClusterArray const& clusters, ClusterAccumulatorArray& accumulators, UnsignedArray origin )
+            : clusters_( clusters ), accumulators_( &accumulators ), origin_( std::move( origin )) {}
    private:
-      ClusterArray& clusters_;
+      ClusterArray const& clusters_;
+      ClusterAccumulatorArray* accumulators_ = nullptr;
+      UnsignedArray origin_;
 };
 
+// The image is divided into this many chunks along one dimension, each chunk accumulating into its own array.
+// The chunks do not depend on the number of threads, and are added in order, so that the result is exactly
+// the same independently of how many threads are used.
+constexpr dip::uint nAccumulationChunks = 64;
+
 dfloat Clustering(
       Image const& in,
       Image& out,
@@ -112,52 +136,70 @@ dfloat Clustering(
    if( ovlDataType.IsBinary() ) {
       ovlDataType = DT_UINT8; // Reading binary images as if they were uint8.
    }
-   std::unique_ptr< Framework::ScanLineFilter > lineFilter;
-   DIP_OVL_NEW_REAL( lineFilter, dip__Clustering, ( clusters ), ovlDataType );
-   ImageConstRefArray inImages;
-   ImageRefArray outImages;
-   DataTypeArray inBufferTypes;
-   DataTypeArray outBufferTypes;
-   DataTypeArray outImageTypes;
-   UnsignedArray nTensorElements;
    if( write ) {
       // We write cluster labels to `out`
-      outImages.emplace_back( out );
-      outBufferTypes.push_back( DT_LABEL );
-      outImageTypes.push_back( DT_LABEL );
-      nTensorElements.push_back( 1 );
       // Forge `out` -- we're not passing `in` to `Scan`, so it won't know how large to make `out`.
       out.ReForge( in, DT_LABEL, Option::AcceptDataTypeChange::DONT_ALLOW );
-   } else {
-      // We update clusters based on `in`
-      inImages.emplace_back( in );
-      inBufferTypes.push_back( ovlDataType );
+      ImageRefArray outImages{ out };
+      std::unique_ptr< Framework::ScanLineFilter > lineFilter;
+      DIP_OVL_NEW_REAL( lineFilter, dip__Clustering, ( clusters ), ovlDataType );
+      DIP_STACK_TRACE_THIS( Framework::Scan( {}, outImages, {}, { DT_LABEL }, { DT_LABEL }, { 1 }, *lineFilter,
+                                             Framework::ScanOption::NeedCoordinates ));
+      return 0.0;
+   }
+
+   // We update clusters based on `in`, chunks are split along the longest dimension
+   dip::uint nDims = in.Dimensionality();
+   dip::uint chunkDim = 0;
+   for( dip::uint ii = 1; ii < nDims; ++ii ) {
+      if( in.Size( ii ) > in.Size( chunkDim )) {
+         chunkDim = ii;
+      }
+   }
+   dip::uint chunkSize = in.Size( chunkDim );
+   dip::uint nChunks = std::min( chunkSize, nAccumulationChunks );
+   std::vector< ClusterAccumulatorArray > accumulators( nChunks, ClusterAccumulatorArray( clusters.size(), ClusterAccumulator( nDims )));
+   dip::uint operations = in.NumberOfPixels() * clusters.size() * 4;
+   dip::uint nThreads = operations < threadingThreshold ? 1 : std::min( GetNumberOfThreads(), nChunks );
+   #pragma omp parallel for schedule( dynamic ) num_threads( static_cast< int >( nThreads ))
+   for( dip::sint chunk = 0; chunk < static_cast< dip::sint >( nChunks ); ++chunk ) {
+      dip::uint uChunk = static_cast< dip::uint >( chunk );
+      dip::uint start = uChunk * chunkSize / nChunks;
+      dip::uint end = ( uChunk + 1 ) * chunkSize / nChunks;
+      RangeArray ranges( nDims );
+      ranges[ chunkDim ] = Range{ static_cast< dip::sint >( start ), static_cast< dip::sint >( end - 1 ) };
+      UnsignedArray origin( nDims, 0 );
+      origin[ chunkDim ] = start;
+      Image view = in.At( ranges );
+      std::unique_ptr< Framework::ScanLineFilter > lineFilter;
+      DIP_OVL_NEW_REAL( lineFilter, dip__Clustering, ( clusters, accumulators[ uChunk ], origin ), ovlDataType );
+      Framework::ScanSingleInput( view, {}, ovlDataType, *lineFilter,
+                                  Framework::ScanOption::NeedCoordinates + Framework::ScanOption::NoMultiThreading );
+   }
+
+   // Add the accumulators of all chunks, in order
+   for( dip::uint tt = 1; tt < nChunks; ++tt ) {
+      for( dip::uint ii = 0; ii < clusters.size(); ++ii ) {
+         accumulators[ 0 ][ ii ].sum += accumulators[ tt ][ ii ].sum;
+         accumulators[ 0 ][ ii ].norm += accumulators[ tt ][ ii ].norm;
+      }
    }
-   DIP_STACK_TRACE_THIS( Framework::Scan( inImages, outImages, inBufferTypes, outBufferTypes, outImageTypes, nTensorElements, *lineFilter,
-                                          Framework::ScanOption::NeedCoordinates + Framework::ScanOption::NoMultiThreading ));
 
    // Process cluster information
    dfloat change = 0;
    dfloat maxval = 0;
-   if( !write ) {
-      //std::cout << "Cluster means: ";
-      for( auto& c : clusters ) {
-         if( c.norm != 0.0 ) {
-            for( dip::uint jj = 0; jj < c.mean.size(); jj++ ) {
-               dfloat val = c.newMean[ jj ] / c.norm;
-               maxval = std::max( std::abs( val ), maxval );
-               dfloat dist = val - c.mean[ jj ];
-               change += dist * dist;
-               c.mean[ jj ] = val;
-               c.newMean[ jj ] = 0.0;
-            }
-         } else {
-            std::fill( c.newMean.begin(), c.newMean.end(), 0.0 );
+   for( dip::uint ii = 0; ii < clusters.size(); ++ii ) {
+      Cluster& c = clusters[ ii ];
+      ClusterAccumulator const& acc = accumulators[ 0 ][ ii ];
+      if( acc.norm != 0.0 ) {
+         for( dip::uint jj = 0; jj < c.mean.size(); jj++ ) {
+            dfloat val = acc.sum[ jj ] / acc.norm;
+            maxval = std::max( std::abs( val ), maxval );
+            dfloat dist = val - c.mean[ jj ];
+            change += dist * dist;
+            c.mean[ jj ] = val;
          }
-         c.norm = 0.0;
-         //std::cout << c.mean << " ; ";
       }
-      //std::cout << "change = " << change << '\n';
    }
    return change <= 1e-10 * maxval ? 0.0 : change;
 }
@@ -188,7 +230,9 @@ void LabelClusters(
 CoordinateArray KMeansClustering(
       Image const& in,
       Image& out,
-      dip::uint nClusters
+      Random& random,
+      dip::uint nClusters,
+      dip::uint sampleSize
 ) {
    // Check the image
    DIP_THROW_IF( !in.IsForged(), E::IMAGE_NOT_FORGED );
@@ -201,17 +245,37 @@ CoordinateArray KMeansClustering(
    dip::uint nDims = in.Dimensionality();
    ClusterArray clusters( nClusters, Cluster( nDims ));
 
+   // In sampled mode, we first find the clusters on a regularly subsampled version of the image
+   dip::uint step = 1;
+   if(( sampleSize > 0 ) && ( sampleSize < in.NumberOfPixels() )) {
+      dfloat factor = static_cast< dfloat >( in.NumberOfPixels() ) / static_cast< dfloat >( sampleSize );
+      step = static_cast< dip::uint >( std::pow( factor, 1.0 / static_cast< dfloat >( nDims )));
+   }
+   Image sample = in.QuickCopy();
+   if( step > 1 ) {
+      sample = in.At( RangeArray( nDims, Range{ 0, -1, step } ));
+   }
+
    // Randomly initialise the clusters
-   Random random;
    UniformRandomGenerator generator( random );
    for( auto& cluster : clusters ) {
       for( dip::uint jj = 0; jj < nDims; ++jj ) {
-         cluster.mean[ jj ] = generator( 0, static_cast< dfloat >( in.Size( jj )));
+         cluster.mean[ jj ] = generator( 0, static_cast< dfloat >( sample.Size( jj )));
       }
    }
 
    // Do cluster iterations
-   while( Clustering( in, out, clusters, false ) > 0.0 ) {};
+   while( Clustering( sample, out, clusters, false ) > 0.0 ) {};
+   if( step > 1 ) {
+      // Scale the cluster centers to the full image, and refine them there -- this typically needs few iterations
+      for( auto& cluster : clusters ) {
+         for( auto& m : cluster.mean ) {
+            m *= static_cast< dfloat >( step );
+         }
+      }
+      sample.Strip();
+      while( Clustering( in, out, clusters, false ) > 0.0 ) {};
+   }
    LabelClusters( clusters );
    Clustering( in, out, clusters, true );
 
@@ -224,4 +288,42 @@ CoordinateArray KMeansClustering(
    return coords;
 }
 
+CoordinateArray KMeansClustering(
+      Image const& in,
+      Image& out,
+      dip::uint nClusters,
+      dip::uint sampleSize
+) {
+   Random random;
+   return KMeansClustering( in, out, random, nClusters, sampleSize );
+}
+
 } // namespace dip
+
+
+#ifdef DIP__ENABLE_DOCTEST
+#include "doctest.h"
+#include "diplib/generation.h"
+#include "diplib/multithreading.h"
+#include "diplib/testing.h"
+
+DOCTEST_TEST_CASE("[DIPlib] testing KMeansClustering with different numbers of threads") {
+   dip::Image img{ dip::UnsignedArray{ 300, 250 }, 1, dip::DT_SFLOAT };
+   img.Fill( 0 );
+   dip::Random random( 0 );
+   dip::UniformNoise( img, img, random, 0.0, 1.0 );
+   for( dip::uint sampleSize : { dip::uint( 0 ), dip::uint( 5000 ) } ) {
+      dip::SetNumberOfThreads( 1 );
+      dip::Random random1( 42 );
+      dip::Image out1;
+      dip::CoordinateArray centers1 = dip::KMeansClustering( img, out1, random1, 4, sampleSize );
+      dip::SetNumberOfThreads( 0 );
+      dip::Random randomN( 42 );
+      dip::Image outN;
+      dip::CoordinateArray centersN = dip::KMeansClustering( img, outN, randomN, 4, sampleSize );
+      DOCTEST_CHECK( centers1 == centersN );
+      DOCTEST_CHECK( dip::testing::CompareImages( out1, outN ));
+   }
+}
+
+#endif // DIP__ENABLE_DOCTEST
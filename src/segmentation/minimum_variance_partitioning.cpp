@@ -23,10 +23,10 @@
 #include "diplib.h"
 #include "diplib/segmentation.h"
 #include "diplib/statistics.h"
-#include "diplib/iterators.h"
 #include "diplib/framework.h"
 #include "diplib/overload.h"
 #include "diplib/random.h"
+#include "diplib/multithreading.h"
 
 /* Algorithm:
   - Compute Sum() projections.
@@ -52,6 +52,46 @@ using ProjectionArray = std::vector< Projection >;
 
 typedef ProjectionArray ComputeSumProjectionsFunction( Image const&, UnsignedArray const&, UnsignedArray const& );
 
+// Computes the projections of one chunk of the image, `offset` is the position of the chunk within the
+// projections along `chunkDim`.
+template< typename TPI >
+class dip__SumProjections : public Framework::ScanLineFilter {
+   public:
+      virtual dip::uint GetNumberOfOperations( dip::uint, dip::uint, dip::uint ) override { return 2; }
+      virtual void Filter( Framework::ScanLineFilterParameters const& params ) override {
+         TPI const* in = static_cast< TPI const* >( params.inBuffer[ 0 ].buffer );
+         dip::sint inStride = params.inBuffer[ 0 ].stride;
+         dip::uint bufferLength = params.bufferLength;
+         dip::uint procDim = params.dimension;
+         UnsignedArray pos = params.position;
+         pos[ chunkDim_ ] += offset_;
+         ProjectionType* line = projections_[ procDim ].data() + pos[ procDim ];
+         ProjectionType sum = 0;
+         for( dip::uint ii = 0; ii < bufferLength; ++ii, in += inStride ) {
+            ProjectionType value = static_cast< ProjectionType >( *in );
+            line[ ii ] += value;
+            sum += value;
+         }
+         // The whole line projects onto a single bin for each of the other dimensions
+         for( dip::uint dim = 0; dim < pos.size(); ++dim ) {
+            if( dim != procDim ) {
+               projections_[ dim ][ pos[ dim ]] += sum;
+            }
+         }
+      }
+      dip__SumProjections( ProjectionArray& projections, dip::uint chunkDim, dip::uint offset )
+            : projections_( projections ), chunkDim_( chunkDim ), offset_( offset ) {}
+   private:
+      ProjectionArray& projections_;
+      dip::uint chunkDim_;
+      dip::uint offset_;
+};
+
+// The partition is divided into this many chunks along one dimension, each chunk computing its own projections.
+// The chunks do not depend on the number of threads, and are added in order, so that the result is exactly
+// the same independently of how many threads are used.
+constexpr dip::uint nProjectionChunks = 64;
+
 template< typename TPI >
 ProjectionArray ComputeSumProjections(
       Image const& img,
@@ -60,22 +100,48 @@ ProjectionArray ComputeSumProjections(
 ) {
    DIP_ASSERT( img.DataType() == DataType( TPI( 0 )));
    dip::uint nDims = img.Dimensionality();
-   ProjectionArray out( nDims );
-   UnsignedArray sizes( nDims );
+   ProjectionArray empty( nDims );
+   RangeArray ranges( nDims );
+   dip::uint chunkDim = 0;
    for( dip::uint dim = 0; dim < nDims; ++dim ) {
       DIP_ASSERT( leftEdges[ dim ] <= rightEdges[ dim ] );
-      sizes[ dim ] = rightEdges[ dim ] - leftEdges[ dim ] + 1;
-      out[ dim ].resize( sizes[ dim ] );
-      std::fill( out[ dim ].begin(), out[ dim ].end(), 0 ); // resize initializes new values to 0, but we don't know what was there before.
+      empty[ dim ].resize( rightEdges[ dim ] - leftEdges[ dim ] + 1, 0 );
+      ranges[ dim ] = Range{ static_cast< dip::sint >( leftEdges[ dim ] ), static_cast< dip::sint >( rightEdges[ dim ] ) };
+      if( empty[ dim ].size() > empty[ chunkDim ].size() ) {
+         chunkDim = dim;
+      }
    }
-   ImageIterator< TPI > it( img, leftEdges, sizes );
-   do {
+   dip::uint chunkSize = empty[ chunkDim ].size();
+   dip::uint nChunks = std::min( chunkSize, nProjectionChunks );
+   std::vector< ProjectionArray > projections( nChunks, empty );
+   dip::uint nPixels = 1;
+   for( auto const& p : empty ) {
+      nPixels *= p.size();
+   }
+   dip::uint nThreads = 2 * nPixels < threadingThreshold ? 1 : std::min( GetNumberOfThreads(), nChunks );
+   #pragma omp parallel for schedule( dynamic ) num_threads( static_cast< int >( nThreads ))
+   for( dip::sint chunk = 0; chunk < static_cast< dip::sint >( nChunks ); ++chunk ) {
+      dip::uint uChunk = static_cast< dip::uint >( chunk );
+      dip::uint start = uChunk * chunkSize / nChunks;
+      dip::uint end = ( uChunk + 1 ) * chunkSize / nChunks;
+      RangeArray chunkRanges = ranges;
+      chunkRanges[ chunkDim ] = Range{ static_cast< dip::sint >( leftEdges[ chunkDim ] + start ),
+                                       static_cast< dip::sint >( leftEdges[ chunkDim ] + end - 1 ) };
+      Image view = img.At( chunkRanges );
+      dip__SumProjections< TPI > lineFilter( projections[ uChunk ], chunkDim, start );
+      Framework::ScanSingleInput( view, {}, view.DataType(), lineFilter,
+                                  Framework::ScanOption::NeedCoordinates + Framework::ScanOption::NoMultiThreading );
+   }
+   // Add the projections of all chunks, in order
+   ProjectionArray& out = projections[ 0 ];
+   for( dip::uint tt = 1; tt < nChunks; ++tt ) {
       for( dip::uint dim = 0; dim < nDims; ++dim ) {
-         dip::uint ii = it.Coordinates()[ dim ];
-         out[ dim ][ ii ] += static_cast< ProjectionType >( *it );
+         for( dip::uint ii = 0; ii < out[ dim ].size(); ++ii ) {
+            out[ dim ][ ii ] += projections[ tt ][ dim ][ ii ];
+         }
       }
-   } while( ++it );
-   return out;
+   }
+   return std::move( out );
 }
 
 class KDTree {
@@ -119,8 +185,6 @@ class KDTree {
 
          // Splits this partition along `optimalDim`, putting the right half into `other`
          void Split( Partition& other ) {
-            std::cout << "Splitting along dimension " << optimalDim << ", threshold = " << threshold << '\n';
-            std::cout << "leftEdge = " << leftEdges[ optimalDim ] << ", rightEdge = " << rightEdges[ optimalDim ] << '\n';
             dip::uint n = nPixels / ( rightEdges[ optimalDim ] - leftEdges[ optimalDim ] + 1 );
             dip::uint leftSize = threshold - leftEdges[ optimalDim ] + 1;
             dip::uint rightSize = rightEdges[ optimalDim ] - threshold;
@@ -346,7 +410,7 @@ void PaintClusters( Image& labs, KDTree const& clusters ) {
    DataTypeArray outImageTypes{ DT_LABEL };
    dip__PaintClusters lineFilter( clusters );
    DIP_STACK_TRACE_THIS( Framework::Scan( {}, outImage, {}, outBufferTypes, outImageTypes, { 1 }, lineFilter,
-                                          Framework::ScanOption::NeedCoordinates + Framework::ScanOption::NoMultiThreading ));
+                                          Framework::ScanOption::NeedCoordinates ));
    labs.Protect( false );
 }
 
@@ -370,3 +434,27 @@ CoordinateArray MinimumVariancePartitioning(
 }
 
 } // namespace dip
+
+
+#ifdef DIP__ENABLE_DOCTEST
+#include "doctest.h"
+#include "diplib/generation.h"
+#include "diplib/multithreading.h"
+#include "diplib/testing.h"
+
+DOCTEST_TEST_CASE("[DIPlib] testing MinimumVariancePartitioning with different numbers of threads") {
+   dip::Image img{ dip::UnsignedArray{ 300, 250 }, 1, dip::DT_SFLOAT };
+   img.Fill( 0 );
+   dip::Random random( 0 );
+   dip::UniformNoise( img, img, random, 0.0, 1.0 );
+   dip::SetNumberOfThreads( 1 );
+   dip::Image out1;
+   dip::CoordinateArray centers1 = dip::MinimumVariancePartitioning( img, out1, 7 );
+   dip::SetNumberOfThreads( 0 );
+   dip::Image outN;
+   dip::CoordinateArray centersN = dip::MinimumVariancePartitioning( img, outN, 7 );
+   DOCTEST_CHECK( centers1 == centersN );
+   DOCTEST_CHECK( dip::testing::CompareImages( out1, outN ));
+}
+
+#endif // DIP__ENABLE_DOCTEST
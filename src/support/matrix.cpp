@@ -19,6 +19,7 @@
  */
 
 #include "diplib/library/numeric.h"
+#include "symmetric_eigensolver.h"
 
 #if defined(__GNUG__) || defined(__clang__)
 // For this file, turn off -Wsign-conversion, Eigen is really bad at this!
@@ -35,12 +36,46 @@
 
 namespace dip {
 
+namespace {
+
+// Uses the closed-form solutions for 2x2 and 3x3 matrices, which don't allocate. Returns false for other sizes.
+// `vectors` can be nullptr; `lambdas` and `vectors` have as many elements as `SymmetricEigenDecomposition` writes.
+bool SmallSymmetricEigenDecomposition(
+      dip::uint n,
+      ConstSampleIterator< dfloat > input, // only the lower triangle is used
+      dfloat* lambdas,
+      dfloat* vectors
+) {
+   switch( n ) {
+      case 2:
+         symmetric_eigensolver::Decompose2( input[ 0 ], input[ 3 ], input[ 1 ], lambdas, vectors );
+         return true;
+      case 3:
+         symmetric_eigensolver::Decompose3( input[ 0 ], input[ 4 ], input[ 8 ], input[ 1 ], input[ 2 ], input[ 5 ], lambdas, vectors );
+         return true;
+      default:
+         return false;
+   }
+}
+
+} // namespace
+
 void SymmetricEigenDecomposition(
       dip::uint n,
       ConstSampleIterator< dfloat > input,
       SampleIterator< dfloat > lambdas,
       SampleIterator< dfloat > vectors
 ) {
+   if(( n == 2 ) || ( n == 3 )) {
+      dfloat tmpLambdas[ 3 ];
+      dfloat tmpVectors[ 9 ];
+      SmallSymmetricEigenDecomposition( n, input, tmpLambdas, vectors ? tmpVectors : nullptr );
+      std::copy( tmpLambdas, tmpLambdas + n, lambdas );
+      if( vectors ) {
+         std::copy( tmpVectors, tmpVectors + n * n, vectors );
+      }
+      return;
+   }
    DIP_ASSERT( input.Stride() >= 0 );
    Eigen::Map< Eigen::MatrixXd const, 0, Eigen::InnerStride<> > matrix( input.Pointer(), n, n, Eigen::InnerStride<>( input.Stride() ));
    if( vectors ) {
@@ -72,6 +107,12 @@ void LargestEigenVector(
       ConstSampleIterator< dfloat > input,
       SampleIterator< dfloat > vector
 ) {
+   dfloat tmpLambdas[ 3 ];
+   dfloat tmpVectors[ 9 ];
+   if( SmallSymmetricEigenDecomposition( n, input, tmpLambdas, tmpVectors )) {
+      std::copy( tmpVectors, tmpVectors + n, vector );
+      return;
+   }
    DIP_ASSERT( input.Stride() >= 0 );
    Eigen::Map< Eigen::MatrixXd const, 0, Eigen::InnerStride<> > matrix( input.Pointer(), n, n, Eigen::InnerStride<>( input.Stride() ));
    Eigen::SelfAdjointEigenSolver< Eigen::MatrixXd > eigensolver( matrix );
@@ -92,6 +133,12 @@ void SmallestEigenVector(
       ConstSampleIterator< dfloat > input,
       SampleIterator< dfloat > vector
 ) {
+   dfloat tmpLambdas[ 3 ];
+   dfloat tmpVectors[ 9 ];
+   if( SmallSymmetricEigenDecomposition( n, input, tmpLambdas, tmpVectors )) {
+      std::copy( tmpVectors + ( n - 1 ) * n, tmpVectors + n * n, vector );
+      return;
+   }
    DIP_ASSERT( input.Stride() >= 0 );
    Eigen::Map< Eigen::MatrixXd const, 0, Eigen::InnerStride<> > matrix( input.Pointer(), n, n, Eigen::InnerStride<>( input.Stride() ));
    Eigen::SelfAdjointEigenSolver< Eigen::MatrixXd > eigensolver( matrix );
@@ -434,4 +481,50 @@ DOCTEST_TEST_CASE("[DIPlib] testing the SingularValueDecomposition and related f
    DOCTEST_CHECK( x[ 1 ] == doctest::Approx( 2.0 ));
 }
 
+DOCTEST_TEST_CASE("[DIPlib] testing the closed-form symmetric EigenDecomposition") {
+   // Compare against Eigen, by embedding the 3x3 matrix in a 4x4 one with a well-separated 4th eigenvalue
+   dip::dfloat matrices[][ 6 ] = {
+         { 1.0, 2.0, 3.0, 0.5, -0.3, 0.8 },
+         { 2.0, 2.0, 2.0, 1e-9, 0.0, -1e-9 },      // nearly a multiple of the identity
+         { 1.0, 1.0, 4.0, 1.0, 1e-3, 2e-3 },       // two nearly equal eigenvalues
+         { 1e-20, 3e-20, -2e-20, 1e-20, 2e-20, 0.0 },
+         { 5e20, 1e20, 2e20, -1e20, 3e20, 1e19 },
+   };
+   for( auto const& packed : matrices ) {
+      dip::dfloat lambdas[ 3 ];
+      dip::dfloat vectors[ 9 ];
+      dip::SymmetricEigenDecompositionPacked( 3, packed, lambdas, vectors );
+      dip::dfloat scale = 0;
+      for( dip::dfloat v : packed ) {
+         scale = std::max( scale, std::abs( v ));
+      }
+      dip::dfloat matrix4[ 16 ] = {};
+      matrix4[ 0 ] = packed[ 0 ];
+      matrix4[ 5 ] = packed[ 1 ];
+      matrix4[ 10 ] = packed[ 2 ];
+      matrix4[ 1 ] = packed[ 3 ];
+      matrix4[ 2 ] = packed[ 4 ];
+      matrix4[ 6 ] = packed[ 5 ];
+      matrix4[ 15 ] = -100 * scale;
+      dip::dfloat lambdas4[ 4 ];
+      dip::SymmetricEigenDecomposition( 4, matrix4, lambdas4 );
+      for( dip::uint ii = 0; ii < 3; ++ii ) {
+         DOCTEST_CHECK( std::abs( lambdas[ ii ] - lambdas4[ ii ] ) <= 1e-14 * scale );
+      }
+      // A v == lambda v, and the vectors are orthonormal
+      dip::dfloat full[ 9 ] = { packed[ 0 ], packed[ 3 ], packed[ 4 ], packed[ 3 ], packed[ 1 ], packed[ 5 ], packed[ 4 ], packed[ 5 ], packed[ 2 ] };
+      for( dip::uint ii = 0; ii < 3; ++ii ) {
+         dip::dfloat const* v = vectors + ii * 3;
+         for( dip::uint jj = 0; jj < 3; ++jj ) {
+            dip::dfloat Av = full[ jj ] * v[ 0 ] + full[ jj + 3 ] * v[ 1 ] + full[ jj + 6 ] * v[ 2 ];
+            DOCTEST_CHECK( std::abs( Av - lambdas[ ii ] * v[ jj ] ) <= 1e-12 * scale );
+         }
+         for( dip::uint jj = 0; jj < 3; ++jj ) {
+            dip::dfloat const* w = vectors + jj * 3;
+            DOCTEST_CHECK( std::abs( v[ 0 ] * w[ 0 ] + v[ 1 ] * w[ 1 ] + v[ 2 ] * w[ 2 ] - ( ii == jj ? 1.0 : 0.0 )) < 1e-12 );
+         }
+      }
+   }
+}
+
 #endif // DIP__ENABLE_DOCTEST
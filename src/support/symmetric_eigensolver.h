@@ -0,0 +1,328 @@
+/*
+ * DIPlib 3.0
+ * This file contains closed-form eigen-decompositions of symmetric 2x2 and 3x3 matrices.
+ *
+ * (c)2026, Cris Luengo.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DIP_SYMMETRIC_EIGENSOLVER_H
+#define DIP_SYMMETRIC_EIGENSOLVER_H
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "diplib/library/types.h"
+#include "diplib/library/numeric.h"
+
+
+// These functions do not allocate memory and do not iterate, they are meant to be called for each pixel
+// of a tensor image. They are templated on the floating-point type used for the computations (`sfloat` or
+// `dfloat`).
+//
+// The input is given as the unique elements of the matrix, in the order used by symmetric tensor images. The
+// eigenvalues are written to `lambdas`, sorted largest to smallest. If `vectors` is not `nullptr`, the
+// corresponding normalized eigenvectors are written to it, the eigenvector for `lambdas[ ii ]` starts at
+// `vectors[ ii * n ]`. This is the same output layout as `dip::SymmetricEigenDecomposition`. The sign of each
+// eigenvector is chosen such that its largest component (the first one in case of ties) is positive.
+
+
+namespace dip {
+namespace symmetric_eigensolver {
+
+namespace detail {
+
+template< typename TPF >
+void NormalizeSign( TPF* vector, dip::uint n ) {
+   dip::uint largest = 0;
+   for( dip::uint ii = 1; ii < n; ++ii ) {
+      if( std::abs( vector[ ii ] ) > std::abs( vector[ largest ] )) {
+         largest = ii;
+      }
+   }
+   if( vector[ largest ] < 0 ) {
+      for( dip::uint ii = 0; ii < n; ++ii ) {
+         vector[ ii ] = -vector[ ii ];
+      }
+   }
+}
+
+} // namespace detail
+
+// The matrix [ xx, xy ; xy, yy ]
+template< typename TPF >
+void Decompose2( TPF xx, TPF yy, TPF xy, TPF* lambdas, TPF* vectors ) {
+   TPF mean = ( xx + yy ) / TPF( 2 );
+   TPF halfDiff = ( xx - yy ) / TPF( 2 );
+   TPF radius = std::hypot( halfDiff, xy );
+   lambdas[ 0 ] = mean + radius;
+   lambdas[ 1 ] = mean - radius;
+   if( vectors ) {
+      // The eigenvector for lambdas[ 0 ] is orthogonal to either row of ( A - lambdas[ 0 ] I ), we pick the
+      // expression that avoids cancellation.
+      TPF v0, v1;
+      if( halfDiff >= 0 ) {
+         v0 = halfDiff + radius;
+         v1 = xy;
+      } else {
+         v0 = xy;
+         v1 = radius - halfDiff;
+      }
+      TPF norm = std::hypot( v0, v1 );
+      if( norm > 0 ) {
+         v0 /= norm;
+         v1 /= norm;
+      } else {
+         // A multiple of the identity matrix
+         v0 = 1;
+         v1 = 0;
+      }
+      vectors[ 0 ] = v0;
+      vectors[ 1 ] = v1;
+      vectors[ 2 ] = -v1;
+      vectors[ 3 ] = v0;
+      detail::NormalizeSign( vectors, 2 );
+      detail::NormalizeSign( vectors + 2, 2 );
+   }
+}
+
+namespace detail {
+
+template< typename TPF >
+void Cross( TPF const* a, TPF const* b, TPF* out ) {
+   out[ 0 ] = a[ 1 ] * b[ 2 ] - a[ 2 ] * b[ 1 ];
+   out[ 1 ] = a[ 2 ] * b[ 0 ] - a[ 0 ] * b[ 2 ];
+   out[ 2 ] = a[ 0 ] * b[ 1 ] - a[ 1 ] * b[ 0 ];
+}
+
+template< typename TPF >
+TPF Dot( TPF const* a, TPF const* b ) {
+   return a[ 0 ] * b[ 0 ] + a[ 1 ] * b[ 1 ] + a[ 2 ] * b[ 2 ];
+}
+
+// The eigenvector for an eigenvalue of multiplicity 1 is orthogonal to the rows of ( A - lambda I ), which has
+// rank 2. We take the cross product of the pair of rows that yields the largest result.
+template< typename TPF >
+void EigenvectorOfSingleEigenvalue( TPF xx, TPF yy, TPF zz, TPF xy, TPF xz, TPF yz, TPF lambda, TPF* vector ) {
+   TPF row0[ 3 ] = { xx - lambda, xy, xz };
+   TPF row1[ 3 ] = { xy, yy - lambda, yz };
+   TPF row2[ 3 ] = { xz, yz, zz - lambda };
+   TPF c01[ 3 ], c02[ 3 ], c12[ 3 ];
+   Cross( row0, row1, c01 );
+   Cross( row0, row2, c02 );
+   Cross( row1, row2, c12 );
+   TPF d01 = Dot( c01, c01 );
+   TPF d02 = Dot( c02, c02 );
+   TPF d12 = Dot( c12, c12 );
+   TPF* best = c01;
+   TPF dBest = d01;
+   if( d02 > dBest ) {
+      best = c02;
+      dBest = d02;
+   }
+   if( d12 > dBest ) {
+      best = c12;
+      dBest = d12;
+   }
+   if( dBest > 0 ) {
+      TPF norm = std::sqrt( dBest );
+      vector[ 0 ] = best[ 0 ] / norm;
+      vector[ 1 ] = best[ 1 ] / norm;
+      vector[ 2 ] = best[ 2 ] / norm;
+   } else {
+      vector[ 0 ] = 1;
+      vector[ 1 ] = 0;
+      vector[ 2 ] = 0;
+   }
+}
+
+// Given the eigenvector `v0`, finds the eigenvector for `lambda` by solving the 2x2 problem in the plane orthogonal
+// to `v0`. This is robust also when `lambda` has multiplicity 2.
+template< typename TPF >
+void EigenvectorInOrthogonalPlane( TPF xx, TPF yy, TPF zz, TPF xy, TPF xz, TPF yz, TPF const* v0, TPF lambda, TPF* vector ) {
+   // Orthonormal basis { u, v } of the plane orthogonal to `v0`
+   TPF u[ 3 ];
+   if( std::abs( v0[ 0 ] ) > std::abs( v0[ 1 ] )) {
+      TPF invLength = TPF( 1 ) / std::sqrt( v0[ 0 ] * v0[ 0 ] + v0[ 2 ] * v0[ 2 ] );
+      u[ 0 ] = -v0[ 2 ] * invLength;
+      u[ 1 ] = 0;
+      u[ 2 ] = v0[ 0 ] * invLength;
+   } else {
+      TPF invLength = TPF( 1 ) / std::sqrt( v0[ 1 ] * v0[ 1 ] + v0[ 2 ] * v0[ 2 ] );
+      u[ 0 ] = 0;
+      u[ 1 ] = v0[ 2 ] * invLength;
+      u[ 2 ] = -v0[ 1 ] * invLength;
+   }
+   TPF v[ 3 ];
+   Cross( v0, u, v );
+   // The 2x2 matrix [ m00, m01 ; m01, m11 ] = [ u, v ]^T ( A - lambda I ) [ u, v ]
+   TPF Au[ 3 ] = { xx * u[ 0 ] + xy * u[ 1 ] + xz * u[ 2 ],
+                   xy * u[ 0 ] + yy * u[ 1 ] + yz * u[ 2 ],
+                   xz * u[ 0 ] + yz * u[ 1 ] + zz * u[ 2 ] };
+   TPF Av[ 3 ] = { xx * v[ 0 ] + xy * v[ 1 ] + xz * v[ 2 ],
+                   xy * v[ 0 ] + yy * v[ 1 ] + yz * v[ 2 ],
+                   xz * v[ 0 ] + yz * v[ 1 ] + zz * v[ 2 ] };
+   TPF m00 = Dot( u, Au ) - lambda;
+   TPF m01 = Dot( u, Av );
+   TPF m11 = Dot( v, Av ) - lambda;
+   // The solution ( a, b ) is orthogonal to the largest row of the 2x2 matrix
+   TPF absM00 = std::abs( m00 );
+   TPF absM01 = std::abs( m01 );
+   TPF absM11 = std::abs( m11 );
+   TPF a = 1;
+   TPF b = 0;
+   if( absM00 >= absM11 ) {
+      if( std::max( absM00, absM01 ) > 0 ) {
+         if( absM00 >= absM01 ) {
+            m01 /= m00;
+            m00 = TPF( 1 ) / std::sqrt( TPF( 1 ) + m01 * m01 );
+            m01 *= m00;
+         } else {
+            m00 /= m01;
+            m01 = TPF( 1 ) / std::sqrt( TPF( 1 ) + m00 * m00 );
+            m00 *= m01;
+         }
+         a = m01;
+         b = -m00;
+      }
+   } else {
+      if( std::max( absM11, absM01 ) > 0 ) {
+         if( absM11 >= absM01 ) {
+            m01 /= m11;
+            m11 = TPF( 1 ) / std::sqrt( TPF( 1 ) + m01 * m01 );
+            m01 *= m11;
+         } else {
+            m11 /= m01;
+            m01 = TPF( 1 ) / std::sqrt( TPF( 1 ) + m11 * m11 );
+            m11 *= m01;
+         }
+         a = m11;
+         b = -m01;
+      }
+   }
+   vector[ 0 ] = a * u[ 0 ] + b * v[ 0 ];
+   vector[ 1 ] = a * u[ 1 ] + b * v[ 1 ];
+   vector[ 2 ] = a * u[ 2 ] + b * v[ 2 ];
+}
+
+// The 3x3 matrix where axis `kk` is decoupled from the other two, `ii` and `jj`: its eigenvalue is `lambdaK`, and
+// the remaining 2x2 matrix is [ a, c ; c, b ].
+template< typename TPF >
+void DecomposeDecoupled( dip::uint kk, TPF lambdaK, dip::uint ii, dip::uint jj, TPF a, TPF b, TPF c, TPF* lambdas, TPF* vectors ) {
+   TPF lambdas2[ 2 ];
+   TPF vectors2[ 4 ];
+   Decompose2( a, b, c, lambdas2, vectors ? vectors2 : nullptr );
+   dip::uint posK = lambdaK >= lambdas2[ 0 ] ? 0 : ( lambdaK >= lambdas2[ 1 ] ? 1 : 2 );
+   for( dip::uint pos = 0, pos2 = 0; pos < 3; ++pos ) {
+      if( pos == posK ) {
+         lambdas[ pos ] = lambdaK;
+         if( vectors ) {
+            TPF* vector = vectors + pos * 3;
+            vector[ ii ] = vector[ jj ] = 0;
+            vector[ kk ] = 1;
+         }
+      } else {
+         lambdas[ pos ] = lambdas2[ pos2 ];
+         if( vectors ) {
+            TPF* vector = vectors + pos * 3;
+            vector[ kk ] = 0;
+            vector[ ii ] = vectors2[ pos2 * 2 ];
+            vector[ jj ] = vectors2[ pos2 * 2 + 1 ];
+         }
+         ++pos2;
+      }
+   }
+}
+
+} // namespace detail
+
+// The matrix [ xx, xy, xz ; xy, yy, yz ; xz, yz, zz ]
+//
+// The eigenvalues are computed with the trigonometric solution of the characteristic polynomial, the eigenvectors
+// with cross products, following D. Eberly, "A Robust Eigensolver for 3x3 Symmetric Matrices", Geometric Tools, 2014.
+template< typename TPF >
+void Decompose3( TPF xx, TPF yy, TPF zz, TPF xy, TPF xz, TPF yz, TPF* lambdas, TPF* vectors ) {
+   // If one axis is decoupled from the other two, the problem reduces to a 2x2 one. This includes diagonal matrices.
+   if(( xy == 0 ) && ( xz == 0 )) {
+      detail::DecomposeDecoupled( 0, xx, 1, 2, yy, zz, yz, lambdas, vectors );
+      return;
+   }
+   if(( xy == 0 ) && ( yz == 0 )) {
+      detail::DecomposeDecoupled( 1, yy, 0, 2, xx, zz, xz, lambdas, vectors );
+      return;
+   }
+   if(( xz == 0 ) && ( yz == 0 )) {
+      detail::DecomposeDecoupled( 2, zz, 0, 1, xx, yy, xy, lambdas, vectors );
+      return;
+   }
+   // Scale the matrix to avoid overflow and underflow (`scale` is not zero here)
+   TPF scale = std::max( std::max( std::max( std::abs( xx ), std::abs( yy )), std::max( std::abs( zz ), std::abs( xy ))),
+                         std::max( std::abs( xz ), std::abs( yz )));
+   xx /= scale;
+   yy /= scale;
+   zz /= scale;
+   xy /= scale;
+   xz /= scale;
+   yz /= scale;
+   // Eigenvalues of B = ( A - q I ) / p are 2 cos( phi + 2 k pi / 3 ), with cos( 3 phi ) = det( B ) / 2
+   TPF q = ( xx + yy + zz ) / TPF( 3 );
+   TPF b00 = xx - q;
+   TPF b11 = yy - q;
+   TPF b22 = zz - q;
+   TPF offDiagonal = xy * xy + xz * xz + yz * yz;
+   TPF p = std::sqrt(( b00 * b00 + b11 * b11 + b22 * b22 + TPF( 2 ) * offDiagonal ) / TPF( 6 ));
+   TPF beta[ 3 ]; // largest to smallest
+   TPF halfDet = 0;
+   if( p > 0 ) {
+      TPF c00 = b11 * b22 - yz * yz;
+      TPF c01 = xy * b22 - yz * xz;
+      TPF c02 = xy * yz - b11 * xz;
+      halfDet = ( b00 * c00 - xy * c01 + xz * c02 ) / ( TPF( 2 ) * p * p * p );
+      halfDet = clamp( halfDet, TPF( -1 ), TPF( 1 ));
+      TPF phi = std::acos( halfDet ) / TPF( 3 );
+      beta[ 0 ] = TPF( 2 ) * std::cos( phi );
+      beta[ 2 ] = TPF( 2 ) * std::cos( phi + TPF( 2.0 * pi / 3.0 ));
+      beta[ 1 ] = -( beta[ 0 ] + beta[ 2 ] );
+   } else {
+      beta[ 0 ] = beta[ 1 ] = beta[ 2 ] = 0;
+   }
+   for( dip::uint ii = 0; ii < 3; ++ii ) {
+      lambdas[ ii ] = q + p * beta[ ii ];
+   }
+   if( vectors ) {
+      if( halfDet >= 0 ) {
+         // The largest eigenvalue is the most separated one
+         detail::EigenvectorOfSingleEigenvalue( xx, yy, zz, xy, xz, yz, lambdas[ 0 ], vectors );
+         detail::EigenvectorInOrthogonalPlane( xx, yy, zz, xy, xz, yz, vectors, lambdas[ 1 ], vectors + 3 );
+         detail::Cross( vectors, vectors + 3, vectors + 6 );
+      } else {
+         // The smallest eigenvalue is the most separated one
+         detail::EigenvectorOfSingleEigenvalue( xx, yy, zz, xy, xz, yz, lambdas[ 2 ], vectors + 6 );
+         detail::EigenvectorInOrthogonalPlane( xx, yy, zz, xy, xz, yz, vectors + 6, lambdas[ 1 ], vectors + 3 );
+         detail::Cross( vectors + 3, vectors + 6, vectors );
+      }
+      for( dip::uint ii = 0; ii < 3; ++ii ) {
+         detail::NormalizeSign( vectors + ii * 3, 3 );
+      }
+   }
+   for( dip::uint ii = 0; ii < 3; ++ii ) {
+      lambdas[ ii ] *= scale;
+   }
+}
+
+} // namespace symmetric_eigensolver
+} // namespace dip
+
+#endif // DIP_SYMMETRIC_EIGENSOLVER_H
@@ -17,9 +17,13 @@
  * limitations under the License.
  */
 
+#include <vector>
+
 #include "diplib.h"
 #include "diplib/transform.h"
-#include "diplib/generation.h"
+#include "diplib/generic_iterators.h"
+#include "diplib/multithreading.h"
+#include "diplib/overload.h"
 
 namespace dip {
 
@@ -65,6 +69,105 @@ bool clip(IntegerArray &A, IntegerArray &B, IntegerArray const &Pmax) {
    }
 }
 
+// An edge pixel: its coordinates and, if a gradient image was given, the direction of the gradient.
+struct EdgePixel {
+   dip::sint x;
+   dip::sint y;
+   dip::dfloat angle;
+};
+using EdgePixelList = std::vector< EdgePixel >;
+
+template< typename TPI >
+void dip__EdgePixels( Image const& in, Image const& gv, EdgePixelList& edges ) {
+   dip::uint width = in.Size( 0 );
+   dip::uint height = in.Size( 1 );
+   dip::sint inStride0 = in.Stride( 0 );
+   dip::sint inStride1 = in.Stride( 1 );
+   bin const* inLine = static_cast< bin const* >( in.Origin() );
+   bool hasGradient = gv.IsForged();
+   dip::sint gvStride0 = hasGradient ? gv.Stride( 0 ) : 0;
+   dip::sint gvStride1 = hasGradient ? gv.Stride( 1 ) : 0;
+   dip::sint gvTensorStride = hasGradient ? gv.TensorStride() : 0;
+   TPI const* gvLine = hasGradient ? static_cast< TPI const* >( gv.Origin() ) : nullptr;
+   for( dip::uint y = 0; y < height; ++y, inLine += inStride1, gvLine += gvStride1 ) {
+      bin const* inPtr = inLine;
+      TPI const* gvPtr = gvLine;
+      for( dip::uint x = 0; x < width; ++x, inPtr += inStride0, gvPtr += gvStride0 ) {
+         if( *inPtr ) {
+            dip::dfloat angle = 0;
+            if( hasGradient ) {
+               angle = std::atan2( static_cast< dip::dfloat >( gvPtr[ gvTensorStride ] ), static_cast< dip::dfloat >( gvPtr[ 0 ] ));
+            }
+            edges.push_back( { static_cast< dip::sint >( x ), static_cast< dip::sint >( y ), angle } );
+         }
+      }
+   }
+}
+
+// Collects the set pixels of the 2D binary image `in` in a single pass over the image. `gv`, if forged, is a
+// real-valued 2-vector image of the same sizes, giving the gradient direction at each pixel.
+EdgePixelList EdgePixels( Image const& in, Image const& gv ) {
+   EdgePixelList edges;
+   DIP_OVL_CALL_REAL( dip__EdgePixels, ( in, gv, edges ), gv.IsForged() ? gv.DataType() : DT_SFLOAT );
+   return edges;
+}
+
+// The accumulation engine for the Hough transforms below. `vote( edge, accumulator )` adds the votes for one
+// edge pixel to `accumulator`, which has the sizes of `out` and normal strides. The edge pixels are divided over
+// the threads, each thread votes into its own accumulator, and these are added together (in parallel) at the end.
+// Votes are small integer counts, which single-precision floats represent exactly, so the result does not depend
+// on the number of threads. `operations` is the cost of voting for a single edge pixel. `vote` must not throw.
+template< typename F >
+void AccumulateVotes( EdgePixelList const& edges, Image& out, dip::uint operations, F const& vote ) {
+   dip::uint nPixels = out.NumberOfPixels();
+   dip::uint nEdges = edges.size();
+   // Each additional thread clears and adds an accumulator, this must be small compared to the voting
+   dip::uint nThreads = 1;
+   if( nEdges * operations >= threadingThreshold ) {
+      nThreads = std::min( GetNumberOfThreads(), std::max( dip::uint( 1 ), nEdges * operations / nPixels ));
+   }
+   Image acc = out.QuickCopy();
+   if( !acc.HasNormalStrides() ) {
+      acc = Image( out.Sizes(), 1, DT_SFLOAT );
+   }
+   acc.Fill( 0 );
+   sfloat* accPtr = static_cast< sfloat* >( acc.Origin() );
+   std::vector< std::vector< sfloat >> buffers( nThreads - 1 );
+   #pragma omp parallel num_threads( static_cast< int >( nThreads ))
+   {
+      dip::uint thread = static_cast< dip::uint >( omp_get_thread_num() );
+      sfloat* threadAcc = accPtr;
+      if( thread > 0 ) {
+         buffers[ thread - 1 ].resize( nPixels, 0.0f );
+         threadAcc = buffers[ thread - 1 ].data();
+      }
+      #pragma omp for schedule( dynamic, 64 )
+      for( dip::sint ii = 0; ii < static_cast< dip::sint >( nEdges ); ++ii ) {
+         vote( edges[ static_cast< dip::uint >( ii ) ], threadAcc );
+      }
+      #pragma omp for schedule( static )
+      for( dip::sint ii = 0; ii < static_cast< dip::sint >( nPixels ); ++ii ) {
+         for( auto const& buffer : buffers ) {
+            accPtr[ ii ] += buffer[ static_cast< dip::uint >( ii ) ];
+         }
+      }
+   }
+   if( !acc.IsIdenticalView( out )) {
+      out.Copy( acc );
+   }
+}
+
+// Adds 1 to each pixel on the line segment between `start` and `end`, after clipping it to the image domain
+// given by `sz` (the largest coordinates). `strides` are the accumulator's strides.
+void VoteLineSegment( IntegerArray start, IntegerArray end, IntegerArray const& sz, IntegerArray const& strides, sfloat* acc ) {
+   if ( clip( start, end, sz ) ) {
+      // Note that after clipping we can be sure that all coordinates are positive
+      for( BresenhamLineIterator it( strides, UnsignedArray( std::move( start )), UnsignedArray( std::move( end ))); it; ++it ) {
+         acc[ *it ] += 1;
+      }
+   }
+}
+
 } // namespace
 
 void HoughTransformCircleCenters(
@@ -81,7 +184,9 @@ void HoughTransformCircleCenters(
    DIP_THROW_IF( !in.IsScalar(), E::IMAGE_NOT_SCALAR );
    DIP_THROW_IF( in.DataType() != DT_BIN, E::IMAGE_NOT_BINARY );
    DIP_THROW_IF( gv.Dimensionality() != nDims, E::DIMENSIONALITIES_DONT_MATCH );
+   DIP_THROW_IF( gv.Sizes() != in.Sizes(), E::SIZES_DONT_MATCH );
    DIP_THROW_IF( gv.TensorElements() != 2, "Only defined for 2-vector images" );
+   DIP_THROW_IF( !gv.DataType().IsReal(), E::DATA_TYPE_NOT_SUPPORTED );
    
    dip::IntegerArray sz{ static_cast< dip::sint >( in.Size(0) - 1), 
                          static_cast< dip::sint >( in.Size(1) - 1) };
@@ -94,58 +199,93 @@ void HoughTransformCircleCenters(
       minsz = static_cast< dip::dfloat >( range[ 0 ] );
       maxsz = static_cast< dip::dfloat >( range[ 1 ] );
    }
-   
+
+   // Find on pixels (before forging `out`, which could be `in`)
+   EdgePixelList edges;
+   DIP_STACK_TRACE_THIS( edges = EdgePixels( in, gv ));
+
    // Initialize accumulator
-   out.ReForge( in.Sizes(), 1, DT_SFLOAT );
-   out.Fill(0);
-   
-   auto coordComp = gv.OffsetToCoordinatesComputer();
+   UnsignedArray sizes = in.Sizes();
+   out.ReForge( sizes, 1, DT_SFLOAT );
+   IntegerArray strides{ 1, static_cast< dip::sint >( sizes[ 0 ] ) };
 
-   // Iterate over on pixels
-   // NOTE: calling end() on View does not work
-   for (auto it = gv.At( in ).begin(); it; ++it) {
-      auto coord = coordComp( it.Offset() );
-      dip::sint x = static_cast< dip::sint >( coord[ 0 ] ),
-                y = static_cast< dip::sint >( coord[ 1 ] );
-      
-      dip::dfloat angle = std::atan2( static_cast< dip::dfloat >( it[ 1 ] ), static_cast< dip::dfloat >( it[ 0 ] ) );
+   // Each on pixel draws lines of up to 2 * maxsz pixels
+   dip::uint operations = 2 * static_cast< dip::uint >( maxsz - minsz ) + 10;
+   AccumulateVotes( edges, out, operations, [ & ]( EdgePixel const& edge, sfloat* acc ) {
+      dip::sint x = edge.x,
+                y = edge.y;
+      dip::dfloat angle = edge.angle;
 
       // TODO: option to select inside or outside
       if (minsz == 0) {
          // Draw single line
          dip::sint cmax = static_cast< dip::sint >( std::cos( angle ) * maxsz ),
                    smax = static_cast< dip::sint >( std::sin( angle ) * maxsz );
-         
-         IntegerArray start{ x - cmax, y - smax }, end{ x + cmax, y + smax };
-         
-         if ( clip( start, end, sz ) ) {
-            // Note that after clipping we can be sure that all coordinates are positive
-            DrawLine( out, UnsignedArray(std::move(start)), UnsignedArray(std::move(end)), { 1 }, S::ADD );
-         }
+
+         VoteLineSegment( { x - cmax, y - smax }, { x + cmax, y + smax }, sz, strides, acc );
       } else {
          // Draw two line segments
          dip::sint cmin = static_cast< dip::sint >( std::cos( angle ) * minsz ),
                    smin = static_cast< dip::sint >( std::sin( angle ) * minsz ),
                    cmax = static_cast< dip::sint >( std::cos( angle ) * maxsz ),
                    smax = static_cast< dip::sint >( std::sin( angle ) * maxsz );
-         
-         IntegerArray start1{ x - cmin, y - smin }, end1{ x - cmax, y - smax },
-                      start2{ x + cmin, y + smin }, end2{ x + cmax, y + smax };
-         
-         if ( clip( start1, end1, sz ) ) {
-            DrawLine( out, UnsignedArray(std::move(start1)), UnsignedArray(std::move(end1)), { 1 }, S::ADD );
-         }
-         if ( clip( start2, end2, sz ) ) {
-            DrawLine( out, UnsignedArray(std::move(start2)), UnsignedArray(std::move(end2)), { 1 }, S::ADD );
-         }
+
+         VoteLineSegment( { x - cmin, y - smin }, { x - cmax, y - smax }, sz, strides, acc );
+         VoteLineSegment( { x + cmin, y + smin }, { x + cmax, y + smax }, sz, strides, acc );
       }
+   } );
+}
+
+void HoughTransformLines(
+      Image const& in,
+      Image& out,
+      dip::uint nAngles
+) {
+   DIP_THROW_IF( !in.IsForged(), E::IMAGE_NOT_FORGED );
+   DIP_THROW_IF( in.Dimensionality() != 2, E::DIMENSIONALITY_NOT_SUPPORTED );
+   DIP_THROW_IF( !in.IsScalar(), E::IMAGE_NOT_SCALAR );
+   DIP_THROW_IF( in.DataType() != DT_BIN, E::IMAGE_NOT_BINARY );
+   DIP_THROW_IF( nAngles < 1, E::INVALID_PARAMETER );
+
+   // Distances are measured from the center pixel of the image
+   dip::sint cx = static_cast< dip::sint >( in.Size( 0 ) / 2 ),
+             cy = static_cast< dip::sint >( in.Size( 1 ) / 2 );
+   dip::dfloat dx = static_cast< dip::dfloat >( std::max( cx, static_cast< dip::sint >( in.Size( 0 )) - 1 - cx )),
+               dy = static_cast< dip::dfloat >( std::max( cy, static_cast< dip::sint >( in.Size( 1 )) - 1 - cy ));
+   dip::sint maxDistance = ceil_cast( std::sqrt( dx * dx + dy * dy ));
+
+   // Find on pixels (before forging `out`, which could be `in`)
+   EdgePixelList edges;
+   DIP_STACK_TRACE_THIS( edges = EdgePixels( in, {} ));
+
+   // Initialize accumulator
+   out.ReForge( { nAngles, static_cast< dip::uint >( 2 * maxDistance + 1 ) }, 1, DT_SFLOAT );
+   dip::sint stride = static_cast< dip::sint >( nAngles );
+
+   // Sine and cosine of each angle
+   std::vector< dip::dfloat > cosines( nAngles ), sines( nAngles );
+   for( dip::uint ii = 0; ii < nAngles; ++ii ) {
+      dip::dfloat angle = static_cast< dip::dfloat >( ii ) * pi / static_cast< dip::dfloat >( nAngles );
+      cosines[ ii ] = std::cos( angle );
+      sines[ ii ] = std::sin( angle );
    }
+
+   // Each on pixel votes once for each angle
+   AccumulateVotes( edges, out, nAngles * 4, [ & ]( EdgePixel const& edge, sfloat* acc ) {
+      dip::dfloat x = static_cast< dip::dfloat >( edge.x - cx ),
+                  y = static_cast< dip::dfloat >( edge.y - cy );
+      for( dip::uint ii = 0; ii < nAngles; ++ii ) {
+         dip::sint distance = round_cast( x * cosines[ ii ] + y * sines[ ii ] ) + maxDistance;
+         acc[ static_cast< dip::sint >( ii ) + distance * stride ] += 1;
+      }
+   } );
 }
 
 } // namespace dip
 
 #ifdef DIP__ENABLE_DOCTEST
 #include "doctest.h"
+#include "diplib/generation.h"
 #include "diplib/linear.h"
 #include "diplib/segmentation.h"
 #include "diplib/statistics.h"
@@ -167,6 +307,31 @@ DOCTEST_TEST_CASE("[DIPlib] testing the HoughTransformCircleCenters function") {
    // Check result   
    DOCTEST_CHECK( m[0] == 512 );
    DOCTEST_CHECK( m[1] == 512 );
+
+   // The accumulator does not depend on the number of threads
+   dip::uint nThreads = dip::GetNumberOfThreads();
+   dip::SetNumberOfThreads( 1 );
+   auto h1 = dip::HoughTransformCircleCenters( bin, gv, { 150, 250 } );
+   dip::SetNumberOfThreads( nThreads );
+   auto h2 = dip::HoughTransformCircleCenters( bin, gv, { 150, 250 } );
+   DOCTEST_CHECK( dip::Count( h1 != h2 ) == 0 );
+}
+
+DOCTEST_TEST_CASE("[DIPlib] testing the HoughTransformLines function") {
+   // Draw a horizontal and a diagonal line
+   dip::Image a( { 200, 100 }, 1, dip::DT_BIN );
+   a.Fill( 0 );
+   dip::DrawLine( a, { 0, 70 }, { 199, 70 } );
+   dip::DrawLine( a, { 10, 10 }, { 89, 89 } );
+   auto h = dip::HoughTransformLines( a, 180 );
+   DOCTEST_REQUIRE( h.Size( 0 ) == 180 );
+   dip::sint maxDistance = ( static_cast< dip::sint >( h.Size( 1 )) - 1 ) / 2;
+   // The horizontal line is at angle 90 degrees, distance 20 from the center pixel (100,50)
+   DOCTEST_CHECK( h.At( 90, static_cast< dip::uint >( maxDistance + 20 )).As< dip::sfloat >() == 200.0f );
+   DOCTEST_CHECK( dip::MaximumPixel( h ) == dip::UnsignedArray{ 90, static_cast< dip::uint >( maxDistance + 20 ) } );
+   // The diagonal line is at angle 135 degrees, distance (t-100)*cos(135)+(t-50)*sin(135) = 35.36; pixel (71,70)
+   // of the horizontal line also falls in this bin
+   DOCTEST_CHECK( h.At( 135, static_cast< dip::uint >( maxDistance + 35 )).As< dip::sfloat >() == 80.0f + 1.0f );
 }
 
 #endif // DIP__ENABLE_DOCTEST
@@ -10,6 +10,7 @@ include/diplib/viewer/include_gl.h
 include/diplib/viewer/link.h
 include/diplib/viewer/manager.h
 include/diplib/viewer/proxy.h
+include/diplib/viewer/pyramid.h
 include/diplib/viewer/slice.h
 include/diplib/viewer/status.h
 include/diplib/viewer/tensor.h
@@ -26,6 +27,7 @@ src/manager.cpp
 src/manager/glfw.cpp
 src/manager/glut.cpp
 src/manager/proxy.cpp
+src/pyramid.cpp
 src/slice.cpp
 src/status.cpp
 src/tensor.cpp
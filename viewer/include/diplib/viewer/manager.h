@@ -58,7 +58,7 @@ class DIPVIEWER_EXPORT Window
     virtual ~Window() { }
 
     /// \brief Refresh window contents.
-    void refresh();
+    virtual void refresh();
     
     /// \brief Marks the window for destruction.
     void destroy() { destroyed_ = true; }
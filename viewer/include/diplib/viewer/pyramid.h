@@ -0,0 +1,77 @@
+/*
+ * DIPlib 3.0 viewer
+ * This file contains definitions for the multi-resolution image pyramid.
+ *
+ * (c)2026, Wouter Caarls
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DIP_VIEWER_PYRAMID_H
+#define DIP_VIEWER_PYRAMID_H
+
+#include <vector>
+
+#include "diplib.h"
+
+#include "diplib/viewer/export.h"
+
+/// \file
+/// \brief Declares `dip::viewer::ImagePyramid`.
+
+namespace dip { namespace viewer {
+
+/// \brief Lazily computed multi-resolution pyramid of an image.
+///
+/// Level 0 is the image itself. Level `l` takes every `2^l`-th pixel along
+/// each dimension, such that it contains only values that occur in the image.
+/// A level is computed when it is first requested, directly from the image,
+/// and kept until a new image is set. Only the levels that are actually used
+/// are stored.
+class DIPVIEWER_CLASS_EXPORT ImagePyramid
+{
+  protected:
+    std::vector<dip::Image> levels_; ///< Computed levels, unforged if not yet requested.
+
+  public:
+    ImagePyramid() { }
+
+    /// \brief Sets the image, discarding all cached levels.
+    DIPVIEWER_EXPORT void setImage(const dip::Image &image);
+
+    /// \brief Returns the image at level 0. Throws if no image was set.
+    const dip::Image &image()
+    {
+      DIP_THROW_IF(levels_.empty(), "No image set");
+      return levels_[0];
+    }
+
+    /// \brief Returns the number of levels, the last one has a single pixel.
+    dip::uint levels() { return levels_.size(); }
+
+    /// \brief Subsampling factor of level `level`.
+    static dip::uint factor(dip::uint level) { return (dip::uint)1 << level; }
+
+    /// \brief Sizes of level `level`, without computing it.
+    DIPVIEWER_EXPORT dip::UnsignedArray sizes(dip::uint level);
+
+    /// \brief Returns level `level`, computing it if necessary.
+    DIPVIEWER_EXPORT const dip::Image &level(dip::uint level);
+
+    /// \brief Returns the finest level with at most `maxSamples` samples (pixels times tensor elements).
+    DIPVIEWER_EXPORT dip::uint coarseLevel(dip::uint maxSamples);
+};
+
+}} // namespace dip::viewer
+
+#endif // DIP_VIEWER_PYRAMID_H
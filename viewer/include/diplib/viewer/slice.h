@@ -20,6 +20,9 @@
 #ifndef DIP_VIEWER_SLICE_H
 #define DIP_VIEWER_SLICE_H
 
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
 #include <thread>
 
 #include "diplib/color.h"
@@ -32,6 +35,7 @@
 #include "diplib/viewer/control.h"
 #include "diplib/viewer/status.h"
 #include "diplib/viewer/link.h"
+#include "diplib/viewer/pyramid.h"
 
 /// \file
 /// \brief Declares `dip::viewer::SliceViewer`.
@@ -47,12 +51,16 @@ class DIPVIEWER_CLASS_EXPORT SliceView : public View
 
     dip::uint dimx_, dimy_;      ///< Indices in options.dims_.             
     unsigned int texture_;       ///< OpenGL texture identifier.
+    dip::uint factor_;           ///< Subsampling factor of the image that was projected.
 
   public:
-    SliceView(ViewPort *viewport, dip::uint dimx, dip::uint dimy) : View(viewport), dimx_(dimx), dimy_(dimy), texture_(0) { }
+    SliceView(ViewPort *viewport, dip::uint dimx, dip::uint dimy) : View(viewport), dimx_(dimx), dimy_(dimy), texture_(0), factor_(1) { }
 
-    DIPVIEWER_EXPORT void project();
-    DIPVIEWER_EXPORT void map();
+    /// \brief Projects `image`, the viewed image of sizes `sizes` subsampled by `factor`.
+    ///
+    /// The result is replicated back to `sizes`.
+    DIPVIEWER_EXPORT void project(const ViewingOptions &options, const dip::Image &image, const dip::UnsignedArray &sizes, dip::uint factor=1);
+    DIPVIEWER_EXPORT void map(const ViewingOptions &options);
     DIPVIEWER_EXPORT void rebuild();
     DIPVIEWER_EXPORT void render();
     dip::uint size(dip::uint ii)
@@ -62,6 +70,7 @@ class DIPVIEWER_CLASS_EXPORT SliceView : public View
     
     dip::uint dimx() { return dimx_; }
     dip::uint dimy() { return dimy_; }
+    dip::uint factor() { return factor_; }
 };
 
 class DIPVIEWER_CLASS_EXPORT SliceViewPort : public ViewPort
@@ -100,7 +109,11 @@ class DIPVIEWER_CLASS_EXPORT SliceViewer : public Viewer
   protected:
     ViewingOptions options_;
     std::thread thread_;
-    bool continue_, updated_;
+    std::atomic<bool> continue_, updated_;
+    bool wake_;                            ///< Set when the calculation thread has new work.
+    std::mutex wake_mutex_;                ///< Protects `wake_`, and changes to `continue_` and `updated_`.
+    std::condition_variable wake_cv_;      ///< Signals changes to `wake_`, `continue_` and `updated_`.
+    ImagePyramid pyramid_;                 ///< Pyramid of `image_`, only used by the calculation thread.
     std::vector<ViewPort*> viewports_;
     SliceViewPort *main_, *left_, *top_;
     TensorViewPort *tensor_;
@@ -133,7 +146,11 @@ class DIPVIEWER_CLASS_EXPORT SliceViewer : public Viewer
     {
       if (continue_)
       {
-        continue_ = false;
+        {
+          std::lock_guard<std::mutex> lock(wake_mutex_);
+          continue_ = false;
+        }
+        wake_cv_.notify_all();
         thread_.join();
       }
       
@@ -155,7 +172,10 @@ class DIPVIEWER_CLASS_EXPORT SliceViewer : public Viewer
     
     ViewingOptions &options() override { return options_; }
     const dip::Image &image() override { return image_; }
-    void setImage(const dip::Image &image) override { original_ = image; refresh_seq_++; }
+    void setImage(const dip::Image &image) override { original_ = image; refresh_seq_++; wake(); }
+
+    /// \brief Refresh window contents, and wakes up the calculation thread.
+    void refresh() override { Viewer::refresh(); wake(); }
     
     /// \brief Update linked viewers.
     ///
@@ -174,6 +194,9 @@ class DIPVIEWER_CLASS_EXPORT SliceViewer : public Viewer
     DIPVIEWER_EXPORT void place();
     DIPVIEWER_EXPORT ViewPort *viewport(int x, int y);
     DIPVIEWER_EXPORT void calculateTextures();
+    DIPVIEWER_EXPORT void projectViews(const ViewingOptions &old_options, const ViewingOptions &options, dip::uint level, bool all);
+    DIPVIEWER_EXPORT void setUpdated();
+    DIPVIEWER_EXPORT void wake();
 };
 
 /// \}
@@ -302,6 +302,11 @@ void HistogramViewPort::calculate()
   dip::Image in = viewer()->image();
   viewer()->unlock();
 
+  calculate(in);
+}
+
+void HistogramViewPort::calculate(const dip::Image &in)
+{
   dip::Image histogram = dip::Image { dip::UnsignedArray{ 100 }, in.TensorElements(), dip::DT_UINT32 };  
   histogram = 0;
 
@@ -0,0 +1,76 @@
+/*
+ * DIPlib 3.0 viewer
+ * This file contains functionality for the multi-resolution image pyramid.
+ *
+ * (c)2026, Wouter Caarls
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "diplib/viewer/pyramid.h"
+
+/// \file
+/// \brief Defines `dip::viewer::ImagePyramid`.
+
+namespace dip { namespace viewer {
+
+void ImagePyramid::setImage(const dip::Image &image)
+{
+  levels_.clear();
+  levels_.push_back(image);
+
+  // Add levels until all dimensions have a single pixel
+  dip::uint largest = 1;
+  for (size_t ii=0; ii < image.Dimensionality(); ++ii)
+    largest = std::max(largest, image.Size(ii));
+  while (largest > 1)
+  {
+    levels_.push_back(dip::Image());
+    largest = (largest - 1) / 2 + 1;
+  }
+}
+
+dip::UnsignedArray ImagePyramid::sizes(dip::uint level)
+{
+  dip::UnsignedArray sizes = image().Sizes();
+  for (size_t ii=0; ii < sizes.size(); ++ii)
+    sizes[ii] = ((sizes[ii] - 1) >> level) + 1;
+  return sizes;
+}
+
+const dip::Image &ImagePyramid::level(dip::uint level)
+{
+  DIP_THROW_IF(level >= levels_.size(), E::INDEX_OUT_OF_RANGE);
+
+  if (!levels_[level].IsForged())
+  {
+    // Copy the subsampled view, such that further processing accesses
+    // contiguous memory.
+    RangeArray range(levels_[0].Dimensionality(), Range(0, -1, factor(level)));
+    dip::Image subsampled = levels_[0].At(range);
+    levels_[level] = subsampled.Copy();
+  }
+
+  return levels_[level];
+}
+
+dip::uint ImagePyramid::coarseLevel(dip::uint maxSamples)
+{
+  dip::uint tensor = image().TensorElements();
+  for (dip::uint ll=0; ll < levels_.size(); ++ll)
+    if (sizes(ll).product() * tensor <= maxSamples)
+      return ll;
+  return levels_.size()-1;
+}
+
+}} // namespace dip::viewer
@@ -17,6 +17,9 @@
  * limitations under the License.
  */
 
+#include <chrono>
+#include <future>
+
 #include "diplib/math.h"
 #include "diplib/statistics.h"
 #include "diplib/generic_iterators.h"
@@ -36,10 +39,65 @@
 
 namespace dip { namespace viewer {
 
-void SliceView::project()
+namespace {
+
+// Number of samples (pixels times tensor elements) of the pyramid level used
+// for the first, coarse, projections and for the initial range statistics.
+constexpr dip::uint PREVIEW_SAMPLES = 1 << 22;
+
+// Number of samples processed at the time when refining the range statistics.
+constexpr dip::uint RANGE_SLAB_SAMPLES = 1 << 24;
+
+// Replicates each pixel of `in` `factor` times along each dimension, and crops
+// the result to `sizes`.
+dip::Image Replicate(const dip::Image &in, dip::uint factor, const dip::UnsignedArray &sizes)
 {
-  auto &o = viewport()->viewer()->options();
-  Image image = viewport()->viewer()->image();
+  dip::Image out(sizes, in.TensorElements(), in.DataType());
+  out.CopyNonDataProperties(in);
+  
+  // Copy `in` once for each offset within a `factor`-sized block
+  dip::uint nDims = sizes.size();
+  dip::UnsignedArray offset(nDims, 0);
+  RangeArray outRange(nDims), inRange(nDims);
+  for (;;)
+  {
+    bool empty = false;
+    for (size_t ii=0; ii < nDims; ++ii)
+    {
+      if (offset[ii] >= sizes[ii])
+      {
+        empty = true;
+        break;
+      }
+      dip::uint n = (sizes[ii] - offset[ii] - 1) / factor + 1;
+      outRange[ii] = Range((dip::sint)offset[ii], -1, factor);
+      inRange[ii] = Range(0, (dip::sint)n - 1);
+    }
+    if (!empty)
+    {
+      dip::Image dest = out.At(outRange);
+      dest.Copy(in.At(inRange));
+    }
+    
+    size_t ii = 0;
+    for (; ii < nDims; ++ii)
+    {
+      if (++offset[ii] < factor)
+        break;
+      offset[ii] = 0;
+    }
+    if (ii == nDims)
+      break;
+  }
+  
+  return out;
+}
+
+} // namespace
+
+void SliceView::project(const ViewingOptions &o, const dip::Image &input, const dip::UnsignedArray &sizes, dip::uint factor)
+{
+  Image image = input;
   
   dip::sint dx = o.dims_[dimx_], dy = o.dims_[dimy_];
   
@@ -50,7 +108,7 @@ void SliceView::project()
     
     for (size_t ii=0; ii < range.size(); ++ii)
       if ((int)ii != dx && (int)ii != dy)
-        range[ii] = Range((dip::sint)o.operating_point_[ii]);
+        range[ii] = Range((dip::sint)(o.operating_point_[ii] / factor));
         
     projected_ = image.At(range);
   }
@@ -61,6 +119,17 @@ void SliceView::project()
     dip::UnsignedArray ro = o.roi_origin_;
     dip::UnsignedArray rs = o.roi_sizes_;
     
+    if (factor > 1)
+    {
+      // Cover the same pixels in the subsampled image
+      for (size_t ii=0; ii < ro.size(); ++ii)
+      {
+        dip::uint end = (ro[ii] + std::max(rs[ii], (dip::uint)1) - 1) / factor;
+        ro[ii] /= factor;
+        rs[ii] = end - ro[ii] + 1;
+      }
+    }
+    
     if (dx != -1)
     {
       process[ (dip::uint)dx ] = false;
@@ -96,13 +165,27 @@ void SliceView::project()
     projected_.Squeeze();
   else
     projected_.PermuteDimensions({(unsigned int)dx, (unsigned int)dy});
+  
+  if (factor > 1)
+  {
+    // Back to the resolution of the viewed image, such that coordinates
+    // in the view do not depend on the pyramid level.
+    dip::UnsignedArray target;
+    for (dip::sint dd : {dx, dy})
+      if (dd != -1 && (projected_.Dimensionality() == 2 || sizes[(dip::uint)dd] > 1))
+        target.push_back(sizes[(dip::uint)dd]);
+    DIP_ASSERT(target.size() == projected_.Dimensionality());
+    if (!target.empty())
+      projected_ = Replicate(projected_, factor, target);
+  }
+  factor_ = factor;
     
-  map();
+  map(o);
 }
 
-void SliceView::map()
+void SliceView::map(const ViewingOptions &options)
 {
-  auto &o = viewport()->viewer()->options();
+  ViewingOptions o = options;
   
   if (projected_.Dimensionality() == 0)
   {
@@ -556,7 +639,7 @@ void SliceViewPort::screenToView(int x, int y, double *ix, double *iy)
     *iy = (y-y_)/viewer()->options().zoom_[(dip::uint)dy] + viewer()->options().origin_[(dip::uint)dy];
 }
 
-SliceViewer::SliceViewer(const dip::Image &image, std::string name, size_t width, size_t height) : Viewer(name), options_(image), continue_(false), updated_(false), original_(image), drag_viewport_(NULL), refresh_seq_(0)
+SliceViewer::SliceViewer(const dip::Image &image, std::string name, size_t width, size_t height) : Viewer(name), options_(image), continue_(false), updated_(false), wake_(true), original_(image), drag_viewport_(NULL), refresh_seq_(0)
 {
   if (width && height)
     requestSize(width, height);
@@ -597,8 +680,8 @@ void SliceViewer::create()
   thread_ = std::thread(&SliceViewer::calculateTextures, this);
   
   // Wait for first projection
-  while (!updated_)
-     std::this_thread::sleep_for(std::chrono::microseconds(1000));
+  std::unique_lock<std::mutex> lock(wake_mutex_);
+  wake_cv_.wait(lock, [this]{ return updated_.load(); });
 }
 
 void SliceViewer::place()
@@ -635,7 +718,11 @@ void SliceViewer::draw()
   {
     for (size_t ii=0; ii < viewports_.size(); ++ii)
       viewports_[ii]->rebuild();
-    updated_ = false;
+    {
+      std::lock_guard<std::mutex> lock(wake_mutex_);
+      updated_ = false;
+    }
+    wake_cv_.notify_all();
   }
   
   for (size_t ii=0; ii < viewports_.size(); ++ii)
@@ -805,15 +892,52 @@ void SliceViewer::calculateTextures()
 {
   ViewingOptions options, old_options;
   int seq = -1;
+  dip::uint level = 0;               // Coarsest pyramid level of the current projections
+  dip::uint coarse = 0;              // Pyramid level for previews and the histogram
+  dip::MinMaxAccumulator range;      // Range of the image slabs processed so far
+  dip::uint slab = 0, slabs = 0;     // Next slab, and number of slabs, in range refinement
+  dip::uint thickness = 1;           // Slab thickness along the last dimension
+  
+  // Only call this under lock
+  auto setRange = [&](const dip::MinMaxAccumulator &acc)
+  {
+    options_.range_ = {acc.Minimum(), acc.Maximum()};
+    if (options.mapping_ == ViewingOptions::Mapping::Linear ||
+        options.mapping_ == ViewingOptions::Mapping::Symmetric || 
+        options.mapping_ == ViewingOptions::Mapping::Logarithmic)
+    {
+      // If we're on some automatic mapping more, adjust it.
+      options_.mapping_range_ = options_.range_;
+      
+      if (options.mapping_ == ViewingOptions::Mapping::Symmetric)
+      {
+        if (std::abs(options_.mapping_range_.first) > std::abs(options_.mapping_range_.second))
+          options_.mapping_range_.second = -options_.mapping_range_.first;
+        else
+          options_.mapping_range_.first = -options_.mapping_range_.second;
+      }
+    }
+  };
 
   while (continue_)
   {
-    // Make sure we don't lose updates
-    while (updated_ && continue_)
-       std::this_thread::sleep_for(std::chrono::microseconds(1000));
-       
-    if (!continue_)
-      break;
+    {
+      // Wait until the last textures were drawn, and there is something to do.
+      // Changes through refresh() and setImage() wake us up; the timeout picks
+      // up options that were changed programmatically without a refresh().
+      std::unique_lock<std::mutex> lock(wake_mutex_);
+      bool refining = level > 0 || slab < slabs;
+      wake_cv_.wait_for(lock, std::chrono::milliseconds(100), [&]{ return !continue_ || (!updated_ && (wake_ || refining)); });
+      
+      if (!continue_)
+        break;
+      
+      // Make sure we don't lose updates
+      if (updated_)
+        continue;
+        
+      wake_ = false;
+    }
   
     old_options = options;
     lock();
@@ -852,54 +976,77 @@ void SliceViewer::calculateTextures()
       }
       else
         image = original;
+      
+      pyramid_.setImage(image);
+      coarse = pyramid_.coarseLevel(PREVIEW_SAMPLES);
         
-      // Get range
-      dip::Image copy = image;
-      copy.TensorToSpatial();
-      dip::MinMaxAccumulator acc = MaximumAndMinimum( image );
+      // Get range from the coarse level. If that is not the full image, it
+      // is refined below, one slab at the time.
+      dip::MinMaxAccumulator acc = MaximumAndMinimum( pyramid_.level(coarse) );
+      
+      range.Reset();
+      slab = slabs = 0;
+      if (coarse > 0)
+      {
+        dip::uint dim = image.Dimensionality()-1;
+        dip::uint plane = image.NumberOfPixels() / image.Size(dim) * image.TensorElements();
+        thickness = std::max(RANGE_SLAB_SAMPLES / plane, (dip::uint)1);
+        slabs = (image.Size(dim) + thickness - 1) / thickness;
+      }
       
       lock();
       image_ = image;
       original_ = original;
-      options_.range_ = {acc.Minimum(), acc.Maximum()};
-      if (options.mapping_ == ViewingOptions::Mapping::Linear ||
-          options.mapping_ == ViewingOptions::Mapping::Symmetric || 
-          options.mapping_ == ViewingOptions::Mapping::Logarithmic)
-      {
-        // If we're on some automatic mapping more, adjust it.
-        options_.mapping_range_ = options_.range_;
-        
-        if (options.mapping_ == ViewingOptions::Mapping::Symmetric)
-        {
-          if (std::abs(options_.mapping_range_.first) > std::abs(options_.mapping_range_.second))
-            options_.mapping_range_.second = -options_.mapping_range_.first;
-          else
-            options_.mapping_range_.first = -options_.mapping_range_.second;
-        }
-      }
+      setRange(acc);
       unlock();
       
       // Recalculate histogram
-      histogram_->calculate();
+      histogram_->calculate(pyramid_.level(coarse));
     }
     
     if (diff >= ViewingOptions::Diff::Projection)
     {
-      // Need to reproject
-      if (old_options.needsReproject(options, main_->view()->dimx(), main_->view()->dimy()) || diff >= ViewingOptions::Diff::Complex)
-        main_->view()->project();
-      if (old_options.needsReproject(options, left_->view()->dimx(), left_->view()->dimy()) || diff >= ViewingOptions::Diff::Complex)
-        left_->view()->project();
-      if (old_options.needsReproject(options, top_->view()->dimx(), top_->view()->dimy()) || diff >= ViewingOptions::Diff::Complex)
-        top_->view()->project();
+      // Slices are extracted at full resolution, projections are previewed
+      // at the coarse level and refined below.
+      level = options.projection_ == ViewingOptions::Projection::None ? 0 : coarse;
+      projectViews(old_options, options, level, diff >= ViewingOptions::Diff::Complex);
+    }
+    else if (diff == ViewingOptions::Diff::None && level > 0)
+    {
+      // Nothing changed since the previews were shown, refine them
+      level = 0;
+      projectViews(options, options, level, false);
+      diff = ViewingOptions::Diff::Draw;
+    }
+    else if (diff == ViewingOptions::Diff::None && slab < slabs)
+    {
+      // Refine range
+      const dip::Image &image = pyramid_.image();
+      dip::uint dim = image.Dimensionality()-1;
+      RangeArray ra(image.Dimensionality());
+      ra[dim] = Range((dip::sint)(slab*thickness), (dip::sint)(std::min((slab+1)*thickness, image.Size(dim))-1));
+      range += MaximumAndMinimum( image.At(ra) );
+      
+      if (++slab == slabs)
+      {
+        lock();
+        setRange(range);
+        unlock();
+        
+        // The new range changes the histogram bins. If it also changed the
+        // mapping range, the next iteration remaps the views.
+        histogram_->calculate(pyramid_.level(coarse));
+        diff = ViewingOptions::Diff::Draw;
+        wake();
+      }
     }
     
     if (diff == ViewingOptions::Diff::Mapping)
     {
       // Need to remap
-      main_->view()->map();
-      left_->view()->map();
-      top_->view()->map();
+      main_->view()->map(options);
+      left_->view()->map(options);
+      top_->view()->map(options);
     }
     
     if (diff >= ViewingOptions::Diff::Place)
@@ -911,14 +1058,50 @@ void SliceViewer::calculateTextures()
     if (diff >= ViewingOptions::Diff::Draw)
     {
       // Just redraw
-      updated_ = true;
+      setUpdated();
     }
     
     if (diff != ViewingOptions::Diff::None)
-      refresh();
+      Viewer::refresh();
+  }
+}
 
-    std::this_thread::sleep_for(std::chrono::microseconds(1000));
+void SliceViewer::projectViews(const ViewingOptions &old_options, const ViewingOptions &options, dip::uint level, bool all)
+{
+  // Compute the level here, the projections only read it
+  const dip::Image &image = pyramid_.level(level);
+  const dip::UnsignedArray &sizes = pyramid_.image().Sizes();
+  dip::uint factor = ImagePyramid::factor(level);
+  
+  // The views are independent, project them concurrently
+  std::vector<std::future<void>> tasks;
+  for (SliceViewPort *viewport : {main_, left_, top_})
+  {
+    SliceView *view = viewport->view();
+    if (all || old_options.needsReproject(options, view->dimx(), view->dimy()) || view->factor() > factor)
+      tasks.push_back(std::async(std::launch::async, [&, view]{ view->project(options, image, sizes, factor); }));
+  }
+  
+  for (auto &task : tasks)
+    task.get();
+}
+
+void SliceViewer::setUpdated()
+{
+  {
+    std::lock_guard<std::mutex> lock(wake_mutex_);
+    updated_ = true;
+  }
+  wake_cv_.notify_all();
+}
+
+void SliceViewer::wake()
+{
+  {
+    std::lock_guard<std::mutex> lock(wake_mutex_);
+    wake_ = true;
   }
+  wake_cv_.notify_all();
 }
 
 void SliceViewer::updateLinkedViewers()